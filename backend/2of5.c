@@ -34,21 +34,20 @@
 #include <stdio.h>
 #include "common.h"
 #ifdef _MSC_VER
-#include <malloc.h>
 #define inline _inline
 #endif
 
-static const char *C25MatrixTable[10] = {
+static const char C25MatrixTable[10][6] = {
     "113311", "311131", "131131", "331111", "113131", "313111",
     "133111", "111331", "311311", "131311"
 };
 
-static const char *C25IndustTable[10] = {
+static const char C25IndustTable[10][10] = {
     "1111313111", "3111111131", "1131111131", "3131111111", "1111311131",
     "3111311111", "1131311111", "1111113131", "3111113111", "1131113111"
 };
 
-static const char *C25InterTable[10] = {
+static const char C25InterTable[10][5] = {
     "11331", "31113", "13113", "33111", "11313", "31311", "13311", "11133",
     "31131", "13131"
 };
@@ -62,6 +61,7 @@ INTERNAL int matrix_two_of_five(struct zint_symbol *symbol, unsigned char source
 
     int i, error_number;
     char dest[512]; /* 6 + 80 * 6 + 6 + 1 ~ 512*/
+    char *d = dest;
 
     if (length > 80) {
         strcpy(symbol->errtxt, "301: Input too long");
@@ -74,16 +74,18 @@ INTERNAL int matrix_two_of_five(struct zint_symbol *symbol, unsigned char source
     }
 
     /* start character */
-    strcpy(dest, "411111");
+    memcpy(d, "411111", 6);
+    d += 6;
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, C25MatrixTable, source[i], dest);
+    for (i = 0; i < length; i++, d += 6) {
+        memcpy(d, C25MatrixTable[source[i] - '0'], 6);
     }
 
     /* Stop character */
-    strcat(dest, "41111");
+    memcpy(d, "41111", 5);
+    d += 5;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return error_number;
 }
@@ -93,6 +95,7 @@ INTERNAL int industrial_two_of_five(struct zint_symbol *symbol, unsigned char so
 
     int i, error_number;
     char dest[512]; /* 6 + 40 * 10 + 6 + 1 */
+    char *d = dest;
 
     if (length > 45) {
         strcpy(symbol->errtxt, "303: Input too long");
@@ -105,16 +108,18 @@ INTERNAL int industrial_two_of_five(struct zint_symbol *symbol, unsigned char so
     }
 
     /* start character */
-    strcpy(dest, "313111");
+    memcpy(d, "313111", 6);
+    d += 6;
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, C25IndustTable, source[i], dest);
+    for (i = 0; i < length; i++, d += 10) {
+        memcpy(d, C25IndustTable[source[i] - '0'], 10);
     }
 
     /* Stop character */
-    strcat(dest, "31113");
+    memcpy(d, "31113", 5);
+    d += 5;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return error_number;
 }
@@ -123,6 +128,7 @@ INTERNAL int industrial_two_of_five(struct zint_symbol *symbol, unsigned char so
 INTERNAL int iata_two_of_five(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, error_number;
     char dest[512]; /* 4 + 45 * 10 + 3 + 1 */
+    char *d = dest;
 
     if (length > 45) {
         strcpy(symbol->errtxt, "305: Input too long");
@@ -135,16 +141,18 @@ INTERNAL int iata_two_of_five(struct zint_symbol *symbol, unsigned char source[]
     }
 
     /* start */
-    strcpy(dest, "1111");
+    memcpy(d, "1111", 4);
+    d += 4;
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, C25IndustTable, source[i], dest);
+    for (i = 0; i < length; i++, d += 10) {
+        memcpy(d, C25IndustTable[source[i] - '0'], 10);
     }
 
     /* stop */
-    strcat(dest, "311");
+    memcpy(d, "311", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return error_number;
 }
@@ -154,6 +162,7 @@ INTERNAL int logic_two_of_five(struct zint_symbol *symbol, unsigned char source[
 
     int i, error_number;
     char dest[512]; /* 4 + 80 * 6 + 3 + 1 */
+    char *d = dest;
 
     if (length > 80) {
         strcpy(symbol->errtxt, "307: Input too long");
@@ -166,16 +175,18 @@ INTERNAL int logic_two_of_five(struct zint_symbol *symbol, unsigned char source[
     }
 
     /* start character */
-    strcpy(dest, "1111");
+    memcpy(d, "1111", 4);
+    d += 4;
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, C25MatrixTable, source[i], dest);
+    for (i = 0; i < length; i++, d += 6) {
+        memcpy(d, C25MatrixTable[source[i] - '0'], 6);
     }
 
     /* Stop character */
-    strcat(dest, "311");
+    memcpy(d, "311", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return error_number;
 }
@@ -184,12 +195,9 @@ INTERNAL int logic_two_of_five(struct zint_symbol *symbol, unsigned char source[
 INTERNAL int interleaved_two_of_five(struct zint_symbol *symbol, const unsigned char source[], size_t length) {
 
     int i, j, error_number;
-    char bars[7], spaces[7], mixed[14], dest[1000];
-#ifndef _MSC_VER
-    unsigned char temp[length + 2];
-#else
-    unsigned char* temp = (unsigned char *) _alloca((length + 2) * sizeof (unsigned char));
-#endif
+    char dest[1000];
+    char *d = dest;
+    unsigned char temp[89 + 2];
 
     if (length > 89) {
         strcpy(symbol->errtxt, "309: Input too long");
@@ -211,31 +219,26 @@ INTERNAL int interleaved_two_of_five(struct zint_symbol *symbol, const unsigned
     ustrcat(temp, source);
 
     /* start character */
-    strcpy(dest, "1111");
+    memcpy(d, "1111", 4);
+    d += 4;
 
     for (i = 0; i < (int) length; i += 2) {
-        int k = 0;
-        /* look up the bars and the spaces and put them in two strings */
-        strcpy(bars, "");
-        lookup(NEON, C25InterTable, temp[i], bars);
-        strcpy(spaces, "");
-        lookup(NEON, C25InterTable, temp[i + 1], spaces);
-
-        /* then merge (interlace) the strings together */
-        for (j = 0; j <= 4; j++) {
-            mixed[k] = bars[j];
-            k++;
-            mixed[k] = spaces[j];
-            k++;
+        /* look up the bars and the spaces */
+        const char *const bars = C25InterTable[temp[i] - '0'];
+        const char *const spaces = C25InterTable[temp[i + 1] - '0'];
+
+        /* then interlace them */
+        for (j = 0; j < 5; j++) {
+            *d++ = bars[j];
+            *d++ = spaces[j];
         }
-        mixed[k] = '\0';
-        strcat(dest, mixed);
     }
 
     /* Stop character */
-    strcat(dest, "311");
+    memcpy(d, "311", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, temp);
     return error_number;
 
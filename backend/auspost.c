@@ -33,11 +33,11 @@
 
 #define GDSET 	"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz #"
 
-static const char *AusNTable[10] = {
+static const char AusNTable[10][2] = {
     "00", "01", "02", "10", "11", "12", "20", "21", "22", "30"
 };
 
-static const char *AusCTable[64] = {
+static const char AusCTable[64][3] = {
     "222", "300", "301", "302", "310", "311", "312", "320", "321", "322",
     "000", "001", "002", "010", "011", "012", "020", "021", "022", "100", "101", "102", "110",
     "111", "112", "120", "121", "122", "200", "201", "202", "210", "211", "212", "220", "221",
@@ -46,7 +46,7 @@ static const char *AusCTable[64] = {
     "003", "013"
 };
 
-static const char *AusBarTable[64] = {
+static const char AusBarTable[64][3] = {
     "000", "001", "002", "003", "010", "011", "012", "013", "020", "021",
     "022", "023", "030", "031", "032", "033", "100", "101", "102", "103", "110", "111", "112",
     "113", "120", "121", "122", "123", "130", "131", "132", "133", "200", "201", "202", "203",
@@ -68,14 +68,14 @@ static inline char convert_pattern(char data, int shift) {
     return (data - '0') << shift;
 }
 
-/* Adds Reed-Solomon error correction to auspost */
-static void rs_error(char data_pattern[]) {
-    int reader, len, triple_writer = 0;
+/* Adds Reed-Solomon error correction to auspost, returning new length of `data_pattern` */
+static int rs_error(char data_pattern[], int len) {
+    int reader, triple_writer = 0;
     unsigned char triple[31];
     unsigned char result[5];
     rs_t rs;
 
-    for (reader = 2, len = (int) strlen(data_pattern); reader < len; reader += 3, triple_writer++) {
+    for (reader = 2; reader < len; reader += 3, triple_writer++) {
         triple[triple_writer] = convert_pattern(data_pattern[reader], 4)
                 + convert_pattern(data_pattern[reader + 1], 2)
                 + convert_pattern(data_pattern[reader + 2], 0);
@@ -85,9 +85,11 @@ static void rs_error(char data_pattern[]) {
     rs_init_code(&rs, 4, 1);
     rs_encode(&rs, triple_writer, triple, result);
 
-    for (reader = 4; reader > 0; reader--) {
-        strcat(data_pattern, AusBarTable[(int) result[reader - 1]]);
+    for (reader = 4; reader > 0; reader--, len += 3) {
+        memcpy(data_pattern + len, AusBarTable[(int) result[reader - 1]], 3);
     }
+
+    return len;
 }
 
 /* Handles Australia Posts's 4 State Codes */
@@ -107,8 +109,10 @@ INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[],
     size_t h;
 
     char data_pattern[200];
+    char *d = data_pattern;
     char fcc[3] = {0, 0, 0}, dpid[10];
     char localstr[30];
+    int posns[15];
 
     /* Check input immediately to catch nuls */
     error_number = is_sane(GDSET, source, length);
@@ -180,54 +184,57 @@ INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[],
     }
 
     /* Start character */
-    strcpy(data_pattern, "13");
+    memcpy(d, "13", 2);
+    d += 2;
 
     /* Encode the FCC */
-    for (reader = 0; reader < 2; reader++) {
-        lookup(NEON, AusNTable, fcc[reader], data_pattern);
+    for (reader = 0; reader < 2; reader++, d += 2) {
+        memcpy(d, AusNTable[fcc[reader] - '0'], 2);
     }
 
     /* printf("AUSPOST FCC: %s  ", fcc); */
 
     /* Delivery Point Identifier (DPID) */
-    for (reader = 0; reader < 8; reader++) {
-        lookup(NEON, AusNTable, dpid[reader], data_pattern);
+    for (reader = 0; reader < 8; reader++, d += 2) {
+        memcpy(d, AusNTable[dpid[reader] - '0'], 2);
     }
 
     /* Customer Information */
     if (h > 8) {
         if ((h == 13) || (h == 18)) {
-            for (reader = 8; reader < h; reader++) {
-                lookup(GDSET, AusCTable, localstr[reader], data_pattern);
+            is_sane_lookup(GDSET, 64, (const unsigned char *) localstr + 8, (int) h - 8, posns);
+            for (reader = 8; reader < h; reader++, d += 3) {
+                memcpy(d, AusCTable[posns[reader - 8]], 3);
             }
         } else if ((h == 16) || (h == 23)) {
-            for (reader = 8; reader < h; reader++) {
-                lookup(NEON, AusNTable, localstr[reader], data_pattern);
+            for (reader = 8; reader < h; reader++, d += 2) {
+                memcpy(d, AusNTable[localstr[reader] - '0'], 2);
             }
         }
     }
 
     /* Filler bar */
-    h = strlen(data_pattern);
+    h = d - data_pattern;
     switch (h) {
         case 22:
         case 37:
         case 52:
-            strcat(data_pattern, "3");
+            *d++ = '3';
+            h++;
             break;
         default:
             break;
     }
 
     /* Reed Solomon error correction */
-    rs_error(data_pattern);
+    h = rs_error(data_pattern, (int) h);
 
     /* Stop character */
-    strcat(data_pattern, "13");
+    memcpy(data_pattern + h, "13", 2);
+    h += 2;
 
     /* Turn the symbol into a bar pattern ready for plotting */
     writer = 0;
-    h = strlen(data_pattern);
     for (loopey = 0; loopey < h; loopey++) {
         if ((data_pattern[loopey] == '1') || (data_pattern[loopey] == '0')) {
             set_module(symbol, 0, writer);
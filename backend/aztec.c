@@ -32,10 +32,8 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "aztec.h"
 #include "reedsol.h"
 
@@ -108,8 +106,8 @@ static int az_bin_append_posn(const int arg, const int length, char *binary, int
     return bin_append_posn(arg, length, binary, posn);
 }
 
-static int aztec_text_process(const unsigned char source[], int src_len, char binary_string[], const int gs1,
-            const int eci, int *data_length, const int debug) {
+static int aztec_text_process(struct zint_symbol *symbol, const unsigned char source[], int src_len,
+            char binary_string[], const int gs1, const int eci, int *data_length, const int debug) {
 
     int i, j;
     char current_mode;
@@ -118,16 +116,14 @@ static int aztec_text_process(const unsigned char source[], int src_len, char bi
     int reduced_length;
     int byte_mode = 0;
     int bp;
+    char *encode_mode = (char *) scratch_alloc(symbol, src_len + 1);
+    unsigned char *reduced_source = (unsigned char *) scratch_alloc(symbol, src_len + 1);
+    char *reduced_encode_mode = (char *) scratch_alloc(symbol, src_len + 1);
 
-#ifndef _MSC_VER
-    char encode_mode[src_len + 1];
-    unsigned char reduced_source[src_len + 1];
-    char reduced_encode_mode[src_len + 1];
-#else
-    char *encode_mode = (char *) _alloca(src_len + 1);
-    unsigned char *reduced_source = (unsigned char *) _alloca(src_len + 1);
-    char *reduced_encode_mode = (char *) _alloca(src_len + 1);
-#endif
+    if (!encode_mode || !reduced_source || !reduced_encode_mode) {
+        strcpy(symbol->errtxt, "500: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     for (i = 0; i < src_len; i++) {
         if (source[i] >= 128) {
@@ -883,11 +879,8 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
     int comp_loop = 4;
     rs_t rs;
     rs_uint_t rs_uint;
-
-#ifdef _MSC_VER
-    unsigned int* data_part;
-    unsigned int* ecc_part;
-#endif
+    unsigned int *data_part;
+    unsigned int *ecc_part;
 
     memset(binary_string, 0, AZTEC_BIN_CAPACITY + 1);
     memset(adjusted_string, 0, AZTEC_MAX_CAPACITY + 1);
@@ -908,8 +901,11 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
 
     populate_map(AztecMap);
 
-    error_number = aztec_text_process(source, length, binary_string, gs1, symbol->eci, &data_length, debug);
+    error_number = aztec_text_process(symbol, source, length, binary_string, gs1, symbol->eci, &data_length, debug);
 
+    if (error_number == ZINT_ERROR_MEMORY) {
+        return error_number;
+    }
     if (error_number != 0) {
         strcpy(symbol->errtxt, "502: Input too long or too many extended ASCII characters");
         return error_number;
@@ -1218,12 +1214,12 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
         printf("    (%d data words, %d ecc words)\n", data_blocks, ecc_blocks);
     }
 
-#ifndef _MSC_VER
-    unsigned int data_part[data_blocks + 3], ecc_part[ecc_blocks + 3];
-#else
-    data_part = (unsigned int*) _alloca((data_blocks + 3) * sizeof (unsigned int));
-    ecc_part = (unsigned int*) _alloca((ecc_blocks + 3) * sizeof (unsigned int));
-#endif
+    data_part = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (data_blocks + 3));
+    ecc_part = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (ecc_blocks + 3));
+    if (!data_part || !ecc_part) {
+        strcpy(symbol->errtxt, "500: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
     /* Copy across data into separate integers */
     memset(data_part, 0, (data_blocks + 2) * sizeof (int));
     memset(ecc_part, 0, (ecc_blocks + 2) * sizeof (int));
@@ -1249,13 +1245,19 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
             rs_encode_uint(&rs, data_blocks, data_part, ecc_part);
             break;
         case 10:
-            rs_uint_init_gf(&rs_uint, 0x409, 1023);
+            if (!rs_uint_init_gf(&rs_uint, symbol, 0x409, 1023)) {
+                strcpy(symbol->errtxt, "500: Insufficient memory");
+                return ZINT_ERROR_MEMORY;
+            }
             rs_uint_init_code(&rs_uint, ecc_blocks, 1);
             rs_uint_encode(&rs_uint, data_blocks, data_part, ecc_part);
             rs_uint_free(&rs_uint);
             break;
         case 12:
-            rs_uint_init_gf(&rs_uint, 0x1069, 4095);
+            if (!rs_uint_init_gf(&rs_uint, symbol, 0x1069, 4095)) {
+                strcpy(symbol->errtxt, "500: Insufficient memory");
+                return ZINT_ERROR_MEMORY;
+            }
             rs_uint_init_code(&rs_uint, ecc_blocks, 1);
             rs_uint_encode(&rs_uint, data_blocks, data_part, ecc_part);
             rs_uint_free(&rs_uint);
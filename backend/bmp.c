@@ -34,10 +34,7 @@
 #include <stdio.h>
 #include "common.h"
 #include "bmp.h"        /* Bitmap header structure */
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#endif
+#include "filemem.h"
 
 INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     int i, row, column;
@@ -47,7 +44,8 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     unsigned int data_offset, data_size, file_size;
     unsigned char *bitmap_file_start, *bmp_posn;
     unsigned char *bitmap;
-    FILE *bmp_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     bitmap_file_header_t file_header;
     bitmap_info_header_t info_header;
     color_ref_t bg_color_ref;
@@ -67,7 +65,7 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     data_offset += (colour_count * (sizeof(color_ref_t)));
     file_size = data_offset + data_size;
 
-    bitmap_file_start = (unsigned char *) malloc(file_size);
+    bitmap_file_start = (unsigned char *) z_malloc(symbol, file_size);
     if (bitmap_file_start == NULL) {
         strcpy(symbol->errtxt, "602: Out of memory");
         return ZINT_ERROR_MEMORY;
@@ -173,26 +171,19 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Open output file in binary mode */
-    if ((symbol->output_options & BARCODE_STDOUT) != 0) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "600: Can't open output file");
-            free(bitmap_file_start);
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        bmp_file = stdout;
-    } else {
-        if (!(bmp_file = fopen(symbol->outfile, "wb"))) {
-            free(bitmap_file_start);
-            strcpy(symbol->errtxt, "601: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        z_free(symbol, bitmap_file_start);
+        strcpy(symbol->errtxt, "601: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
-    fwrite(bitmap_file_start, file_header.file_size, 1, bmp_file);
-    fclose(bmp_file);
+    fm_write(bitmap_file_start, file_header.file_size, 1, fmp);
+    if (!fm_close(fmp, symbol)) {
+        z_free(symbol, bitmap_file_start);
+        strcpy(symbol->errtxt, "603: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
 
-    free(bitmap_file_start);
+    z_free(symbol, bitmap_file_start);
     return 0;
 }
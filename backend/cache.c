@@ -0,0 +1,332 @@
+/* cache.c - least recently used cache of encoded symbols */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+#include "common.h"
+#include "cache.h"
+
+/* Most entries the cache can be set to hold */
+#define CACHE_MAX_ENTRIES   1000000
+
+/* A cached encode, held with its key and results in a single allocation */
+struct cache_entry {
+    struct cache_entry *chain; /* Next entry in same hash bucket */
+    struct cache_entry *newer; /* Neighbours in order of use */
+    struct cache_entry *older;
+    struct cache_key key; /* `key.source` points to copy of data following entry */
+    int results[CACHE_SETTINGS]; /* Settings as left by encoding */
+    int error_number;
+    int rows;
+    int width;
+    unsigned char text[128];
+    char errtxt[100];
+    /* Followed by `rows` row heights, `rows` rows of encoded data, then `key.length` bytes of source data */
+};
+
+static struct cache_entry **buckets; /* `bucket_count` hash chains */
+static int bucket_count; /* Power of 2 */
+static struct cache_entry *newest, *oldest;
+static int max_entries, entry_count;
+static unsigned long hit_count, miss_count;
+
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+static SRWLOCK cache_mutex = SRWLOCK_INIT;
+#define cache_lock()    AcquireSRWLockExclusive(&cache_mutex)
+#define cache_unlock()  ReleaseSRWLockExclusive(&cache_mutex)
+#else
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define cache_lock()    pthread_mutex_lock(&cache_mutex)
+#define cache_unlock()  pthread_mutex_unlock(&cache_mutex)
+#endif
+#else
+#define cache_lock()
+#define cache_unlock()
+#endif /* ZINT_NO_THREADS */
+
+/* The settings that encoding reads, and in some cases adjusts */
+static void cache_settings(const struct zint_symbol *symbol, int settings[CACHE_SETTINGS]) {
+    settings[0] = symbol->symbology;
+    settings[1] = symbol->height;
+    settings[2] = symbol->whitespace_width;
+    settings[3] = symbol->border_width;
+    settings[4] = symbol->output_options;
+    settings[5] = symbol->option_1;
+    settings[6] = symbol->option_2;
+    settings[7] = symbol->option_3;
+    settings[8] = symbol->show_hrt;
+    settings[9] = symbol->fontsize;
+    settings[10] = symbol->input_mode;
+    settings[11] = symbol->eci;
+    settings[12] = symbol->warn_level;
+}
+
+static void cache_restore_settings(struct zint_symbol *symbol, const int settings[CACHE_SETTINGS]) {
+    symbol->symbology = settings[0];
+    symbol->height = settings[1];
+    symbol->whitespace_width = settings[2];
+    symbol->border_width = settings[3];
+    symbol->output_options = settings[4];
+    symbol->option_1 = settings[5];
+    symbol->option_2 = settings[6];
+    symbol->option_3 = settings[7];
+    symbol->show_hrt = settings[8];
+    symbol->fontsize = settings[9];
+    symbol->input_mode = settings[10];
+    symbol->eci = settings[11];
+    symbol->warn_level = settings[12];
+}
+
+/* FNV-1a */
+static unsigned int cache_hash(unsigned int hash, const unsigned char *data, const size_t length) {
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619;
+    }
+    return hash;
+}
+
+/* Set up `key` for encoding `source` with the settings of `symbol`. Returns 0 if the encode can't be cached, i.e.
+   if `symbol` already has rows (which encoding adds to) or debug is set (whose output would be skipped) */
+INTERNAL int cache_key(struct cache_key *key, const struct zint_symbol *symbol, const unsigned char source[],
+            const int length) {
+    unsigned int hash;
+
+    if (symbol->rows || symbol->debug) {
+        return 0;
+    }
+
+    memset(key, 0, sizeof(*key));
+    cache_settings(symbol, key->settings);
+    key->dot_size = symbol->dot_size;
+    memcpy(key->primary, symbol->primary, sizeof(key->primary) - 1); /* Compared up to NUL only */
+    key->source = source;
+    key->length = length;
+
+    hash = cache_hash(2166136261u, (const unsigned char *) key->settings, sizeof(key->settings));
+    hash = cache_hash(hash, (const unsigned char *) key->primary, strlen(key->primary));
+    key->hash = cache_hash(hash, source, length);
+
+    return 1;
+}
+
+static int cache_key_equal(const struct cache_key *a, const struct cache_key *b) {
+    return a->hash == b->hash && a->length == b->length && a->dot_size == b->dot_size
+            && memcmp(a->settings, b->settings, sizeof(a->settings)) == 0
+            && strcmp(a->primary, b->primary) == 0 && memcmp(a->source, b->source, a->length) == 0;
+}
+
+/* Unlink `entry` from the list in order of use */
+static void cache_unlink(struct cache_entry *entry) {
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        oldest = entry->newer;
+    }
+}
+
+/* Make `entry` the most recently used */
+static void cache_link_newest(struct cache_entry *entry) {
+    entry->newer = NULL;
+    entry->older = newest;
+    if (newest) {
+        newest->newer = entry;
+    } else {
+        oldest = entry;
+    }
+    newest = entry;
+}
+
+static struct cache_entry *cache_find(const struct cache_key *key) {
+    struct cache_entry *entry;
+
+    for (entry = buckets[key->hash & (bucket_count - 1)]; entry; entry = entry->chain) {
+        if (cache_key_equal(&entry->key, key)) {
+            break;
+        }
+    }
+    return entry;
+}
+
+/* Remove the least recently used entry */
+static void cache_evict(void) {
+    struct cache_entry *entry = oldest;
+    struct cache_entry **link = &buckets[entry->key.hash & (bucket_count - 1)];
+
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+    cache_unlink(entry);
+    free(entry);
+    entry_count--;
+}
+
+/* If the encode identified by `key` is cached, set `symbol` to its result and return its error number (0 or a
+   warning), else return -1 */
+INTERNAL int cache_get(const struct cache_key *key, struct zint_symbol *symbol) {
+    struct cache_entry *entry;
+    int error_number = -1;
+
+    cache_lock();
+    if (max_entries) {
+        if ((entry = cache_find(key))) {
+            const int *row_height = (const int *) (entry + 1);
+            const unsigned char *encoded_data = (const unsigned char *) (row_height + entry->rows);
+
+            cache_unlink(entry);
+            cache_link_newest(entry);
+
+            cache_restore_settings(symbol, entry->results);
+            symbol->rows = entry->rows;
+            symbol->width = entry->width;
+            memcpy(symbol->text, entry->text, sizeof(symbol->text));
+            strcpy(symbol->errtxt, entry->errtxt);
+            memcpy(symbol->row_height, row_height, sizeof(int) * entry->rows);
+            memcpy(symbol->encoded_data, encoded_data, sizeof(symbol->encoded_data[0]) * entry->rows);
+            error_number = entry->error_number;
+            hit_count++;
+        } else {
+            miss_count++;
+        }
+    }
+    cache_unlock();
+
+    return error_number;
+}
+
+/* Cache the result in `symbol` of the encode identified by `key`, evicting the least recently used entry if full */
+INTERNAL void cache_put(const struct cache_key *key, const struct zint_symbol *symbol, const int error_number) {
+    struct cache_entry *entry;
+    int *row_height;
+    unsigned char *encoded_data;
+    size_t size;
+
+    size = sizeof(struct cache_entry) + (sizeof(int) + sizeof(symbol->encoded_data[0])) * symbol->rows + key->length;
+    if (!(entry = (struct cache_entry *) malloc(size))) {
+        return; /* Not an error, just not cached */
+    }
+    row_height = (int *) (entry + 1);
+    encoded_data = (unsigned char *) (row_height + symbol->rows);
+
+    entry->key = *key;
+    entry->key.source = encoded_data + sizeof(symbol->encoded_data[0]) * symbol->rows;
+    memcpy((unsigned char *) entry->key.source, key->source, key->length);
+    cache_settings(symbol, entry->results);
+    entry->error_number = error_number;
+    entry->rows = symbol->rows;
+    entry->width = symbol->width;
+    memcpy(entry->text, symbol->text, sizeof(entry->text));
+    strcpy(entry->errtxt, symbol->errtxt);
+    memcpy(row_height, symbol->row_height, sizeof(int) * symbol->rows);
+    memcpy(encoded_data, symbol->encoded_data, sizeof(symbol->encoded_data[0]) * symbol->rows);
+
+    cache_lock();
+    /* May have been disabled, or the same encode cached by another thread, in the meantime */
+    if (!max_entries || cache_find(key)) {
+        cache_unlock();
+        free(entry);
+        return;
+    }
+    while (entry_count >= max_entries) {
+        cache_evict();
+    }
+    entry->chain = buckets[key->hash & (bucket_count - 1)];
+    buckets[key->hash & (bucket_count - 1)] = entry;
+    cache_link_newest(entry);
+    entry_count++;
+    cache_unlock();
+}
+
+/* Empty the cache and set the number of entries it may hold, 0 disabling it. Hit and miss counts are reset */
+INTERNAL int cache_size(const int entries) {
+    int error_number = 0;
+
+    if (entries < 0 || entries > CACHE_MAX_ENTRIES) {
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    cache_lock();
+    while (entry_count) {
+        cache_evict();
+    }
+    free(buckets);
+    buckets = NULL;
+    bucket_count = 0;
+    max_entries = 0;
+    hit_count = miss_count = 0;
+
+    if (entries) {
+        /* Aim for load factor of at most 1 */
+        bucket_count = 16;
+        while (bucket_count < entries) {
+            bucket_count <<= 1;
+        }
+        if ((buckets = (struct cache_entry **) calloc(bucket_count, sizeof(struct cache_entry *)))) {
+            max_entries = entries;
+        } else {
+            bucket_count = 0;
+            error_number = ZINT_ERROR_MEMORY;
+        }
+    }
+    cache_unlock();
+
+    return error_number;
+}
+
+/* Return number of lookups found and not found since the cache was last sized, and number of entries it holds */
+INTERNAL void cache_stats(unsigned long *hits, unsigned long *misses, int *entries) {
+    cache_lock();
+    if (hits) {
+        *hits = hit_count;
+    }
+    if (misses) {
+        *misses = miss_count;
+    }
+    if (entries) {
+        *entries = entry_count;
+    }
+    cache_unlock();
+}
@@ -0,0 +1,63 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef __CACHE_H
+#define __CACHE_H
+
+/* Number of `zint_symbol` settings making up a cache key */
+#define CACHE_SETTINGS  13
+
+/* Identifies an encode of `source` with a particular set of symbol settings */
+struct cache_key {
+    int settings[CACHE_SETTINGS];
+    float dot_size;
+    char primary[128];
+    const unsigned char *source;
+    int length;
+    unsigned int hash;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+    INTERNAL int cache_key(struct cache_key *key, const struct zint_symbol *symbol, const unsigned char source[],
+                const int length);
+    INTERNAL int cache_get(const struct cache_key *key, struct zint_symbol *symbol);
+    INTERNAL void cache_put(const struct cache_key *key, const struct zint_symbol *symbol, const int error_number);
+    INTERNAL int cache_size(const int max_entries);
+    INTERNAL void cache_stats(unsigned long *hits, unsigned long *misses, int *entries);
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CACHE_H */
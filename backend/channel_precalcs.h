@@ -29,78 +29,242 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-/* Channel code precalculated values to avoid excessive looping */
+/* Channel Code numbers of characters that can follow each choice of element widths, for `channel_count()` */
 /* To generate uncomment CHANNEL_GENERATE_PRECALCS define and run "./test_channel -f generate -g" */
 /* Paste result below here */
-static channel_precalc channel_precalcs7[] = {
-    {  115338, { 1, 3, 1, 1, 1, 1, 5, 1, }, { 1, 1, 1, 2, 1, 2, 3, 3, }, { 1, 7, 5, 5, 5, 5, 5, }, { 1, 7, 7, 7, 6, 6, 5, }, },
-    {  230676, { 1, 1, 2, 2, 4, 1, 1, 2, }, { 1, 2, 1, 3, 2, 1, 3, 1, }, { 1, 7, 7, 6, 5, 2, 2, }, { 1, 7, 6, 6, 4, 3, 3, }, },
-    {  346014, { 1, 2, 3, 1, 1, 1, 3, 2, }, { 1, 2, 2, 1, 1, 3, 1, 3, }, { 1, 7, 6, 4, 4, 4, 4, }, { 1, 7, 6, 5, 5, 5, 3, }, },
-    {  461352, { 1, 2, 1, 1, 1, 2, 2, 4, }, { 1, 3, 1, 1, 3, 2, 2, 1, }, { 1, 7, 6, 6, 6, 6, 5, }, { 1, 7, 5, 5, 5, 3, 2, }, },
-};
-static channel_precalc channel_precalcs8[] = {
-    {  119121, { 2, 1, 3, 2, 1, 3, 2, 1, }, { 1, 1, 1, 4, 3, 2, 1, 2, }, { 8, 7, 7, 5, 4, 4, 2, }, { 8, 8, 8, 8, 5, 3, 2, }, },
-    {  238242, { 2, 1, 1, 2, 2, 2, 1, 4, }, { 1, 1, 3, 1, 1, 2, 4, 2, }, { 8, 7, 7, 7, 6, 5, 4, }, { 8, 8, 8, 6, 6, 6, 5, }, },
-    {  357363, { 2, 2, 1, 4, 1, 1, 1, 3, }, { 1, 1, 1, 1, 3, 2, 5, 1, }, { 8, 7, 6, 6, 3, 3, 3, }, { 8, 8, 8, 8, 8, 6, 5, }, },
-    {  476484, { 2, 2, 1, 1, 3, 2, 3, 1, }, { 1, 1, 3, 1, 2, 2, 3, 2, }, { 8, 7, 6, 6, 6, 4, 3, }, { 8, 8, 8, 6, 6, 5, 4, }, },
-    {  595605, { 2, 3, 3, 2, 1, 1, 1, 2, }, { 1, 1, 2, 1, 1, 1, 5, 3, }, { 8, 7, 5, 3, 2, 2, 2, }, { 8, 8, 8, 7, 7, 7, 7, }, },
-    {  714726, { 2, 1, 1, 6, 1, 1, 2, 1, }, { 1, 2, 1, 3, 1, 4, 1, 2, }, { 8, 7, 7, 7, 2, 2, 2, }, { 8, 8, 7, 7, 5, 5, 2, }, },
-    {  833847, { 2, 1, 1, 3, 1, 3, 3, 1, }, { 1, 2, 3, 1, 1, 3, 2, 2, }, { 8, 7, 7, 7, 5, 5, 3, }, { 8, 8, 7, 5, 5, 5, 3, }, },
-    {  952968, { 2, 2, 2, 3, 2, 1, 2, 1, }, { 1, 2, 2, 1, 2, 2, 2, 3, }, { 8, 7, 6, 5, 3, 2, 2, }, { 8, 8, 7, 6, 6, 5, 4, }, },
-    { 1072089, { 2, 5, 1, 1, 2, 2, 1, 1, }, { 1, 2, 1, 3, 1, 3, 3, 1, }, { 8, 7, 3, 3, 3, 2, 1, }, { 8, 8, 7, 7, 5, 5, 3, }, },
-    { 1191210, { 2, 2, 1, 2, 1, 1, 3, 3, }, { 1, 3, 1, 1, 5, 1, 1, 2, }, { 8, 7, 6, 6, 5, 5, 5, }, { 8, 8, 6, 6, 6, 2, 2, }, },
-    { 1310331, { 2, 1, 2, 1, 2, 3, 2, 2, }, { 1, 4, 1, 3, 1, 1, 2, 2, }, { 8, 7, 7, 6, 6, 5, 3, }, { 8, 8, 5, 5, 3, 3, 3, }, },
-    { 1429452, { 2, 2, 1, 2, 2, 3, 2, 1, }, { 1, 5, 3, 1, 2, 1, 1, 1, }, { 8, 7, 6, 6, 5, 4, 2, }, { 8, 8, 4, 2, 2, 1, 1, }, },
-    { 1548573, { 3, 1, 1, 2, 5, 1, 1, 1, }, { 1, 1, 2, 2, 1, 2, 5, 1, }, { 8, 6, 6, 6, 5, 1, 1, }, { 8, 8, 8, 7, 6, 6, 5, }, },
-    { 1667694, { 3, 2, 2, 1, 1, 3, 2, 1, }, { 1, 1, 1, 1, 2, 4, 3, 2, }, { 8, 6, 5, 4, 4, 4, 2, }, { 8, 8, 8, 8, 8, 7, 4, }, },
-    { 1786815, { 3, 4, 2, 1, 2, 1, 1, 1, }, { 1, 1, 2, 1, 1, 2, 1, 6, }, { 8, 6, 3, 2, 2, 1, 1, }, { 8, 8, 8, 7, 7, 7, 6, }, },
-    { 1905936, { 3, 2, 1, 3, 1, 3, 1, 1, }, { 1, 2, 1, 1, 1, 4, 2, 3, }, { 8, 6, 5, 5, 3, 3, 1, }, { 8, 8, 7, 7, 7, 7, 4, }, },
-    { 2025057, { 3, 1, 2, 2, 1, 1, 4, 1, }, { 1, 3, 2, 1, 1, 1, 5, 1, }, { 8, 6, 6, 5, 4, 4, 4, }, { 8, 8, 6, 5, 5, 5, 5, }, },
-    { 2144178, { 3, 1, 2, 1, 2, 2, 2, 2, }, { 1, 5, 1, 1, 4, 1, 1, 1, }, { 8, 6, 6, 5, 5, 4, 3, }, { 8, 8, 4, 4, 4, 1, 1, }, },
-    { 2263299, { 4, 2, 1, 2, 1, 1, 1, 3, }, { 1, 1, 1, 1, 3, 3, 3, 2, }, { 8, 5, 4, 4, 3, 3, 3, }, { 8, 8, 8, 8, 8, 6, 4, }, },
-    { 2382420, { 4, 2, 1, 1, 1, 1, 4, 1, }, { 1, 2, 2, 2, 2, 2, 2, 2, }, { 8, 5, 4, 4, 4, 4, 4, }, { 8, 8, 7, 6, 5, 4, 3, }, },
-    { 2501541, { 5, 1, 1, 2, 2, 1, 1, 2, }, { 1, 1, 2, 3, 3, 1, 1, 3, }, { 8, 4, 4, 4, 3, 2, 2, }, { 8, 8, 8, 7, 5, 3, 3, }, },
-    { 2620662, { 6, 1, 1, 1, 2, 1, 1, 2, }, { 1, 2, 4, 1, 2, 3, 1, 1, }, { 8, 3, 3, 3, 3, 2, 2, }, { 8, 8, 7, 4, 4, 3, 1, }, },
-    { 2739783, { 1, 1, 1, 1, 3, 3, 4, 1, }, { 2, 1, 2, 1, 6, 1, 1, 1, }, { 8, 8, 8, 8, 8, 6, 4, }, { 8, 7, 7, 6, 6, 1, 1, }, },
-    { 2858904, { 1, 1, 2, 3, 3, 1, 3, 1, }, { 2, 1, 3, 1, 3, 1, 2, 2, }, { 8, 8, 8, 7, 5, 3, 3, }, { 8, 7, 7, 5, 5, 3, 3, }, },
-    { 2978025, { 1, 2, 2, 4, 1, 2, 1, 2, }, { 2, 1, 1, 1, 1, 3, 4, 2, }, { 8, 8, 7, 6, 3, 3, 2, }, { 8, 7, 7, 7, 7, 7, 5, }, },
-    { 3097146, { 1, 2, 2, 1, 3, 3, 2, 1, }, { 2, 1, 3, 3, 2, 2, 1, 1, }, { 8, 8, 7, 6, 6, 4, 2, }, { 8, 7, 7, 5, 3, 2, 1, }, },
-    { 3216267, { 1, 3, 1, 1, 1, 3, 1, 4, }, { 2, 1, 3, 2, 3, 2, 1, 1, }, { 8, 8, 6, 6, 6, 6, 4, }, { 8, 7, 7, 5, 4, 2, 1, }, },
-    { 3335388, { 1, 1, 1, 4, 4, 1, 2, 1, }, { 2, 2, 1, 1, 1, 1, 3, 4, }, { 8, 8, 8, 8, 5, 2, 2, }, { 8, 7, 6, 6, 6, 6, 6, }, },
-    { 3454509, { 1, 1, 2, 4, 3, 1, 2, 1, }, { 2, 2, 2, 5, 1, 1, 1, 1, }, { 8, 8, 8, 7, 4, 2, 2, }, { 8, 7, 6, 5, 1, 1, 1, }, },
-    { 3573630, { 1, 2, 1, 3, 1, 2, 3, 2, }, { 2, 2, 2, 1, 1, 4, 2, 1, }, { 8, 8, 7, 7, 5, 5, 4, }, { 8, 7, 6, 5, 5, 5, 2, }, },
-    { 3692751, { 1, 4, 2, 3, 2, 1, 1, 1, }, { 2, 2, 1, 1, 2, 1, 2, 4, }, { 8, 8, 5, 4, 2, 1, 1, }, { 8, 7, 6, 6, 6, 5, 5, }, },
-    { 3811872, { 1, 1, 2, 1, 3, 5, 1, 1, }, { 2, 3, 3, 2, 2, 1, 1, 1, }, { 8, 8, 8, 7, 7, 5, 1, }, { 8, 7, 5, 3, 2, 1, 1, }, },
-    { 3930993, { 1, 1, 1, 1, 6, 2, 2, 1, }, { 2, 4, 1, 2, 1, 3, 1, 1, }, { 8, 8, 8, 8, 8, 3, 2, }, { 8, 7, 4, 4, 3, 3, 1, }, },
-    { 4050114, { 1, 3, 3, 2, 2, 1, 2, 1, }, { 2, 6, 2, 1, 1, 1, 1, 1, }, { 8, 8, 6, 4, 3, 2, 2, }, { 8, 7, 2, 1, 1, 1, 1, }, },
-    { 4169235, { 2, 1, 2, 2, 4, 2, 1, 1, }, { 2, 1, 2, 1, 1, 1, 4, 3, }, { 8, 7, 7, 6, 5, 2, 1, }, { 8, 7, 7, 6, 6, 6, 6, }, },
-    { 4288356, { 2, 2, 2, 1, 1, 3, 3, 1, }, { 2, 1, 1, 4, 2, 1, 1, 3, }, { 8, 7, 6, 5, 5, 5, 3, }, { 8, 7, 7, 7, 4, 3, 3, }, },
-    { 4407477, { 2, 3, 3, 1, 2, 1, 1, 2, }, { 2, 1, 3, 2, 4, 1, 1, 1, }, { 8, 7, 5, 3, 3, 2, 2, }, { 8, 7, 7, 5, 4, 1, 1, }, },
-    { 4526598, { 2, 1, 4, 1, 4, 1, 1, 1, }, { 2, 2, 2, 1, 2, 3, 1, 2, }, { 8, 7, 7, 4, 4, 1, 1, }, { 8, 7, 6, 5, 5, 4, 2, }, },
-    { 4645719, { 2, 4, 2, 1, 1, 2, 1, 2, }, { 2, 2, 1, 1, 3, 2, 3, 1, }, { 8, 7, 4, 3, 3, 3, 2, }, { 8, 7, 6, 6, 6, 4, 3, }, },
-    { 4764840, { 2, 1, 1, 1, 2, 4, 1, 3, }, { 2, 4, 1, 2, 1, 3, 1, 1, }, { 8, 7, 7, 7, 7, 6, 3, }, { 8, 7, 4, 4, 3, 3, 1, }, },
-    { 4883961, { 3, 1, 1, 3, 2, 2, 1, 2, }, { 2, 1, 2, 2, 2, 1, 2, 3, }, { 8, 6, 6, 6, 4, 3, 2, }, { 8, 7, 7, 6, 5, 4, 4, }, },
-    { 5003082, { 3, 3, 3, 1, 1, 1, 2, 1, }, { 2, 1, 2, 1, 1, 3, 1, 4, }, { 8, 6, 4, 2, 2, 2, 2, }, { 8, 7, 7, 6, 6, 6, 4, }, },
-    { 5122203, { 3, 1, 1, 2, 1, 2, 1, 4, }, { 2, 3, 1, 1, 1, 2, 4, 1, }, { 8, 6, 6, 6, 5, 5, 4, }, { 8, 7, 5, 5, 5, 5, 4, }, },
-    { 5241324, { 4, 1, 1, 3, 1, 2, 2, 1, }, { 2, 1, 3, 1, 1, 3, 3, 1, }, { 8, 5, 5, 5, 3, 3, 2, }, { 8, 7, 7, 5, 5, 5, 3, }, },
-    { 5360445, { 4, 3, 1, 1, 2, 1, 1, 2, }, { 2, 4, 1, 3, 2, 1, 1, 1, }, { 8, 5, 3, 3, 3, 2, 2, }, { 8, 7, 4, 4, 2, 1, 1, }, },
-    { 5479566, { 1, 1, 3, 1, 3, 2, 1, 3, }, { 3, 1, 1, 2, 1, 2, 1, 4, }, { 8, 8, 8, 6, 6, 4, 3, }, { 8, 6, 6, 6, 5, 5, 4, }, },
-    { 5598687, { 1, 2, 1, 1, 5, 1, 3, 1, }, { 3, 1, 1, 1, 1, 3, 1, 4, }, { 8, 8, 7, 7, 7, 3, 3, }, { 8, 6, 6, 6, 6, 6, 4, }, },
-    { 5717808, { 1, 3, 1, 2, 1, 3, 1, 3, }, { 3, 1, 1, 2, 4, 1, 1, 2, }, { 8, 8, 6, 6, 5, 5, 3, }, { 8, 6, 6, 6, 5, 2, 2, }, },
-    { 5836929, { 1, 1, 2, 3, 1, 2, 3, 2, }, { 3, 2, 1, 1, 1, 1, 2, 4, }, { 8, 8, 8, 7, 5, 5, 4, }, { 8, 6, 5, 5, 5, 5, 5, }, },
-    { 5956050, { 1, 2, 3, 3, 2, 2, 1, 1, }, { 3, 2, 3, 1, 1, 1, 1, 3, }, { 8, 8, 7, 5, 3, 2, 1, }, { 8, 6, 5, 3, 3, 3, 3, }, },
-    { 6075171, { 1, 3, 1, 1, 3, 3, 2, 1, }, { 3, 3, 1, 1, 3, 1, 2, 1, }, { 8, 8, 6, 6, 6, 4, 2, }, { 8, 6, 4, 4, 4, 2, 2, }, },
-    { 6194292, { 2, 1, 1, 3, 4, 1, 2, 1, }, { 3, 1, 2, 1, 3, 1, 3, 1, }, { 8, 7, 7, 7, 5, 2, 2, }, { 8, 6, 6, 5, 5, 3, 3, }, },
-    { 6313413, { 2, 3, 2, 2, 1, 2, 2, 1, }, { 3, 1, 1, 2, 1, 3, 2, 2, }, { 8, 7, 5, 4, 3, 3, 2, }, { 8, 6, 6, 6, 5, 5, 3, }, },
-    { 6432534, { 2, 3, 1, 1, 2, 2, 3, 1, }, { 3, 2, 1, 2, 3, 1, 2, 1, }, { 8, 7, 5, 5, 5, 4, 3, }, { 8, 6, 5, 5, 4, 2, 2, }, },
-    { 6551655, { 3, 1, 1, 2, 1, 4, 1, 2, }, { 3, 1, 2, 3, 1, 1, 3, 1, }, { 8, 6, 6, 6, 5, 5, 2, }, { 8, 6, 6, 5, 3, 3, 3, }, },
-    { 6670776, { 3, 1, 1, 1, 1, 3, 4, 1, }, { 3, 3, 1, 2, 1, 1, 3, 1, }, { 8, 6, 6, 6, 6, 6, 4, }, { 8, 6, 4, 4, 3, 3, 3, }, },
-    { 6789897, { 5, 2, 1, 1, 2, 1, 2, 1, }, { 3, 1, 1, 1, 2, 2, 3, 2, }, { 8, 4, 3, 3, 3, 2, 2, }, { 8, 6, 6, 6, 6, 5, 4, }, },
-    { 6909018, { 1, 2, 2, 2, 2, 1, 4, 1, }, { 4, 1, 1, 2, 1, 2, 1, 3, }, { 8, 8, 7, 6, 5, 4, 4, }, { 8, 5, 5, 5, 4, 4, 3, }, },
-    { 7028139, { 1, 1, 3, 2, 2, 2, 1, 3, }, { 4, 2, 2, 1, 2, 2, 1, 1, }, { 8, 8, 8, 6, 5, 4, 3, }, { 8, 5, 4, 3, 3, 2, 1, }, },
-    { 7147260, { 2, 1, 4, 3, 2, 1, 1, 1, }, { 4, 1, 1, 1, 4, 1, 1, 2, }, { 8, 7, 7, 4, 2, 1, 1, }, { 8, 5, 5, 5, 5, 2, 2, }, },
-    { 7266381, { 2, 4, 1, 3, 2, 1, 1, 1, }, { 4, 2, 1, 1, 1, 2, 1, 3, }, { 8, 7, 4, 4, 2, 1, 1, }, { 8, 5, 4, 4, 4, 4, 3, }, },
-    { 7385502, { 4, 2, 1, 3, 1, 2, 1, 1, }, { 4, 1, 1, 4, 2, 1, 1, 1, }, { 8, 5, 4, 4, 2, 2, 1, }, { 8, 5, 5, 5, 2, 1, 1, }, },
-    { 7504623, { 1, 1, 3, 4, 3, 1, 1, 1, }, { 5, 2, 1, 1, 1, 1, 1, 3, }, { 8, 8, 8, 6, 3, 1, 1, }, { 8, 4, 3, 3, 3, 3, 3, }, },
-    { 7623744, { 3, 1, 1, 2, 2, 1, 2, 3, }, { 5, 2, 1, 1, 1, 2, 1, 2, }, { 8, 6, 6, 6, 5, 4, 4, }, { 8, 4, 3, 3, 3, 3, 2, }, },
+static const unsigned int channel_counts[13][8][8][5] = {
+    { /* B[0] */
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 1, 0, 0, 0, 0, }, { 18, 3, 3, 3, 3, },
+          { 96, 28, 28, 28, 28, }, { 330, 124, 124, 124, 124, }, { 893, 391, 391, 391, 391, }, { 2072, 1008, 1008, 1008, 1008, }, },
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 28, 2, 2, 2, 2, }, { 228, 49, 49, 49, 49, },
+          { 960, 302, 302, 302, 302, }, { 2946, 1142, 1142, 1142, 1142, }, { 7466, 3317, 3317, 3317, 3317, }, { 16610, 8138, 8138, 8138, 8138, }, },
+        { { 0, 0, 0, 0, 0, }, { 12, 0, 0, 0, 0, }, { 223, 28, 28, 28, 28, }, { 1302, 314, 314, 314, 314, },
+          { 4809, 1578, 1578, 1578, 1578, }, { 13782, 5445, 5445, 5445, 5445, }, { 33521, 15033, 15033, 15033, 15033, }, { 72596, 35737, 35737, 35737, 35737, }, },
+        { { 1, 0, 0, 0, 0, }, { 96, 4, 4, 4, 4, }, { 996, 154, 154, 154, 154, }, { 4900, 1258, 1258, 1258, 1258, },
+          { 16738, 5636, 5636, 5636, 5636, }, { 45934, 18373, 18373, 18373, 18373, }, { 108758, 49083, 49083, 49083, 49083, }, { 231350, 114261, 114261, 114261, 114261, }, },
+        { { 13, 0, 0, 0, 0, }, { 402, 26, 26, 26, 26, }, { 3207, 551, 551, 551, 551, }, { 14272, 3806, 3806, 3806, 3806, },
+          { 46372, 15881, 15881, 15881, 15881, }, { 123622, 49866, 49866, 49866, 49866, }, { 287357, 130261, 130261, 130261, 130261, }, { 603692, 298856, 298856, 298856, 298856, }, },
+        { { 61, 0, 0, 0, 0, }, { 1218, 96, 96, 96, 96, }, { 8382, 1533, 1533, 1533, 1533, }, { 34978, 9564, 9564, 9564, 9564, },
+          { 109846, 38063, 38063, 38063, 38063, }, { 286942, 116444, 116444, 116444, 116444, }, { 658274, 299363, 299363, 299363, 299363, }, { 1370534, 679654, 679654, 679654, 679654, }, },
+        { { 192, 0, 0, 0, 0, }, { 3026, 267, 267, 267, 267, }, { 18965, 3613, 3613, 3613, 3613, }, { 75728, 21071, 21071, 21071, 21071, },
+          { 232115, 81117, 81117, 81117, 81117, }, { 597410, 243517, 243517, 243517, 243517, }, { 1357253, 618731, 618731, 618731, 618731, }, { 2806904, 1393785, 1393785, 1393785, 1393785, }, },
+        { { 483, 0, 0, 0, 0, }, { 6566, 623, 623, 623, 623, }, { 38606, 7567, 7567, 7567, 7567, }, { 149342, 42087, 42087, 42087, 42087, },
+          { 449594, 158123, 158123, 158123, 158123, }, { 1144298, 468025, 468025, 468025, 468025, }, { 2580554, 1178589, 1178589, 1178589, 1178589, }, { 5309402, 2639105, 2639105, 2639105, 2639105, }, },
+    },
+    { /* S[1] */
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 3, 1, 0, 0, 0, }, { 25, 15, 6, 6, 6, },
+          { 96, 68, 34, 34, 34, }, { 267, 206, 115, 115, 115, }, { 617, 502, 301, 301, 301, }, { 1261, 1064, 672, 672, 672, }, },
+        { { 0, 0, 0, 0, 0, }, { 2, 0, 0, 0, 0, }, { 47, 26, 9, 9, 9, }, { 253, 179, 88, 88, 88, },
+          { 840, 658, 371, 371, 371, }, { 2175, 1804, 1103, 1103, 1103, }, { 4821, 4149, 2683, 2683, 2683, }, { 9593, 8472, 5714, 5714, 5714, }, },
+        { { 0, 0, 0, 0, 0, }, { 28, 12, 3, 3, 3, }, { 286, 195, 90, 90, 90, }, { 1264, 988, 551, 551, 551, },
+          { 3867, 3231, 1986, 1986, 1986, }, { 9588, 8337, 5457, 5457, 5457, }, { 20704, 18488, 12663, 12663, 12663, }, { 40500, 36859, 26143, 26143, 26143, }, },
+        { { 4, 1, 0, 0, 0, }, { 150, 92, 37, 37, 37, }, { 1104, 842, 451, 451, 451, }, { 4378, 3642, 2215, 2215, 2215, },
+          { 12737, 11102, 7274, 7274, 7274, }, { 30710, 27561, 19001, 19001, 19001, }, { 65178, 59675, 42729, 42729, 42729, }, { 126046, 117089, 86367, 86367, 86367, }, },
+        { { 26, 13, 4, 4, 4, }, { 525, 376, 185, 185, 185, }, { 3255, 2656, 1565, 1565, 1565, }, { 12075, 10466, 6780, 6780, 6780, },
+          { 33985, 30491, 20975, 20975, 20975, }, { 80395, 73756, 52949, 52949, 52949, }, { 168595, 157096, 116499, 116499, 116499, }, { 323435, 304836, 231974, 231974, 231974, }, },
+        { { 96, 61, 26, 26, 26, }, { 1437, 1122, 621, 621, 621, }, { 8031, 6849, 4317, 4317, 4317, }, { 28499, 25414, 17274, 17274, 17274, },
+          { 78381, 71783, 51308, 51308, 51308, }, { 182919, 170498, 126425, 126425, 126425, }, { 380291, 358911, 273803, 273803, 273803, }, { 725307, 690880, 539236, 539236, 539236, }, },
+        { { 267, 192, 96, 96, 96, }, { 3346, 2759, 1653, 1653, 1653, }, { 17458, 15352, 10179, 10179, 10179, }, { 60046, 54657, 38585, 38585, 38585, },
+          { 162400, 150998, 111315, 111315, 111315, }, { 375214, 353893, 269445, 269445, 269445, }, { 775054, 738522, 576689, 576689, 576689, }, { 1471750, 1413119, 1126329, 1126329, 1126329, }, },
+        { { 623, 483, 267, 267, 267, }, { 6944, 5943, 3773, 3773, 3773, }, { 34520, 31039, 21413, 21413, 21413, }, { 116036, 107255, 78077, 78077, 78077, },
+          { 309902, 291471, 220415, 220415, 220415, }, { 710564, 676273, 526361, 526361, 526361, }, { 1460516, 1401965, 1116353, 1116353, 1116353, }, { 2764028, 2670297, 2166269, 2166269, 2166269, }, },
+    },
+    { /* B[1] */
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 3, 3, 1, 0, 0, }, { 25, 25, 15, 6, 6, },
+          { 96, 96, 68, 34, 34, }, { 267, 267, 206, 115, 115, }, { 617, 617, 502, 301, 301, }, { 1261, 1261, 1064, 672, 672, }, },
+        { { 0, 0, 0, 0, 0, }, { 2, 2, 0, 0, 0, }, { 44, 44, 23, 6, 6, }, { 228, 228, 154, 63, 63, },
+          { 744, 744, 562, 275, 275, }, { 1908, 1908, 1537, 836, 836, }, { 4204, 4204, 3532, 2066, 2066, }, { 8332, 8332, 7211, 4453, 4453, }, },
+        { { 0, 0, 0, 0, 0, }, { 26, 26, 10, 1, 1, }, { 239, 239, 148, 43, 43, }, { 1011, 1011, 735, 298, 298, },
+          { 3027, 3027, 2391, 1146, 1146, }, { 7413, 7413, 6162, 3282, 3282, }, { 15883, 15883, 13667, 7842, 7842, }, { 30907, 30907, 27266, 16550, 16550, }, },
+        { { 4, 4, 1, 0, 0, }, { 122, 122, 64, 9, 9, }, { 818, 818, 556, 165, 165, }, { 3114, 3114, 2378, 951, 951, },
+          { 8870, 8870, 7235, 3407, 3407, }, { 21122, 21122, 17973, 9413, 9413, }, { 44474, 44474, 38971, 22025, 22025, }, { 85546, 85546, 76589, 45867, 45867, }, },
+        { { 22, 22, 9, 0, 0, }, { 375, 375, 226, 35, 35, }, { 2151, 2151, 1552, 461, 461, }, { 7697, 7697, 6088, 2402, 2402, },
+          { 21248, 21248, 17754, 8238, 8238, }, { 49685, 49685, 43046, 22239, 22239, }, { 103417, 103417, 91918, 51321, 51321, }, { 197389, 197389, 178790, 105928, 105928, }, },
+        { { 70, 70, 35, 0, 0, }, { 912, 912, 597, 96, 96, }, { 4776, 4776, 3594, 1062, 1062, }, { 16424, 16424, 13339, 5199, 5199, },
+          { 44396, 44396, 37798, 17323, 17323, }, { 102524, 102524, 90103, 46030, 46030, }, { 211696, 211696, 190316, 105208, 105208, }, { 401872, 401872, 367445, 215801, 215801, }, },
+        { { 171, 171, 96, 0, 0, }, { 1909, 1909, 1322, 216, 216, }, { 9427, 9427, 7321, 2148, 2148, }, { 31547, 31547, 26158, 10086, 10086, },
+          { 84019, 84019, 72617, 32934, 32934, }, { 192295, 192295, 170974, 86526, 86526, }, { 394763, 394763, 358231, 196398, 196398, }, { 746443, 746443, 687812, 401022, 401022, }, },
+        { { 356, 356, 216, 0, 0, }, { 3598, 3598, 2597, 427, 427, }, { 17062, 17062, 13581, 3955, 3955, }, { 55990, 55990, 47209, 18031, 18031, },
+          { 147502, 147502, 129071, 58015, 58015, }, { 335350, 335350, 301059, 151147, 151147, }, { 685462, 685462, 626911, 341299, 341299, }, { 1292278, 1292278, 1198547, 694519, 694519, }, },
+    },
+    { /* S[2] */
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 6, 3, 3, 1, 1, }, { 28, 19, 19, 9, 9, },
+          { 81, 62, 62, 34, 34, }, { 186, 152, 152, 91, 91, }, { 371, 316, 316, 201, 201, }, { 672, 589, 589, 392, 392, }, },
+        { { 0, 0, 0, 0, 0, }, { 6, 2, 2, 0, 0, }, { 57, 38, 38, 17, 17, }, { 212, 165, 165, 91, 91, },
+          { 561, 469, 469, 287, 287, }, { 1230, 1072, 1072, 701, 701, }, { 2387, 2138, 2138, 1466, 1466, }, { 4248, 3879, 3879, 2758, 2758, }, },
+        { { 1, 0, 0, 0, 0, }, { 42, 25, 25, 9, 9, }, { 255, 196, 196, 105, 105, }, { 848, 713, 713, 437, 437, },
+          { 2136, 1881, 1881, 1245, 1245, }, { 4560, 4131, 4131, 2880, 2880, }, { 8708, 8041, 8041, 5825, 5825, }, { 15336, 14357, 14357, 10716, 10716, }, },
+        { { 9, 4, 4, 1, 1, }, { 156, 113, 113, 55, 55, }, { 786, 653, 653, 391, 391, }, { 2456, 2163, 2163, 1427, 1427, },
+          { 6006, 5463, 5463, 3828, 3828, }, { 12612, 11709, 11709, 8560, 8560, }, { 23842, 22449, 22449, 16946, 16946, }, { 41712, 39679, 39679, 30722, 30722, }, },
+        { { 35, 22, 22, 9, 9, }, { 426, 340, 340, 191, 191, }, { 1941, 1690, 1690, 1091, 1091, }, { 5836, 5295, 5295, 3686, 3686, },
+          { 14001, 13010, 13010, 9516, 9516, }, { 29082, 27446, 27446, 20807, 20807, }, { 54607, 52096, 52096, 40597, 40597, }, { 95112, 91461, 91461, 72862, 72862, }, },
+        { { 96, 70, 70, 35, 35, }, { 966, 816, 816, 501, 501, }, { 4137, 3714, 3714, 2532, 2532, }, { 12124, 11225, 11225, 8140, 8140, },
+          { 28707, 27073, 27073, 20475, 20475, }, { 59178, 56494, 56494, 44073, 44073, }, { 110593, 106488, 106488, 85108, 85108, }, { 192024, 186071, 186071, 151644, 151644, }, },
+        { { 216, 171, 171, 96, 96, }, { 1932, 1693, 1693, 1106, 1106, }, { 7938, 7279, 7279, 5173, 5173, }, { 22848, 21461, 21461, 16072, 16072, },
+          { 53592, 51085, 51085, 39683, 39683, }, { 109872, 105769, 105769, 84448, 84448, }, { 204624, 198365, 198365, 161833, 161833, }, { 354480, 345421, 345421, 286790, 286790, }, },
+        { { 427, 356, 356, 216, 216, }, { 3528, 3171, 3171, 2170, 2170, }, { 14076, 13107, 13107, 9626, 9626, }, { 39984, 37959, 37959, 29178, 29178, },
+          { 93132, 89487, 89487, 71056, 71056, }, { 190152, 184203, 184203, 149912, 149912, }, { 353220, 344163, 344163, 285612, 285612, }, { 610848, 597759, 597759, 504028, 504028, }, },
+    },
+    { /* B[2] */
+        { { 0, 0, 0, 0, 0, }, { 0, 0, 0, 0, 0, }, { 6, 6, 3, 3, 1, }, { 28, 28, 19, 19, 9, },
+          { 81, 81, 62, 62, 34, }, { 186, 186, 152, 152, 91, }, { 371, 371, 316, 316, 201, }, { 672, 672, 589, 589, 392, }, },
+        { { 0, 0, 0, 0, 0, }, { 6, 6, 2, 2, 0, }, { 51, 51, 32, 32, 11, }, { 184, 184, 137, 137, 63, },
+          { 480, 480, 388, 388, 206, }, { 1044, 1044, 886, 886, 515, }, { 2016, 2016, 1767, 1767, 1095, }, { 3576, 3576, 3207, 3207, 2086, }, },
+        { { 1, 1, 0, 0, 0, }, { 36, 36, 19, 19, 3, }, { 198, 198, 139, 139, 48, }, { 636, 636, 501, 501, 225, },
+          { 1575, 1575, 1320, 1320, 684, }, { 3330, 3330, 2901, 2901, 1650, }, { 6321, 6321, 5654, 5654, 3438, }, { 11088, 11088, 10109, 10109, 6468, }, },
+        { { 8, 8, 3, 3, 0, }, { 114, 114, 71, 71, 13, }, { 531, 531, 398, 398, 136, }, { 1608, 1608, 1315, 1315, 579, },
+          { 3870, 3870, 3327, 3327, 1692, }, { 8052, 8052, 7149, 7149, 4000, }, { 15134, 15134, 13741, 13741, 8238, }, { 26376, 26376, 24343, 24343, 15386, }, },
+        { { 26, 26, 13, 13, 0, }, { 270, 270, 184, 184, 35, }, { 1155, 1155, 904, 904, 305, }, { 3380, 3380, 2839, 2839, 1230, },
+          { 7995, 7995, 7004, 7004, 3510, }, { 16470, 16470, 14834, 14834, 8195, }, { 30765, 30765, 28254, 28254, 16755, }, { 53400, 53400, 49749, 49749, 31150, }, },
+        { { 61, 61, 35, 35, 0, }, { 540, 540, 390, 390, 75, }, { 2196, 2196, 1773, 1773, 591, }, { 6288, 6288, 5389, 5389, 2304, },
+          { 14706, 14706, 13072, 13072, 6474, }, { 30096, 30096, 27412, 27412, 14991, }, { 55986, 55986, 51881, 51881, 30501, }, { 96912, 96912, 90959, 90959, 56532, }, },
+        { { 120, 120, 75, 75, 0, }, { 966, 966, 727, 727, 140, }, { 3801, 3801, 3142, 3142, 1036, }, { 10724, 10724, 9337, 9337, 3948, },
+          { 24885, 24885, 22378, 22378, 10976, }, { 50694, 50694, 46591, 46591, 25270, }, { 94031, 94031, 87772, 87772, 51240, }, { 162456, 162456, 153397, 153397, 94766, }, },
+        { { 211, 211, 140, 140, 0, }, { 1596, 1596, 1239, 1239, 238, }, { 6138, 6138, 5169, 5169, 1688, }, { 17136, 17136, 15111, 15111, 6330, },
+          { 39540, 39540, 35895, 35895, 17464, }, { 80280, 80280, 74331, 74331, 40040, }, { 148596, 148596, 139539, 139539, 80988, }, { 256368, 256368, 243279, 243279, 149548, }, },
+    },
+    { /* S[3] */
+        { { 0, 0, 0, 0, 0, }, { 1, 0, 0, 0, 0, }, { 8, 5, 5, 2, 2, }, { 25, 19, 19, 10, 10, },
+          { 57, 47, 47, 28, 28, }, { 110, 95, 95, 61, 61, }, { 191, 170, 170, 115, 115, }, { 308, 280, 280, 197, 197, }, },
+        { { 0, 0, 0, 0, 0, }, { 11, 6, 6, 2, 2, }, { 52, 40, 40, 21, 21, }, { 143, 121, 121, 74, 74, },
+          { 309, 274, 274, 182, 182, }, { 580, 529, 529, 371, 371, }, { 991, 921, 921, 672, 672, }, { 1582, 1490, 1490, 1121, 1121, }, },
+        { { 3, 1, 1, 0, 0, }, { 45, 33, 33, 16, 16, }, { 177, 150, 150, 91, 91, }, { 459, 411, 411, 276, 276, },
+          { 966, 891, 891, 636, 636, }, { 1788, 1680, 1680, 1251, 1251, }, { 3030, 2883, 2883, 2216, 2216, }, { 4812, 4620, 4620, 3641, 3641, }, },
+        { { 13, 8, 8, 3, 3, }, { 123, 101, 101, 58, 58, }, { 443, 395, 395, 262, 262, }, { 1113, 1029, 1029, 736, 736, },
+          { 2308, 2178, 2178, 1635, 1635, }, { 4238, 4052, 4052, 3149, 3149, }, { 7148, 6896, 6896, 5503, 5503, }, { 11318, 10990, 10990, 8957, 8957, }, },
+        { { 35, 26, 26, 13, 13, }, { 270, 235, 235, 149, 149, }, { 925, 850, 850, 599, 599, }, { 2280, 2150, 2150, 1609, 1609, },
+          { 4685, 4485, 4485, 3494, 3494, }, { 8560, 8275, 8275, 6639, 6639, }, { 14395, 14010, 14010, 11499, 11499, }, { 22750, 22250, 22250, 18599, 18599, }, },
+        { { 75, 61, 61, 35, 35, }, { 516, 465, 465, 315, 315, }, { 1713, 1605, 1605, 1182, 1182, }, { 4170, 3984, 3984, 3085, 3085, },
+          { 8517, 8232, 8232, 6598, 6598, }, { 15510, 15105, 15105, 12421, 12421, }, { 26031, 25485, 25485, 21380, 21380, }, { 41088, 40380, 40380, 34427, 34427, }, },
+        { { 140, 120, 120, 75, 75, }, { 896, 826, 826, 587, 587, }, { 2912, 2765, 2765, 2106, 2106, }, { 7028, 6776, 6776, 5389, 5389, },
+          { 14294, 13909, 13909, 11402, 11402, }, { 25970, 25424, 25424, 21321, 21321, }, { 43526, 42791, 42791, 36532, 36532, }, { 68642, 67690, 67690, 58631, 58631, }, },
+        { { 238, 211, 211, 140, 140, }, { 1450, 1358, 1358, 1001, 1001, }, { 4642, 4450, 4450, 3481, 3481, }, { 11134, 10806, 10806, 8781, 8781, },
+          { 22576, 22076, 22076, 18431, 18431, }, { 40948, 40240, 40240, 34291, 34291, }, { 68560, 67608, 67608, 58551, 58551, }, { 108052, 106820, 106820, 93731, 93731, }, },
+    },
+    { /* B[3] */
+        { { 0, 0, 0, 0, 0, }, { 1, 1, 0, 0, 0, }, { 8, 8, 5, 5, 2, }, { 25, 25, 19, 19, 10, },
+          { 57, 57, 47, 47, 28, }, { 110, 110, 95, 95, 61, }, { 191, 191, 170, 170, 115, }, { 308, 308, 280, 280, 197, }, },
+        { { 0, 0, 0, 0, 0, }, { 10, 10, 5, 5, 1, }, { 44, 44, 32, 32, 13, }, { 118, 118, 96, 96, 49, },
+          { 252, 252, 217, 217, 125, }, { 470, 470, 419, 419, 261, }, { 800, 800, 730, 730, 481, }, { 1274, 1274, 1182, 1182, 813, }, },
+        { { 3, 3, 1, 1, 0, }, { 34, 34, 22, 22, 5, }, { 125, 125, 98, 98, 39, }, { 316, 316, 268, 268, 133, },
+          { 657, 657, 582, 582, 327, }, { 1208, 1208, 1100, 1100, 671, }, { 2039, 2039, 1892, 1892, 1225, }, { 3230, 3230, 3038, 3038, 2059, }, },
+        { { 10, 10, 5, 5, 0, }, { 78, 78, 56, 56, 13, }, { 266, 266, 218, 218, 85, }, { 654, 654, 570, 570, 277, },
+          { 1342, 1342, 1212, 1212, 669, }, { 2450, 2450, 2264, 2264, 1361, }, { 4118, 4118, 3866, 3866, 2473, }, { 6506, 6506, 6178, 6178, 4145, }, },
+        { { 22, 22, 13, 13, 0, }, { 147, 147, 112, 112, 26, }, { 482, 482, 407, 407, 156, }, { 1167, 1167, 1037, 1037, 496, },
+          { 2377, 2377, 2177, 2177, 1186, }, { 4322, 4322, 4037, 4037, 2401, }, { 7247, 7247, 6862, 6862, 4351, }, { 11432, 11432, 10932, 10932, 7281, }, },
+        { { 40, 40, 26, 26, 0, }, { 246, 246, 195, 195, 45, }, { 788, 788, 680, 680, 257, }, { 1890, 1890, 1704, 1704, 805, },
+          { 3832, 3832, 3547, 3547, 1913, }, { 6950, 6950, 6545, 6545, 3861, }, { 11636, 11636, 11090, 11090, 6985, }, { 18338, 18338, 17630, 17630, 11677, }, },
+        { { 65, 65, 45, 45, 0, }, { 380, 380, 310, 310, 71, }, { 1199, 1199, 1052, 1052, 393, }, { 2858, 2858, 2606, 2606, 1219, },
+          { 5777, 5777, 5392, 5392, 2885, }, { 10460, 10460, 9914, 9914, 5811, }, { 17495, 17495, 16760, 16760, 10501, }, { 27554, 27554, 26602, 26602, 17543, }, },
+        { { 98, 98, 71, 71, 0, }, { 554, 554, 462, 462, 105, }, { 1730, 1730, 1538, 1538, 569, }, { 4106, 4106, 3778, 3778, 1753, },
+          { 8282, 8282, 7782, 7782, 4137, }, { 14978, 14978, 14270, 14270, 8321, }, { 25034, 25034, 24082, 24082, 15025, }, { 39410, 39410, 38178, 38178, 25089, }, },
+    },
+    { /* S[4] */
+        { { 0, 0, 0, 0, 0, }, { 2, 1, 1, 0, 0, }, { 8, 6, 6, 3, 3, }, { 18, 15, 15, 9, 9, },
+          { 33, 29, 29, 19, 19, }, { 54, 49, 49, 34, 34, }, { 82, 76, 76, 55, 55, }, { 118, 111, 111, 83, 83, }, },
+        { { 1, 0, 0, 0, 0, }, { 12, 9, 9, 4, 4, }, { 36, 31, 31, 19, 19, }, { 76, 69, 69, 47, 47, },
+          { 136, 127, 127, 92, 92, }, { 220, 209, 209, 158, 158, }, { 332, 319, 319, 249, 249, }, { 476, 461, 461, 369, 369, }, },
+        { { 5, 3, 3, 1, 1, }, { 34, 29, 29, 17, 17, }, { 94, 86, 86, 59, 59, }, { 194, 183, 183, 135, 135, },
+          { 344, 330, 330, 255, 255, }, { 554, 537, 537, 429, 429, }, { 834, 814, 814, 667, 667, }, { 1194, 1171, 1171, 979, 979, }, },
+        { { 13, 10, 10, 5, 5, }, { 72, 65, 65, 43, 43, }, { 192, 181, 181, 133, 133, }, { 392, 377, 377, 293, 293, },
+          { 692, 673, 673, 543, 543, }, { 1112, 1089, 1089, 903, 903, }, { 1672, 1645, 1645, 1393, 1393, }, { 2392, 2361, 2361, 2033, 2033, }, },
+        { { 26, 22, 22, 13, 13, }, { 130, 121, 121, 86, 86, }, { 340, 326, 326, 251, 251, }, { 690, 671, 671, 541, 541, },
+          { 1215, 1191, 1191, 991, 991, }, { 1950, 1921, 1921, 1636, 1636, }, { 2930, 2896, 2896, 2511, 2511, }, { 4190, 4151, 4151, 3651, 3651, }, },
+        { { 45, 40, 40, 26, 26, }, { 212, 201, 201, 150, 150, }, { 548, 531, 531, 423, 423, }, { 1108, 1085, 1085, 899, 899, },
+          { 1948, 1919, 1919, 1634, 1634, }, { 3124, 3089, 3089, 2684, 2684, }, { 4692, 4651, 4651, 4105, 4105, }, { 6708, 6661, 6661, 5953, 5953, }, },
+        { { 71, 65, 65, 45, 45, }, { 322, 309, 309, 239, 239, }, { 826, 806, 806, 659, 659, }, { 1666, 1639, 1639, 1387, 1387, },
+          { 2926, 2892, 2892, 2507, 2507, }, { 4690, 4649, 4649, 4103, 4103, }, { 7042, 6994, 6994, 6259, 6259, }, { 10066, 10011, 10011, 9059, 9059, }, },
+        { { 105, 98, 98, 71, 71, }, { 464, 449, 449, 357, 357, }, { 1184, 1161, 1161, 969, 969, }, { 2384, 2353, 2353, 2025, 2025, },
+          { 4184, 4145, 4145, 3645, 3645, }, { 6704, 6657, 6657, 5949, 5949, }, { 10064, 10009, 10009, 9057, 9057, }, { 14384, 14321, 14321, 13089, 13089, }, },
+    },
+    { /* B[4] */
+        { { 0, 0, 0, 0, 0, }, { 2, 2, 1, 1, 0, }, { 8, 8, 6, 6, 3, }, { 18, 18, 15, 15, 9, },
+          { 33, 33, 29, 29, 19, }, { 54, 54, 49, 49, 34, }, { 82, 82, 76, 76, 55, }, { 118, 118, 111, 111, 83, }, },
+        { { 1, 1, 0, 0, 0, }, { 10, 10, 7, 7, 2, }, { 28, 28, 23, 23, 11, }, { 58, 58, 51, 51, 29, },
+          { 103, 103, 94, 94, 59, }, { 166, 166, 155, 155, 104, }, { 250, 250, 237, 237, 167, }, { 358, 358, 343, 343, 251, }, },
+        { { 4, 4, 2, 2, 0, }, { 22, 22, 17, 17, 5, }, { 58, 58, 50, 50, 23, }, { 118, 118, 107, 107, 59, },
+          { 208, 208, 194, 194, 119, }, { 334, 334, 317, 317, 209, }, { 502, 502, 482, 482, 335, }, { 718, 718, 695, 695, 503, }, },
+        { { 8, 8, 5, 5, 0, }, { 38, 38, 31, 31, 9, }, { 98, 98, 87, 87, 39, }, { 198, 198, 183, 183, 99, },
+          { 348, 348, 329, 329, 199, }, { 558, 558, 535, 535, 349, }, { 838, 838, 811, 811, 559, }, { 1198, 1198, 1167, 1167, 839, }, },
+        { { 13, 13, 9, 9, 0, }, { 58, 58, 49, 49, 14, }, { 148, 148, 134, 134, 59, }, { 298, 298, 279, 279, 149, },
+          { 523, 523, 499, 499, 299, }, { 838, 838, 809, 809, 524, }, { 1258, 1258, 1224, 1224, 839, }, { 1798, 1798, 1759, 1759, 1259, }, },
+        { { 19, 19, 14, 14, 0, }, { 82, 82, 71, 71, 20, }, { 208, 208, 191, 191, 83, }, { 418, 418, 395, 395, 209, },
+          { 733, 733, 704, 704, 419, }, { 1174, 1174, 1139, 1139, 734, }, { 1762, 1762, 1721, 1721, 1175, }, { 2518, 2518, 2471, 2471, 1763, }, },
+        { { 26, 26, 20, 20, 0, }, { 110, 110, 97, 97, 27, }, { 278, 278, 258, 258, 111, }, { 558, 558, 531, 531, 279, },
+          { 978, 978, 944, 944, 559, }, { 1566, 1566, 1525, 1525, 979, }, { 2350, 2350, 2302, 2302, 1567, }, { 3358, 3358, 3303, 3303, 2351, }, },
+        { { 34, 34, 27, 27, 0, }, { 142, 142, 127, 127, 35, }, { 358, 358, 335, 335, 143, }, { 718, 718, 687, 687, 359, },
+          { 1258, 1258, 1219, 1219, 719, }, { 2014, 2014, 1967, 1967, 1259, }, { 3022, 3022, 2967, 2967, 2015, }, { 4318, 4318, 4255, 4255, 3023, }, },
+    },
+    { /* S[5] */
+        { { 0, 0, 0, 0, 0, }, { 3, 2, 2, 1, 1, }, { 6, 5, 5, 3, 3, }, { 10, 9, 9, 6, 6, },
+          { 15, 14, 14, 10, 10, }, { 21, 20, 20, 15, 15, }, { 28, 27, 27, 21, 21, }, { 36, 35, 35, 28, 28, }, },
+        { { 2, 1, 1, 0, 0, }, { 9, 8, 8, 5, 5, }, { 18, 17, 17, 12, 12, }, { 30, 29, 29, 22, 22, },
+          { 45, 44, 44, 35, 35, }, { 63, 62, 62, 51, 51, }, { 84, 83, 83, 70, 70, }, { 108, 107, 107, 92, 92, }, },
+        { { 5, 4, 4, 2, 2, }, { 18, 17, 17, 12, 12, }, { 36, 35, 35, 27, 27, }, { 60, 59, 59, 48, 48, },
+          { 90, 89, 89, 75, 75, }, { 126, 125, 125, 108, 108, }, { 168, 167, 167, 147, 147, }, { 216, 215, 215, 192, 192, }, },
+        { { 9, 8, 8, 5, 5, }, { 30, 29, 29, 22, 22, }, { 60, 59, 59, 48, 48, }, { 100, 99, 99, 84, 84, },
+          { 150, 149, 149, 130, 130, }, { 210, 209, 209, 186, 186, }, { 280, 279, 279, 252, 252, }, { 360, 359, 359, 328, 328, }, },
+        { { 14, 13, 13, 9, 9, }, { 45, 44, 44, 35, 35, }, { 90, 89, 89, 75, 75, }, { 150, 149, 149, 130, 130, },
+          { 225, 224, 224, 200, 200, }, { 315, 314, 314, 285, 285, }, { 420, 419, 419, 385, 385, }, { 540, 539, 539, 500, 500, }, },
+        { { 20, 19, 19, 14, 14, }, { 63, 62, 62, 51, 51, }, { 126, 125, 125, 108, 108, }, { 210, 209, 209, 186, 186, },
+          { 315, 314, 314, 285, 285, }, { 441, 440, 440, 405, 405, }, { 588, 587, 587, 546, 546, }, { 756, 755, 755, 708, 708, }, },
+        { { 27, 26, 26, 20, 20, }, { 84, 83, 83, 70, 70, }, { 168, 167, 167, 147, 147, }, { 280, 279, 279, 252, 252, },
+          { 420, 419, 419, 385, 385, }, { 588, 587, 587, 546, 546, }, { 784, 783, 783, 735, 735, }, { 1008, 1007, 1007, 952, 952, }, },
+        { { 35, 34, 34, 27, 27, }, { 108, 107, 107, 92, 92, }, { 216, 215, 215, 192, 192, }, { 360, 359, 359, 328, 328, },
+          { 540, 539, 539, 500, 500, }, { 756, 755, 755, 708, 708, }, { 1008, 1007, 1007, 952, 952, }, { 1296, 1295, 1295, 1232, 1232, }, },
+    },
+    { /* B[5] */
+        { { 0, 0, 0, 0, 0, }, { 3, 3, 2, 2, 1, }, { 6, 6, 5, 5, 3, }, { 10, 10, 9, 9, 6, },
+          { 15, 15, 14, 14, 10, }, { 21, 21, 20, 20, 15, }, { 28, 28, 27, 27, 21, }, { 36, 36, 35, 35, 28, }, },
+        { { 2, 2, 1, 1, 0, }, { 6, 6, 5, 5, 2, }, { 12, 12, 11, 11, 6, }, { 20, 20, 19, 19, 12, },
+          { 30, 30, 29, 29, 20, }, { 42, 42, 41, 41, 30, }, { 56, 56, 55, 55, 42, }, { 72, 72, 71, 71, 56, }, },
+        { { 3, 3, 2, 2, 0, }, { 9, 9, 8, 8, 3, }, { 18, 18, 17, 17, 9, }, { 30, 30, 29, 29, 18, },
+          { 45, 45, 44, 44, 30, }, { 63, 63, 62, 62, 45, }, { 84, 84, 83, 83, 63, }, { 108, 108, 107, 107, 84, }, },
+        { { 4, 4, 3, 3, 0, }, { 12, 12, 11, 11, 4, }, { 24, 24, 23, 23, 12, }, { 40, 40, 39, 39, 24, },
+          { 60, 60, 59, 59, 40, }, { 84, 84, 83, 83, 60, }, { 112, 112, 111, 111, 84, }, { 144, 144, 143, 143, 112, }, },
+        { { 5, 5, 4, 4, 0, }, { 15, 15, 14, 14, 5, }, { 30, 30, 29, 29, 15, }, { 50, 50, 49, 49, 30, },
+          { 75, 75, 74, 74, 50, }, { 105, 105, 104, 104, 75, }, { 140, 140, 139, 139, 105, }, { 180, 180, 179, 179, 140, }, },
+        { { 6, 6, 5, 5, 0, }, { 18, 18, 17, 17, 6, }, { 36, 36, 35, 35, 18, }, { 60, 60, 59, 59, 36, },
+          { 90, 90, 89, 89, 60, }, { 126, 126, 125, 125, 90, }, { 168, 168, 167, 167, 126, }, { 216, 216, 215, 215, 168, }, },
+        { { 7, 7, 6, 6, 0, }, { 21, 21, 20, 20, 7, }, { 42, 42, 41, 41, 21, }, { 70, 70, 69, 69, 42, },
+          { 105, 105, 104, 104, 70, }, { 147, 147, 146, 146, 105, }, { 196, 196, 195, 195, 147, }, { 252, 252, 251, 251, 196, }, },
+        { { 8, 8, 7, 7, 0, }, { 24, 24, 23, 23, 8, }, { 48, 48, 47, 47, 24, }, { 80, 80, 79, 79, 48, },
+          { 120, 120, 119, 119, 80, }, { 168, 168, 167, 167, 120, }, { 224, 224, 223, 223, 168, }, { 288, 288, 287, 287, 224, }, },
+    },
+    { /* S[6] */
+        { { 1, 0, 0, 0, 0, }, { 2, 2, 2, 1, 1, }, { 3, 3, 3, 2, 2, }, { 4, 4, 4, 3, 3, },
+          { 5, 5, 5, 4, 4, }, { 6, 6, 6, 5, 5, }, { 7, 7, 7, 6, 6, }, { 8, 8, 8, 7, 7, }, },
+        { { 2, 2, 2, 1, 1, }, { 4, 4, 4, 3, 3, }, { 6, 6, 6, 5, 5, }, { 8, 8, 8, 7, 7, },
+          { 10, 10, 10, 9, 9, }, { 12, 12, 12, 11, 11, }, { 14, 14, 14, 13, 13, }, { 16, 16, 16, 15, 15, }, },
+        { { 3, 3, 3, 2, 2, }, { 6, 6, 6, 5, 5, }, { 9, 9, 9, 8, 8, }, { 12, 12, 12, 11, 11, },
+          { 15, 15, 15, 14, 14, }, { 18, 18, 18, 17, 17, }, { 21, 21, 21, 20, 20, }, { 24, 24, 24, 23, 23, }, },
+        { { 4, 4, 4, 3, 3, }, { 8, 8, 8, 7, 7, }, { 12, 12, 12, 11, 11, }, { 16, 16, 16, 15, 15, },
+          { 20, 20, 20, 19, 19, }, { 24, 24, 24, 23, 23, }, { 28, 28, 28, 27, 27, }, { 32, 32, 32, 31, 31, }, },
+        { { 5, 5, 5, 4, 4, }, { 10, 10, 10, 9, 9, }, { 15, 15, 15, 14, 14, }, { 20, 20, 20, 19, 19, },
+          { 25, 25, 25, 24, 24, }, { 30, 30, 30, 29, 29, }, { 35, 35, 35, 34, 34, }, { 40, 40, 40, 39, 39, }, },
+        { { 6, 6, 6, 5, 5, }, { 12, 12, 12, 11, 11, }, { 18, 18, 18, 17, 17, }, { 24, 24, 24, 23, 23, },
+          { 30, 30, 30, 29, 29, }, { 36, 36, 36, 35, 35, }, { 42, 42, 42, 41, 41, }, { 48, 48, 48, 47, 47, }, },
+        { { 7, 7, 7, 6, 6, }, { 14, 14, 14, 13, 13, }, { 21, 21, 21, 20, 20, }, { 28, 28, 28, 27, 27, },
+          { 35, 35, 35, 34, 34, }, { 42, 42, 42, 41, 41, }, { 49, 49, 49, 48, 48, }, { 56, 56, 56, 55, 55, }, },
+        { { 8, 8, 8, 7, 7, }, { 16, 16, 16, 15, 15, }, { 24, 24, 24, 23, 23, }, { 32, 32, 32, 31, 31, },
+          { 40, 40, 40, 39, 39, }, { 48, 48, 48, 47, 47, }, { 56, 56, 56, 55, 55, }, { 64, 64, 64, 63, 63, }, },
+    },
+    { /* B[6] */
+        { { 1, 1, 0, 0, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+        { { 1, 1, 1, 1, 0, }, { 2, 2, 2, 2, 1, }, { 3, 3, 3, 3, 2, }, { 4, 4, 4, 4, 3, },
+          { 5, 5, 5, 5, 4, }, { 6, 6, 6, 6, 5, }, { 7, 7, 7, 7, 6, }, { 8, 8, 8, 8, 7, }, },
+    },
 };
@@ -34,11 +34,9 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include <assert.h>
 #include "common.h"
+#include "scratch.h"
 
 INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[], const size_t length);
 
@@ -445,11 +443,12 @@ static int Rows2Columns(struct zint_symbol *symbol, CharacterSetTable *T, const
     int fBackupOk = 0;      /* The memorised set is o.k. */
     int testListSize = 0;
     int pTestList[62];
-#ifndef _MSC_VER
-    int *pBackupSet[dataLength];
-#else
-    int *pBackupSet = (int *)_alloca(dataLength*sizeof(int));
-#endif
+    int *pBackupSet = (int *) scratch_alloc(symbol, sizeof(int) * dataLength);
+
+    if (!pBackupSet) {
+        strcpy(symbol->errtxt, "414: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     rowsRequested=*pRows;
     columnsRequested = *pUseColumns >= 4 ? *pUseColumns : 0;
@@ -639,12 +638,10 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
     int emptyColumns;
     char dest[1000];
     int r, c;
-#ifdef _MSC_VER
     CharacterSetTable *T;
     unsigned char *data;
     int *pSet;
-    uchar * pOutput;
-#endif
+    uchar *pOutput;
     /* Suppresses clang-analyzer-core.VLASize warning */
     assert(length > 0);
 
@@ -673,11 +670,10 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-#ifndef _MSC_VER
-    unsigned char data[length*2+1];
-#else
-    data = (unsigned char *) _alloca(length * 2+1);
-#endif
+    if (!(data = (unsigned char *) scratch_alloc(symbol, length * 2 + 1))) {
+        strcpy(symbol->errtxt, "414: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     dataLength = 0;
     if (symbol->output_options & READER_INIT) {
@@ -697,13 +693,12 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
     }
 
     /* Build character set table */
-#ifndef _MSC_VER
-    CharacterSetTable T[dataLength];
-    int pSet[dataLength];
-#else
-    T=(CharacterSetTable *)_alloca(dataLength*sizeof(CharacterSetTable));
-    pSet = (int *)_alloca(dataLength*sizeof(int));
-#endif
+    T = (CharacterSetTable *) scratch_alloc(symbol, sizeof(CharacterSetTable) * dataLength);
+    pSet = (int *) scratch_alloc(symbol, sizeof(int) * dataLength);
+    if (!T || !pSet) {
+        strcpy(symbol->errtxt, "414: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
     CreateCharacterSetTable(T,data,dataLength);
 
     /* Find final row and column count */
@@ -729,6 +724,9 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
         /* column count given */
         error_number = Columns2Rows(symbol, T, dataLength, &rows, &useColumns, pSet, &fillings);
     }
+    if (error_number == ZINT_ERROR_MEMORY) {
+        return error_number;
+    }
     if (error_number != 0) {
         strcpy(symbol->errtxt, "413: Data string too long");
         return error_number;
@@ -777,11 +775,10 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
 
     /* >>> Build C128 code numbers */
     /* The C128 column count contains Start (2CW), Row ID, Checksum, Stop */
-#ifndef _MSC_VER
-    uchar pOutput[columns * rows];
-#else
-    pOutput = (unsigned char *)_alloca(columns * rows * sizeof(char));
-#endif
+    if (!(pOutput = (uchar *) scratch_alloc(symbol, columns * rows))) {
+        strcpy(symbol->errtxt, "414: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
     pOutPos = pOutput;
     charCur=0;
     /* >> Loop over rows */
@@ -971,11 +968,14 @@ INTERNAL int codablock(struct zint_symbol *symbol,const unsigned char source[],
 
     /* Paint the C128 patterns */
     for (r = 0; r < rows; r++) {
-        strcpy(dest, "");
-        for(c = 0; c < columns; c++) {
-            strcat(dest, C128Table[pOutput[r * columns + c]]);
+        char *d = dest;
+        for (c = 0; c < columns; c++) {
+            const char *p;
+            for (p = C128Table[pOutput[r * columns + c]]; *p; p++) {
+                *d++ = *p;
+            }
         }
-        expand(symbol, dest);
+        expand(symbol, dest, d - dest);
         symbol->row_height[r] = 10;
     }
 
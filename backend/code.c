@@ -44,7 +44,7 @@
 #define SILVER  "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%abcd"
 #define ARSENIC "0123456789ABCDEFGHJKLMNPRSTUVWXYZ"
 
-static const char *C11Table[11] = {
+static const char C11Table[11][6] = {
     "111121", "211121", "121121", "221111", "112121", "212111", "122111",
     "111221", "211211", "211111", "112111"
 };
@@ -53,7 +53,7 @@ static const char *C11Table[11] = {
 
 /* Incorporates Table A1 */
 
-static const char *C39Table[43] = {
+static const char C39Table[43][10] = {
     /* Code 39 character assignments (Table 1) */
     "1112212111", "2112111121", "1122111121", "2122111111", "1112211121",
     "2112211111", "1122211111", "1112112121", "2112112111", "1122112111", "2111121121",
@@ -88,7 +88,7 @@ static const char *C93Ctrl[128] = {
     "dP", "dQ", "dR", "dS", "dT", "dU", "dV", "dW", "dX", "dY", "dZ", "bP", "bQ", "bR", "bS", "bT"
 };
 
-static const char *C93Table[47] = {
+static const char C93Table[47][6] = {
     "131112", "111213", "111312", "111411", "121113", "121212", "121311",
     "111114", "131211", "141111", "211113", "211212", "211311", "221112", "221211", "231111",
     "112113", "112212", "112311", "122112", "132111", "111123", "111222", "111321", "121122",
@@ -104,6 +104,7 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     int h, c_digit, c_weight, c_count, k_digit, k_weight, k_count;
     int weight[122], error_number;
     char dest[750]; /* 6 + 121 * 6 + 2 * 6 + 5 + 1 == 750 */
+    char *d = dest;
     char checkstr[3];
     int num_check_digits;
 
@@ -114,7 +115,8 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
         strcpy(symbol->errtxt, "320: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(SODIUM, source, length);
+    /* Weights are the positions in SODIUM, with '-' as 10 */
+    error_number = is_sane_lookup(SODIUM, 11, source, length, weight);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "321: Invalid characters in data");
         return error_number;
@@ -138,15 +140,12 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     k_count = 0;
 
     /* start character */
-    strcpy(dest, "112211");
+    memcpy(d, "112211", 6);
+    d += 6;
 
     /* Draw main body of barcode */
-    for (i = 0; i < length; i++) {
-        lookup(SODIUM, C11Table, source[i], dest);
-        if (source[i] == '-')
-            weight[i] = 10;
-        else
-            weight[i] = ctoi(source[i]);
+    for (i = 0; i < length; i++, d += 6) {
+        memcpy(d, C11Table[weight[i]], 6);
     }
 
     if (num_check_digits) {
@@ -167,7 +166,8 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
                 checkstr[0] = '-';
             }
             checkstr[1] = '\0';
-            lookup(SODIUM, C11Table, checkstr[0], dest);
+            memcpy(d, C11Table[c_digit], 6);
+            d += 6;
         } else {
             weight[length] = c_digit;
 
@@ -191,8 +191,9 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
                 checkstr[1] = '-';
             }
             checkstr[2] = '\0';
-            lookup(SODIUM, C11Table, checkstr[0], dest);
-            lookup(SODIUM, C11Table, checkstr[1], dest);
+            memcpy(d, C11Table[c_digit], 6);
+            memcpy(d + 6, C11Table[k_digit], 6);
+            d += 12;
         }
     }
 
@@ -201,9 +202,10 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     /* Stop character */
-    strcat(dest, "11221");
+    memcpy(d, "11221", 5);
+    d += 5;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     ustrcpy(symbol->text, source);
     if (num_check_digits) {
@@ -217,7 +219,9 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], const size_
     int i;
     int counter;
     int error_number;
+    int posns[85];
     char dest[880]; /* 10 (Start) + 85 * 10 + 10 (Check) + 9 (Stop) + 1 = 880 */
+    char *d = dest;
     char localstr[2] = {0};
 
     counter = 0;
@@ -237,51 +241,29 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], const size_
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(SILVER, source, length);
+    /* Only the first 43 characters of SILVER, excluding the Code 93 shifts */
+    error_number = is_sane_lookup(SILVER, 43, source, (int) length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "324: Invalid characters in data");
         return error_number;
     }
 
     /* Start character */
-    strcpy(dest, "1211212111");
+    memcpy(d, "1211212111", 10);
+    d += 10;
 
-    for (i = 0; i < (int) length; i++) {
-        lookup(SILVER, C39Table, source[i], dest);
-        counter += posn(SILVER, source[i]);
+    for (i = 0; i < (int) length; i++, d += 10) {
+        memcpy(d, C39Table[posns[i]], 10);
+        counter += posns[i];
     }
 
     if (symbol->option_2 == 1) {
 
         char check_digit;
         counter = counter % 43;
-        if (counter < 10) {
-             check_digit = itoc(counter);
-        } else {
-            if (counter < 36) {
-                check_digit = (counter - 10) + 'A';
-            } else {
-                switch (counter) {
-                    case 36: check_digit = '-';
-                        break;
-                    case 37: check_digit = '.';
-                        break;
-                    case 38: check_digit = ' ';
-                        break;
-                    case 39: check_digit = '$';
-                        break;
-                    case 40: check_digit = '/';
-                        break;
-                    case 41: check_digit = '+';
-                        break;
-                    case 42: check_digit = 37;
-                        break;
-                    default: check_digit = ' ';
-                        break; /* Keep compiler happy */
-                }
-            }
-        }
-        lookup(SILVER, C39Table, check_digit, dest);
+        check_digit = SILVER[counter];
+        memcpy(d, C39Table[counter], 10);
+        d += 10;
 
         /* Display a space check digit as _, otherwise it looks like an error */
         if (check_digit == ' ') {
@@ -293,11 +275,12 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], const size_
     }
 
     /* Stop character */
-    strcat(dest, "121121211");
+    memcpy(d, "121121211", 9);
+    d += 9;
 
     if ((symbol->symbology == BARCODE_LOGMARS) || (symbol->symbology == BARCODE_HIBC_39)) {
         /* LOGMARS uses wider 'wide' bars than normal Code 39 */
-        counter = strlen(dest);
+        counter = d - dest;
         for (i = 0; i < counter; i++) {
             if (dest[i] == '2') {
                 dest[i] = '3';
@@ -305,7 +288,7 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], const size_
         }
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     if (symbol->symbology == BARCODE_CODE39) {
         ustrcpy(symbol->text, "*");
@@ -368,8 +351,8 @@ INTERNAL int pharmazentral(struct zint_symbol *symbol, unsigned char source[], i
 /* Extended Code 39 - ISO/IEC 16388:2007 Annex A */
 INTERNAL int ec39(struct zint_symbol *symbol, unsigned char source[], int length) {
 
-    unsigned char buffer[85 * 2 + 1] = {0};
-    int i;
+    unsigned char buffer[85 * 2 + 1];
+    int i, b;
     int error_number;
 
     if (length > 85) {
@@ -378,17 +361,21 @@ INTERNAL int ec39(struct zint_symbol *symbol, unsigned char source[], int length
     }
 
     /* Creates a buffer string and places control characters into it */
-    for (i = 0; i < length; i++) {
+    for (i = 0, b = 0; i < length; i++) {
         if (source[i] > 127) {
             /* Cannot encode extended ASCII */
             strcpy(symbol->errtxt, "329: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
-        ustrcat(buffer, EC39Ctrl[source[i]]);
+        buffer[b++] = EC39Ctrl[source[i]][0];
+        if (EC39Ctrl[source[i]][1]) {
+            buffer[b++] = EC39Ctrl[source[i]][1];
+        }
     }
+    buffer[b] = '\0';
 
     /* Then sends the buffer to the C39 function */
-    error_number = c39(symbol, buffer, ustrlen(buffer));
+    error_number = c39(symbol, buffer, b);
 
     for (i = 0; i < length; i++)
         symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
@@ -406,12 +393,12 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
 
     int i;
     int h, weight, c, k, values[128], error_number;
-    char buffer[220];
+    char buffer[220] = {0};
     char dest[670];
+    char *d = dest;
     char set_copy[] = SILVER;
 
     error_number = 0;
-    strcpy(buffer, "");
 
     if (length > 107) {
         strcpy(symbol->errtxt, "330: Input too long");
@@ -419,26 +406,26 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
     }
 
     /* Message Content */
-    for (i = 0; i < length; i++) {
+    for (i = 0, h = 0; i < length; i++) {
         if (source[i] > 127) {
             /* Cannot encode extended ASCII */
             strcpy(symbol->errtxt, "331: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
-        strcat(buffer, C93Ctrl[source[i]]);
+        buffer[h++] = C93Ctrl[source[i]][0];
+        if (C93Ctrl[source[i]][1]) {
+            buffer[h++] = C93Ctrl[source[i]][1];
+        }
         symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
     }
 
     /* Now we can check the true length of the barcode */
-    h = (int) strlen(buffer);
     if (h > 107) {
         strcpy(symbol->errtxt, "332: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
 
-    for (i = 0; i < h; i++) {
-        values[i] = posn(SILVER, buffer[i]);
-    }
+    is_sane_lookup(SILVER, 47, (const unsigned char *) buffer, h, values); /* C93Ctrl only gives SILVER characters */
 
     /* Putting the data into dest[] is not done until after check digits are calculated */
 
@@ -453,7 +440,6 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
     }
     c = c % 47;
     values[h] = c;
-    buffer[h] = set_copy[c];
 
     /* Check digit K */
     k = 0;
@@ -465,19 +451,21 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
             weight = 1;
     }
     k = k % 47;
-    buffer[++h] = set_copy[k];
-    buffer[++h] = '\0';
+    values[++h] = k;
+    h++;
 
     /* Start character */
-    strcpy(dest, "111141");
+    memcpy(d, "111141", 6);
+    d += 6;
 
-    for (i = 0; i < h; i++) {
-        lookup(SILVER, C93Table, buffer[i], dest);
+    for (i = 0; i < h; i++, d += 6) {
+        memcpy(d, C93Table[values[i]], 6);
     }
 
     /* Stop character */
-    strcat(dest, "1111411");
-    expand(symbol, dest);
+    memcpy(d, "1111411", 7);
+    d += 7;
+    expand(symbol, dest, d - dest);
 
     symbol->text[length] = set_copy[c];
     symbol->text[length + 1] = set_copy[k];
@@ -486,125 +474,122 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
     return error_number;
 }
 
-typedef const struct s_channel_precalc {
-    long value; unsigned char B[8]; unsigned char S[8]; unsigned char bmax[7]; unsigned char smax[7];
-} channel_precalc;
+/* Channel characters are ranked in the order they are enumerated by CHNCHR in ANSI/AIM BC12-1998 Annex D
+   Figure D5 (Copyright (c) AIM 1997), i.e. lexicographically on the element widths S[0], B[0], ..., S[6], B[6]
+   (S[7] and B[7] being fixed by the total width), excluding those with a narrow bar which ends a run of 5
+   narrow elements (or all 2 or 4 elements at the start of a channel 8 character). Rather than stepping
+   through the enumeration, the widths are found directly from the number of characters that follow each
+   choice, so that encoding takes the same time for any value */
 
 //#define CHANNEL_GENERATE_PRECALCS
 
 #ifdef CHANNEL_GENERATE_PRECALCS
-/* To generate precalc tables uncomment define and run "./test_channel -f generate -g" and place result in "channel_precalcs.h" */
-static void channel_generate_precalc(int channels, long value, int mod, int last, int B[8], int S[8], int bmax[7], int smax[7]) {
-    int i;
-    if (value == mod) printf("static channel_precalc channel_precalcs%d[] = {\n", channels);
-    printf("    { %7ld, {", value); for (i = 0; i < 8; i++) printf(" %d,", B[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 8; i++) printf(" %d,", S[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 7; i++) printf(" %d,", bmax[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 7; i++) printf(" %d,", smax[i]); printf(" }, },\n");
-    if (value == last) printf("};\n");
-}
+static long channel_count(const int p, const int s, const int b, const int run);
 #else
 #include "channel_precalcs.h"
+
+/* Returns the number of characters that can be completed from element `p` (0-13 for S[0], B[0], ..., S[6], B[6])
+   when the next space can be at most `s` wide and the next bar at most `b` wide, and the preceding `run` (capped
+   at 4) elements are narrow */
+static long channel_count(const int p, const int s, const int b, const int run) {
+    if (p == 14) {
+        /* S[7] and B[7] are fixed - B[7] can't end a run of 5 narrow elements */
+        return !(s == 1 && b == 1 && run >= 3);
+    }
+    return channel_counts[p - 1][s - 1][b - 1][run];
+}
 #endif
 
-static long channel_copy_precalc(channel_precalc precalc, int B[8], int S[8], int bmax[7], int smax[7]) {
-    int i;
+/* Returns the number of characters in which element `p` has width `w` */
+static long channel_choice_count(const int p, const int w, const int s, const int b, const int run) {
+    const int next_run = w == 1 ? (run < 4 ? run + 1 : 4) : 0;
 
-    for (i = 0; i < 7; i++) {
-        B[i] = precalc.B[i];
-        S[i] = precalc.S[i];
-        bmax[i] = precalc.bmax[i];
-        smax[i] = precalc.smax[i];
+    if (p & 1) {
+        /* A narrow bar can't end a run of 5 narrow elements (all 2 or 4 at the start of the character) */
+        if (w == 1 && run >= (p == 1 ? 1 : p == 3 ? 3 : 4)) {
+            return 0;
+        }
+        return channel_count(p + 1, s, b + 1 - w, next_run);
     }
-    B[7] = precalc.B[7];
-    S[7] = precalc.S[7];
+    return channel_count(p + 1, s + 1 - w, b, next_run);
+}
 
-    return precalc.value;
+#ifdef CHANNEL_GENERATE_PRECALCS
+static long channel_count(const int p, const int s, const int b, const int run) {
+    long count = 0;
+    int w;
+
+    if (p == 14) {
+        return !(s == 1 && b == 1 && run >= 3);
+    }
+    for (w = 1; w <= ((p & 1) ? b : s); w++) {
+        count += channel_choice_count(p, w, s, b, run);
+    }
+    return count;
 }
 
-/* CHNCHR is adapted from ANSI/AIM BC12-1998 Annex D Figure D5 and is Copyright (c) AIM 1997 */
-
-/* It is used here on the understanding that it forms part of the specification
-   for Channel Code and therefore its use is permitted under the following terms
-   set out in that document:
-
-   "It is the intent and understanding of AIM [t]hat the symbology presented in this
-   specification is entirely in the public domain and free of all use restrictions,
-   licenses and fees. AIM USA, its member companies, or individual officers
-   assume no liability for the use of this document." */
-
-static void CHNCHR(int channels, long target_value, int B[8], int S[8]) {
-    /* Use of initial pre-calculations taken from Barcode Writer in Pure PostScript (bwipp)
-     * Copyright (c) 2004-2020 Terry Burton (MIT/X-Consortium license) */
-    static channel_precalc initial_precalcs[6] = {
-        { 0, { 1, 1, 1, 1, 1, 2, 1, 2, }, { 1, 1, 1, 1, 1, 1, 1, 3, }, { 1, 1, 1, 1, 1, 3, 2, }, { 1, 1, 1, 1, 1, 3, 3, }, },
-        { 0, { 1, 1, 1, 1, 2, 1, 1, 3, }, { 1, 1, 1, 1, 1, 1, 1, 4, }, { 1, 1, 1, 1, 4, 3, 3, }, { 1, 1, 1, 1, 4, 4, 4, }, },
-        { 0, { 1, 1, 1, 2, 1, 1, 2, 3, }, { 1, 1, 1, 1, 1, 1, 1, 5, }, { 1, 1, 1, 5, 4, 4, 4, }, { 1, 1, 1, 5, 5, 5, 5, }, },
-        { 0, { 1, 1, 2, 1, 1, 2, 1, 4, }, { 1, 1, 1, 1, 1, 1, 1, 6, }, { 1, 1, 6, 5, 5, 5, 4, }, { 1, 1, 6, 6, 6, 6, 6, }, },
-        { 0, { 1, 2, 1, 1, 2, 1, 1, 5, }, { 1, 1, 1, 1, 1, 1, 1, 7, }, { 1, 7, 6, 6, 6, 5, 5, }, { 1, 7, 7, 7, 7, 7, 7, }, },
-        { 0, { 2, 1, 1, 2, 1, 1, 2, 5, }, { 1, 1, 1, 1, 1, 1, 1, 8, }, { 8, 7, 7, 7, 6, 6, 6, }, { 8, 8, 8, 8, 8, 8, 8, }, },
-    };
-    int bmax[7], smax[7];
-    long value = 0;
-
-    channel_copy_precalc(initial_precalcs[channels - 3], B, S, bmax, smax);
-
-#ifndef CHANNEL_GENERATE_PRECALCS
-    if (channels == 7 && target_value >= channel_precalcs7[0].value) {
-        value = channel_copy_precalc(channel_precalcs7[(target_value / channel_precalcs7[0].value) - 1], B, S, bmax, smax);
-    } else if (channels == 8 && target_value >= channel_precalcs8[0].value) {
-        value = channel_copy_precalc(channel_precalcs8[(target_value / channel_precalcs8[0].value) - 1], B, S, bmax, smax);
+/* To generate `channel_counts` uncomment define and run "./test_channel -f generate -g" and place result in
+   "channel_precalcs.h" */
+static void channel_generate_precalc(void) {
+    int p, s, b, run;
+
+    printf("static const unsigned int channel_counts[13][8][8][5] = {\n");
+    for (p = 1; p < 14; p++) {
+        printf("    { /* %s[%d] */\n", p & 1 ? "B" : "S", p >> 1);
+        for (s = 1; s <= 8; s++) {
+            printf("        {");
+            for (b = 1; b <= 8; b++) {
+                if (b == 5) {
+                    printf("\n         ");
+                }
+                printf(" {");
+                for (run = 0; run < 5; run++) {
+                    printf(" %ld,", channel_count(p, s, b, run));
+                }
+                printf(" },");
+            }
+            printf(" },\n");
+        }
+        printf("    },\n");
     }
+    printf("};\n");
+}
 #endif
 
-    goto chkchr;
-
-ls0:smax[1] = smax[0] + 1 - S[0]; B[0] = 1;
-    if (S[0] == 1) goto nb0;
-lb0:    bmax[1] = bmax[0] + 1 - B[0]; S[1] = 1;
-ls1:        smax[2] = smax[1] + 1 - S[1]; B[1] = 1;
-            if (S[0] + B[0] + S[1] == 3) goto nb1;
-lb1:            bmax[2] = bmax[1] + 1 - B[1]; S[2] = 1;
-ls2:                smax[3] = smax[2] + 1 - S[2]; B[2] = 1;
-                    if (B[0] + S[1] + B[1] + S[2] == 4) goto nb2;
-lb2:                    bmax[3] = bmax[2] + 1 - B[2]; S[3] = 1;
-ls3:                        smax[4] = smax[3] + 1 - S[3]; B[3] = 1;
-                            if (B[1] + S[2] + B[2] + S[3] == 4) goto nb3;
-lb3:                            bmax[4] = bmax[3] + 1 - B[3]; S[4] = 1;
-ls4:                                smax[5] = smax[4] + 1 - S[4]; B[4] = 1;
-                                    if (B[2] + S[3] + B[3] + S[4] == 4) goto nb4;
-lb4:                                    bmax[5] = bmax[4] + 1 - B[4]; S[5] = 1;
-ls5:                                        smax[6] = smax[5] + 1 - S[5]; B[5] = 1;
-                                            if (B[3] + S[4] + B[4] + S[5] == 4) goto nb5;
-lb5:                                            bmax[6] = bmax[5] + 1 - B[5]; S[6] = 1;
-ls6:                                                S[7] = smax[6] + 1 - S[6]; B[6] = 1;
-                                                    if (B[4] + S[5] + B[5] + S[6] == 4) goto nb6;
-lb6:                                                    B[7] = bmax[6] + 1 - B[6];
-                                                        if (B[5] + S[6] + B[6] + S[7] + B[7] == 5) goto nb6;
-chkchr:
-#ifdef CHANNEL_GENERATE_PRECALCS
-                                                        if (channels == 7 && value && value % 115338 == 0) { /* 115338 == (576688 + 2) / 5 */
-                                                            channel_generate_precalc(channels, value, 115338, 115338 * (5 - 1), B, S, bmax, smax);
-                                                        } else if (channels == 8 && value && value % 119121 == 0) { /* 119121 == (7742862 + 3) / 65 */
-                                                            channel_generate_precalc(channels, value, 119121, 119121 * (65 - 1), B, S, bmax, smax);
-                                                        }
-#endif
-                                                        if (value == target_value) return;
-                                                        value++;
-nb6:                                                    if (++B[6] <= bmax[6]) goto lb6;
-                                                    if (++S[6] <= smax[6]) goto ls6;
-nb5:                                            if (++B[5] <= bmax[5]) goto lb5;
-                                            if (++S[5] <= smax[5]) goto ls5;
-nb4:                                    if (++B[4] <= bmax[4]) goto lb4;
-                                    if (++S[4] <= smax[4]) goto ls4;
-nb3:                            if (++B[3] <= bmax[3]) goto lb3;
-                            if (++S[3] <= smax[3]) goto ls3;
-nb2:                    if (++B[2] <= bmax[2]) goto lb2;
-                    if (++S[2] <= smax[2]) goto ls2;
-nb1:            if (++B[1] <= bmax[1]) goto lb1;
-            if (++S[1] <= smax[1]) goto ls1;
-nb0:    if (++B[0] <= bmax[0]) goto lb0;
-    if (++S[0] <= smax[0]) goto ls0;
+/* Sets the widths of the channel character ranked `value` */
+static void channel_unrank(const int channels, long value, int B[8], int S[8]) {
+    int i;
+    int p = 2 * (8 - channels); /* Elements before this are narrow for channels < 8 */
+    int s = channels, b = channels; /* Maximum widths of next space and bar */
+    int run = p < 4 ? p : 4;
+
+    for (i = 0; i < p; i++) {
+        B[i >> 1] = S[i >> 1] = 1;
+    }
+
+    for (; p < 14; p++) {
+        const int max = (p & 1) ? b : s;
+        int w;
+
+        for (w = 1; w < max; w++) {
+            const long count = channel_choice_count(p, w, s, b, run);
+            if (value < count) {
+                break;
+            }
+            value -= count;
+        }
+
+        if (p & 1) {
+            B[p >> 1] = w;
+            b += 1 - w;
+        } else {
+            S[p >> 1] = w;
+            s += 1 - w;
+        }
+        run = w == 1 ? (run < 4 ? run + 1 : 4) : 0;
+    }
+    S[7] = s;
+    B[7] = b;
 }
 
 /* Channel Code - According to ANSI/AIM BC12-1998 */
@@ -612,7 +597,7 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
     int S[8] = {0}, B[8] = {0};
     long target_value = 0;
     char pattern[30];
-    int channels, i;
+    int channels, i, p;
     int error_number, range = 0, zeroes;
     char hrt[9];
 
@@ -686,15 +671,16 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
         return ZINT_ERROR_INVALID_DATA;
     }
 
-    CHNCHR(channels, target_value, B, S);
+#ifdef CHANNEL_GENERATE_PRECALCS
+    channel_generate_precalc();
+#endif
+
+    channel_unrank(channels, target_value, B, S);
 
-    strcpy(pattern, "111111111"); /* Finder pattern */
-    for (i = 8 - channels; i < 8; i++) {
-        char part[3];
-        part[0] = itoc(S[i]);
-        part[1] = itoc(B[i]);
-        part[2] = '\0';
-        strcat(pattern, part);
+    memcpy(pattern, "111111111", 9); /* Finder pattern */
+    for (i = 8 - channels, p = 9; i < 8; i++, p += 2) {
+        pattern[p] = itoc(S[i]);
+        pattern[p + 1] = itoc(B[i]);
     }
 
     zeroes = channels - 1 - length;
@@ -705,7 +691,7 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
     ustrcpy(hrt + zeroes, source);
     ustrcpy(symbol->text, hrt);
 
-    expand(symbol, pattern);
+    expand(symbol, pattern, p);
 
     return error_number;
 }
@@ -716,7 +702,9 @@ INTERNAL int vin(struct zint_symbol *symbol, const unsigned char source[], const
     /* This code verifies the check digit present in North American VIN codes */
 
     char local_source[18];
-    char dest[200];
+    int posns[17];
+    char dest[200]; /* 10 + 10 + 17 * 10 + 9 + 1 = 200 */
+    char *d = dest;
     char input_check;
     char output_check;
     int value[17];
@@ -782,22 +770,26 @@ INTERNAL int vin(struct zint_symbol *symbol, const unsigned char source[], const
     }
 
     /* Start character */
-    strcpy(dest, "1211212111");
+    memcpy(d, "1211212111", 10);
+    d += 10;
 
     /* Import character 'I' prefix? */
     if (symbol->option_2 & 1) {
-        strcat(dest, "1121122111");
+        memcpy(d, C39Table[18], 10);
+        d += 10;
     }
 
     // Copy glyphs to symbol
-    for (i = 0; i < 17; i++) {
-        lookup(SILVER, C39Table, local_source[i], dest);
+    is_sane_lookup(SILVER, 43, (const unsigned char *) local_source, 17, posns); /* Already checked against ARSENIC */
+    for (i = 0; i < 17; i++, d += 10) {
+        memcpy(d, C39Table[posns[i]], 10);
     }
 
-    strcat(dest, "121121211");
+    memcpy(d, "121121211", 9);
+    d += 9;
 
     ustrcpy(symbol->text, local_source);
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     return 0;
 }
@@ -33,9 +33,6 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include <assert.h>
 #include "common.h"
 #include "code128.h"
@@ -209,22 +206,18 @@ INTERNAL void dxsmooth(int list[2][C128_MAX], int *indexliste) {
  * Translate Code 128 Set A characters into barcodes.
  * This set handles all control characters NUL to US.
  */
-static void c128_set_a(unsigned char source, char dest[], int values[], int *bar_chars) {
+static void c128_set_a(unsigned char source, int values[], int *bar_chars) {
 
     if (source > 127) {
         if (source < 160) {
-            strcat(dest, C128Table[(source - 128) + 64]);
             values[(*bar_chars)] = (source - 128) + 64;
         } else {
-            strcat(dest, C128Table[(source - 128) - 32]);
             values[(*bar_chars)] = (source - 128) - 32;
         }
     } else {
         if (source < 32) {
-            strcat(dest, C128Table[source + 64]);
             values[(*bar_chars)] = source + 64;
         } else {
-            strcat(dest, C128Table[source - 32]);
             values[(*bar_chars)] = source - 32;
         }
     }
@@ -236,12 +229,10 @@ static void c128_set_a(unsigned char source, char dest[], int values[], int *bar
  * This set handles all characters which are not part of long numbers and not
  * control characters.
  */
-static void c128_set_b(unsigned char source, char dest[], int values[], int *bar_chars) {
+static void c128_set_b(unsigned char source, int values[], int *bar_chars) {
     if (source > 127) {
-        strcat(dest, C128Table[source - 32 - 128]);
         values[(*bar_chars)] = source - 32 - 128;
     } else {
-        strcat(dest, C128Table[source - 32]);
         values[(*bar_chars)] = source - 32;
     }
     (*bar_chars)++;
@@ -250,11 +241,10 @@ static void c128_set_b(unsigned char source, char dest[], int values[], int *bar
 /* Translate Code 128 Set C characters into barcodes
  * This set handles numbers in a compressed form
  */
-static void c128_set_c(unsigned char source_a, unsigned char source_b, char dest[], int values[], int *bar_chars) {
+static void c128_set_c(unsigned char source_a, unsigned char source_b, int values[], int *bar_chars) {
     int weight;
 
     weight = (10 * ctoi(source_a)) + ctoi(source_b);
-    strcat(dest, C128Table[weight]);
     values[(*bar_chars)] = weight;
     (*bar_chars)++;
 }
@@ -292,34 +282,235 @@ STATIC_UNLESS_ZINT_TEST int hrt_cpy_iso8859_1(struct zint_symbol *symbol, const
     return j;
 }
 
+/* Minimal encodation states are code set (B, A or C) times whether FNC4 extended latch in effect */
+#define C128_SET_B  0
+#define C128_SET_A  1
+#define C128_SET_C  2
+#define C128_STATES 6
+#define C128_INF    10000
+
+/* How the character(s) ending in a state were encoded */
+#define C128_DIRECT 0
+#define C128_SHIFT  1
+#define C128_PAIR   2
+#define C128_FNC1   3
+
+/* Whether `set` (A or B) can encode low (7-bit) character `low` directly */
+static int c128_can_encode(const int set, const unsigned char low) {
+    return set == C128_SET_A ? low < 96 : low >= 32;
+}
+
+/* Value of low (7-bit) character `low` in `set` (A or B) */
+static int c128_value(const int set, const unsigned char low) {
+    if (set == C128_SET_A && low < 32) {
+        return low + 64;
+    }
+    return low - 32;
+}
+
+/* Find the least number of symbol characters needed to encode `source` by doing a shortest path search over
+   code set and FNC4 latch states, allowing for Shift, single and double FNC4 and (if `gs1`) FNC1 ('['), then put
+   the start character(s) and data into `values`. Returns number of data symbol characters, and only sets
+   `values` if that is within the 60 character limit */
+static int c128_minimal(struct zint_symbol *symbol, const unsigned char source[], const int length, const int gs1,
+            int values[], int *p_bar_characters, char *p_last_set) {
+    int cost[C128_MAX + 1][C128_STATES];
+    char prev[C128_MAX + 1][C128_STATES];
+    char how[C128_MAX + 1][C128_STATES];
+    char path[C128_MAX], path_how[C128_MAX];
+    int i, s, t, steps, best;
+    const int reader_init = !gs1 && (symbol->output_options & READER_INIT); /* Not supported by GS1-128 */
+    const int no_c = symbol->symbology == BARCODE_CODE128B;
+    static const char set_chars[3] = { 'B', 'A', 'C' };
+    /* Latch values (Code B, Code A, Code C) and FNC4 in each set (FNC4 not available in set C) */
+    static const int latch_values[3] = { 100, 101, 99 };
+    static const int fnc4_values[2] = { 100, 101 };
+    static const int start_values[3] = { 104, 103, 105 };
+    int bar_characters = 0;
+
+    for (i = 0; i <= length; i++) {
+        for (s = 0; s < C128_STATES; s++) {
+            cost[i][s] = C128_INF;
+        }
+    }
+    cost[0][C128_SET_B * 2] = 0;
+    cost[0][C128_SET_A * 2] = 0;
+    if (!no_c) {
+        /* Reader Initialisation requires Start B, FNC3, Code C */
+        cost[0][C128_SET_C * 2] = reader_init ? 1 : 0;
+    }
+
+    for (i = 0; i < length; i++) {
+        for (s = 0; s < C128_STATES; s++) {
+            if (cost[i][s] == C128_INF) {
+                continue;
+            }
+            for (t = 0; t < C128_STATES; t++) {
+                const int t_set = t >> 1, t_ext = t & 1;
+                int next = i + 1;
+                int c = cost[i][s] + 1;
+                int method = C128_DIRECT;
+
+                if (t_set == C128_SET_C && (no_c || t_ext != (s & 1))) {
+                    /* Can't change FNC4 latch in set C */
+                    continue;
+                }
+                if (t_set != (s >> 1)) {
+                    c++; /* Latch */
+                }
+                if (t_ext != (s & 1)) {
+                    c += 2; /* Double FNC4 */
+                }
+                if (gs1 && source[i] == '[') {
+                    method = C128_FNC1;
+                } else if (t_set == C128_SET_C) {
+                    if (!istwodigits(source, length, i)) {
+                        continue;
+                    }
+                    next++;
+                    method = C128_PAIR;
+                } else {
+                    if ((source[i] >> 7) != t_ext) {
+                        c++; /* Single FNC4 */
+                    }
+                    if (!c128_can_encode(t_set, source[i] & 0x7F)) {
+                        c++;
+                        method = C128_SHIFT;
+                    }
+                }
+                if (c < cost[next][t]) {
+                    cost[next][t] = c;
+                    prev[next][t] = s;
+                    how[next][t] = method;
+                }
+            }
+        }
+    }
+
+    best = 0;
+    for (s = 1; s < C128_STATES; s++) {
+        if (cost[length][s] < cost[length][best]) {
+            best = s;
+        }
+    }
+    if (cost[length][best] > 60) {
+        return cost[length][best];
+    }
+
+    /* Trace path back, recording states at each character boundary passed through */
+    steps = 0;
+    for (i = length, s = best; i > 0; steps++) {
+        path[steps] = s;
+        path_how[steps] = how[i][s];
+        t = prev[i][s];
+        i -= path_how[steps] == C128_PAIR ? 2 : 1;
+        s = t;
+    }
+
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("Data: %.*s (%d)\n", length, source, length);
+        printf("Minimal: %d data symbol characters\n", cost[length][best]);
+    }
+
+    /* Start character(s), `s` now being the initial state */
+    if (reader_init) {
+        values[bar_characters++] = (s >> 1) == C128_SET_A ? 103 : 104;
+        values[bar_characters++] = 96; /* FNC3 */
+        if ((s >> 1) == C128_SET_C) {
+            values[bar_characters++] = 99;
+        }
+    } else {
+        values[bar_characters++] = start_values[s >> 1];
+    }
+    if (gs1) {
+        values[bar_characters++] = 102;
+    }
+
+    /* Encode the data */
+    for (i = 0; steps > 0; s = t) {
+        int t_set;
+        steps--;
+        t = path[steps];
+        t_set = t >> 1;
+        if (t_set != (s >> 1)) {
+            values[bar_characters++] = latch_values[t_set];
+        }
+        if ((t & 1) != (s & 1)) {
+            values[bar_characters++] = fnc4_values[t_set];
+            values[bar_characters++] = fnc4_values[t_set];
+        }
+        switch (path_how[steps]) {
+            case C128_FNC1:
+                values[bar_characters++] = 102;
+                i++;
+                break;
+            case C128_PAIR:
+                values[bar_characters++] = 10 * ctoi(source[i]) + ctoi(source[i + 1]);
+                i += 2;
+                break;
+            default:
+                if ((source[i] >> 7) != (t & 1)) {
+                    values[bar_characters++] = fnc4_values[t_set];
+                }
+                if (path_how[steps] == C128_SHIFT) {
+                    values[bar_characters++] = 98;
+                    values[bar_characters++] = c128_value(!t_set, source[i] & 0x7F);
+                } else {
+                    values[bar_characters++] = c128_value(t_set, source[i] & 0x7F);
+                }
+                i++;
+                break;
+        }
+    }
+
+    *p_bar_characters = bar_characters;
+    if (p_last_set) {
+        *p_last_set = set_chars[best >> 1];
+    }
+
+    return cost[length][best];
+}
+
+/* Expand symbol character `values` directly into a row of modules (cf. `expand()`) */
+static void c128_expand(struct zint_symbol *symbol, const int values[], const int bar_characters) {
+    int i, j, k;
+    int writer = 0;
+
+    for (i = 0; i < bar_characters; i++) {
+        const char *widths = C128Table[values[i]];
+        /* Each symbol character starts with a bar */
+        for (j = 0; widths[j]; j++) {
+            const int width = widths[j] - '0';
+            if (!(j & 1)) {
+                for (k = 0; k < width; k++) {
+                    set_module(symbol, symbol->rows, writer + k);
+                }
+            }
+            writer += width;
+        }
+    }
+
+    if (writer > symbol->width) {
+        symbol->width = writer;
+    }
+    symbol->rows++;
+}
+
 /* Handle Code 128, 128B and HIBC 128 */
-INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[], const size_t length) {
-    int i, j, k, values[C128_MAX] = {0}, bar_characters, read, total_sum;
-    int error_number, indexchaine, indexliste, f_state;
-    int sourcelen;
+/* Choose code sets by the rules of ISO 15417 Annex E and put the symbol characters of `source` into `values` */
+static int c128_annex_e(struct zint_symbol *symbol, const unsigned char source[], const int sourcelen, int values[],
+            int *p_bar_characters) {
+    int i, j, k, bar_characters, read, indexchaine, indexliste, f_state;
     int list[2][C128_MAX] = {{0}};
     char set[C128_MAX] = {0}, fset[C128_MAX], mode, last_set, current_set = ' ';
     float glyph_count;
-    char dest[1000];
 
     /* Suppresses clang-analyzer-core.UndefinedBinaryOperatorResult warning on fset which is fully set */
-    assert(length > 0);
-
-    error_number = 0;
-    strcpy(dest, "");
-
-    sourcelen = length;
+    assert(sourcelen > 0);
 
     bar_characters = 0;
     f_state = 0;
 
-    if (sourcelen > C128_MAX) {
-        /* This only blocks ridiculously long input - the actual length of the
-           resulting barcode depends on the type of data, so this is trapped later */
-        strcpy(symbol->errtxt, "340: Input too long");
-        return ZINT_ERROR_TOO_LONG;
-    }
-
     /* Detect extended ASCII characters */
     for (i = 0; i < sourcelen; i++) {
         fset[i] = source[i] >= 128 ? 'f' : ' ';
@@ -488,27 +679,20 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
         /* Reader Initialisation mode */
         switch (set[0]) {
             case 'A': /* Start A */
-                strcat(dest, C128Table[103]);
                 values[0] = 103;
                 current_set = 'A';
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
                 bar_characters++;
                 break;
             case 'B': /* Start B */
-                strcat(dest, C128Table[104]);
                 values[0] = 104;
                 current_set = 'B';
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
                 bar_characters++;
                 break;
             case 'C': /* Start C */
-                strcat(dest, C128Table[104]); /* Start B */
                 values[0] = 104;
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
-                strcat(dest, C128Table[99]); /* Code C */
                 values[2] = 99;
                 bar_characters += 2;
                 current_set = 'C';
@@ -518,17 +702,14 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
         /* Normal mode */
         switch (set[0]) {
             case 'A': /* Start A */
-                strcat(dest, C128Table[103]);
                 values[0] = 103;
                 current_set = 'A';
                 break;
             case 'B': /* Start B */
-                strcat(dest, C128Table[104]);
                 values[0] = 104;
                 current_set = 'B';
                 break;
             case 'C': /* Start C */
-                strcat(dest, C128Table[105]);
                 values[0] = 105;
                 current_set = 'C';
                 break;
@@ -537,22 +718,19 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
     bar_characters++;
 
     if (fset[0] == 'F') {
+        /* No extended mode in set C, so latch (and state change) deferred until next in A or B */
         switch (current_set) {
             case 'A':
-                strcat(dest, C128Table[101]);
-                strcat(dest, C128Table[101]);
-                values[bar_characters] = 101;
-                values[bar_characters + 1] = 101;
+                values[bar_characters++] = 101;
+                values[bar_characters++] = 101;
+                f_state = 1;
                 break;
             case 'B':
-                strcat(dest, C128Table[100]);
-                strcat(dest, C128Table[100]);
-                values[bar_characters] = 100;
-                values[bar_characters + 1] = 100;
+                values[bar_characters++] = 100;
+                values[bar_characters++] = 100;
+                f_state = 1;
                 break;
         }
-        bar_characters += 2;
-        f_state = 1;
     }
 
     /* Encode the data */
@@ -562,18 +740,15 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
         if ((read != 0) && (set[read] != current_set)) {
             /* Latch different code set */
             switch (set[read]) {
-                case 'A': strcat(dest, C128Table[101]);
-                    values[bar_characters] = 101;
+                case 'A': values[bar_characters] = 101;
                     bar_characters++;
                     current_set = 'A';
                     break;
-                case 'B': strcat(dest, C128Table[100]);
-                    values[bar_characters] = 100;
+                case 'B': values[bar_characters] = 100;
                     bar_characters++;
                     current_set = 'B';
                     break;
-                case 'C': strcat(dest, C128Table[99]);
-                    values[bar_characters] = 99;
+                case 'C': values[bar_characters] = 99;
                     bar_characters++;
                     current_set = 'C';
                     break;
@@ -585,39 +760,31 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
                 /* Latch beginning of extended mode */
                 switch (current_set) {
                     case 'A':
-                        strcat(dest, C128Table[101]);
-                        strcat(dest, C128Table[101]);
-                        values[bar_characters] = 101;
-                        values[bar_characters + 1] = 101;
+                        values[bar_characters++] = 101;
+                        values[bar_characters++] = 101;
+                        f_state = 1;
                         break;
                     case 'B':
-                        strcat(dest, C128Table[100]);
-                        strcat(dest, C128Table[100]);
-                        values[bar_characters] = 100;
-                        values[bar_characters + 1] = 100;
+                        values[bar_characters++] = 100;
+                        values[bar_characters++] = 100;
+                        f_state = 1;
                         break;
                 }
-                bar_characters += 2;
-                f_state = 1;
             }
             if ((fset[read] == ' ') && (f_state == 1)) {
                 /* Latch end of extended mode */
                 switch (current_set) {
                     case 'A':
-                        strcat(dest, C128Table[101]);
-                        strcat(dest, C128Table[101]);
-                        values[bar_characters] = 101;
-                        values[bar_characters + 1] = 101;
+                        values[bar_characters++] = 101;
+                        values[bar_characters++] = 101;
+                        f_state = 0;
                         break;
                     case 'B':
-                        strcat(dest, C128Table[100]);
-                        strcat(dest, C128Table[100]);
-                        values[bar_characters] = 100;
-                        values[bar_characters + 1] = 100;
+                        values[bar_characters++] = 100;
+                        values[bar_characters++] = 100;
+                        f_state = 0;
                         break;
                 }
-                bar_characters += 2;
-                f_state = 0;
             }
         }
 
@@ -625,52 +792,80 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
             /* Shift to or from extended mode */
             switch (current_set) {
                 case 'A':
-                    strcat(dest, C128Table[101]); /* FNC 4 */
-                    values[bar_characters] = 101;
+                    values[bar_characters++] = 101;
                     break;
                 case 'B':
-                    strcat(dest, C128Table[100]); /* FNC 4 */
-                    values[bar_characters] = 100;
+                    values[bar_characters++] = 100;
                     break;
             }
-            bar_characters++;
         }
 
         if ((set[read] == 'a') || (set[read] == 'b')) {
             /* Insert shift character */
-            strcat(dest, C128Table[98]);
             values[bar_characters] = 98;
             bar_characters++;
         }
 
         switch (set[read]) { /* Encode data characters */
             case 'a':
-            case 'A': c128_set_a(source[read], dest, values, &bar_characters);
+            case 'A': c128_set_a(source[read], values, &bar_characters);
                 read++;
                 break;
             case 'b':
-            case 'B': c128_set_b(source[read], dest, values, &bar_characters);
+            case 'B': c128_set_b(source[read], values, &bar_characters);
                 read++;
                 break;
-            case 'C': c128_set_c(source[read], source[read + 1], dest, values, &bar_characters);
+            case 'C': c128_set_c(source[read], source[read + 1], values, &bar_characters);
                 read += 2;
                 break;
         }
 
     } while (read < sourcelen);
 
+    *p_bar_characters = bar_characters;
+    return 0;
+}
+
+INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[], const size_t length) {
+    int i, values[C128_MAX] = {0}, bar_characters, total_sum;
+    int error_number;
+    int sourcelen;
+
+    error_number = 0;
+
+    sourcelen = length;
+
+    bar_characters = 0;
+
+    if (sourcelen > C128_MAX) {
+        /* This only blocks ridiculously long input - the actual length of the
+           resulting barcode depends on the type of data, so this is trapped later */
+        strcpy(symbol->errtxt, "340: Input too long");
+        return ZINT_ERROR_TOO_LONG;
+    }
+
+    if (symbol->option_3 == C128_OPTIMAL) {
+        if (c128_minimal(symbol, source, sourcelen, 0 /*gs1*/, values, &bar_characters, NULL) > 60) {
+            strcpy(symbol->errtxt, "341: Input too long");
+            return ZINT_ERROR_TOO_LONG;
+        }
+    } else {
+        error_number = c128_annex_e(symbol, source, sourcelen, values, &bar_characters);
+        if (error_number != 0) {
+            return error_number;
+        }
+    }
+
     /* check digit calculation */
     total_sum = values[0] % 103; /* Mod as we go along to avoid overflow */
 
     for (i = 1; i < bar_characters; i++) {
         total_sum = (total_sum + values[i] * i) % 103;
     }
-    strcat(dest, C128Table[total_sum]);
     values[bar_characters] = total_sum;
     bar_characters++;
 
     /* Stop character */
-    strcat(dest, C128Table[106]);
     values[bar_characters] = 106;
     bar_characters++;
 
@@ -680,7 +875,11 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
             printf(" %d", values[i]);
         }
         printf(" (%d)\n", bar_characters);
-        printf("Barspaces: %s\n", dest);
+        printf("Barspaces: ");
+        for (i = 0; i < bar_characters; i++) {
+            fputs(C128Table[values[i]], stdout);
+        }
+        fputc('\n', stdout);
     }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) {
@@ -688,54 +887,23 @@ INTERNAL int code_128(struct zint_symbol *symbol, const unsigned char source[],
     }
 #endif
 
-    expand(symbol, dest);
+    c128_expand(symbol, values, bar_characters);
 
     hrt_cpy_iso8859_1(symbol, source, length);
 
     return error_number;
 }
 
-/* Handle EAN-128 (Now known as GS1-128) */
-INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const size_t length) {
-    int i, j, values[C128_MAX] = {0}, bar_characters, read, total_sum;
-    int error_number, indexchaine, indexliste;
+/* Choose code sets for GS1-128 by the rules of ISO 15417 Annex E and put the symbol characters of `reduced` into
+   `values`, setting `p_last_set` to the code set of the last data character */
+static int gs1_128_annex_e(struct zint_symbol *symbol, const char reduced[], const int reduced_length, int values[],
+            int *p_bar_characters, char *p_last_set) {
+    int i, j, bar_characters, read, indexchaine, indexliste, c_count;
     int list[2][C128_MAX] = {{0}};
     char set[C128_MAX] = {0}, mode, last_set;
     float glyph_count;
-    char dest[1000];
-    int separator_row, linkage_flag, c_count;
-    int reduced_length;
-#ifndef _MSC_VER
-    char reduced[length + 1];
-#else
-    char* reduced = (char*) _alloca(length + 1);
-#endif
-
-    strcpy(dest, "");
-    linkage_flag = 0;
 
     bar_characters = 0;
-    separator_row = 0;
-
-    if (length > C128_MAX) {
-        /* This only blocks ridiculously long input - the actual length of the
-        resulting barcode depends on the type of data, so this is trapped later */
-        strcpy(symbol->errtxt, "342: Input too long");
-        return ZINT_ERROR_TOO_LONG;
-    }
-
-    /* if part of a composite symbol make room for the separator pattern */
-    if (symbol->symbology == BARCODE_GS1_128_CC) {
-        separator_row = symbol->rows;
-        symbol->row_height[symbol->rows] = 1;
-        symbol->rows += 1;
-    }
-
-    error_number = gs1_verify(symbol, source, length, reduced);
-    if (error_number != 0) {
-        return error_number;
-    }
-    reduced_length = strlen(reduced);
 
     /* Decide on mode using same system as PDF417 and rules of ISO 15417 Annex E */
     indexliste = 0;
@@ -858,21 +1026,17 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
     /* So now we know what start character to use - we can get on with it! */
     switch (set[0]) {
         case 'A': /* Start A */
-            strcat(dest, C128Table[103]);
             values[0] = 103;
             break;
         case 'B': /* Start B */
-            strcat(dest, C128Table[104]);
             values[0] = 104;
             break;
         case 'C': /* Start C */
-            strcat(dest, C128Table[105]);
             values[0] = 105;
             break;
     }
     bar_characters++;
 
-    strcat(dest, C128Table[102]);
     values[1] = 102;
     bar_characters++;
 
@@ -882,16 +1046,13 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
 
         if ((read != 0) && (set[read] != set[read - 1])) { /* Latch different code set */
             switch (set[read]) {
-                case 'A': strcat(dest, C128Table[101]);
-                    values[bar_characters] = 101;
+                case 'A': values[bar_characters] = 101;
                     bar_characters++;
                     break;
-                case 'B': strcat(dest, C128Table[100]);
-                    values[bar_characters] = 100;
+                case 'B': values[bar_characters] = 100;
                     bar_characters++;
                     break;
-                case 'C': strcat(dest, C128Table[99]);
-                    values[bar_characters] = 99;
+                case 'C': values[bar_characters] = 99;
                     bar_characters++;
                     break;
             }
@@ -899,7 +1060,6 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
 
         if ((set[read] == 'a') || (set[read] == 'b')) {
             /* Insert shift character */
-            strcat(dest, C128Table[98]);
             values[bar_characters] = 98;
             bar_characters++;
         }
@@ -908,26 +1068,77 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
             switch (set[read]) { /* Encode data characters */
                 case 'A':
                 case 'a':
-                    c128_set_a(reduced[read], dest, values, &bar_characters);
+                    c128_set_a(reduced[read], values, &bar_characters);
                     read++;
                     break;
                 case 'B':
                 case 'b':
-                    c128_set_b(reduced[read], dest, values, &bar_characters);
+                    c128_set_b(reduced[read], values, &bar_characters);
                     read++;
                     break;
                 case 'C':
-                    c128_set_c(reduced[read], reduced[read + 1], dest, values, &bar_characters);
+                    c128_set_c(reduced[read], reduced[read + 1], values, &bar_characters);
                     read += 2;
                     break;
             }
         } else {
-            strcat(dest, C128Table[102]);
             values[bar_characters] = 102;
             bar_characters++;
             read++;
         }
     } while (read < reduced_length);
+    *p_last_set = set[reduced_length - 1];
+
+    *p_bar_characters = bar_characters;
+    return 0;
+}
+
+/* Handle EAN-128 (Now known as GS1-128) */
+INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const size_t length) {
+    int i, values[C128_MAX] = {0}, bar_characters, total_sum;
+    int error_number;
+    char last_set;
+    int separator_row, linkage_flag;
+    int reduced_length;
+    char reduced[C128_MAX + 1];
+
+    linkage_flag = 0;
+
+    bar_characters = 0;
+    separator_row = 0;
+
+    if (length > C128_MAX) {
+        /* This only blocks ridiculously long input - the actual length of the
+        resulting barcode depends on the type of data, so this is trapped later */
+        strcpy(symbol->errtxt, "342: Input too long");
+        return ZINT_ERROR_TOO_LONG;
+    }
+
+    /* if part of a composite symbol make room for the separator pattern */
+    if (symbol->symbology == BARCODE_GS1_128_CC) {
+        separator_row = symbol->rows;
+        symbol->row_height[symbol->rows] = 1;
+        symbol->rows += 1;
+    }
+
+    error_number = gs1_verify(symbol, source, length, reduced);
+    if (error_number != 0) {
+        return error_number;
+    }
+    reduced_length = strlen(reduced);
+
+    if (symbol->option_3 == C128_OPTIMAL) {
+        if (c128_minimal(symbol, (const unsigned char *) reduced, reduced_length, 1 /*gs1*/, values, &bar_characters,
+                &last_set) > 60) {
+            strcpy(symbol->errtxt, "344: Input too long");
+            return ZINT_ERROR_TOO_LONG;
+        }
+    } else {
+        error_number = gs1_128_annex_e(symbol, reduced, reduced_length, values, &bar_characters, &last_set);
+        if (error_number != 0) {
+            return error_number;
+        }
+    }
 
     /* "...note that the linkage flag is an extra code set character between
     the last data character and the Symbol Check Character" (GS1 Specification) */
@@ -938,7 +1149,7 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
         case 1:
         case 2:
             /* CC-A or CC-B 2D component */
-            switch (set[reduced_length - 1]) {
+            switch (last_set) {
                 case 'A': linkage_flag = 100;
                     break;
                 case 'B': linkage_flag = 99;
@@ -949,7 +1160,7 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
             break;
         case 3:
             /* CC-C 2D component */
-            switch (set[reduced_length - 1]) {
+            switch (last_set) {
                 case 'A': linkage_flag = 99;
                     break;
                 case 'B': linkage_flag = 101;
@@ -961,7 +1172,6 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
     }
 
     if (linkage_flag != 0) {
-        strcat(dest, C128Table[linkage_flag]);
         values[bar_characters] = linkage_flag;
         bar_characters++;
     }
@@ -972,12 +1182,10 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
     for (i = 1; i < bar_characters; i++) {
         total_sum = (total_sum + values[i] * i) % 103;
     }
-    strcat(dest, C128Table[total_sum]);
     values[bar_characters] = total_sum;
     bar_characters++;
 
     /* Stop character */
-    strcat(dest, C128Table[106]);
     values[bar_characters] = 106;
     bar_characters++;
 
@@ -987,7 +1195,11 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
             printf(" %d", values[i]);
         }
         printf(" (%d)\n", bar_characters);
-        printf("Barspaces: %s\n", dest);
+        printf("Barspaces: ");
+        for (i = 0; i < bar_characters; i++) {
+            fputs(C128Table[values[i]], stdout);
+        }
+        fputc('\n', stdout);
     }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) {
@@ -995,7 +1207,7 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], const s
     }
 #endif
 
-    expand(symbol, dest);
+    c128_expand(symbol, values, bar_characters);
 
     /* Add the separator pattern for composite symbols */
     if (symbol->symbology == BARCODE_GS1_128_CC) {
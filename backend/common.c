@@ -95,18 +95,15 @@ INTERNAL void to_upper(unsigned char source[]) {
 
 /* Verifies that a string only uses valid characters */
 INTERNAL int is_sane(const char test_string[], const unsigned char source[], const size_t length) {
-    unsigned int j;
-    size_t i, lt = strlen(test_string);
+    unsigned char set[32] = {0}; /* Bitmap of the 256 byte values, set if in `test_string` */
+    const unsigned char *ts;
+    size_t i;
 
+    for (ts = (const unsigned char *) test_string; *ts; ts++) {
+        set[*ts >> 3] |= 1 << (*ts & 0x07);
+    }
     for (i = 0; i < length; i++) {
-        unsigned int latch = FALSE;
-        for (j = 0; j < lt; j++) {
-            if (source[i] == test_string[j]) {
-                latch = TRUE;
-                break;
-            }
-        }
-        if (!(latch)) {
+        if (!(set[source[i] >> 3] & (1 << (source[i] & 0x07)))) {
             return ZINT_ERROR_INVALID_DATA;
         }
     }
@@ -114,16 +111,24 @@ INTERNAL int is_sane(const char test_string[], const unsigned char source[], con
     return 0;
 }
 
-/* Replaces huge switch statements for looking up in tables */
-INTERNAL void lookup(const char set_string[], const char *table[], const char data, char dest[]) {
-    int i, n = (int) strlen(set_string);
+/* Verifies that a string only uses valid characters, and sets `posns[]` to the position of each in `test_string`,
+   so that width tables indexed by position can be used directly */
+INTERNAL int is_sane_lookup(const char test_string[], const int test_length, const unsigned char source[],
+            const int length, int *posns) {
+    signed char lut[256]; /* Direct byte value to `test_string` position, -1 if not present */
+    int i;
 
-    for (i = 0; i < n; i++) {
-        if (data == set_string[i]) {
-            strcat(dest, table[i]);
-            break;
+    memset(lut, -1, sizeof(lut));
+    for (i = 0; i < test_length; i++) {
+        lut[(unsigned char) test_string[i]] = (signed char) i;
+    }
+    for (i = 0; i < length; i++) {
+        if ((posns[i] = lut[source[i]]) < 0) {
+            return ZINT_ERROR_INVALID_DATA;
         }
     }
+
+    return 0;
 }
 
 /* Returns the position of data in set_string */
@@ -165,25 +170,27 @@ INTERNAL void unset_module(struct zint_symbol *symbol, const int y_coord, const
     symbol->encoded_data[y_coord][x_coord >> 3] &= ~(1 << (x_coord & 0x07));
 }
 
-/* Expands from a width pattern to a bit pattern */
-INTERNAL void expand(struct zint_symbol *symbol, const char data[]) {
-
-    int reader, n = (int) strlen(data);
-    int writer, i;
-    int latch, num;
-
-    writer = 0;
-    latch = 1;
-
-    for (reader = 0; reader < n; reader++) {
-        num = ctoi(data[reader]);
-        for (i = 0; i < num; i++) {
-            if (latch) {
-                set_module(symbol, symbol->rows, writer);
+/* Expands from a width pattern of `length` digits to a bit pattern, setting each dark run a byte at a time */
+INTERNAL void expand(struct zint_symbol *symbol, const char data[], const int length) {
+
+    unsigned char *row = symbol->encoded_data[symbol->rows];
+    int reader;
+    int writer = 0;
+    int latch = 1;
+
+    for (reader = 0; reader < length; reader++) {
+        const int num = ctoi(data[reader]);
+        if (latch && num > 0) {
+            int x = writer;
+            const int end = writer + num;
+            while (x < end) {
+                const int bit = x & 0x07;
+                const int n = end - x < 8 - bit ? end - x : 8 - bit; /* Modules in this byte */
+                row[x >> 3] |= ((1 << n) - 1) << bit;
+                x += n;
             }
-            writer++;
         }
-
+        writer += num;
         latch = !latch;
     }
 
@@ -407,6 +414,46 @@ INTERNAL int colour_to_blue(int colour) {
     return return_val;
 }
 
+/* Allocate `size` bytes using `symbol`'s allocator (see `ZBarcode_SetAllocator()`), or the system's if none set
+   or `symbol` NULL */
+INTERNAL void *z_malloc(const struct zint_symbol *symbol, const size_t size) {
+    if (symbol && symbol->allocator.malloc_fn) {
+        return symbol->allocator.malloc_fn(symbol->allocator.context, size);
+    }
+    return malloc(size);
+}
+
+/* As `z_malloc()` but zeroed */
+INTERNAL void *z_calloc(const struct zint_symbol *symbol, const size_t size) {
+    void *ptr;
+    if (symbol && symbol->allocator.malloc_fn) {
+        if ((ptr = symbol->allocator.malloc_fn(symbol->allocator.context, size))) {
+            memset(ptr, 0, size);
+        }
+        return ptr;
+    }
+    return calloc(1, size);
+}
+
+/* Resize `ptr` (which may be NULL) got from `z_malloc()` or `z_calloc()` */
+INTERNAL void *z_realloc(const struct zint_symbol *symbol, void *ptr, const size_t size) {
+    if (symbol && symbol->allocator.realloc_fn) {
+        return symbol->allocator.realloc_fn(symbol->allocator.context, ptr, size);
+    }
+    return realloc(ptr, size);
+}
+
+/* Free `ptr` (which may be NULL) got from `z_malloc()`, `z_calloc()` or `z_realloc()` */
+INTERNAL void z_free(const struct zint_symbol *symbol, void *ptr) {
+    if (ptr) {
+        if (symbol && symbol->allocator.free_fn) {
+            symbol->allocator.free_fn(symbol->allocator.context, ptr);
+        } else {
+            free(ptr);
+        }
+    }
+}
+
 #ifdef ZINT_TEST
 /* Dumps hex-formatted codewords in symbol->errtxt (for use in testing) */
 void debug_test_codeword_dump(struct zint_symbol *symbol, unsigned char *codewords, int length) {
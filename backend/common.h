@@ -92,7 +92,8 @@ extern "C" {
     INTERNAL char itoc(const int source);
     INTERNAL void to_upper(unsigned char source[]);
     INTERNAL int is_sane(const char test_string[], const unsigned char source[], const size_t length);
-    INTERNAL void lookup(const char set_string[], const char *table[], const char data, char dest[]);
+    INTERNAL int is_sane_lookup(const char test_string[], const int test_length, const unsigned char source[],
+                const int length, int *posns);
     INTERNAL void bin_append(const int arg, const int length, char *binary);
     INTERNAL int bin_append_posn(const int arg, const int length, char *binary, int posn);
     INTERNAL int posn(const char set_string[], const char data);
@@ -103,7 +104,7 @@ extern "C" {
     INTERNAL void set_module_colour(struct zint_symbol *symbol, const int y_coord, const int x_coord, const int colour);
     #endif
     INTERNAL void unset_module(struct zint_symbol *symbol, const int y_coord, const int x_coord);
-    INTERNAL void expand(struct zint_symbol *symbol, const char data[]);
+    INTERNAL void expand(struct zint_symbol *symbol, const char data[], const int length);
     INTERNAL int is_stackable(const int symbology);
     INTERNAL int is_extendable(const int symbology);
     INTERNAL int is_composite(const int symbology);
@@ -117,6 +118,11 @@ extern "C" {
     INTERNAL int colour_to_green(int colour);
     INTERNAL int colour_to_blue(int colour);
 
+    INTERNAL void *z_malloc(const struct zint_symbol *symbol, const size_t size);
+    INTERNAL void *z_calloc(const struct zint_symbol *symbol, const size_t size);
+    INTERNAL void *z_realloc(const struct zint_symbol *symbol, void *ptr, const size_t size);
+    INTERNAL void z_free(const struct zint_symbol *symbol, void *ptr);
+
     #ifdef ZINT_TEST
     void debug_test_codeword_dump(struct zint_symbol *symbol, unsigned char *codewords, int length);
     void debug_test_codeword_dump_int(struct zint_symbol *symbol, int *codewords, int length);
@@ -52,10 +52,8 @@
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "pdf417.h"
 #include "gs1.h"
 #include "general_field.h"
@@ -113,10 +111,9 @@ static int cc_a(struct zint_symbol *symbol, char source[], int cc_width) {
     int k, offset, j, total, rsCodeWords[8];
     int LeftRAPStart, RightRAPStart, CentreRAPStart, StartCluster;
     int LeftRAP, RightRAP, CentreRAP, Cluster, dummy[5];
-    int loop;
+    int p;
     UINT codeWords[28];
     UINT bitStr[13];
-    char pattern[580];
     char local_source[210]; /* A copy of source but with padding zeroes to make 208 bits */
 
     variant = 0;
@@ -242,7 +239,7 @@ static int cc_a(struct zint_symbol *symbol, char source[], int cc_width) {
     Cluster = StartCluster; /* Cluster can be 0, 1 or 2 for Cluster(0), Cluster(3) and Cluster(6) */
 
     for (i = 0; i < rows; i++) {
-        strcpy(pattern, "");
+        p = 0;
         offset = 929 * Cluster;
         for (j = 0; j < 5; j++) {
             dummy[j] = 0;
@@ -252,40 +249,31 @@ static int cc_a(struct zint_symbol *symbol, char source[], int cc_width) {
         }
         /* Copy the data into codebarre */
         if (cc_width != 3) {
-            bin_append(rap_side[LeftRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_side[LeftRAP - 1], 10, p);
         }
-        bin_append(pdf_bitpattern[offset + dummy[1]], 16, pattern);
-        strcat(pattern, "0");
+        p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[1]], 16, p) + 1;
         if (cc_width == 3) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (cc_width >= 2) {
-            bin_append(pdf_bitpattern[offset + dummy[2]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[2]], 16, p) + 1;
         }
         if (cc_width == 4) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (cc_width >= 3) {
-            bin_append(pdf_bitpattern[offset + dummy[3]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[3]], 16, p) + 1;
         }
         if (cc_width == 4) {
-            bin_append(pdf_bitpattern[offset + dummy[4]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[4]], 16, p) + 1;
         }
-        bin_append(rap_side[RightRAP - 1], 10, pattern);
-        strcat(pattern, "1"); /* stop */
+        p = pdf_set_modules(symbol, i, rap_side[RightRAP - 1], 10, p);
+        set_module(symbol, i, p); /* stop */
+        p++;
 
-        /* so now pattern[] holds the string of '1's and '0's. - copy this to the symbol */
-        for (loop = 0; loop < (int) strlen(pattern); loop++) {
-            if (pattern[loop] == '1') {
-                set_module(symbol, i, loop);
-            }
-        }
         symbol->row_height[i] = 2;
         symbol->rows++;
-        symbol->width = strlen(pattern);
+        symbol->width = p;
 
         /* Set up RAPs and Cluster for next row */
         LeftRAP++;
@@ -317,19 +305,19 @@ static int cc_a(struct zint_symbol *symbol, char source[], int cc_width) {
 /* CC-B 2D component */
 static int cc_b(struct zint_symbol *symbol, char source[], int cc_width) {
     int length, i;
-#ifndef _MSC_VER
-    unsigned char data_string[(strlen(source) / 8) + 3];
-#else
-    unsigned char *data_string = (unsigned char *) _alloca((strlen(source) / 8) + 3);
-#endif
+    unsigned char *data_string = (unsigned char *) scratch_alloc(symbol, (strlen(source) / 8) + 3);
     int chainemc[180], mclength;
     int k, j, p, longueur, mccorrection[50], offset;
     int total, dummy[5];
-    char pattern[580];
     int variant, LeftRAPStart, CentreRAPStart, RightRAPStart, StartCluster;
     int LeftRAP, CentreRAP, RightRAP, Cluster, loop;
     int columns;
 
+    if (!data_string) {
+        strcpy(symbol->errtxt, "448: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+
     length = strlen(source) / 8;
 
     for (i = 0; i < length; i++) {
@@ -502,7 +490,6 @@ static int cc_b(struct zint_symbol *symbol, char source[], int cc_width) {
     /* Cluster can be 0, 1 or 2 for Cluster(0), Cluster(3) and Cluster(6) */
 
     for (i = 0; i < symbol->rows; i++) {
-        strcpy(pattern, "");
         offset = 929 * Cluster;
         for (j = 0; j < 5; j++) {
             dummy[j] = 0;
@@ -511,38 +498,29 @@ static int cc_b(struct zint_symbol *symbol, char source[], int cc_width) {
             dummy[j + 1] = chainemc[i * columns + j];
         }
         /* Copy the data into codebarre */
-        bin_append(rap_side[LeftRAP - 1], 10, pattern);
-        bin_append(pdf_bitpattern[offset + dummy[1]], 16, pattern);
-        strcat(pattern, "0");
+        p = pdf_set_modules(symbol, i, rap_side[LeftRAP - 1], 10, 0);
+        p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[1]], 16, p) + 1;
         if (cc_width == 3) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (cc_width >= 2) {
-            bin_append(pdf_bitpattern[offset + dummy[2]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[2]], 16, p) + 1;
         }
         if (cc_width == 4) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (cc_width >= 3) {
-            bin_append(pdf_bitpattern[offset + dummy[3]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[3]], 16, p) + 1;
         }
         if (cc_width == 4) {
-            bin_append(pdf_bitpattern[offset + dummy[4]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[4]], 16, p) + 1;
         }
-        bin_append(rap_side[RightRAP - 1], 10, pattern);
-        strcat(pattern, "1"); /* stop */
+        p = pdf_set_modules(symbol, i, rap_side[RightRAP - 1], 10, p);
+        set_module(symbol, i, p); /* stop */
+        p++;
 
-        /* so now pattern[] holds the string of '1's and '0's. - copy this to the symbol */
-        for (loop = 0; loop < (int) strlen(pattern); loop++) {
-            if (pattern[loop] == '1') {
-                set_module(symbol, i, loop);
-            }
-        }
         symbol->row_height[i] = 2;
-        symbol->width = strlen(pattern);
+        symbol->width = p;
 
         /* Set up RAPs and Cluster for next row */
         LeftRAP++;
@@ -574,15 +552,15 @@ static int cc_b(struct zint_symbol *symbol, char source[], int cc_width) {
 /* CC-C 2D component - byte compressed PDF417 */
 static int cc_c(struct zint_symbol *symbol, char source[], int cc_width, int ecc_level) {
     int length, i, p;
-#ifndef _MSC_VER
-    unsigned char data_string[(strlen(source) / 8) + 4];
-#else
-    unsigned char *data_string = (unsigned char *) _alloca((strlen(source) / 8) + 4);
-#endif
+    unsigned char *data_string = (unsigned char *) scratch_alloc(symbol, (strlen(source) / 8) + 4);
     int chainemc[1000], mclength, k;
     int offset, longueur, loop, total, j, mccorrection[520];
     int c1, c2, c3, dummy[35];
-    char pattern[580];
+
+    if (!data_string) {
+        strcpy(symbol->errtxt, "448: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     length = strlen(source) / 8;
 
@@ -689,24 +667,17 @@ static int cc_c(struct zint_symbol *symbol, char source[], int cc_width, int ecc
                 offset = 1858; /* cluster(6) */
                 break;
         }
-        strcpy(pattern, "");
-        bin_append(0x1FEA8, 17, pattern); /* Row start */
+        p = pdf_set_modules(symbol, i, 0x1FEA8, 17, 0); /* Row start */
 
         for (j = 0; j <= cc_width + 1; j++) {
-            bin_append(pdf_bitpattern[offset + dummy[j]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[j]], 16, p) + 1;
         }
-        bin_append(0x3FA29, 18, pattern); /* Row Stop */
+        p = pdf_set_modules(symbol, i, 0x3FA29, 18, p); /* Row Stop */
 
-        for (loop = 0; loop < (int) strlen(pattern); loop++) {
-            if (pattern[loop] == '1') {
-                set_module(symbol, i, loop);
-            }
-        }
         symbol->row_height[i] = 3;
     }
     symbol->rows = (mclength / cc_width);
-    symbol->width = (int)strlen(pattern);
+    symbol->width = p;
 
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("CC-C Columns: %d, Rows: %d\n", cc_width, symbol->rows);
@@ -952,14 +923,17 @@ static int cc_binary_string(struct zint_symbol *symbol, const char source[], cha
     int ai90_mode, last_digit, remainder, binary_length;
     int mode;
     int source_len = strlen(source);
-#ifndef _MSC_VER
-    char general_field[source_len + 1];
-#else
-    char *general_field = (char *) _alloca(source_len + 1);
-#endif
+    const size_t mark = scratch_mark(symbol); /* May be called up to 3 times */
+    char *general_field = (char *) scratch_alloc(symbol, source_len + 1);
+    char *ninety = (char *) scratch_alloc(symbol, source_len + 1);
     int target_bitsize;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
 
+    if (!general_field || !ninety) {
+        strcpy(symbol->errtxt, "448: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+
     encoding_method = 1;
     read_posn = 0;
     ai_crop = 0;
@@ -1042,11 +1016,6 @@ static int cc_binary_string(struct zint_symbol *symbol, const char source[], cha
 
     if (encoding_method == 3) {
         /* Encodation Method field of "11" - AI 90 */
-#ifndef _MSC_VER
-        char ninety[source_len + 1];
-#else
-        char *ninety = (char *) _alloca(source_len + 1);
-#endif
         int ninety_len, alpha, alphanum, numeric, test1, test2, test3;
 
         /* "This encodation method may be used if an element string with an AI
@@ -1261,6 +1230,7 @@ static int cc_binary_string(struct zint_symbol *symbol, const char source[], cha
         strcpy(symbol->errtxt, "441: Invalid characters in input data");
         return ZINT_ERROR_INVALID_DATA;
     }
+    scratch_release(symbol, mark);
 
     binary_length = (int)strlen(binary_string);
     switch (cc_mode) {
@@ -1349,18 +1319,20 @@ static int cc_binary_string(struct zint_symbol *symbol, const char source[], cha
     return 0;
 }
 
-static int linear_dummy_run(unsigned char *source, int length, char *errtxt) {
+static int linear_dummy_run(struct zint_symbol *symbol, unsigned char *source, int length) {
     struct zint_symbol *dummy;
     int error_number;
     int linear_width;
 
     dummy = ZBarcode_Create();
+    dummy->allocator = symbol->allocator;
     dummy->symbology = BARCODE_GS1_128_CC;
     dummy->option_1 = 3;
+    dummy->option_3 = symbol->option_3;
     error_number = ean_128(dummy, source, length);
     linear_width = dummy->width;
     if (error_number != 0) {
-        strcpy(errtxt, dummy->errtxt);
+        strcpy(symbol->errtxt, dummy->errtxt);
     }
     ZBarcode_Delete(dummy);
 
@@ -1375,16 +1347,17 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
     int error_number, cc_mode, cc_width, ecc_level;
     int j, i, k;
     unsigned int bs = 13 * length + 500 + 1; /* Allow for 8 bits + 5-bit latch per char + 500 bits overhead/padding */
-#ifndef _MSC_VER
-    char binary_string[bs];
-#else
-    char *binary_string = (char *) _alloca(bs);
-#endif
+    char *binary_string = (char *) scratch_alloc(symbol, bs);
     unsigned int pri_len;
     struct zint_symbol *linear;
     int top_shift, bottom_shift;
     int linear_width = 0;
 
+    if (!binary_string) {
+        strcpy(symbol->errtxt, "448: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+
     /* Perform sanity checks on input options first */
     error_number = 0;
     pri_len = (int)strlen(symbol->primary);
@@ -1407,7 +1380,7 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
 
     if (symbol->symbology == BARCODE_GS1_128_CC) {
         /* Do a test run of encoding the linear component to establish its width */
-        linear_width = linear_dummy_run((unsigned char *) symbol->primary, pri_len, symbol->errtxt);
+        linear_width = linear_dummy_run(symbol, (unsigned char *) symbol->primary, pri_len);
         if (linear_width == 0) {
             strcat(symbol->errtxt, " in linear component");
             return ZINT_ERROR_INVALID_DATA;
@@ -1527,6 +1500,7 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
 
     /* 2D component done, now calculate linear component */
     linear = ZBarcode_Create(); /* Symbol contains the 2D component and Linear contains the rest */
+    linear->allocator = symbol->allocator;
 
     linear->symbology = symbol->symbology;
     linear->option_2 = symbol->option_2;
@@ -1538,6 +1512,7 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
     } else {
         /* GS1-128 needs to know which type of 2D component is used */
         linear->option_1 = cc_mode;
+        linear->option_3 = symbol->option_3;
     }
 
     switch (symbol->symbology) {
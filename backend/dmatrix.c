@@ -43,13 +43,13 @@
 #include <assert.h>
 #include <math.h>
 #ifdef _MSC_VER
-#include <malloc.h>
 /* ceilf (C99) not before MSVC++2013 (C++ 12.0) */
 #if _MSC_VER < 1800
 #define ceilf ceil
 #endif
 #endif
 #include "common.h"
+#include "scratch.h"
 #include "reedsol.h"
 #include "dmatrix.h"
 
@@ -535,11 +535,13 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
     int current_mode, next_mode;
     size_t inputlen = *length_p;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
-#ifndef _MSC_VER
-    char binary[2 * inputlen + 1 + 4 + 1]; /* Allow for GS1/READER_INIT, ECI and nul chars overhead */
-#else
-    char* binary = (char*) _alloca(2 * inputlen + 1 + 4 + 1);
-#endif
+    /* Allow for GS1/READER_INIT, ECI and nul chars overhead */
+    char *binary = (char *) scratch_alloc(symbol, 2 * inputlen + 1 + 4 + 1);
+
+    if (!binary) {
+        strcpy(symbol->errtxt, "529: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     sp = 0;
     tp = 0;
@@ -1290,9 +1292,9 @@ static int data_matrix_200(struct zint_symbol *symbol,const unsigned char source
         unsigned char *grid;
         NC = W - 2 * (W / FW);
         NR = H - 2 * (H / FH);
-        places = (int *) malloc(sizeof(int) * NC * NR);
+        places = (int *) z_malloc(symbol, sizeof(int) * NC * NR);
         ecc200placement(places, NR, NC);
-        grid = (unsigned char *) malloc((size_t) W * H);
+        grid = (unsigned char *) z_malloc(symbol, (size_t) W * H);
         memset(grid, 0, W * H);
         for (y = 0; y < H; y += FH) {
             for (x = 0; x < W; x++)
@@ -1336,8 +1338,8 @@ static int data_matrix_200(struct zint_symbol *symbol,const unsigned char source
             }
             symbol->row_height[(H - y) - 1] = 1;
         }
-        free(grid);
-        free(places);
+        z_free(symbol, grid);
+        z_free(symbol, places);
     }
 
     symbol->rows = H;
@@ -43,10 +43,11 @@
 #include <stdint.h>
 #else
 #include "ms_stdint.h"
-#include <malloc.h>
 #endif
 #include "common.h"
+#include "scratch.h"
 #include "gs1.h"
+#include "parallel.h"
 
 #define GF 113
 #define PM 3
@@ -68,51 +69,22 @@ static const unsigned short int dot_patterns[113] = {
     0x1b8, 0x1c6, 0x1cc
 };
 
-// Printed() routine from Annex A adapted to char array of ASCII 1's and 0's
-static int get_dot(char Dots[], const int Hgt, const int Wid, const int x, const int y) {
-    int retval = 0;
-
-    if ((x >= 0) && (x < Wid) && (y >= 0) && (y < Hgt)) {
-        if (Dots[(y * Wid) + x] == '1') {
-            retval = 1;
-        }
-    }
-
-    return retval;
-}
-
-static int clr_col(char *Dots, const int Hgt, const int Wid, const int x) {
-    int y;
-    for (y = x & 1; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, y)) {
-            return 0;
-        }
-    }
-
-    return 1;
-}
-
-static int clr_row(char *Dots, const int Hgt, const int Wid, const int y) {
-    int x;
-    for (x = y & 1; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, y)) {
-            return 0;
-        }
-    }
+/* Dots are held one per byte (0 or 1) in a grid with a border of 2 unprinted dots all round, so that the
+   neighbours of any dot may be examined without bounds checking */
+#define DOT_BORDER          2
+#define DOT_STRIDE(Wid)     ((Wid) + DOT_BORDER * 2)
+#define DOT_IDX(Wid, x, y)  (((y) + DOT_BORDER) * DOT_STRIDE(Wid) + (x) + DOT_BORDER)
 
-    return 1;
-}
-
-// calc penalty for empty interior columns
-static int col_penalty(char *Dots, int Hgt, int Wid) {
-    int x, penalty = 0, penalty_local = 0;
+// calc penalty for runs of empty interior rows/columns, given the count of printed dots in each
+static int line_penalty(const int counts[], const int lines, const int positions) {
+    int i, penalty = 0, penalty_local = 0;
 
-    for (x = 1; x < Wid - 1; x++) {
-        if (clr_col(Dots, Hgt, Wid, x)) {
+    for (i = 1; i < lines - 1; i++) {
+        if (counts[i] == 0) {
             if (penalty_local == 0) {
-                penalty_local = Hgt;
+                penalty_local = positions;
             } else {
-                penalty_local *= Hgt;
+                penalty_local *= positions;
             }
         } else {
             if (penalty_local) {
@@ -125,38 +97,31 @@ static int col_penalty(char *Dots, int Hgt, int Wid) {
     return penalty + penalty_local;
 }
 
-// calc penalty for empty interior rows
-static int row_penalty(char *Dots, int Hgt, int Wid) {
-    int y, penalty = 0, penalty_local = 0;
+/* Dot pattern scoring routine from Annex A, `Dots` as set by `place_dots()` */
+static int score_array(const unsigned char Dots[], const int Hgt, const int Wid, int row_counts[],
+            int col_counts[]) {
+    const int stride = DOT_STRIDE(Wid);
+    int x, y, worstedge, first, last, sum;
+    int penalty = 0;
 
-    for (y = 1; y < Hgt - 1; y++) {
-        if (clr_row(Dots, Hgt, Wid, y)) {
-            if (penalty_local == 0) {
-                penalty_local = Wid;
-            } else {
-                penalty_local *= Wid;
-            }
-        } else {
-            if (penalty_local) {
-                penalty += penalty_local;
-                penalty_local = 0;
+    // count the printed dots in each row and column (non-data positions are never printed)
+    memset(col_counts, 0, sizeof(int) * Wid);
+    for (y = 0; y < Hgt; y++) {
+        const unsigned char *row = Dots + DOT_IDX(Wid, 0, y);
+        row_counts[y] = 0;
+        for (x = y & 1; x < Wid; x += 2) {
+            if (row[x]) {
+                row_counts[y]++;
+                col_counts[x]++;
             }
         }
     }
 
-    return penalty + penalty_local;
-}
-
-/* Dot pattern scoring routine from Annex A */
-static int score_array(char Dots[], int Hgt, int Wid) {
-    int x, y, worstedge, first, last, sum;
-    int penalty = 0;
-
     // first, guard against "pathelogical" gaps in the array
     // subtract a penalty score for empty rows/columns from total code score for each mask,
     // where the penalty is Sum(N ^ n), where N is the number of positions in a column/row,
     // and n is the number of consecutive empty rows/columns
-    penalty = row_penalty(Dots, Hgt, Wid) + col_penalty(Dots, Hgt, Wid);
+    penalty = line_penalty(row_counts, Hgt, Wid) + line_penalty(col_counts, Wid, Hgt);
 
     sum = 0;
     first = -1;
@@ -164,7 +129,7 @@ static int score_array(char Dots[], int Hgt, int Wid) {
 
     // across the top edge, count printed dots and measure their extent
     for (x = 0; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, 0)) {
+        if (Dots[DOT_IDX(Wid, x, 0)]) {
             if (first < 0) {
                 first = x;
             }
@@ -185,7 +150,7 @@ static int score_array(char Dots[], int Hgt, int Wid) {
 
     // across the bottom edge, ditto
     for (x = Wid & 1; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, Hgt - 1)) {
+        if (Dots[DOT_IDX(Wid, x, Hgt - 1)]) {
             if (first < 0) {
                 first = x;
             }
@@ -209,7 +174,7 @@ static int score_array(char Dots[], int Hgt, int Wid) {
 
     // down the left edge, ditto
     for (y = 0; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, 0, y)) {
+        if (Dots[DOT_IDX(Wid, 0, y)]) {
             if (first < 0) {
                 first = y;
             }
@@ -233,7 +198,7 @@ static int score_array(char Dots[], int Hgt, int Wid) {
 
     // down the right edge, ditto
     for (y = Hgt & 1; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, Wid - 1, y)) {
+        if (Dots[DOT_IDX(Wid, Wid - 1, y)]) {
             if (first < 0) {
                 first = y;
             }
@@ -255,16 +220,10 @@ static int score_array(char Dots[], int Hgt, int Wid) {
     // plus the # of printed dots surrounded by 8 unprinted neighbors
     sum = 0;
     for (y = 0; y < Hgt; y++) {
-        for (x = y & 1; x < Wid; x += 2) {
-            if ((!get_dot(Dots, Hgt, Wid, x - 1, y - 1))
-                    && (!get_dot(Dots, Hgt, Wid, x + 1, y - 1))
-                    && (!get_dot(Dots, Hgt, Wid, x - 1, y + 1))
-                    && (!get_dot(Dots, Hgt, Wid, x + 1, y + 1))
-                    && ((!get_dot(Dots, Hgt, Wid, x, y))
-                    || ((!get_dot(Dots, Hgt, Wid, x - 2, y))
-                    && (!get_dot(Dots, Hgt, Wid, x, y - 2))
-                    && (!get_dot(Dots, Hgt, Wid, x + 2, y))
-                    && (!get_dot(Dots, Hgt, Wid, x, y + 2))))) {
+        const unsigned char *dot = Dots + DOT_IDX(Wid, y & 1, y);
+        for (x = y & 1; x < Wid; x += 2, dot += 2) {
+            if (!(dot[-stride - 1] | dot[-stride + 1] | dot[stride - 1] | dot[stride + 1])
+                    && (!dot[0] || !(dot[-2] | dot[-2 * stride] | dot[2] | dot[2 * stride]))) {
                 sum++;
             }
         }
@@ -280,7 +239,7 @@ static int score_array(char Dots[], int Hgt, int Wid) {
 
 static void rsencode(int nd, int nc, unsigned char *wd) {
     // roots (antilogs): root[0] = 1; for (i = 1; i < GF - 1; i++) root[i] = (PM * root[i - 1]) % GF;
-    static int root[GF - 1] = {
+    static const int root[GF - 1] = {
           1,   3,   9,  27,  81,  17,  51,  40,   7,  21,
          63,  76,   2,   6,  18,  54,  49,  34, 102,  80,
          14,  42,  13,  39,   4,  12,  36, 108,  98,  68,
@@ -480,7 +439,7 @@ static int binary(const unsigned char source[], int length, int position) {
 
 /* Analyse input data stream and encode using algorithm from Annex F */
 static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned char source[], int length, unsigned char *codeword_array, int *binary_finish) {
-    static char lead_specials[] = "\x09\x1C\x1D\x1E"; // HT, FS, GS, RS
+    static const char lead_specials[] = "\x09\x1C\x1D\x1E"; // HT, FS, GS, RS
 
     int input_position, array_length, i;
     char encoding_mode;
@@ -1115,23 +1074,6 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
     return array_length;
 }
 
-/* Convert codewords to binary data stream */
-static size_t make_dotstream(unsigned char masked_array[], int array_length, char dot_stream[]) {
-    int i;
-
-    dot_stream[0] = '\0';
-
-    /* Mask value is encoded as two dots */
-    bin_append(masked_array[0], 2, dot_stream);
-
-    /* The rest of the data uses 9-bit dot patterns from Annex C */
-    for (i = 1; i < array_length; i++) {
-        bin_append(dot_patterns[masked_array[i]], 9, dot_stream);
-    }
-
-    return strlen(dot_stream);
-}
-
 /* Determines if a given dot is a reserved corner dot
  * to be used by one of the last six bits
  */
@@ -1176,73 +1118,74 @@ static int is_corner(int column, int row, int width, int height) {
     return corner;
 }
 
-/* Place the dots in the symbol*/
-static void fold_dotstream(char dot_stream[], int width, int height, char dot_array[]) {
+/* Calculate the grid position (as `DOT_IDX()`) of each dot of the data stream, i.e. the fold of the stream
+   into the symbol, so that it need only be worked out once per symbol size */
+static void fold_map(const int width, const int height, unsigned short map[]) {
     int column, row;
     int input_position = 0;
 
     if (height % 2) {
         /* Horizontal folding */
         for (row = 0; row < height; row++) {
-            for (column = 0; column < width; column++) {
-                if (!((column + row) % 2)) {
-                    if (is_corner(column, row, width, height)) {
-                        dot_array[(row * width) + column] = 'C';
-                    } else {
-                        dot_array[((height - row - 1) * width) + column] = dot_stream[input_position];
-                        input_position++;
-                    }
-                } else {
-                    dot_array[((height - row - 1) * width) + column] = ' '; // Non-data position
+            for (column = row & 1; column < width; column += 2) {
+                if (!is_corner(column, row, width, height)) {
+                    map[input_position++] = DOT_IDX(width, column, height - row - 1);
                 }
             }
         }
 
         /* Corners */
-        dot_array[width - 2] = dot_stream[input_position];
-        input_position++;
-        dot_array[(height * width) - 2] = dot_stream[input_position];
-        input_position++;
-        dot_array[(width * 2) - 1] = dot_stream[input_position];
-        input_position++;
-        dot_array[((height - 1) * width) - 1] = dot_stream[input_position];
-        input_position++;
-        dot_array[0] = dot_stream[input_position];
-        input_position++;
-        dot_array[(height - 1) * width] = dot_stream[input_position];
+        map[input_position++] = DOT_IDX(width, width - 2, 0);
+        map[input_position++] = DOT_IDX(width, width - 2, height - 1);
+        map[input_position++] = DOT_IDX(width, width - 1, 1);
+        map[input_position++] = DOT_IDX(width, width - 1, height - 2);
+        map[input_position++] = DOT_IDX(width, 0, 0);
+        map[input_position] = DOT_IDX(width, 0, height - 1);
     } else {
         /* Vertical folding */
         for (column = 0; column < width; column++) {
-            for (row = 0; row < height; row++) {
-                if (!((column + row) % 2)) {
-                    if (is_corner(column, row, width, height)) {
-                        dot_array[(row * width) + column] = 'C';
-                    } else {
-                        dot_array[(row * width) + column] = dot_stream[input_position];
-                        input_position++;
-                    }
-                } else {
-                    dot_array[(row * width) + column] = ' '; // Non-data position
+            for (row = column & 1; row < height; row += 2) {
+                if (!is_corner(column, row, width, height)) {
+                    map[input_position++] = DOT_IDX(width, column, row);
                 }
             }
         }
 
         /* Corners */
-        dot_array[((height - 1) * width) - 1] = dot_stream[input_position];
-        input_position++;
-        dot_array[(height - 2) * width] = dot_stream[input_position];
-        input_position++;
-        dot_array[(height * width) - 2] = dot_stream[input_position];
-        input_position++;
-        dot_array[((height - 1) * width) + 1] = dot_stream[input_position];
-        input_position++;
-        dot_array[width - 1] = dot_stream[input_position];
-        input_position++;
-        dot_array[0] = dot_stream[input_position];
+        map[input_position++] = DOT_IDX(width, width - 1, height - 2);
+        map[input_position++] = DOT_IDX(width, 0, height - 2);
+        map[input_position++] = DOT_IDX(width, width - 2, height - 1);
+        map[input_position++] = DOT_IDX(width, 1, height - 1);
+        map[input_position++] = DOT_IDX(width, width - 1, 0);
+        map[input_position] = DOT_IDX(width, 0, 0);
+    }
+}
+
+/* Place the dots of the masked codewords in the symbol using the fold map, padding with printed dots */
+static void place_dots(const unsigned char masked_array[], const int array_length, const unsigned short map[],
+            const int n_dots, unsigned char dot_array[]) {
+    int i, bit;
+    int input_position = 0;
+
+    /* Mask value is encoded as two dots */
+    dot_array[map[input_position++]] = (masked_array[0] >> 1) & 1;
+    dot_array[map[input_position++]] = masked_array[0] & 1;
+
+    /* The rest of the data uses 9-bit dot patterns from Annex C */
+    for (i = 1; i < array_length && input_position < n_dots; i++) {
+        const int pattern = dot_patterns[masked_array[i]];
+        for (bit = 0x100; bit && input_position < n_dots; bit >>= 1) {
+            dot_array[map[input_position++]] = (pattern & bit) ? 1 : 0;
+        }
+    }
+
+    /* Add pad bits */
+    while (input_position < n_dots) {
+        dot_array[map[input_position++]] = 1;
     }
 }
 
-static void apply_mask(int mask, int data_length, unsigned char *masked_codeword_array, unsigned char *codeword_array, int ecc_length) {
+static void apply_mask(int mask, int data_length, unsigned char *masked_codeword_array, const unsigned char *codeword_array, int ecc_length) {
     int weight = 0;
     int j;
 
@@ -1279,50 +1222,84 @@ static void apply_mask(int mask, int data_length, unsigned char *masked_codeword
     rsencode(data_length + 1, ecc_length, masked_codeword_array);
 }
 
-static void force_corners(int width, int height, char *dot_array) {
+static void force_corners(int width, int height, unsigned char *dot_array) {
     if (width % 2) {
         // "Vertical" symbol
-        dot_array[0] = '1';
-        dot_array[width - 1] = '1';
-        dot_array[(height - 2) * width] = '1';
-        dot_array[((height - 1) * width) - 1] = '1';
-        dot_array[((height - 1) * width) + 1] = '1';
-        dot_array[(height * width) - 2] = '1';
+        dot_array[DOT_IDX(width, 0, 0)] = 1;
+        dot_array[DOT_IDX(width, width - 1, 0)] = 1;
+        dot_array[DOT_IDX(width, 0, height - 2)] = 1;
+        dot_array[DOT_IDX(width, width - 1, height - 2)] = 1;
+        dot_array[DOT_IDX(width, 1, height - 1)] = 1;
+        dot_array[DOT_IDX(width, width - 2, height - 1)] = 1;
     } else {
         // "Horizontal" symbol
-        dot_array[0] = '1';
-        dot_array[width - 2] = '1';
-        dot_array[(2 * width) - 1] = '1';
-        dot_array[((height - 1) * width) - 1] = '1';
-        dot_array[(height - 1) * width] = '1';
-        dot_array[(height * width) - 2] = '1';
+        dot_array[DOT_IDX(width, 0, 0)] = 1;
+        dot_array[DOT_IDX(width, width - 2, 0)] = 1;
+        dot_array[DOT_IDX(width, width - 1, 1)] = 1;
+        dot_array[DOT_IDX(width, width - 1, height - 2)] = 1;
+        dot_array[DOT_IDX(width, 0, height - 1)] = 1;
+        dot_array[DOT_IDX(width, width - 2, height - 1)] = 1;
+    }
+}
+
+struct dc_mask_ctx {
+    const unsigned char *codeword_array;
+    const unsigned short *dot_map;
+    unsigned char *masked_arrays[PARALLEL_MAX_THREADS]; /* Scratch per thread */
+    unsigned char *dot_arrays[PARALLEL_MAX_THREADS]; /* Scratch per thread, initially all unprinted */
+    int counts[PARALLEL_MAX_THREADS][200 * 2];
+    int data_length;
+    int ecc_length;
+    int width;
+    int height;
+    int n_dots;
+    int score[8];
+};
+
+/* Score mask `index % 4`, with forced corners if `index` >= 4 (`parallel_job`) */
+static void dc_mask_job(void *vctx, const int index, const int thread) {
+    struct dc_mask_ctx *ctx = (struct dc_mask_ctx *) vctx;
+    unsigned char *masked_codeword_array = ctx->masked_arrays[thread];
+    unsigned char *dot_array = ctx->dot_arrays[thread];
+
+    apply_mask(index % 4, ctx->data_length, masked_codeword_array, ctx->codeword_array, ctx->ecc_length);
+
+    place_dots(masked_codeword_array, (ctx->data_length + ctx->ecc_length + 1), ctx->dot_map, ctx->n_dots,
+            dot_array);
+
+    if (index >= 4) {
+        force_corners(ctx->width, ctx->height, dot_array);
     }
+
+    ctx->score[index] = score_array(dot_array, ctx->height, ctx->width, ctx->counts[thread],
+                            ctx->counts[thread] + ctx->height);
 }
 
 INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], int length) {
     int i, j, k;
-    size_t jc, n_dots;
+    size_t n_dots;
     int data_length, ecc_length;
     int min_dots, min_area;
     int height, width;
     int mask_score[8];
-    size_t dot_stream_length;
+    int masked_length, dot_array_size;
+    int threads;
+    unsigned char *thread_scratch = NULL;
+    struct dc_mask_ctx ctx;
     int high_score, best_mask;
     int binary_finish = 0;
     int debug = symbol->debug;
     int padding_dots, is_first;
     int codeword_array_len = length * 4 + 8; /* Allow up to 4 codewords per input + 2 (FNC) + 4 (ECI) + 2 (special char 1st position) */
-#ifdef _MSC_VER
-    unsigned char* masked_codeword_array;
-#endif
-
-#ifndef _MSC_VER
-    unsigned char codeword_array[codeword_array_len];
-#else
-    char* dot_stream;
-    char* dot_array;
-    unsigned char* codeword_array = (unsigned char *) _alloca(codeword_array_len);
-#endif /* _MSC_VER */
+    unsigned char *masked_codeword_array;
+    unsigned short *dot_map;
+    unsigned char *dot_array;
+    unsigned char *codeword_array = (unsigned char *) scratch_alloc(symbol, codeword_array_len);
+
+    if (!codeword_array) {
+        strcpy(symbol->errtxt, "528: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     if (symbol->eci > 811799) {
         strcpy(symbol->errtxt, "525: Invalid ECI");
@@ -1418,17 +1395,18 @@ INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], i
     }
 
     n_dots = (height * width) / 2;
+    dot_array_size = DOT_STRIDE(width) * (height + DOT_BORDER * 2);
 
-#ifndef _MSC_VER
-    char dot_stream[height * width * 3];
-    char dot_array[width * height * sizeof (char) ];
-#else
-    dot_stream = (char *) _alloca(height * width * 3);
-    if (!dot_stream) return ZINT_ERROR_MEMORY;
+    dot_map = (unsigned short *) scratch_alloc(symbol, sizeof(unsigned short) * n_dots);
+    dot_array = (unsigned char *) scratch_alloc(symbol, dot_array_size);
+    if (!dot_map || !dot_array) {
+        strcpy(symbol->errtxt, "528: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
-    dot_array = (char *) _alloca(width * height * sizeof (char));
-    if (!dot_array) return ZINT_ERROR_MEMORY;
-#endif
+    /* The fold is the same for every mask, and non-data positions (and the border) remain unprinted */
+    fold_map(width, height, dot_map);
+    memset(dot_array, 0, dot_array_size);
 
     /* Add pad characters */
     padding_dots = n_dots - min_dots; /* get the number of free dots available for padding */
@@ -1456,31 +1434,44 @@ INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], i
     }
 
     ecc_length = 3 + (data_length / 2);
+    masked_length = data_length + 1 + ecc_length;
 
+    if (!(masked_codeword_array = (unsigned char *) scratch_alloc(symbol, masked_length))) {
+        strcpy(symbol->errtxt, "528: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
-#ifndef _MSC_VER
-    unsigned char masked_codeword_array[data_length + 1 + ecc_length];
-#else
-    masked_codeword_array = (unsigned char *) _alloca((data_length + 1 + ecc_length) * sizeof (unsigned char));
-#endif /* _MSC_VER */
-
-    /* Evaluate data mask options */
-    for (i = 0; i < 4; i++) {
-
-        apply_mask(i, data_length, masked_codeword_array, codeword_array, ecc_length);
-
-        dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
-
-        /* Add pad bits */
-        for (jc = dot_stream_length; jc < n_dots; jc++) {
-            strcat(dot_stream, "1");
+    /* Evaluate data mask options, with (4-7) and without (0-3) forced corners */
+    threads = parallel_threads(symbol, width * height, 8);
+    if (threads > 1) {
+        thread_scratch = (unsigned char *) scratch_alloc(symbol, (threads - 1) * (masked_length + dot_array_size));
+        if (thread_scratch) {
+            memset(thread_scratch, 0, (threads - 1) * (masked_length + dot_array_size));
+        } else {
+            threads = 1; /* Fall back to evaluating in turn */
         }
+    }
+    ctx.codeword_array = codeword_array;
+    ctx.dot_map = dot_map;
+    ctx.masked_arrays[0] = masked_codeword_array;
+    ctx.dot_arrays[0] = dot_array;
+    for (i = 1; i < threads; i++) {
+        ctx.masked_arrays[i] = thread_scratch + (i - 1) * (masked_length + dot_array_size);
+        ctx.dot_arrays[i] = ctx.masked_arrays[i] + masked_length;
+    }
+    ctx.data_length = data_length;
+    ctx.ecc_length = ecc_length;
+    ctx.width = width;
+    ctx.height = height;
+    ctx.n_dots = (int) n_dots;
+    parallel_for(threads, 8, dc_mask_job, &ctx);
+
+    for (i = 0; i < 8; i++) {
+        mask_score[i] = ctx.score[i];
+    }
 
-        fold_dotstream(dot_stream, width, height, dot_array);
-
-        mask_score[i] = score_array(dot_array, height, width);
-
-        if (debug & ZINT_DEBUG_PRINT) {
+    if (debug & ZINT_DEBUG_PRINT) {
+        for (i = 0; i < 4; i++) {
             printf("Mask %d score is %d\n", i, mask_score[i]);
         }
     }
@@ -1495,31 +1486,12 @@ INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], i
         }
     }
 
-    /* Re-evaluate using forced corners if needed */
+    /* Use forced corners scores if needed */
     if (best_mask <= (height * width) / 2) {
-        for (i = 0; i < 4; i++) {
-
-            apply_mask(i, data_length, masked_codeword_array, codeword_array, ecc_length);
-
-            dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
-
-            /* Add pad bits */
-            for (jc = dot_stream_length; jc < n_dots; jc++) {
-                strcat(dot_stream, "1");
-            }
-
-            fold_dotstream(dot_stream, width, height, dot_array);
-
-            force_corners(width, height, dot_array);
-
-            mask_score[i + 4] = score_array(dot_array, height, width);
-
+        for (i = 4; i < 8; i++) {
             if (debug & ZINT_DEBUG_PRINT) {
-                printf("Mask %d score is %d\n", i + 4, mask_score[i + 4]);
+                printf("Mask %d score is %d\n", i, mask_score[i]);
             }
-        }
-
-        for (i = 4; i < 8; i++) {
             if (mask_score[i] >= high_score) {
                 high_score = mask_score[i];
                 best_mask = i;
@@ -1534,14 +1506,7 @@ INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], i
     /* Apply best mask */
     apply_mask(best_mask % 4, data_length, masked_codeword_array, codeword_array, ecc_length);
 
-    dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
-
-    /* Add pad bits */
-    for (jc = dot_stream_length; jc < n_dots; jc++) {
-        strcat(dot_stream, "1");
-    }
-
-    fold_dotstream(dot_stream, width, height, dot_array);
+    place_dots(masked_codeword_array, (data_length + ecc_length + 1), dot_map, (int) n_dots, dot_array);
 
     if (best_mask >= 4) {
         force_corners(width, height, dot_array);
@@ -1553,7 +1518,7 @@ INTERNAL int dotcode(struct zint_symbol *symbol, const unsigned char source[], i
 
     for (k = 0; k < height; k++) {
         for (j = 0; j < width; j++) {
-            if (dot_array[(k * width) + j] == '1') {
+            if (dot_array[DOT_IDX(width, j, k)]) {
                 set_module(symbol, k, j);
             }
         }
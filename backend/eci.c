@@ -34,9 +34,7 @@
 #include <stdio.h>
 #include "eci.h"
 #include "common.h"
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
+#include "scratch.h"
 
 /* Convert Unicode to other character encodings */
 INTERNAL int utf_to_eci(const int eci, const unsigned char source[], unsigned char dest[], int *length) {
@@ -252,22 +250,25 @@ INTERNAL int utf_to_eci(const int eci, const unsigned char source[], unsigned ch
     return 0;
 }
 
-/* Find the lowest ECI mode which will encode a given set of Unicode text */
-INTERNAL int get_best_eci(unsigned char source[], int length) {
+/* Find the lowest ECI mode which will encode a given set of Unicode text, returning 0 if out of memory */
+INTERNAL int get_best_eci(struct zint_symbol *symbol, unsigned char source[], int length) {
     int eci = 3;
+    const size_t mark = scratch_mark(symbol);
+    unsigned char *local_source = (unsigned char *) scratch_alloc(symbol, length + 1);
 
-#ifndef _MSC_VER
-    unsigned char local_source[length + 1];
-#else
-    unsigned char *local_source = (unsigned char*) _alloca(length + 1);
-#endif
+    if (!local_source) {
+        return 0;
+    }
 
     do {
         if (utf_to_eci(eci, source, local_source, &length) == 0) {
+            scratch_release(symbol, mark);
             return eci;
         }
         eci++;
     } while (eci < 25);
 
+    scratch_release(symbol, mark);
+
     return 26; // If all of these fail, use Unicode!
 }
@@ -36,11 +36,10 @@
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
 #include "emf.h"
+#include "filemem.h"
+#include "scratch.h"
 
 static int count_rectangles(struct zint_symbol *symbol) {
     int rectangles = 0;
@@ -158,7 +157,8 @@ static int utfle_length(unsigned char *input, int length) {
 
 INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     int i;
-    FILE *emf_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
     int error_number = 0;
     int rectangle_count, this_rectangle;
@@ -215,14 +215,12 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     int current_fsize;
     int current_halign;
 
-#ifdef _MSC_VER
     emr_rectangle_t *rectangle;
     emr_ellipse_t *circle;
     emr_polygon_t *hexagon;
     emr_exttextoutw_t *text;
     int *text_fsizes;
     int *text_haligns;
-#endif
 
     fgred = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
     fggrn = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
@@ -242,21 +240,16 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     hexagon_count = count_hexagons(symbol);
     string_count = count_strings(symbol, &fsize, &fsize2, &halign, &halign1, &halign2);
 
-#ifndef _MSC_VER
-    emr_rectangle_t rectangle[rectangle_count ? rectangle_count : 1]; // Avoid sanitize runtime error by making always non-zero
-    emr_ellipse_t circle[circle_count ? circle_count : 1];
-    emr_polygon_t hexagon[hexagon_count ? hexagon_count : 1];
-    emr_exttextoutw_t text[string_count ? string_count: 1];
-    int text_fsizes[string_count ? string_count: 1];
-    int text_haligns[string_count ? string_count: 1];
-#else
-    rectangle = (emr_rectangle_t*) _alloca(rectangle_count * sizeof (emr_rectangle_t));
-    circle = (emr_ellipse_t*) _alloca(circle_count * sizeof (emr_ellipse_t));
-    hexagon = (emr_polygon_t*) _alloca(hexagon_count * sizeof (emr_polygon_t));
-    text = (emr_exttextoutw_t*) _alloca(string_count * sizeof (emr_exttextoutw_t));
-    text_fsizes = (int *) _alloca(string_count * sizeof (int));
-    text_haligns = (int *) _alloca(string_count * sizeof (int));
-#endif
+    rectangle = (emr_rectangle_t *) scratch_alloc(symbol, sizeof(emr_rectangle_t) * rectangle_count);
+    circle = (emr_ellipse_t *) scratch_alloc(symbol, sizeof(emr_ellipse_t) * circle_count);
+    hexagon = (emr_polygon_t *) scratch_alloc(symbol, sizeof(emr_polygon_t) * hexagon_count);
+    text = (emr_exttextoutw_t *) scratch_alloc(symbol, sizeof(emr_exttextoutw_t) * string_count);
+    text_fsizes = (int *) scratch_alloc(symbol, sizeof(int) * string_count);
+    text_haligns = (int *) scratch_alloc(symbol, sizeof(int) * string_count);
+    if (!rectangle || !circle || !hexagon || !text || !text_fsizes || !text_haligns) {
+        strcpy(symbol->errtxt, "642: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     //Calculate how many coloured rectangles
     if (symbol->symbology == BARCODE_ULTRA) {
@@ -615,7 +608,7 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
             assert(str->length > 0);
             utfle_len = utfle_length(str->text, str->length);
             bumped_len = bump_up(utfle_len) * 2;
-            this_string[this_text] = (unsigned char *) malloc(bumped_len);
+            this_string[this_text] = (unsigned char *) z_malloc(symbol, bumped_len);
             memset(this_string[this_text], 0, bumped_len);
             text[this_text].type = 0x00000054; // EMR_EXTTEXTOUTW
             text[this_text].size = 76 + bumped_len;
@@ -667,61 +660,56 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     emr_header.emf_header.records = recordcount;
 
     /* Send EMF data to file */
-    if (symbol->output_options & BARCODE_STDOUT) {
-        emf_file = stdout;
-    } else {
-        emf_file = fopen(symbol->outfile, "wb");
-    }
-    if (emf_file == NULL) {
+    if (!fm_open(fmp, symbol, "wb")) {
         strcpy(symbol->errtxt, "640: Could not open output file");
         return ZINT_ERROR_FILE_ACCESS;
     }
 
-    fwrite(&emr_header, sizeof (emr_header_t), 1, emf_file);
+    fm_write(&emr_header, sizeof (emr_header_t), 1, fmp);
 
-    fwrite(&emr_mapmode, sizeof (emr_mapmode_t), 1, emf_file);
+    fm_write(&emr_mapmode, sizeof (emr_mapmode_t), 1, fmp);
 
     if (rotate_angle) {
-        fwrite(&emr_setworldtransform, sizeof (emr_setworldtransform_t), 1, emf_file);
+        fm_write(&emr_setworldtransform, sizeof (emr_setworldtransform_t), 1, fmp);
     }
 
-    fwrite(&emr_createbrushindirect_bg, sizeof (emr_createbrushindirect_t), 1, emf_file);
+    fm_write(&emr_createbrushindirect_bg, sizeof (emr_createbrushindirect_t), 1, fmp);
 
     if (symbol->symbology == BARCODE_ULTRA) {
         for (i = 0; i < 8; i++) {
             if (rectangle_count_bycolour[i + 1]) {
-                fwrite(&emr_createbrushindirect_colour[i], sizeof (emr_createbrushindirect_t), 1, emf_file);
+                fm_write(&emr_createbrushindirect_colour[i], sizeof (emr_createbrushindirect_t), 1, fmp);
             }
         }
     } else {
-        fwrite(&emr_createbrushindirect_fg, sizeof (emr_createbrushindirect_t), 1, emf_file);
+        fm_write(&emr_createbrushindirect_fg, sizeof (emr_createbrushindirect_t), 1, fmp);
     }
 
-    fwrite(&emr_createpen, sizeof (emr_createpen_t), 1, emf_file);
+    fm_write(&emr_createpen, sizeof (emr_createpen_t), 1, fmp);
 
     if (symbol->vector->strings) {
-        fwrite(&emr_extcreatefontindirectw, sizeof (emr_extcreatefontindirectw_t), 1, emf_file);
+        fm_write(&emr_extcreatefontindirectw, sizeof (emr_extcreatefontindirectw_t), 1, fmp);
         if (fsize2) {
-            fwrite(&emr_extcreatefontindirectw2, sizeof (emr_extcreatefontindirectw_t), 1, emf_file);
+            fm_write(&emr_extcreatefontindirectw2, sizeof (emr_extcreatefontindirectw_t), 1, fmp);
         }
     }
 
-    fwrite(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, emf_file);
-    fwrite(&emr_selectobject_pen, sizeof (emr_selectobject_t), 1, emf_file);
+    fm_write(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, fmp);
+    fm_write(&emr_selectobject_pen, sizeof (emr_selectobject_t), 1, fmp);
     if (draw_background) {
-        fwrite(&background, sizeof (emr_rectangle_t), 1, emf_file);
+        fm_write(&background, sizeof (emr_rectangle_t), 1, fmp);
     }
 
     if (symbol->symbology == BARCODE_ULTRA) {
         for(i = 0; i < 8; i++) {
             if (rectangle_count_bycolour[i + 1]) {
-                fwrite(&emr_selectobject_colour[i], sizeof (emr_selectobject_t), 1, emf_file);
+                fm_write(&emr_selectobject_colour[i], sizeof (emr_selectobject_t), 1, fmp);
 
                 rect = symbol->vector->rectangles;
                 this_rectangle = 0;
                 while (rect) {
                     if (rect->colour == i + 1) {
-                        fwrite(&rectangle[this_rectangle], sizeof (emr_rectangle_t), 1, emf_file);
+                        fm_write(&rectangle[this_rectangle], sizeof (emr_rectangle_t), 1, fmp);
                     }
                     this_rectangle++;
                     rect = rect->next;
@@ -729,42 +717,42 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
             }
         }
     } else {
-        fwrite(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, emf_file);
+        fm_write(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, fmp);
 
         // Rectangles
         for (i = 0; i < rectangle_count; i++) {
-            fwrite(&rectangle[i], sizeof (emr_rectangle_t), 1, emf_file);
+            fm_write(&rectangle[i], sizeof (emr_rectangle_t), 1, fmp);
         }
     }
 
     // Hexagons
     for (i = 0; i < hexagon_count; i++) {
-        fwrite(&hexagon[i], sizeof (emr_polygon_t), 1, emf_file);
+        fm_write(&hexagon[i], sizeof (emr_polygon_t), 1, fmp);
     }
 
     // Circles
     if (symbol->symbology == BARCODE_MAXICODE) {
         // Bullseye needed
         for (i = 0; i < circle_count; i++) {
-            fwrite(&circle[i], sizeof (emr_ellipse_t), 1, emf_file);
+            fm_write(&circle[i], sizeof (emr_ellipse_t), 1, fmp);
             if (i < circle_count - 1) {
                 if (i % 2) {
-                    fwrite(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, emf_file);
+                    fm_write(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, fmp);
                 } else {
-                    fwrite(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, emf_file);
+                    fm_write(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, fmp);
                 }
             }
         }
     } else {
         for (i = 0; i < circle_count; i++) {
-            fwrite(&circle[i], sizeof (emr_ellipse_t), 1, emf_file);
+            fm_write(&circle[i], sizeof (emr_ellipse_t), 1, fmp);
         }
     }
 
     // Text
     if (string_count > 0) {
-        fwrite(&emr_selectobject_font, sizeof (emr_selectobject_t), 1, emf_file);
-        fwrite(&emr_settextcolor, sizeof (emr_settextcolor_t), 1, emf_file);
+        fm_write(&emr_selectobject_font, sizeof (emr_selectobject_t), 1, fmp);
+        fm_write(&emr_settextcolor, sizeof (emr_settextcolor_t), 1, fmp);
     }
 
     current_fsize = fsize;
@@ -772,29 +760,28 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     for (i = 0; i < string_count; i++) {
         if (text_fsizes[i] != current_fsize) { // NOLINT(clang-analyzer-core.UndefinedBinaryOperatorResult) suppress clang-tidy warning: text_fsizes fully set
             current_fsize = text_fsizes[i];
-            fwrite(&emr_selectobject_font2, sizeof (emr_selectobject_t), 1, emf_file);
+            fm_write(&emr_selectobject_font2, sizeof (emr_selectobject_t), 1, fmp);
         }
         if (text_haligns[i] != current_halign) {
             current_halign = text_haligns[i];
             if (current_halign == 0) {
-                fwrite(&emr_settextalign, sizeof (emr_settextalign_t), 1, emf_file);
+                fm_write(&emr_settextalign, sizeof (emr_settextalign_t), 1, fmp);
             } else if (current_halign == 1) {
-                fwrite(&emr_settextalign1, sizeof (emr_settextalign_t), 1, emf_file);
+                fm_write(&emr_settextalign1, sizeof (emr_settextalign_t), 1, fmp);
             } else {
-                fwrite(&emr_settextalign2, sizeof (emr_settextalign_t), 1, emf_file);
+                fm_write(&emr_settextalign2, sizeof (emr_settextalign_t), 1, fmp);
             }
         }
-        fwrite(&text[i], sizeof (emr_exttextoutw_t), 1, emf_file);
-        fwrite(this_string[i], bump_up(text[i].w_emr_text.chars) * 2, 1, emf_file);
-        free(this_string[i]);
+        fm_write(&text[i], sizeof (emr_exttextoutw_t), 1, fmp);
+        fm_write(this_string[i], bump_up(text[i].w_emr_text.chars) * 2, 1, fmp);
+        z_free(symbol, this_string[i]);
     }
 
-    fwrite(&emr_eof, sizeof (emr_eof_t), 1, emf_file);
+    fm_write(&emr_eof, sizeof (emr_eof_t), 1, fmp);
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(emf_file);
-    } else {
-        fclose(emf_file);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "641: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
     return error_number;
 }
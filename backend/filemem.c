@@ -0,0 +1,227 @@
+/* filemem.c - write output to file, stdout or memory */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <io.h>
+#include <fcntl.h>
+#endif
+#include "common.h"
+#include "filemem.h"
+
+#define FM_STDOUT   1
+#define FM_MEMORY   2
+
+/* Initial allocation of memory output, doubled as required */
+#define FM_MEM_INIT 1024
+
+/* Open the output given by `symbol->output_options` (`BARCODE_MEMORY_FILE` or `BARCODE_STDOUT`) or
+   `symbol->outfile` for writing, `mode` "w" or "wb". Returns 0 on failure */
+INTERNAL int fm_open(struct filemem *fmp, struct zint_symbol *symbol, const char *mode) {
+    memset(fmp, 0, sizeof(struct filemem));
+    if (symbol->output_options & BARCODE_MEMORY_FILE) {
+        if (symbol->memfile) {
+            z_free(symbol, symbol->memfile);
+            symbol->memfile = NULL;
+        }
+        symbol->memfile_size = 0;
+        fmp->symbol = symbol;
+        if (!(fmp->mem = (unsigned char *) z_malloc(symbol, FM_MEM_INIT))) {
+            return 0;
+        }
+        fmp->memsize = FM_MEM_INIT;
+        fmp->flags = FM_MEMORY;
+        return 1;
+    }
+    if (symbol->output_options & BARCODE_STDOUT) {
+#ifdef _MSC_VER
+        if (mode[1] == 'b' && -1 == _setmode(_fileno(stdout), _O_BINARY)) {
+            return 0;
+        }
+#endif
+        fmp->fp = stdout;
+        fmp->flags = FM_STDOUT;
+        return 1;
+    }
+    if (!(fmp->fp = fopen(symbol->outfile, mode))) {
+        return 0;
+    }
+    return 1;
+}
+
+/* Make room for `len` more bytes in memory output */
+static int fm_mem_expand(struct filemem *fmp, const size_t len) {
+    unsigned char *mem;
+    size_t memsize = fmp->memsize;
+
+    if (fmp->err) {
+        return 0;
+    }
+    if (fmp->mempos + len <= memsize) {
+        return 1;
+    }
+    while (fmp->mempos + len > memsize) {
+        memsize <<= 1;
+    }
+    if (!(mem = (unsigned char *) z_realloc(fmp->symbol, fmp->mem, memsize))) {
+        fmp->err = ENOMEM;
+        return 0;
+    }
+    fmp->mem = mem;
+    fmp->memsize = memsize;
+    return 1;
+}
+
+/* `fwrite()` to output */
+INTERNAL size_t fm_write(const void *ptr, const size_t size, const size_t nitems, struct filemem *fmp) {
+    size_t ret;
+
+    if (fmp->flags & FM_MEMORY) {
+        const size_t len = size * nitems;
+        if (!fm_mem_expand(fmp, len)) {
+            return 0;
+        }
+        memcpy(fmp->mem + fmp->mempos, ptr, len);
+        fmp->mempos += len;
+        return nitems;
+    }
+    if ((ret = fwrite(ptr, size, nitems, fmp->fp)) != nitems && !fmp->err) {
+        fmp->err = errno ? errno : EIO;
+    }
+    return ret;
+}
+
+/* `fputc()` to output */
+INTERNAL int fm_putc(const int ch, struct filemem *fmp) {
+    if (fmp->flags & FM_MEMORY) {
+        if (!fm_mem_expand(fmp, 1)) {
+            return EOF;
+        }
+        fmp->mem[fmp->mempos++] = (unsigned char) ch;
+        return ch;
+    }
+    if (fputc(ch, fmp->fp) == EOF) {
+        if (!fmp->err) {
+            fmp->err = errno ? errno : EIO;
+        }
+        return EOF;
+    }
+    return ch;
+}
+
+/* `fputs()` to output */
+INTERNAL int fm_puts(const char *str, struct filemem *fmp) {
+    if (fmp->flags & FM_MEMORY) {
+        const size_t len = strlen(str);
+        if (!fm_mem_expand(fmp, len)) {
+            return EOF;
+        }
+        memcpy(fmp->mem + fmp->mempos, str, len);
+        fmp->mempos += len;
+        return 1;
+    }
+    if (fputs(str, fmp->fp) == EOF) {
+        if (!fmp->err) {
+            fmp->err = errno ? errno : EIO;
+        }
+        return EOF;
+    }
+    return 1;
+}
+
+/* `fprintf()` to output */
+INTERNAL int fm_printf(struct filemem *fmp, const char *format, ...) {
+    va_list ap;
+    int ret;
+
+    if (fmp->flags & FM_MEMORY) {
+        /* Size the output first, then format it in place */
+        va_start(ap, format);
+#ifdef _MSC_VER
+        ret = _vscprintf(format, ap);
+#else
+        ret = vsnprintf(NULL, 0, format, ap);
+#endif
+        va_end(ap);
+        if (ret < 0 || !fm_mem_expand(fmp, (size_t) ret + 1)) {
+            if (!fmp->err) {
+                fmp->err = EINVAL;
+            }
+            return -1;
+        }
+        va_start(ap, format);
+        vsprintf((char *) fmp->mem + fmp->mempos, format, ap);
+        va_end(ap);
+        fmp->mempos += ret;
+        return ret;
+    }
+    va_start(ap, format);
+    ret = vfprintf(fmp->fp, format, ap);
+    va_end(ap);
+    if (ret < 0 && !fmp->err) {
+        fmp->err = errno ? errno : EIO;
+    }
+    return ret;
+}
+
+/* Non-zero if a write has failed */
+INTERNAL int fm_error(const struct filemem *fmp) {
+    return fmp->err;
+}
+
+/* Close output, handing memory output over to `symbol->memfile`. Returns 0 if output failed */
+INTERNAL int fm_close(struct filemem *fmp, struct zint_symbol *symbol) {
+    if (fmp->flags & FM_MEMORY) {
+        if (fmp->err) {
+            z_free(symbol, fmp->mem);
+            fmp->mem = NULL;
+            return 0;
+        }
+        symbol->memfile = fmp->mem;
+        symbol->memfile_size = (int) fmp->mempos;
+        fmp->mem = NULL;
+        return 1;
+    }
+    if (fmp->flags & FM_STDOUT) {
+        if (fflush(fmp->fp) != 0 && !fmp->err) {
+            fmp->err = errno ? errno : EIO;
+        }
+    } else if (fclose(fmp->fp) != 0 && !fmp->err) {
+        fmp->err = errno ? errno : EIO;
+    }
+    fmp->fp = NULL;
+    return !fmp->err;
+}
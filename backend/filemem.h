@@ -0,0 +1,62 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef __FILEMEM_H
+#define __FILEMEM_H
+
+#include <stdio.h>
+
+/* Output target of the file writers - a file, stdout or (`BARCODE_MEMORY_FILE`) a growing memory buffer */
+struct filemem {
+    FILE *fp;
+    unsigned char *mem;
+    size_t memsize; /* Allocated size of `mem` */
+    size_t mempos; /* Bytes written to `mem` */
+    int flags;
+    int err; /* Set on first write error */
+    const struct zint_symbol *symbol; /* Owner of memory output, for its allocator */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+    INTERNAL int fm_open(struct filemem *fmp, struct zint_symbol *symbol, const char *mode);
+    INTERNAL size_t fm_write(const void *ptr, const size_t size, const size_t nitems, struct filemem *fmp);
+    INTERNAL int fm_putc(const int ch, struct filemem *fmp);
+    INTERNAL int fm_puts(const char *str, struct filemem *fmp);
+    INTERNAL int fm_printf(struct filemem *fmp, const char *format, ...);
+    INTERNAL int fm_error(const struct filemem *fmp);
+    INTERNAL int fm_close(struct filemem *fmp, struct zint_symbol *symbol);
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FILEMEM_H */
@@ -52,10 +52,8 @@
  * License along with the GNU LIBICONV Library; see the file COPYING.LIB.
  * If not, see <https://www.gnu.org/licenses/>.
  */
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "gb2312.h"
 #include "gb18030.h"
 
@@ -2874,11 +2872,13 @@ INTERNAL int gb18030_utf8tomb(struct zint_symbol *symbol, const unsigned char so
             unsigned int *gbdata) {
     int error_number, ret;
     unsigned int i, j, length;
-#ifndef _MSC_VER
-    unsigned int utfdata[*p_length + 1];
-#else
-    unsigned int *utfdata = (unsigned int *) _alloca((*p_length + 1) * sizeof(unsigned int));
-#endif
+    const size_t mark = scratch_mark(symbol);
+    unsigned int *utfdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (*p_length + 1));
+
+    if (!utfdata) {
+        strcpy(symbol->errtxt, "821: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     error_number = utf8_to_unicode(symbol, source, utfdata, p_length, 0 /*disallow_4byte*/);
     if (error_number != 0) {
@@ -2902,18 +2902,22 @@ INTERNAL int gb18030_utf8tomb(struct zint_symbol *symbol, const unsigned char so
 
     *p_length = j;
 
+    scratch_release(symbol, mark);
+
     return 0;
 }
 
 /* Convert UTF-8 string to single byte ECI and place in array of ints */
-INTERNAL int gb18030_utf8tosb(int eci, const unsigned char source[], int *p_length, unsigned int *gbdata,
-            int full_multibyte) {
+INTERNAL int gb18030_utf8tosb(struct zint_symbol *symbol, int eci, const unsigned char source[], int *p_length,
+            unsigned int *gbdata, int full_multibyte) {
     int error_number;
-#ifndef _MSC_VER
-    unsigned char single_byte[*p_length + 1];
-#else
-    unsigned char *single_byte = (unsigned char *) _alloca(*p_length + 1);
-#endif
+    const size_t mark = scratch_mark(symbol);
+    unsigned char *single_byte = (unsigned char *) scratch_alloc(symbol, *p_length + 1);
+
+    if (!single_byte) {
+        strcpy(symbol->errtxt, "822: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     error_number = utf_to_eci(eci, source, single_byte, p_length);
     if (error_number != 0) {
@@ -2922,6 +2926,7 @@ INTERNAL int gb18030_utf8tosb(int eci, const unsigned char source[], int *p_leng
     }
 
     gb18030_cpy(single_byte, p_length, gbdata, full_multibyte);
+    scratch_release(symbol, mark);
 
     return 0;
 }
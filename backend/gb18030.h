@@ -40,8 +40,8 @@ extern "C" {
 INTERNAL int gb18030_wctomb_zint(unsigned int *r1, unsigned int *r2, unsigned int wc);
 INTERNAL int gb18030_utf8tomb(struct zint_symbol *symbol, const unsigned char source[], int *p_length,
             unsigned int *gbdata);
-INTERNAL int gb18030_utf8tosb(int eci, const unsigned char source[], int *p_length, unsigned int *gbdata,
-            int full_multibyte);
+INTERNAL int gb18030_utf8tosb(struct zint_symbol *symbol, int eci, const unsigned char source[], int *p_length,
+            unsigned int *gbdata, int full_multibyte);
 INTERNAL void gb18030_cpy(const unsigned char source[], int *p_length, unsigned int *gbdata, int full_multibyte);
 
 #ifdef __cplusplus
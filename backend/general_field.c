@@ -34,8 +34,8 @@
 #include "common.h"
 #include "general_field.h"
 
-static char alphanum_puncs[] = "*,-./";
-static char isoiec_puncs[] = "!\"%&'()*+,-./:;<=>?_ ";
+static const char alphanum_puncs[] = "*,-./";
+static const char isoiec_puncs[] = "!\"%&'()*+,-./:;<=>?_ ";
 
 /* Returns type of char at `i`. FNC1 counted as NUMERIC. Returns 0 if invalid char */
 static int general_field_type(char *general_field, int i) {
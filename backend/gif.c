@@ -34,12 +34,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "common.h"
+#include "scratch.h"
 #include <math.h>
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#include <malloc.h>
-#endif
+#include "filemem.h"
 
 #define SSET    "0123456789ABCDEF"
 
@@ -275,7 +272,8 @@ static int gif_lzw(statestruct *pState, int paletteBitSize) {
  */
 INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     unsigned char outbuf[10];
-    FILE *gif_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     unsigned short usTemp;
     int byte_out;
     int colourCount;
@@ -300,15 +298,12 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
     /* Allow for overhead of 4 == code size + byte count + overflow byte + zero terminator */
     unsigned int lzoutbufSize = symbol->bitmap_height * symbol->bitmap_width + 4;
-#ifdef _MSC_VER
-    char * lzwoutbuf;
-#endif
+    char *lzwoutbuf = (char *) scratch_alloc(symbol, lzoutbufSize);
 
-#ifndef _MSC_VER
-    char lzwoutbuf[lzoutbufSize];
-#else
-    lzwoutbuf = (char *) _alloca(lzoutbufSize);
-#endif /* _MSC_VER */
+    if (!lzwoutbuf) {
+        strcpy(symbol->errtxt, "613: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /*
      * Build a table of the used palette items.
@@ -466,19 +461,9 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     paletteSize = 1<<paletteBitSize;
 
     /* Open output file in binary mode */
-    if ((symbol->output_options & BARCODE_STDOUT) != 0) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "610: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        gif_file = stdout;
-    } else {
-        if (!(gif_file = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "611: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "611: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     /* GIF signature (6) */
@@ -486,7 +471,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     if (transparent_index != -1)
         outbuf[4] = '9';
 
-    fwrite(outbuf, 6, 1, gif_file);
+    fm_write(outbuf, 6, 1, fmp);
     /* Screen Descriptor (7) */
     /* Screen Width */
     usTemp = (unsigned short) symbol->bitmap_width;
@@ -521,12 +506,12 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     outbuf[5] = backgroundColourIndex;
     /* Byte 7 must be 0x00  */
     outbuf[6] = 0x00;
-    fwrite(outbuf, 7, 1, gif_file);
+    fm_write(outbuf, 7, 1, fmp);
     /* Global Color Table (paletteSize*3) */
-    fwrite(paletteRGB, 3*paletteCount, 1, gif_file);
+    fm_write(paletteRGB, 3*paletteCount, 1, fmp);
     /* add unused palette items to fill palette size */
     for (paletteIndex = paletteCount; paletteIndex < paletteSize; paletteIndex++) {
-        fwrite(RGBUnused, 3, 1, gif_file);
+        fm_write(RGBUnused, 3, 1, fmp);
     }
 
     /* Graphic control extension (8) */
@@ -554,7 +539,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         outbuf[6] = (unsigned char) transparent_index;
         /* Block Terminator */
         outbuf[7] = 0;
-        fwrite(outbuf, 8, 1, gif_file);
+        fm_write(outbuf, 8, 1, fmp);
     }
     /* Image Descriptor */
     /* Image separator character = ',' */
@@ -577,7 +562,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
      * There is no local color table if its most significant bit is reset.
      */
     outbuf[9] = 0x00;
-    fwrite(outbuf, 10, 1, gif_file);
+    fm_write(outbuf, 10, 1, fmp);
 
     /* prepare state array */
     State.pIn = pixelbuf;
@@ -588,14 +573,17 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* call lzw encoding */
     byte_out = gif_lzw(&State, paletteBitSize);
     if (byte_out <= 0) {
-        fclose(gif_file);
+        (void) fm_close(fmp, symbol);
         return ZINT_ERROR_MEMORY;
     }
-    fwrite(lzwoutbuf, byte_out, 1, gif_file);
+    fm_write(lzwoutbuf, byte_out, 1, fmp);
 
     /* GIF terminator */
-    fputc('\x3b', gif_file);
-    fclose(gif_file);
+    fm_putc('\x3b', fmp);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "612: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
 
     return 0;
 }
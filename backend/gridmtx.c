@@ -34,10 +34,8 @@
    AIM Global Document Number AIMD014 Rev. 1.63 Revised 9 Dec 2008 */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "reedsol.h"
 #include "gridmtx.h"
 #include "gb2312.h"
@@ -123,12 +121,13 @@ static int in_numeral(const unsigned int gbdata[], const int length, const int i
 
 /* Calculate optimized encoding modes. Adapted from Project Nayuki */
 /* Copyright (c) Project Nayuki. (MIT License) See qr.c for detailed notice */
-static void define_mode(char* mode, const unsigned int gbdata[], const int length, const int debug) {
+static void define_mode(char *mode, char char_modes[], const unsigned int gbdata[], const int length,
+            const int debug) {
     /* Must be in same order as GM_H etc */
     static const char mode_types[] = { GM_CHINESE, GM_NUMBER, GM_LOWER, GM_UPPER, GM_MIXED, GM_BYTE, '\0' };
 
     /* Initial mode costs */
-    static unsigned int head_costs[GM_NUM_MODES] = {
+    static const unsigned int head_costs[GM_NUM_MODES] = {
     /*  H            N (+pad prefix)    L            U            M            B (+byte count) */
         4 * GM_MULT, (4 + 2) * GM_MULT, 4 * GM_MULT, 4 * GM_MULT, 4 * GM_MULT, (4 + 9) * GM_MULT
     };
@@ -158,11 +157,6 @@ static void define_mode(char* mode, const unsigned int gbdata[], const int lengt
     char cur_mode;
     unsigned int prev_costs[GM_NUM_MODES];
     unsigned int cur_costs[GM_NUM_MODES];
-#ifndef _MSC_VER
-    char char_modes[length * GM_NUM_MODES];
-#else
-    char *char_modes = (char *) _alloca(length * GM_NUM_MODES);
-#endif
 
     /* char_modes[i * GM_NUM_MODES + j] represents the mode to encode the code point at index i such that the final
      * segment ends in mode_types[j] and the total number of bits is minimized over all possible choices */
@@ -322,8 +316,8 @@ static int add_shift_char(char binary[], int bp, int shifty, int debug) {
     return bp;
 }
 
-static int gm_encode(unsigned int gbdata[], const int length, char binary[], const int reader, const int eci,
-            int *bin_len, int debug) {
+static int gm_encode(struct zint_symbol *symbol, unsigned int gbdata[], const int length, char binary[],
+            const int reader, const int eci, int *bin_len, int debug) {
     /* Create a binary stream representation of the input data.
        7 sets are defined - Chinese characters, Numerals, Lower case letters, Upper case letters,
        Mixed numerals and latters, Control characters and 8-bit binary data */
@@ -337,11 +331,13 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
     int byte_count = 0;
     int shift;
     int bp;
-#ifndef _MSC_VER
-    char mode[length];
-#else
-    char* mode = (char*) _alloca(length);
-#endif
+    char *mode = (char *) scratch_alloc(symbol, length);
+    char *char_modes = (char *) scratch_alloc(symbol, (size_t) length * GM_NUM_MODES);
+
+    if (!mode || !char_modes) {
+        strcpy(symbol->errtxt, "535: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     *binary = '\0';
     bp = 0;
@@ -368,7 +364,7 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
         }
     }
 
-    define_mode(mode, gbdata, length, debug);
+    define_mode(mode, char_modes, gbdata, length, debug);
 
     do {
         int next_mode = mode[sp];
@@ -946,13 +942,8 @@ static void place_data_in_grid(unsigned char word[], char grid[], int modules, i
 static void place_layer_id(char* grid, int size, int layers, int modules, int ecc_level) {
     int i, j, layer, start, stop;
 
-#ifndef _MSC_VER
-    int layerid[layers + 1];
-    int id[modules * modules];
-#else
-    int* layerid = (int *) _alloca((layers + 1) * sizeof (int));
-    int* id = (int *) _alloca((modules * modules) * sizeof (int));
-#endif
+    int layerid[13 + 1]; /* Up to 13 layers */
+    int id[27 * 27]; /* Up to 27 x 27 macromodules */
 
     /* Calculate Layer IDs */
     for (i = 0; i <= layers; i++) {
@@ -1008,12 +999,13 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
     int size_squared;
     int bin_len;
 
-#ifndef _MSC_VER
-    unsigned int gbdata[length + 1];
-#else
-    char* grid;
-    unsigned int* gbdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-#endif
+    char *grid;
+    unsigned int *gbdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (length + 1));
+
+    if (!gbdata) {
+        strcpy(symbol->errtxt, "535: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* If ZINT_FULL_MULTIBYTE set use Hanzi mode in DATA_MODE or for single-byte Latin */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
@@ -1024,10 +1016,12 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
         int done = 0;
         if (symbol->eci != 29) { /* Unless ECI 29 (GB) */
             /* Try single byte (Latin) conversion first */
-            error_number = gb2312_utf8tosb(symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source, &length,
-                                gbdata, full_multibyte);
+            error_number = gb2312_utf8tosb(symbol, symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source,
+                                &length, gbdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                return error_number;
             } else if (symbol->eci && symbol->eci <= 899) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
                 return error_number;
@@ -1049,7 +1043,10 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-    error_number = gm_encode(gbdata, length, binary, reader, symbol->eci, &bin_len, symbol->debug);
+    error_number = gm_encode(symbol, gbdata, length, binary, reader, symbol->eci, &bin_len, symbol->debug);
+    if (error_number == ZINT_ERROR_MEMORY) {
+        return error_number;
+    }
     if (error_number != 0) {
         strcpy(symbol->errtxt, "531: Input data too long");
         return error_number;
@@ -1145,11 +1142,10 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
     modules = 1 + (layers * 2);
     size_squared = size * size;
 
-#ifndef _MSC_VER
-    char grid[size_squared];
-#else
-    grid = (char *) _alloca(size_squared * sizeof(char));
-#endif
+    if (!(grid = (char *) scratch_alloc(symbol, size_squared))) {
+        strcpy(symbol->errtxt, "535: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     memset(grid, '0', size_squared);
 
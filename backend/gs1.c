@@ -32,9 +32,6 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
 #include "gs1.h"
 
@@ -68,654 +65,343 @@ static void itostr(char ai_string[], int ai_value) {
     strcat(ai_string, ")");
 }
 
-/* Returns the number of times a character occurs in a string */
-static int ustrchr_cnt(const unsigned char string[], const size_t length, const unsigned char c) {
-    int count = 0;
-    unsigned int i;
-    for (i = 0; i < length; i++) {
-        if (string[i] == c) {
-            count++;
+/* GS1 AI descriptor flags */
+#define GS1_PREDEF  0x01 /* Predefined length (no FNC1 separator needed after it), figure 7.8.4-2 */
+#define GS1_DATE    0x02 /* Data begins with date YYMMDD */
+#define GS1_CSET39  0x04 /* Non-numeric data restricted to CSET 39 (otherwise CSET 82) */
+#define GS1_DATE2   0x08 /* Data may be followed by a 2nd date YYMMDD (length must be minimum or maximum) */
+#define GS1_STEP2   0x10 /* Data length less minimum must be even */
+
+/* GS1 AI descriptor */
+struct gs1_ai_desc {
+    unsigned short ai;      /* First AI of range */
+    unsigned short ai_end;  /* Last AI of range */
+    unsigned char min_len;  /* Minimum data length */
+    unsigned char max_len;  /* Maximum data length */
+    unsigned char num_len;  /* Number of leading data characters that must be numeric */
+    unsigned char check;    /* Position (1-based) of mod 10 check digit, 0 if none */
+    unsigned char flags;
+};
+
+/* AI descriptors sorted by AI, according to GS1 General Specification Release 19, January 2019 */
+static const struct gs1_ai_desc gs1_ais[] = {
+    {    0,    0, 18, 18, 18, 18, GS1_PREDEF }, /* SSCC */
+    {    1,    2, 14, 14, 14, 14, GS1_PREDEF }, /* GTIN, CONTENT */
+    {   10,   10,  1, 20,  0,  0, 0 }, /* BATCH/LOT */
+    {   11,   13,  6,  6,  6,  0, GS1_PREDEF | GS1_DATE }, /* PROD DATE, DUE DATE, PACK DATE */
+    {   15,   17,  6,  6,  6,  0, GS1_PREDEF | GS1_DATE }, /* BEST BY, SELL BY, USE BY */
+    {   20,   20,  2,  2,  2,  0, GS1_PREDEF }, /* VARIANT */
+    {   21,   22,  1, 20,  0,  0, 0 }, /* SERIAL, CPV */
+    {   30,   30,  1,  8,  8,  0, 0 }, /* VAR COUNT */
+    {   37,   37,  1,  8,  8,  0, 0 }, /* COUNT */
+    {   90,   90,  1, 30,  0,  0, 0 }, /* INTERNAL */
+    {   91,   99,  1, 90,  0,  0, 0 }, /* INTERNAL */
+    {  235,  235,  1, 28,  0,  0, GS1_PREDEF }, /* TPX (prefix 23 legacy predefined length, kept for compatibility) */
+    {  240,  241,  1, 30,  0,  0, 0 }, /* ADDITIONAL ID, CUST PART NO */
+    {  242,  242,  1,  6,  6,  0, 0 }, /* MTO VARIANT */
+    {  243,  243,  1, 20,  0,  0, 0 }, /* PCN */
+    {  250,  251,  1, 30,  0,  0, 0 }, /* SECONDARY SERIAL, REF TO SOURCE */
+    {  253,  253, 13, 30, 13, 13, 0 }, /* GDTI */
+    {  254,  254,  1, 20,  0,  0, 0 }, /* GLN EXTENSION COMPONENT */
+    {  255,  255, 13, 25, 25, 13, 0 }, /* GCN */
+    {  400,  401,  1, 30,  0,  0, 0 }, /* ORDER NUMBER, GINC */
+    {  402,  402, 17, 17, 17, 17, 0 }, /* GSIN */
+    {  403,  403,  1, 30,  0,  0, 0 }, /* ROUTE */
+    {  410,  417, 13, 13, 13, 13, GS1_PREDEF }, /* SHIP TO LOC ... PARTY GLN */
+    {  420,  420,  1, 20,  0,  0, 0 }, /* SHIP TO POST */
+    {  421,  421,  4, 12,  3,  0, 0 }, /* SHIP TO POST */
+    {  422,  422,  3,  3,  3,  0, 0 }, /* ORIGIN */
+    {  423,  423,  4, 15, 15,  0, 0 }, /* COUNTRY INITIAL PROCESS */
+    {  424,  424,  3,  3,  3,  0, 0 }, /* COUNTRY PROCESS */
+    {  425,  425,  4, 15, 15,  0, 0 }, /* COUNTRY DISASSEMBLY */
+    {  426,  426,  3,  3,  3,  0, 0 }, /* COUNTRY FULL PROCESS */
+    {  427,  427,  1,  3,  0,  0, 0 }, /* ORIGIN SUBDIVISION */
+    {  710,  714,  1, 20,  0,  0, 0 }, /* NHRN PZN, CIP, CN, DRN, AIM */
+    { 3100, 3169,  6,  6,  6,  0, GS1_PREDEF }, /* NET WEIGHT ... */
+    { 3200, 3379,  6,  6,  6,  0, GS1_PREDEF }, /* NET WEIGHT (lb) ... */
+    { 3400, 3579,  6,  6,  6,  0, GS1_PREDEF }, /* GROSS WEIGHT (lb) ... */
+    { 3600, 3699,  6,  6,  6,  0, GS1_PREDEF }, /* NET VOLUME ... */
+    { 3900, 3909,  1, 15, 15,  0, 0 }, /* AMOUNT */
+    { 3910, 3919,  4, 18, 18,  0, 0 }, /* AMOUNT */
+    { 3920, 3929,  1, 15, 15,  0, 0 }, /* PRICE */
+    { 3930, 3939,  4, 18, 18,  0, 0 }, /* PRICE */
+    { 3940, 3949,  4,  4,  4,  0, 0 }, /* PRCNT OFF */
+    { 7001, 7001, 13, 13, 13,  0, 0 }, /* NSN */
+    { 7002, 7002,  1, 30,  0,  0, 0 }, /* MEAT CUT */
+    { 7003, 7003, 10, 10, 10,  0, GS1_DATE }, /* EXPIRY TIME */
+    { 7004, 7004,  1,  4,  4,  0, 0 }, /* ACTIVE POTENCY */
+    { 7005, 7005,  1, 12,  0,  0, 0 }, /* CATCH AREA */
+    { 7006, 7006,  6,  6,  6,  0, GS1_DATE }, /* FIRST FREEZE DATE */
+    { 7007, 7007,  6, 12, 12,  0, GS1_DATE | GS1_DATE2 }, /* HARVEST DATE */
+    { 7008, 7008,  1,  3,  0,  0, 0 }, /* AQUATIC SPECIES */
+    { 7009, 7009,  1, 10,  0,  0, 0 }, /* FISHING GEAR TYPE */
+    { 7010, 7010,  1,  2,  0,  0, 0 }, /* PROD METHOD */
+    { 7020, 7022,  1, 20,  0,  0, 0 }, /* REFURB LOT, FUNC STAT, REV STAT */
+    { 7023, 7023,  1, 30,  0,  0, 0 }, /* GIAI ASSEMBLY */
+    { 7030, 7039,  4, 30,  3,  0, 0 }, /* PROCESSOR # */
+    { 7040, 7040,  4,  4,  1,  0, 0 }, /* UIC+EXT */
+    { 7230, 7239,  3, 30,  0,  0, 0 }, /* CERT # */
+    { 7240, 7240,  1, 20,  0,  0, 0 }, /* PROTOCOL */
+    { 8001, 8001, 14, 14, 14,  0, 0 }, /* DIMENSIONS */
+    { 8002, 8002,  1, 20,  0,  0, 0 }, /* CMT NO */
+    { 8003, 8003, 15, 30, 14, 14, 0 }, /* GRAI */
+    { 8004, 8004,  1, 30,  0,  0, 0 }, /* GIAI */
+    { 8005, 8005,  6,  6,  6,  0, 0 }, /* PRICE PER UNIT */
+    { 8006, 8006, 18, 18, 18, 14, 0 }, /* ITIP */
+    { 8007, 8007,  1, 34,  0,  0, 0 }, /* IBAN */
+    { 8008, 8008,  8, 12, 12,  0, GS1_DATE | GS1_STEP2 }, /* PROD TIME */
+    { 8009, 8009,  1, 50,  0,  0, 0 }, /* OPTSEN */
+    { 8010, 8010,  1, 30,  0,  0, GS1_CSET39 }, /* CPID */
+    { 8011, 8011,  1, 12, 12,  0, 0 }, /* CPID SERIAL */
+    { 8012, 8012,  1, 20,  0,  0, 0 }, /* VERSION */
+    { 8013, 8013,  1, 30,  0,  0, 0 }, /* BUDI-DI */
+    { 8017, 8018, 18, 18, 18, 18, 0 }, /* GSRN PROVIDER, GSRN RECIPIENT */
+    { 8019, 8019,  1, 10, 10,  0, 0 }, /* SRIN */
+    { 8020, 8020,  1, 25,  0,  0, 0 }, /* REF NO */
+    { 8026, 8026, 18, 18, 18, 14, 0 }, /* ITIP CONTENT */
+    { 8110, 8110,  1, 70,  0,  0, 0 }, /* Coupon code */
+    { 8111, 8111,  4,  4,  4,  0, 0 }, /* POINTS */
+    { 8112, 8112,  1, 70,  0,  0, 0 }, /* Paperless coupon code */
+    { 8200, 8200,  1, 70,  0,  0, 0 }, /* PRODUCT URL */
+};
+
+/* Binary search for descriptor of AI `ai_value` of `ai_length` digits, returning NULL if not found */
+static const struct gs1_ai_desc *gs1_ai_lookup(const int ai_value, const int ai_length) {
+    int s = 0, e = sizeof(gs1_ais) / sizeof(gs1_ais[0]) - 1;
+
+    /* AIs are 2 to 4 digits, with no leading zero unless 2 digits */
+    if (ai_length != (ai_value < 100 ? 2 : ai_value < 1000 ? 3 : 4)) {
+        return NULL;
+    }
+    while (s <= e) {
+        const int m = (s + e) / 2;
+        if (ai_value < gs1_ais[m].ai) {
+            e = m - 1;
+        } else if (ai_value > gs1_ais[m].ai_end) {
+            s = m + 1;
+        } else {
+            return gs1_ais + m;
         }
     }
-    return count;
+    return NULL;
 }
 
-INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[], const size_t src_len, char reduced[]) {
-    int i, j, last_ai, ai_latch;
-    char ai_string[7]; /* 6 char max "(NNNN)" */
-    int bracket_level, max_bracket_level, ai_length, max_ai_length, min_ai_length;
-    int ai_count;
-    int error_latch;
-    int error_value;
-#ifdef _MSC_VER
-    int *ai_value;
-    int *ai_location;
-    int *data_location;
-    int *data_length;
-#endif
-    int ai_max = ustrchr_cnt(source, src_len, '[') + 1; /* Plus 1 so non-zero */
-#ifndef _MSC_VER
-    int ai_value[ai_max], ai_location[ai_max], data_location[ai_max], data_length[ai_max];
-#else
-    ai_value = (int*) _alloca(ai_max * sizeof(int));
-    ai_location = (int*) _alloca(ai_max * sizeof(int));
-    data_location = (int*) _alloca(ai_max * sizeof(int));
-    data_length = (int*) _alloca(ai_max * sizeof(int));
-#endif
+/* Whether AI with 2-digit prefix `ai_prefix` is of predefined length, figure 7.8.4-2 (used for unknown AIs, which
+   are only let through in ZPL compatibility mode) */
+static int gs1_predef_prefix(const int ai_prefix) {
+    return (ai_prefix >= 0 && ai_prefix <= 4) || (ai_prefix >= 11 && ai_prefix <= 20)
+            || ai_prefix == 23 /* legacy support */ || (ai_prefix >= 31 && ai_prefix <= 36) || ai_prefix == 41;
+}
 
-    /* Detect extended ASCII characters */
-    for (i = 0; i < (int) src_len; i++) {
-        if (source[i] >= 128) {
-            strcpy(symbol->errtxt, "250: Extended ASCII characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] == '\0') {
-            strcpy(symbol->errtxt, "262: NUL characters not permitted in GS1 mode");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] < 32) {
-            strcpy(symbol->errtxt, "251: Control characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] == 127) {
-            strcpy(symbol->errtxt, "263: DEL characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-    }
+/* Whether character in GS1 AI encodable character set 82 (figure 7.11-1) */
+static int gs1_cset82(const unsigned char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '%' && c <= '?') || c == '!' || c == '"'
+            || c == '_';
+}
 
-    if (source[0] != '[') {
-        strcpy(symbol->errtxt, "252: Data does not start with an AI");
-        if (symbol->warn_level != WARN_ZPL_COMPAT) {
-            return ZINT_ERROR_INVALID_DATA;
-        } else {
-            error_value = ZINT_WARN_NONCOMPLIANT;
+/* Whether character in GS1 AI encodable character set 39 (figure 7.11-2) */
+static int gs1_cset39(const unsigned char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '#' || c == '-' || c == '/';
+}
+
+/* Check AI data `data` of length `data_len` against content requirements of `desc`, returning 0 if ok */
+static int gs1_check_content(const struct gs1_ai_desc *desc, const unsigned char data[], const int data_len) {
+    static const char days_in_month[13] = { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int i;
+
+    for (i = 0; i < data_len; i++) {
+        if (i < desc->num_len) {
+            if (data[i] < '0' || data[i] > '9') {
+                return 1;
+            }
+        } else if (desc->flags & GS1_CSET39 ? !gs1_cset39(data[i]) : !gs1_cset82(data[i])) {
+            return 1;
         }
     }
-
-    /* Check the position of the brackets */
-    bracket_level = 0;
-    max_bracket_level = 0;
-    ai_length = 0;
-    max_ai_length = 0;
-    min_ai_length = 5;
-    j = 0;
-    ai_latch = 0;
-    error_value = 0;
-    for (i = 0; i < (int) src_len; i++) {
-        ai_length += j;
-        if (((j == 1) && (source[i] != ']')) && ((source[i] < '0') || (source[i] > '9'))) {
-            ai_latch = 1;
+    if (desc->check && data_len >= desc->check) {
+        int sum = 0;
+        for (i = desc->check - 2; i >= 0; i--) {
+            sum += ((desc->check - 2 - i) & 1 ? 1 : 3) * ctoi(data[i]);
         }
-        if (source[i] == '[') {
-            bracket_level++;
-            j = 1;
+        if (ctoi(data[desc->check - 1]) != (10 - sum % 10) % 10) {
+            return 1;
         }
-        if (source[i] == ']') {
-            bracket_level--;
-            if (ai_length < min_ai_length) {
-                min_ai_length = ai_length;
+    }
+    if (desc->flags & GS1_DATE) {
+        for (i = 0; i < data_len; i += 6) {
+            const int month = ctoi(data[i + 2]) * 10 + ctoi(data[i + 3]);
+            const int day = ctoi(data[i + 4]) * 10 + ctoi(data[i + 5]);
+            /* Day "00" means last day of month */
+            if (month < 1 || month > 12 || day > days_in_month[month]) {
+                return 1;
+            }
+            if (!(desc->flags & GS1_DATE2)) {
+                break;
             }
-            j = 0;
-            ai_length = 0;
-        }
-        if (bracket_level > max_bracket_level) {
-            max_bracket_level = bracket_level;
-        }
-        if (ai_length > max_ai_length) {
-            max_ai_length = ai_length;
         }
     }
-    min_ai_length--;
+    return 0;
+}
 
-    if (bracket_level != 0) {
-        /* Not all brackets are closed */
-        strcpy(symbol->errtxt, "253: Malformed AI in input data (brackets don\'t match)");
-        return ZINT_ERROR_INVALID_DATA;
+/* Whether data length `data_len` allowed by `desc` */
+static int gs1_length_ok(const struct gs1_ai_desc *desc, const int data_len) {
+    if (data_len < desc->min_len || data_len > desc->max_len) {
+        return 0;
+    }
+    if ((desc->flags & GS1_DATE2) && data_len != desc->min_len && data_len != desc->max_len) {
+        return 0;
     }
+    if ((desc->flags & GS1_STEP2) && ((data_len - desc->min_len) & 1)) {
+        return 0;
+    }
+    return 1;
+}
 
-    if (max_bracket_level > 1) {
-        /* Nested brackets */
-        strcpy(symbol->errtxt, "254: Found nested brackets in input data");
+/* Check character is allowed in GS1 data, setting `errtxt` and returning error if not */
+static int gs1_check_char(struct zint_symbol *symbol, const unsigned char c) {
+    if (c >= 128) {
+        strcpy(symbol->errtxt, "250: Extended ASCII characters are not supported by GS1");
         return ZINT_ERROR_INVALID_DATA;
     }
-
-    if (max_ai_length > 4) {
-        /* AI is too long */
-        strcpy(symbol->errtxt, "255: Invalid AI in input data (AI too long)");
+    if (c == '\0') {
+        strcpy(symbol->errtxt, "262: NUL characters not permitted in GS1 mode");
         return ZINT_ERROR_INVALID_DATA;
     }
-
-    if (min_ai_length <= 1) {
-        /* AI is too short */
-        strcpy(symbol->errtxt, "256: Invalid AI in input data (AI too short)");
+    if (c < 32) {
+        strcpy(symbol->errtxt, "251: Control characters are not supported by GS1");
         return ZINT_ERROR_INVALID_DATA;
     }
-
-    if (ai_latch == 1) {
-        /* Non-numeric data in AI */
-        strcpy(symbol->errtxt, "257: Invalid AI in input data (non-numeric characters in AI)");
+    if (c == 127) {
+        strcpy(symbol->errtxt, "263: DEL characters are not supported by GS1");
         return ZINT_ERROR_INVALID_DATA;
     }
+    return 0;
+}
 
-    ai_count = 0;
-    for (i = 1; i < (int) src_len; i++) {
-        if (source[i - 1] == '[') {
-            ai_location[ai_count] = i;
-            j = 0;
-            do {
-                ai_string[j] = source[i + j];
-                j++;
-            } while (ai_string[j - 1] != ']');
-            ai_string[j - 1] = '\0';
-            ai_value[ai_count] = atoi(ai_string);
-            ai_count++;
-        }
-    }
+/* Verify GS1 data `source` in a single pass, validating each AI and its data against the descriptor table and
+   putting the resulting string in `reduced`, where '[' refers to the FNC1 character */
+INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[], const size_t src_len, char reduced[]) {
+    int i, j, k;
+    int ai_value, ai_length, data_start, data_len;
+    int ai_latch;
+    int error_number;
+    int error_value = 0;
+    char ai_string[7]; /* 6 char max "(NNNN)" */
+    const struct gs1_ai_desc *desc;
+    const int length = (int) src_len;
+    const int strict = symbol->input_mode & GS1STRICT_MODE;
 
-    for (i = 0; i < ai_count; i++) {
-        data_location[i] = ai_location[i] + 3;
-        if (ai_value[i] >= 100) {
-            data_location[i]++;
-        }
-        if (ai_value[i] >= 1000) {
-            data_location[i]++;
+    /* Check characters before anything else so that their errors take precedence */
+    for (i = 0; i < length; i++) {
+        if ((error_number = gs1_check_char(symbol, source[i]))) {
+            return error_number;
         }
-        data_length[i] = 0;
-        do {
-            data_length[i]++;
-        } while ((source[data_location[i] + data_length[i] - 1] != '[') && (data_location[i] + data_length[i] <= (int) src_len));
-        data_length[i]--;
     }
 
-    for (i = 0; i < ai_count; i++) {
-        if (data_length[i] == 0) {
-            /* No data for given AI */
-            strcpy(symbol->errtxt, "258: Empty data field in input data");
+    if (source[0] != '[') {
+        strcpy(symbol->errtxt, "252: Data does not start with an AI");
+        if (symbol->warn_level != WARN_ZPL_COMPAT) {
             return ZINT_ERROR_INVALID_DATA;
         }
+        error_value = ZINT_WARN_NONCOMPLIANT;
     }
-    
-    strcpy(ai_string, "");
-    
-    // Check for valid AI values and data lengths according to GS1 General
-    // Specification Release 19, January 2019
-    for (i = 0; i < ai_count; i++) {
-        
-        error_latch = 2;
-        switch (ai_value[i]) {
-            // Length 2 Fixed
-            case 20: // VARIANT
-                if (data_length[i] != 2) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 3 Fixed
-            case 422: // ORIGIN
-            case 424: // COUNTRY PROCESS
-            case 426: // COUNTRY FULL PROCESS
-                if (data_length[i] != 3) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 4 Fixed
-            case 7040: // UIC+EXT
-            case 8111: // POINTS
-                if (data_length[i] != 4) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 6 Fixed
-            case 11: // PROD DATE
-            case 12: // DUE DATE
-            case 13: // PACK DATE
-            case 15: // BEST BY
-            case 16: // SELL BY
-            case 17: // USE BY
-            case 7006: // FIRST FREEZE DATE
-            case 8005: // PRICE PER UNIT
-                if (data_length[i] != 6) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 10 Fixed
-            case 7003: // EXPIRY TIME
-                if (data_length[i] != 10) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 13 Fixed
-            case 410: // SHIP TO LOC
-            case 411: // BILL TO
-            case 412: // PURCHASE FROM
-            case 413: // SHIP FOR LOC
-            case 414: // LOC NO
-            case 415: // PAY TO
-            case 416: // PROD/SERV LOC
-            case 417: // PARTY GLN
-            case 7001: // NSN
-                if (data_length[i] != 13) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 14 Fixed
-            case 1: // GTIN
-            case 2: // CONTENT
-            case 8001: // DIMENSIONS
-                if (data_length[i] != 14) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 17 Fixed
-            case 402: // GSIN
-                if (data_length[i] != 17) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 18 Fixed
-            case 0: // SSCC
-            case 8006: // ITIP
-            case 8017: // GSRN PROVIDER
-            case 8018: // GSRN RECIPIENT
-            case 8026: // ITIP CONTENT
-                if (data_length[i] != 18) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 2 Max
-            case 7010: // PROD METHOD
-                if (data_length[i] > 2) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 3 Max
-            case 427: // ORIGIN SUBDIVISION
-            case 7008: // AQUATIC SPECIES
-                if (data_length[i] > 3) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 4 Max
-            case 7004: // ACTIVE POTENCY
-                if (data_length[i] > 4) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 6 Max
-            case 242: // MTO VARIANT
-                if (data_length[i] > 6) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 8 Max
-            case 30: // VAR COUNT
-            case 37: // COUNT
-                if (data_length[i] > 8) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 10 Max
-            case 7009: // FISHING GEAR TYPE
-            case 8019: // SRIN
-                if (data_length[i] > 10) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 12 Max
-            case 7005: // CATCH AREA
-            case 8011: // CPID SERIAL
-                if (data_length[i] > 12) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 20 Max
-            case 10: // BATCH/LOT
-            case 21: // SERIAL
-            case 22: // CPV
-            case 243: // PCN
-            case 254: // GLN EXTENSION COMPONENT
-            case 420: // SHIP TO POST
-            case 7020: // REFURB LOT
-            case 7021: // FUNC STAT
-            case 7022: // REV STAT
-            case 710: // NHRN PZN
-            case 711: // NHRN CIP
-            case 712: // NHRN CN
-            case 713: // NHRN DRN
-            case 714: // NHRN AIM
-            case 7240: // PROTOCOL
-            case 8002: // CMT NO
-            case 8012: // VERSION
-                if (data_length[i] > 20) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 25 Max
-            case 8020: // REF NO
-                if (data_length[i] > 25) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 28 Max
-            case 235: // TPX
-                if (data_length[i] > 28) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
 
-            // Length 30 Max
-            case 240: // ADDITIONAL ID
-            case 241: // CUST PART NO
-            case 250: // SECONDARY SERIAL
-            case 251: // REF TO SOURCE
-            case 400: // ORDER NUMBER
-            case 401: // GINC
-            case 403: // ROUTE
-            case 7002: // MEAT CUT
-            case 7023: // GIAI ASSEMBLY
-            case 8004: // GIAI
-            case 8010: // CPID
-            case 8013: // BUDI-DI
-            case 90: // INTERNAL
-                if (data_length[i] > 30) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 34 Max
-            case 8007: // IBAN
-                if (data_length[i] > 34) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 50 Max
-            case 8009: // OPTSEN
-                if (data_length[i] > 50) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-            // Length 70 Max
-            case 8110: // Coupon code
-            case 8112: // Paperless coupon code
-            case 8200: // PRODUCT URL
-                if (data_length[i] > 70) {
-                    error_latch = 1;
-                } else {
-                    error_latch = 0;
-                }
-                break;
-                
-        }
-        
-        if (ai_value[i] == 253) { // GDTI
-            if ((data_length[i] < 13) || (data_length[i] > 30)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if (ai_value[i] == 255) { // GCN
-            if ((data_length[i] < 13) || (data_length[i] > 25)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3100) && (ai_value[i] <= 3169)) {
-            if (data_length[i] != 6) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3200) && (ai_value[i] <= 3379)) {
-            if (data_length[i] != 6) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3400) && (ai_value[i] <= 3579)) {
-            if (data_length[i] != 6) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3600) && (ai_value[i] <= 3699)) {
-            if (data_length[i] != 6) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3900) && (ai_value[i] <= 3909)) { // AMOUNT
-            if (data_length[i] > 15) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3910) && (ai_value[i] <= 3919)) { // AMOUNT
-            if ((data_length[i] < 4) || (data_length[i] > 18)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3920) && (ai_value[i] <= 3929)) { // PRICE
-            if (data_length[i] > 15) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3930) && (ai_value[i] <= 3939)) { // PRICE
-            if ((data_length[i] < 4) || (data_length[i] > 18)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] >= 3940) && (ai_value[i] <= 3949)) { // PRCNT OFF
-            if (data_length[i] != 4) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if (ai_value[i] == 421) { // SHIP TO POST
-            if ((data_length[i] < 4) || (data_length[i] > 12)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
-        }
-        
-        if ((ai_value[i] == 423) || (ai_value[i] == 425)) {
-            // COUNTRY INITIAL PROCESS || COUNTRY DISASSEMBLY
-            if ((data_length[i] < 4) || (data_length[i] > 15)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
+    j = 0;
+    ai_latch = 1; /* Set if FNC1 separator not needed before next AI */
+    i = 0;
+    while (i < length) {
+        if (source[i] != '[') {
+            /* Data preceding first AI (ZPL compatibility mode only) */
+            if (source[i] == ']') {
+                strcpy(symbol->errtxt, "253: Malformed AI in input data (brackets don\'t match)");
+                return ZINT_ERROR_INVALID_DATA;
             }
+            reduced[j++] = source[i++];
+            continue;
         }
-        
-        if (ai_value[i] == 7007) { // HARVEST DATE
-            if ((data_length[i] != 6) && (data_length[i] != 12)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
+
+        /* AI */
+        ai_value = 0;
+        for (k = i + 1; k < length && source[k] != ']'; k++) {
+            if (source[k] == '[') {
+                strcpy(symbol->errtxt, "254: Found nested brackets in input data");
+                return ZINT_ERROR_INVALID_DATA;
             }
-        }
-        
-        if ((ai_value[i] >= 7030) && (ai_value[i] <= 7039)) { // PROCESSOR #
-            if ((data_length[i] < 4) || (data_length[i] > 30)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
+            if (source[k] < '0' || source[k] > '9') {
+                strcpy(symbol->errtxt, "257: Invalid AI in input data (non-numeric characters in AI)");
+                return ZINT_ERROR_INVALID_DATA;
             }
-        }
-        
-        if ((ai_value[i] >= 7230) && (ai_value[i] <= 7239)) { // CERT #
-            if ((data_length[i] < 3) || (data_length[i] > 30)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
+            if (k - i <= 4) {
+                ai_value = ai_value * 10 + ctoi(source[k]);
             }
         }
-        
-        if (ai_value[i] == 8003) { // GRAI
-            if ((data_length[i] < 15) || (data_length[i] > 30)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
+        if (k == length) {
+            strcpy(symbol->errtxt, "253: Malformed AI in input data (brackets don\'t match)");
+            return ZINT_ERROR_INVALID_DATA;
         }
-        
-        if (ai_value[i] == 8008) { // PROD TIME
-            if ((data_length[i] != 8) && (data_length[i] != 10) && (data_length[i] != 12)) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
+        ai_length = k - (i + 1);
+        if (ai_length > 4) {
+            strcpy(symbol->errtxt, "255: Invalid AI in input data (AI too long)");
+            return ZINT_ERROR_INVALID_DATA;
         }
-        
-        if ((ai_value[i] >= 91) && (ai_value[i] <= 99)) { // INTERNAL
-            if (data_length[i] > 90) {
-                error_latch = 1;
-            } else {
-                error_latch = 0;
-            }
+        if (ai_length < 2) {
+            strcpy(symbol->errtxt, "256: Invalid AI in input data (AI too short)");
+            return ZINT_ERROR_INVALID_DATA;
         }
 
-        if (error_latch == 1) {
-            itostr(ai_string, ai_value[i]);
-            strcpy(symbol->errtxt, "259: Invalid data length for AI ");
-            strcat(symbol->errtxt, ai_string);
-            if (symbol->warn_level != WARN_ZPL_COMPAT) {
+        /* AI data */
+        data_start = k + 1;
+        for (k = data_start; k < length && source[k] != '['; k++) {
+            if (source[k] == ']') {
+                strcpy(symbol->errtxt, "253: Malformed AI in input data (brackets don\'t match)");
                 return ZINT_ERROR_INVALID_DATA;
-            } else {
-                error_value = ZINT_WARN_NONCOMPLIANT;
             }
         }
+        data_len = k - data_start;
+        if (data_len == 0) {
+            /* No data for given AI */
+            strcpy(symbol->errtxt, "258: Empty data field in input data");
+            return ZINT_ERROR_INVALID_DATA;
+        }
 
-        if (error_latch == 2) {
-            itostr(ai_string, ai_value[i]);
+        desc = gs1_ai_lookup(ai_value, ai_length);
+        error_number = 0;
+        if (desc == NULL) {
+            itostr(ai_string, ai_value);
             strcpy(symbol->errtxt, "260: Invalid AI value ");
             strcat(symbol->errtxt, ai_string);
+            error_number = ZINT_ERROR_INVALID_DATA;
+        } else if (!gs1_length_ok(desc, data_len)) {
+            itostr(ai_string, ai_value);
+            strcpy(symbol->errtxt, "259: Invalid data length for AI ");
+            strcat(symbol->errtxt, ai_string);
+            error_number = ZINT_ERROR_INVALID_DATA;
+        } else if (strict && gs1_check_content(desc, source + data_start, data_len)) {
+            itostr(ai_string, ai_value);
+            strcpy(symbol->errtxt, "261: Invalid data for AI ");
+            strcat(symbol->errtxt, ai_string);
+            error_number = ZINT_ERROR_INVALID_DATA;
+        }
+        if (error_number) {
             if (symbol->warn_level != WARN_ZPL_COMPAT) {
-                return ZINT_ERROR_INVALID_DATA;
-            } else {
-                error_value = ZINT_WARN_NONCOMPLIANT;
+                return error_number;
             }
+            error_value = ZINT_WARN_NONCOMPLIANT;
         }
-    }
 
-    /* Resolve AI data - put resulting string in 'reduced' */
-    j = 0;
-    ai_latch = 1;
-    for (i = 0; i < (int) src_len; i++) {
-        if ((source[i] != '[') && (source[i] != ']')) {
-            reduced[j++] = source[i];
+        /* Resolve AI data - FNC1 separator needed only if previous AI not of predefined length */
+        if (!ai_latch) {
+            reduced[j++] = '[';
         }
-        if (source[i] == '[') {
-            /* Start of an AI string */
-            if (ai_latch == 0) {
-                reduced[j++] = '[';
-            }
-            ai_string[0] = source[i + 1];
-            ai_string[1] = source[i + 2];
-            ai_string[2] = '\0';
-            last_ai = atoi(ai_string);
-            ai_latch = 0;
-            /* The following values from "GS-1 General Specification Release 20.0"
-            figure 7.8.4-2 "Element Strings with Predefined Length Using Application Identifiers" */
-            if (
-                    ((last_ai >= 0) && (last_ai <= 4))
-                    || ((last_ai >= 11) && (last_ai <= 20))
-                    || (last_ai == 23) /* legacy support */
-                    || ((last_ai >= 31) && (last_ai <= 36))
-                    || (last_ai == 41)
-                    ) {
-                ai_latch = 1;
-            }
+        for (k = i + 1; k < i + 1 + ai_length; k++) {
+            reduced[j++] = source[k];
         }
-        /* The ']' character is simply dropped from the input */
+        for (k = data_start; k < data_start + data_len; k++) {
+            reduced[j++] = source[k];
+        }
+        ai_latch = desc ? desc->flags & GS1_PREDEF : gs1_predef_prefix(ctoi(source[i + 1]) * 10 + ctoi(source[i + 2]));
+
+        i = data_start + data_len;
     }
     reduced[j] = '\0';
 
@@ -34,14 +34,13 @@
  * (previously AIMD-015:2010 (Rev 0.8)) */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "reedsol.h"
 #include "hanxin.h"
 #include "gb2312.h"
 #include "gb18030.h"
+#include "parallel.h"
 #include "assert.h"
 
 /* Find which submode to use for a text character */
@@ -339,12 +338,13 @@ static int in_fourbyte(const unsigned int gbdata[], const int length, const int
 
 /* Calculate optimized encoding modes. Adapted from Project Nayuki */
 /* Copyright (c) Project Nayuki. (MIT License) See qr.c for detailed notice */
-static void hx_define_mode(char *mode, const unsigned int gbdata[], const int length, const int debug) {
+static void hx_define_mode(char *mode, char char_modes[], const unsigned int gbdata[], const int length,
+            const int debug) {
     /* Must be in same order as HX_N etc */
     static const char mode_types[] = { 'n', 't', 'b', '1', '2', 'd', 'f', '\0' };
 
     /* Initial mode costs */
-    static unsigned int head_costs[HX_NUM_MODES] = {
+    static const unsigned int head_costs[HX_NUM_MODES] = {
     /*  N            T            B                   1            2            D            F */
         4 * HX_MULT, 4 * HX_MULT, (4 + 13) * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 0
     };
@@ -375,11 +375,6 @@ static void hx_define_mode(char *mode, const unsigned int gbdata[], const int le
     char cur_mode;
     unsigned int prev_costs[HX_NUM_MODES];
     unsigned int cur_costs[HX_NUM_MODES];
-#ifndef _MSC_VER
-    char char_modes[length * HX_NUM_MODES];
-#else
-    char *char_modes = (char *) _alloca(length * HX_NUM_MODES);
-#endif
 
     /* char_modes[i * HX_NUM_MODES + j] represents the mode to encode the code point at index i such that the final
      * segment ends in mode_types[j] and the total number of bits is minimized over all possible choices */
@@ -1334,25 +1329,66 @@ static int hx_evaluate(const unsigned char *local, const int size) {
     return result;
 }
 
+struct hx_mask_ctx {
+    const unsigned char *grid;
+    const unsigned char *mask;
+    unsigned char *locals; /* `size_squared` scratch per thread */
+    int size;
+    int version;
+    int ecc_level;
+    int penalty[4];
+};
+
+/* Evaluate bitmask `pattern` (`parallel_job`). The null pattern 00 sets no bits in `mask` so is just a copy */
+static void hx_mask_job(void *vctx, const int pattern, const int thread) {
+    struct hx_mask_ctx *ctx = (struct hx_mask_ctx *) vctx;
+    const int size_squared = ctx->size * ctx->size;
+    unsigned char *local = ctx->locals + thread * size_squared;
+    const int bit = 1 << pattern;
+    int k;
+
+    for (k = 0; k < size_squared; k++) {
+        if (ctx->mask[k] & bit) {
+            local[k] = ctx->grid[k] ^ 0x01;
+        } else {
+            local[k] = ctx->grid[k] & 0x0f;
+        }
+    }
+    /* Set the Structural Info */
+    hx_set_function_info(local, ctx->size, ctx->version, ctx->ecc_level, pattern, 0 /*debug*/);
+
+    /* Evaluate result */
+    ctx->penalty[pattern] = hx_evaluate(local, ctx->size);
+}
+
 /* Apply the four possible bitmasks for evaluation */
 /* TODO: Haven't been able to replicate (or even get close to) the penalty scores in ISO/IEC 20830
  * (draft 2019-10-10) Annex K examples; however they don't use alternating filler pattern on structural info */
-static void hx_apply_bitmask(unsigned char *grid, const int size, const int version, const int ecc_level,
-            const int user_mask, const int debug) {
+static int hx_apply_bitmask(struct zint_symbol *symbol, unsigned char *grid, const int size, const int version,
+            const int ecc_level, const int user_mask, int threads, const int debug) {
     int x, y;
     int i, j, r, k;
     int pattern, penalty[4] = {0};
     int best_pattern;
     int bit;
     int size_squared = size * size;
-
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char local[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-    unsigned char *local = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-#endif
+    struct hx_mask_ctx ctx;
+    unsigned char *mask = (unsigned char *) scratch_alloc(symbol, size_squared);
+    unsigned char *local = NULL;
+
+    if (mask && !user_mask) {
+        /* Per-thread evaluation buffers, the first doubling as `local` if not spread */
+        if (threads > 1 && !(local = (unsigned char *) scratch_alloc(symbol, (size_t) threads * size_squared))) {
+            threads = 1; /* Fall back to evaluating in turn */
+        }
+        if (!local) {
+            local = (unsigned char *) scratch_alloc(symbol, size_squared);
+        }
+    }
+    if (!mask || (!user_mask && !local)) {
+        strcpy(symbol->errtxt, "543: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* Perform data masking */
     memset(mask, 0, size_squared);
@@ -1381,33 +1417,17 @@ static void hx_apply_bitmask(unsigned char *grid, const int size, const int vers
         best_pattern = user_mask - 1;
     } else {
         // apply data masks to grid, result in local
-
-        /* Do null pattern 00 separately first */
-        pattern = 0;
-        for (k = 0; k < size_squared; k++) {
-            local[k] = grid[k] & 0x0f;
-        }
-        /* Set the Structural Info */
-        hx_set_function_info(local, size, version, ecc_level, pattern, 0 /*debug*/);
-
-        /* Evaluate result */
-        penalty[pattern] = hx_evaluate(local, size);
+        ctx.grid = grid;
+        ctx.mask = mask;
+        ctx.locals = local;
+        ctx.size = size;
+        ctx.version = version;
+        ctx.ecc_level = ecc_level;
+        parallel_for(threads, 4, hx_mask_job, &ctx);
 
         best_pattern = 0;
-        for (pattern = 1; pattern < 4; pattern++) {
-            bit = 1 << pattern;
-            for (k = 0; k < size_squared; k++) {
-                if (mask[k] & bit) {
-                    local[k] = grid[k] ^ 0x01;
-                } else {
-                    local[k] = grid[k] & 0x0f;
-                }
-            }
-            /* Set the Structural Info */
-            hx_set_function_info(local, size, version, ecc_level, pattern, 0 /*debug*/);
-
-            /* Evaluate result */
-            penalty[pattern] = hx_evaluate(local, size);
+        for (pattern = 0; pattern < 4; pattern++) {
+            penalty[pattern] = ctx.penalty[pattern];
             if (penalty[pattern] < penalty[best_pattern]) {
                 best_pattern = pattern;
             }
@@ -1424,7 +1444,7 @@ static void hx_apply_bitmask(unsigned char *grid, const int size, const int vers
 
     /* Apply mask */
     if (best_pattern) { /* If not null mask */
-        if (!user_mask && best_pattern == 3) { /* Reuse last */
+        if (!user_mask && best_pattern == 3 && threads == 1) { /* Reuse last */
             memcpy(grid, local, size_squared);
         } else {
             bit = 1 << best_pattern;
@@ -1437,6 +1457,8 @@ static void hx_apply_bitmask(unsigned char *grid, const int size, const int vers
     }
     /* Set the Structural Info */
     hx_set_function_info(grid, size, version, ecc_level, best_pattern, debug);
+
+    return 0;
 }
 
 /* Han Xin Code - main */
@@ -1450,19 +1472,19 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
     int size_squared;
     int codewords;
     int bin_len;
-
-#ifndef _MSC_VER
-    unsigned int gbdata[(length + 1) * 2];
-    char mode[length];
-#else
-    unsigned int* gbdata = (unsigned int *) _alloca(((length + 1) * 2) * sizeof (unsigned int));
-    char *mode = (char *) _alloca(length);
-    char* binary;
+    unsigned int *gbdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (length + 1) * 2);
+    char *mode = (char *) scratch_alloc(symbol, length);
+    char *char_modes = (char *) scratch_alloc(symbol, (size_t) length * HX_NUM_MODES);
+    char *binary;
     unsigned char *datastream;
     unsigned char *fullstream;
     unsigned char *picket_fence;
     unsigned char *grid;
-#endif
+
+    if (!gbdata || !mode || !char_modes) {
+        strcpy(symbol->errtxt, "543: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* If ZINT_FULL_MULTIBYTE set use Hanzi mode in DATA_MODE or for single-byte Latin */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
@@ -1477,10 +1499,12 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
         int done = 0;
         if (symbol->eci != 29) { /* Unless ECI 29 (GB) */
             /* Try single byte (Latin) conversion first */
-            int error_number = gb18030_utf8tosb(symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source, &length,
-                                    gbdata, full_multibyte);
+            int error_number = gb18030_utf8tosb(symbol, symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source,
+                                    &length, gbdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                return error_number;
             } else if (symbol->eci && symbol->eci <= 899) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
                 return error_number;
@@ -1495,15 +1519,14 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    hx_define_mode(mode, gbdata, length, symbol->debug);
+    hx_define_mode(mode, char_modes, gbdata, length, symbol->debug);
 
     est_binlen = calculate_binlength(mode, gbdata, length, symbol->eci);
 
-#ifndef _MSC_VER
-    char binary[est_binlen + 1];
-#else
-    binary = (char *) _alloca((est_binlen + 1) * sizeof (char));
-#endif
+    if (!(binary = (char *) scratch_alloc(symbol, est_binlen + 1))) {
+        strcpy(symbol->errtxt, "543: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     if ((ecc_level <= 0) || (ecc_level >= 5)) {
         ecc_level = 1;
@@ -1588,17 +1611,14 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
     size = (version * 2) + 21;
     size_squared = size * size;
 
-#ifndef _MSC_VER
-    unsigned char datastream[data_codewords];
-    unsigned char fullstream[hx_total_codewords[version - 1]];
-    unsigned char picket_fence[hx_total_codewords[version - 1]];
-    unsigned char grid[size_squared];
-#else
-    datastream = (unsigned char *) _alloca((data_codewords) * sizeof (unsigned char));
-    fullstream = (unsigned char *) _alloca((hx_total_codewords[version - 1]) * sizeof (unsigned char));
-    picket_fence = (unsigned char *) _alloca((hx_total_codewords[version - 1]) * sizeof (unsigned char));
-    grid = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-#endif
+    datastream = (unsigned char *) scratch_alloc(symbol, data_codewords);
+    fullstream = (unsigned char *) scratch_alloc(symbol, hx_total_codewords[version - 1]);
+    picket_fence = (unsigned char *) scratch_alloc(symbol, hx_total_codewords[version - 1]);
+    grid = (unsigned char *) scratch_alloc(symbol, size_squared);
+    if (!datastream || !fullstream || !picket_fence || !grid) {
+        strcpy(symbol->errtxt, "543: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     memset(datastream, 0, data_codewords);
 
@@ -1642,7 +1662,10 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    hx_apply_bitmask(grid, size, version, ecc_level, user_mask, symbol->debug);
+    if (hx_apply_bitmask(symbol, grid, size, version, ecc_level, user_mask, parallel_threads(symbol, size_squared, 4),
+            symbol->debug)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     symbol->width = size;
     symbol->rows = size;
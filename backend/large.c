@@ -46,9 +46,6 @@
  *   "R128 is released into the public domain. See LICENSE for details." LICENSE is The Unlicense.
  */
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
 #include "large.h"
 
@@ -111,6 +108,10 @@ INTERNAL void large_sub_u64(large_int *t, uint64_t s) {
  *      p11 + k10
  */
 INTERNAL void large_mul_u64(large_int *t, uint64_t s) {
+#ifdef LARGE_INT128
+    const large_uint128 u = large_to_u128(t) * s;
+    large_from_u128(t, u);
+#else
     uint64_t thi = t->hi;
     uint64_t tlo0 = t->lo & MASK32;
     uint64_t tlo1 = t->lo >> 32;
@@ -129,8 +130,10 @@ INTERNAL void large_mul_u64(large_int *t, uint64_t s) {
 
     t->lo = (tmp << 32) + p00; /* (p01 + p10 + k00) << 32 + p00 (note any carry from unmasked p01 shifted out) */
     t->hi = (s1 * tlo1) + k10 + (tmp >> 32) + thi * s; /* p11 + k10 + k01 + thi * s */
+#endif
 }
 
+#if !defined(LARGE_INT128) || defined(ZINT_TEST)
 /* Count leading zeroes. See Hickman `r128__clz64()` */
 STATIC_UNLESS_ZINT_TEST int clz_u64(uint64_t x) {
    uint64_t n = 64, y;
@@ -142,11 +145,18 @@ STATIC_UNLESS_ZINT_TEST int clz_u64(uint64_t x) {
    y = x >>  1; if (y) { n -=  1; x = y; }
    return (int) (n - x);
 }
+#endif
 
 /* Divide 128-bit dividend `t` by 64-bit divisor `v`
  * See Jacob `divmod128by128/64()` and Warren Section 9–2 (divmu64.c.txt)
  * Note digits are 32-bit parts */
 INTERNAL uint64_t large_div_u64(large_int *t, uint64_t v) {
+#ifdef LARGE_INT128
+    const large_uint128 u = large_to_u128(t);
+    const large_uint128 q = u / v;
+    large_from_u128(t, q);
+    return (uint64_t) u - (uint64_t) q * v; /* Remainder, computed modulo 2**64 as less than `v` */
+#else
     const uint64_t b = 0x100000000; /* Number base (2**32) */
     uint64_t qhi = 0; /* High digit of returned quotient */
 
@@ -233,6 +243,7 @@ INTERNAL uint64_t large_div_u64(large_int *t, uint64_t v) {
 
     /* Unnormalize remainder */
     return ((rnhilo1 << 32) + tnlo0 - (qhat0 * v)) >> norm_shift;
+#endif
 }
 
 /* Unset a bit (zero-based) */
@@ -277,16 +288,17 @@ INTERNAL void large_uint_array(const large_int *t, unsigned int *uint_array, int
 /* As `large_uint_array()` above, except output to unsigned char array */
 INTERNAL void large_uchar_array(const large_int *t, unsigned char *uchar_array, int size, int bits) {
     int i;
-#ifndef _MSC_VER
-    unsigned int uint_array[size ? size : 1]; /* Avoid run-time warning if size is 0 */
-#else
-    unsigned int *uint_array = (unsigned int *) _alloca((size ? size : 1) * sizeof(unsigned int));
-#endif
+    unsigned int uint_array[128]; /* No more than 128 elements (of 1 bit each) can be non-zero */
+    const int used = size < 128 ? size : 128;
+    const int lead = size - used;
 
-    large_uint_array(t, uint_array, size, bits);
+    large_uint_array(t, uint_array, used, bits);
 
-    for (i = 0; i < size; i++) {
-        uchar_array[i] = uint_array[i];
+    for (i = 0; i < lead; i++) {
+        uchar_array[i] = 0;
+    }
+    for (i = 0; i < used; i++) {
+        uchar_array[lead + i] = uint_array[i];
     }
 }
 
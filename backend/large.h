@@ -45,6 +45,15 @@ extern "C" {
 
 typedef struct { uint64_t lo; uint64_t hi; } large_int;
 
+/* Use the compiler's native unsigned 128-bit type for multiplication and division where it has one (GCC & clang on
+   64-bit targets), unless `ZINT_NO_INT128` defined */
+#if defined(__SIZEOF_INT128__) && !defined(ZINT_NO_INT128)
+#define LARGE_INT128
+__extension__ typedef unsigned __int128 large_uint128; /* `__extension__` to avoid pedantic warning */
+#define large_to_u128(t) (((large_uint128) (t)->hi << 64) | (t)->lo)
+#define large_from_u128(t, u) do { (t)->lo = (uint64_t) (u); (t)->hi = (uint64_t) ((u) >> 64); } while (0)
+#endif
+
 #define large_lo(s) ((s)->lo)
 #define large_hi(s) ((s)->hi)
 
@@ -36,8 +36,15 @@
 #ifdef _MSC_VER
 #include <malloc.h>
 #endif
+#if !defined(_WIN32) && !defined(ZINT_NO_MMAP)
+#define ZINT_MMAP
+#include <sys/mman.h>
+#endif
 #include "common.h"
 #include "gs1.h"
+#include "filemem.h"
+#include "cache.h"
+#include "scratch.h"
 
 #define TECHNETIUM  "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%"
 
@@ -87,15 +94,20 @@ void ZBarcode_Clear(struct zint_symbol *symbol) {
     memset(symbol->text, 0, sizeof(symbol->text));
     symbol->errtxt[0] = '\0';
     if (symbol->bitmap != NULL) {
-        free(symbol->bitmap);
+        z_free(symbol, symbol->bitmap);
         symbol->bitmap = NULL;
     }
     if (symbol->alphamap != NULL) {
-        free(symbol->alphamap);
+        z_free(symbol, symbol->alphamap);
         symbol->alphamap = NULL;
     }
     symbol->bitmap_width = 0;
     symbol->bitmap_height = 0;
+    if (symbol->memfile != NULL) {
+        z_free(symbol, symbol->memfile);
+        symbol->memfile = NULL;
+    }
+    symbol->memfile_size = 0;
 
     // If there is a rendered version, ensure its memory is released
     vector_free(symbol);
@@ -105,17 +117,21 @@ void ZBarcode_Delete(struct zint_symbol *symbol) {
     if (!symbol) return;
 
     if (symbol->bitmap != NULL)
-        free(symbol->bitmap);
+        z_free(symbol, symbol->bitmap);
     if (symbol->alphamap != NULL)
-        free(symbol->alphamap);
+        z_free(symbol, symbol->alphamap);
+    if (symbol->memfile != NULL)
+        z_free(symbol, symbol->memfile);
 
     // If there is a rendered version, ensure its memory is released
     vector_free(symbol);
 
+    scratch_free(symbol);
+
     free(symbol);
 }
 
-INTERNAL int get_best_eci(unsigned char source[], int length); /* Calculate suitable ECI mode */
+INTERNAL int get_best_eci(struct zint_symbol *symbol, unsigned char source[], int length); /* Calculate suitable ECI mode */
 INTERNAL int utf_to_eci(const int eci, const unsigned char source[], unsigned char dest[], int *length); /* Convert Unicode to other encodings */
 
 INTERNAL int eanx(struct zint_symbol *symbol, unsigned char source[], int length); /* EAN system barcodes */
@@ -146,6 +162,8 @@ INTERNAL int pharma_two(struct zint_symbol *symbol, unsigned char source[], int
 INTERNAL int post_plot(struct zint_symbol *symbol, unsigned char source[], int length); /* Postnet */
 INTERNAL int planet_plot(struct zint_symbol *symbol, unsigned char source[], int length); /* PLANET */
 INTERNAL int imail(struct zint_symbol *symbol, unsigned char source[], int length); /* Intelligent Mail (aka USPS OneCode) */
+INTERNAL int imail_data_pattern(const unsigned char source[], const int length, char data_pattern[66],
+                char errtxt[]); /* Intelligent Mail bar states */
 INTERNAL int royal_plot(struct zint_symbol *symbol, unsigned char source[], int length); /* RM4SCC */
 INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[], int length); /* Australia Post 4-state */
 INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[],const size_t length); /* Code 16k */
@@ -184,6 +202,14 @@ INTERNAL int dpd_parcel(struct zint_symbol *symbol, unsigned char source[], int
 
 INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to PNG/BMP/PCX */
 INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to EPS/EMF/SVG */
+INTERNAL int plot_raster_sheet(struct zint_symbol *sheet, struct zint_symbol *symbol, const int x, const int y,
+            const int rotate_angle); /* Plot onto raster sheet */
+INTERNAL int plot_raster_page(struct zint_symbol *sheet, int file_type); /* Plot raster sheet to PNG/BMP/PCX */
+INTERNAL int plot_raster_into(struct zint_symbol *symbol, const int rotate_angle, const struct zint_pixbuf *dst,
+            const int x, const int y); /* Plot into caller's pixel memory */
+INTERNAL int plot_vector_sheet(struct zint_symbol *sheet, struct zint_symbol *symbol, const float x, const float y,
+            const int rotate_angle); /* Plot onto vector sheet */
+INTERNAL int plot_vector_page(struct zint_symbol *sheet, int file_type); /* Plot vector sheet to EPS/SVG */
 
 static void error_tag(char error_string[], int error_number) {
 
@@ -203,20 +229,16 @@ static void error_tag(char error_string[], int error_number) {
 
 /* Output a hexadecimal representation of the rendered symbol */
 static int dump_plot(struct zint_symbol *symbol) {
-    FILE *f;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int i, r;
     char hex[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8',
         '9', 'A', 'B', 'C', 'D', 'E', 'F'};
     int space = 0;
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        f = stdout;
-    } else {
-        f = fopen(symbol->outfile, "w");
-        if (!f) {
-            strcpy(symbol->errtxt, "201: Could not open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "w")) {
+        strcpy(symbol->errtxt, "201: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     for (r = 0; r < symbol->rows; r++) {
@@ -233,28 +255,27 @@ static int dump_plot(struct zint_symbol *symbol) {
                 }
             }
             if (((i + 1) % 4) == 0) {
-                fputc(hex[byt], f);
+                fm_putc(hex[byt], fmp);
                 space++;
                 byt = 0;
             }
             if (space == 2 && i + 1 < symbol->width) {
-                fputc(' ', f);
+                fm_putc(' ', fmp);
                 space = 0;
             }
         }
 
         if ((symbol->width % 4) != 0) {
             byt = byt << (4 - (symbol->width % 4));
-            fputc(hex[byt], f);
+            fm_putc(hex[byt], fmp);
         }
-        fputs("\n", f);
+        fm_putc('\n', fmp);
         space = 0;
     }
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(f);
-    } else {
-        fclose(f);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "243: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     return 0;
@@ -739,19 +760,18 @@ static int reduced_charset(struct zint_symbol *symbol, unsigned char *source, in
     /* These are the "norm" standards which only support Latin-1 at most, though a few support ECI */
     int error_number = 0;
     unsigned char *preprocessed = source;
-
-#ifndef _MSC_VER
-    unsigned char preprocessed_buf[in_length + 1];
-#else
-    unsigned char *preprocessed_buf = (unsigned char *) _alloca(in_length + 1);
-#endif
+    const size_t mark = scratch_mark(symbol);
 
     if ((symbol->input_mode & 0x07) == UNICODE_MODE) {
         /* Prior check ensures ECI only set for those that support it */
-        preprocessed = preprocessed_buf;
+        if (!(preprocessed = (unsigned char *) scratch_alloc(symbol, in_length + 1))) {
+            strcpy(symbol->errtxt, "317: Insufficient memory for input buffer");
+            return ZINT_ERROR_MEMORY;
+        }
         error_number = utf_to_eci(symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source, preprocessed, &in_length);
         if (error_number != 0) {
             strcpy(symbol->errtxt, "204: Invalid characters in input data");
+            scratch_release(symbol, mark);
             return error_number;
         }
     }
@@ -921,6 +941,8 @@ static int reduced_charset(struct zint_symbol *symbol, unsigned char *source, in
             break;
     }
 
+    scratch_release(symbol, mark);
+
     return error_number;
 }
 
@@ -943,12 +965,12 @@ static int escape_char_process(struct zint_symbol *symbol, unsigned char *input_
     int in_posn, out_posn;
     int hex1, hex2;
     int i, unicode;
+    unsigned char *escaped_string = (unsigned char *) scratch_alloc(symbol, *length + 1);
 
-#ifndef _MSC_VER
-    unsigned char escaped_string[*length + 1];
-#else
-    unsigned char* escaped_string = (unsigned char*) _alloca(*length + 1);
-#endif
+    if (!escaped_string) {
+        strcpy(symbol->errtxt, "318: Insufficient memory for escape buffer");
+        return ZINT_ERROR_MEMORY;
+    }
 
     in_posn = 0;
     out_posn = 0;
@@ -1069,15 +1091,15 @@ static int escape_char_process(struct zint_symbol *symbol, unsigned char *input_
     return error_number;
 }
 
-int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length) {
+/* Encode without reference to the cache */
+static int encode_symbol(struct zint_symbol *symbol, const unsigned char *source, int in_length) {
     int error_number, error_buffer;
-#ifdef _MSC_VER
-    unsigned char* local_source;
-#endif
+    unsigned char *local_source;
 
     if (!symbol) return ZINT_ERROR_INVALID_DATA;
 
     error_number = 0;
+    scratch_reset(symbol, 1 /*new_peak*/);
 
     if (source == NULL) {
         strcpy(symbol->errtxt, "200: Input data NULL");
@@ -1100,11 +1122,11 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
         strcpy(symbol->outfile, "out.png");
 #endif
     }
-#ifndef _MSC_VER
-    unsigned char local_source[in_length + 1];
-#else
-    local_source = (unsigned char*) _alloca(in_length + 1);
-#endif
+    if (!(local_source = (unsigned char *) scratch_alloc(symbol, in_length + 1))) {
+        strcpy(symbol->errtxt, "317: Insufficient memory for input buffer");
+        error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* First check the symbology field */
     if (!ZBarcode_ValidID(symbol->symbology)) {
@@ -1279,11 +1301,12 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
         if (gs1_compliant(symbol->symbology) == 1) {
             // Reduce input for composite and non-forced symbologies, others (EAN128 and RSS_EXP based) will handle it themselves
             if (is_composite(symbol->symbology) || !check_force_gs1(symbol->symbology)) {
-#ifndef _MSC_VER
-                char reduced[in_length + 1];
-#else
-                char* reduced = (char*) _alloca(in_length + 1);
-#endif
+                char *reduced = (char *) scratch_alloc(symbol, in_length + 1);
+                if (!reduced) {
+                    strcpy(symbol->errtxt, "343: Insufficient memory for GS1 buffer");
+                    error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+                    return ZINT_ERROR_MEMORY;
+                }
                 error_number = gs1_verify(symbol, local_source, in_length, reduced);
                 if (error_number != 0) {
                     if (is_composite(symbol->symbology)) {
@@ -1307,7 +1330,11 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
     if ((error_number == ZINT_ERROR_INVALID_DATA) && symbol->eci == 0 && supports_eci(symbol->symbology)
             && (symbol->input_mode & 0x07) == UNICODE_MODE) {
         /* Try another ECI mode */
-        symbol->eci = get_best_eci(local_source, in_length);
+        if (!(symbol->eci = get_best_eci(symbol, local_source, in_length))) {
+            strcpy(symbol->errtxt, "357: Insufficient memory for ECI buffer");
+            error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+            return ZINT_ERROR_MEMORY;
+        }
 
         error_number = extended_or_reduced_charset(symbol, local_source, in_length);
 
@@ -1332,10 +1359,122 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
     return error_number;
 }
 
+int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length) {
+    struct cache_key key;
+    int error_number;
+
+    if (!symbol || source == NULL) {
+        return encode_symbol(symbol, source, in_length);
+    }
+    if (in_length <= 0) {
+        in_length = (int) ustrlen(source);
+    }
+    if (in_length <= 0 || !cache_key(&key, symbol, source, in_length)) {
+        return encode_symbol(symbol, source, in_length);
+    }
+
+    if ((error_number = cache_get(&key, symbol)) != -1) {
+        if (strcmp(symbol->outfile, "") == 0) {
+#ifdef NO_PNG
+            strcpy(symbol->outfile, "out.gif");
+#else
+            strcpy(symbol->outfile, "out.png");
+#endif
+        }
+        return error_number;
+    }
+
+    error_number = encode_symbol(symbol, source, in_length);
+    if (error_number < ZINT_ERROR) {
+        cache_put(&key, symbol, error_number);
+    }
+
+    return error_number;
+}
+
+/* Set the number of encodes the cache may hold, 0 (the default) disabling it. Any cached encodes are discarded */
+int ZBarcode_Cache_Size(int max_entries) {
+    return cache_size(max_entries);
+}
+
+/* Get the number of cache lookups found and not found since the cache was last sized, and its number of entries */
+void ZBarcode_Cache_Stats(unsigned long *hits, unsigned long *misses, int *entries) {
+    cache_stats(hits, misses, entries);
+}
+
+/* Get the most working memory in bytes held at once by `symbol` during its last encode and any output since */
+unsigned long ZBarcode_Scratch_Peak(const struct zint_symbol *symbol) {
+    return symbol ? (unsigned long) scratch_peak(symbol) : 0;
+}
+
+/* Route all memory allocated for `symbol` through `allocator`, or through the system allocator if `allocator` NULL.
+   Any output and working memory `symbol` already holds is freed first (as with `ZBarcode_Clear()`) */
+int ZBarcode_SetAllocator(struct zint_symbol *symbol, const struct zint_allocator *allocator) {
+    if (!symbol) return ZINT_ERROR_INVALID_OPTION;
+
+    if (allocator && (!allocator->malloc_fn || !allocator->realloc_fn || !allocator->free_fn)) {
+        strcpy(symbol->errtxt, "264: Allocator requires malloc, realloc and free functions");
+        error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    ZBarcode_Clear(symbol);
+    scratch_free(symbol);
+
+    if (allocator) {
+        symbol->allocator = *allocator;
+    } else {
+        memset(&symbol->allocator, 0, sizeof(symbol->allocator));
+    }
+
+    return 0;
+}
+
+/* Encode `count` Intelligent Mail Barcodes, each "tracking[-routing]" as given to `ZBarcode_Encode()`, without a
+   symbol. The bar states of `sources[i]` (of length `lengths[i]`, or NUL-terminated if `lengths` NULL) are placed
+   NUL-terminated at `bar_states + i * ZINT_IMAIL_BAR_STATES` as 'F' (full), 'A' (ascender), 'D' (descender) or
+   'T' (tracker), or as an empty string if the input is invalid. If `errors` non-NULL each item's error code is
+   placed there. Returns the most severe error code of any item, 0 if all encoded */
+int ZBarcode_Encode_IMail_Batch(const unsigned char *const *sources, const int *lengths, int count,
+                char *bar_states, int *errors) {
+    static const char states[4] = { 'F', 'A', 'D', 'T' };
+    char errtxt[100];
+    int i, j, error_number, ret = 0;
+
+    if (!sources || !bar_states || count < 0) {
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    for (i = 0; i < count; i++, bar_states += ZINT_IMAIL_BAR_STATES) {
+        if (!sources[i]) {
+            error_number = ZINT_ERROR_INVALID_DATA;
+        } else {
+            const int length = lengths ? lengths[i] : (int) ustrlen(sources[i]);
+            error_number = imail_data_pattern(sources[i], length, bar_states, errtxt);
+        }
+        if (error_number) {
+            bar_states[0] = '\0';
+            if (error_number > ret) {
+                ret = error_number;
+            }
+        } else {
+            for (j = 0; j < 65; j++) {
+                bar_states[j] = states[bar_states[j] - '0'];
+            }
+        }
+        if (errors) {
+            errors[i] = error_number;
+        }
+    }
+
+    return ret;
+}
+
 int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle) {
     int error_number;
 
     if (!symbol) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(symbol, 0 /*new_peak*/);
 
     switch (rotate_angle) {
         case 0:
@@ -1425,6 +1564,7 @@ int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle) {
     int error_number;
 
     if (!symbol) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(symbol, 0 /*new_peak*/);
 
     switch (rotate_angle) {
         case 0:
@@ -1451,10 +1591,74 @@ int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle) {
     return error_number;
 }
 
+/* Bytes taken by a row of `width` pixels of pixel buffer format, -1 if unknown */
+static int pixbuf_row_size(const int format, const int width) {
+    switch (format) {
+        case ZINT_PIXEL_MONO1:
+            return (width + 7) / 8;
+        case ZINT_PIXEL_GRAY8:
+        case ZINT_PIXEL_PALETTE8:
+            return width;
+        case ZINT_PIXEL_RGB24:
+            return width * 3;
+        case ZINT_PIXEL_RGBA32:
+        case ZINT_PIXEL_RGBA32_PRE:
+        case ZINT_PIXEL_BGRA32_PRE:
+            return width * 4;
+    }
+    return -1;
+}
+
+/* Render encoded `symbol` into the caller's pixel memory `dst` with its top left corner at pixel `x`, `y`, instead of
+   into `bitmap`/`alphamap`. Pixels of `dst` outside the symbol are left untouched */
+int ZBarcode_Buffer_Into(struct zint_symbol *symbol, int rotate_angle, const struct zint_pixbuf *dst, int x, int y) {
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(symbol, 0 /*new_peak*/);
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbol->errtxt, "294: Invalid rotation angle");
+            error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    if (symbol->output_options & BARCODE_DOTTY_MODE) {
+        if (!(is_dotty(symbol->symbology))) {
+            strcpy(symbol->errtxt, "295: Selected symbology cannot be rendered as dots");
+            error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+    }
+
+    if (!dst || pixbuf_row_size(dst->format, 0) == -1) {
+        strcpy(symbol->errtxt, "296: Unknown pixel buffer format");
+        error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+    if ((!dst->pixels && dst->width && dst->height) || dst->width < 0 || dst->height < 0
+            || dst->stride < pixbuf_row_size(dst->format, dst->width)) {
+        strcpy(symbol->errtxt, "297: Invalid pixel buffer");
+        error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    error_number = plot_raster_into(symbol, rotate_angle, dst, x, y);
+    error_tag(symbol->errtxt, error_number);
+    return error_number;
+}
+
 int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle) {
     int error_number;
 
     if (!symbol) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(symbol, 0 /*new_peak*/);
 
     switch (rotate_angle) {
         case 0:
@@ -1481,6 +1685,144 @@ int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle) {
     return error_number;
 }
 
+/* Output file type of a sheet given by its `outfile` extension, -1 if not available */
+static int sheet_file_type(const struct zint_symbol *sheet) {
+    static const char extensions[][4] = { "PNG", "BMP", "PCX", "GIF", "TIF", "EPS", "SVG" };
+    static const int file_types[] = {
+        OUT_PNG_FILE, OUT_BMP_FILE, OUT_PCX_FILE, OUT_GIF_FILE, OUT_TIF_FILE, OUT_EPS_FILE, OUT_SVG_FILE
+    };
+    const int len = (int) strlen(sheet->outfile);
+    char output[4];
+    int i;
+
+    if (len <= 3) {
+        return -1;
+    }
+    memcpy(output, sheet->outfile + len - 3, 4);
+    to_upper((unsigned char *) output);
+    for (i = 0; i < (int) (sizeof(file_types) / sizeof(file_types[0])); i++) {
+        if (strcmp(output, extensions[i]) == 0) {
+            return file_types[i];
+        }
+    }
+    return -1;
+}
+
+/* Start a page of `width` x `height` pixels (raster) or units (vector) for symbols to be placed on by
+   `ZBarcode_Sheet_Add()`, its format given by the `outfile` extension */
+int ZBarcode_Sheet_Begin(struct zint_symbol *sheet, int width, int height) {
+    int file_type;
+
+    if (!sheet) return ZINT_ERROR_INVALID_DATA;
+
+    file_type = sheet_file_type(sheet);
+    ZBarcode_Clear(sheet);
+
+    if (file_type == -1) {
+        strcpy(sheet->errtxt, "244: Unknown or unsupported output format for sheet");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+    if (width < 1 || height < 1 || width > 65535 || height > 65535) {
+        strcpy(sheet->errtxt, "245: Invalid sheet size (1 to 65535 only)");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    if (file_type < OUT_PNG_FILE) {
+        if (!(sheet->vector = (struct zint_vector *) z_calloc(sheet, sizeof(struct zint_vector)))) {
+            strcpy(sheet->errtxt, "246: Insufficient memory for sheet");
+            error_tag(sheet->errtxt, ZINT_ERROR_MEMORY);
+            return ZINT_ERROR_MEMORY;
+        }
+        sheet->vector->width = (float) width;
+        sheet->vector->height = (float) height;
+    } else {
+        if (!(sheet->bitmap = (unsigned char *) z_malloc(sheet, (size_t) width * height))) {
+            strcpy(sheet->errtxt, "247: Insufficient memory for sheet");
+            error_tag(sheet->errtxt, ZINT_ERROR_MEMORY);
+            return ZINT_ERROR_MEMORY;
+        }
+        memset(sheet->bitmap, '0', (size_t) width * height); /* Paper */
+        sheet->bitmap_width = width;
+        sheet->bitmap_height = height;
+    }
+
+    return 0;
+}
+
+/* Render encoded `symbol` onto the page of `sheet` with its top left corner at `x`, `y` */
+int ZBarcode_Sheet_Add(struct zint_symbol *sheet, struct zint_symbol *symbol, float x, float y, int rotate_angle) {
+    int error_number;
+
+    if (!sheet || !symbol) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(symbol, 0 /*new_peak*/);
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(sheet->errtxt, "248: Invalid rotation angle");
+            error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    if ((symbol->output_options & BARCODE_DOTTY_MODE) && !is_dotty(symbol->symbology)) {
+        strcpy(sheet->errtxt, "249: Selected symbology cannot be rendered as dots");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    /* Output of Ultracode colours depends on the symbology of the page as a whole */
+    if ((symbol->symbology == BARCODE_ULTRA) != (sheet->symbology == BARCODE_ULTRA)) {
+        strcpy(sheet->errtxt, "298: Ultracode can only be placed on sheets of symbology Ultracode");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    if (sheet->vector) {
+        error_number = plot_vector_sheet(sheet, symbol, x, y, rotate_angle);
+    } else if (sheet->bitmap) {
+        error_number = plot_raster_sheet(sheet, symbol, (int) x, (int) y, rotate_angle);
+    } else {
+        strcpy(sheet->errtxt, "299: Sheet not begun");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    strcpy(sheet->errtxt, symbol->errtxt);
+    error_tag(sheet->errtxt, error_number);
+    return error_number;
+}
+
+/* Write the page of `sheet` to its `outfile` */
+int ZBarcode_Sheet_Print(struct zint_symbol *sheet) {
+    int error_number;
+    int file_type;
+
+    if (!sheet) return ZINT_ERROR_INVALID_DATA;
+    scratch_reset(sheet, 0 /*new_peak*/);
+
+    file_type = sheet_file_type(sheet);
+    if ((file_type < OUT_PNG_FILE && !sheet->vector) || (file_type >= OUT_PNG_FILE && !sheet->bitmap)) {
+        /* Not begun, or `outfile` changed to another kind of format since */
+        strcpy(sheet->errtxt, "300: Sheet not begun for this output format");
+        error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    if (sheet->vector) {
+        error_number = plot_vector_page(sheet, file_type);
+    } else {
+        error_number = plot_raster_page(sheet, file_type);
+    }
+    error_tag(sheet->errtxt, error_number);
+    return error_number;
+}
+
 int ZBarcode_Encode_and_Print(struct zint_symbol *symbol, unsigned char *input, int length, int rotate_angle) {
     int error_number;
     int first_err;
@@ -1582,8 +1924,21 @@ int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
         }
     }
 
+#ifdef ZINT_MMAP
+    /* Encode straight from a read-only mapping of the file if possible, falling back to reading it below */
+    if (file_opened) {
+        void *mapped = mmap(NULL, (size_t) fileLen, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (mapped != MAP_FAILED) {
+            fclose(file);
+            ret = ZBarcode_Encode(symbol, (const unsigned char *) mapped, (int) fileLen);
+            (void) munmap(mapped, (size_t) fileLen);
+            return ret;
+        }
+    }
+#endif
+
     /* Allocate memory */
-    buffer = (unsigned char *) malloc(fileLen * sizeof (unsigned char));
+    buffer = (unsigned char *) z_malloc(symbol, fileLen * sizeof (unsigned char));
     if (!buffer) {
         strcpy(symbol->errtxt, "231: Internal memory error");
         error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
@@ -1603,7 +1958,7 @@ int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
             if (file_opened) {
                 fclose(file);
             }
-            free(buffer);
+            z_free(symbol, buffer);
             return ZINT_ERROR_INVALID_DATA;
         }
         nRead += n;
@@ -1613,7 +1968,57 @@ int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
         fclose(file);
     }
     ret = ZBarcode_Encode(symbol, buffer, nRead);
-    free(buffer);
+    z_free(symbol, buffer);
+    return ret;
+}
+
+/* Encode the concatenation of `count` spans as if given to `ZBarcode_Encode()` in one buffer. The data of `spans[i]`
+   is `spans[i].length` bytes at `spans[i].source`, or NUL-terminated if `spans[i].length` <= 0. A single span is
+   passed through without being gathered */
+int ZBarcode_Encode_Spans(struct zint_symbol *symbol, const struct zint_span *spans, int count) {
+    unsigned char *buffer, *b;
+    int lengths[ZINT_MAX_SPANS];
+    int i, length = 0;
+    int ret;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!spans || count <= 0 || count > ZINT_MAX_SPANS) {
+        sprintf(symbol->errtxt, "265: Spans NULL or count %d not in range 1 to %d", count, ZINT_MAX_SPANS);
+        error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        return ZINT_ERROR_INVALID_DATA;
+    }
+    if (count == 1) {
+        return ZBarcode_Encode(symbol, spans[0].source, spans[0].length);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!spans[i].source) {
+            sprintf(symbol->errtxt, "266: Span %d data NULL", i);
+            error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+            return ZINT_ERROR_INVALID_DATA;
+        }
+        lengths[i] = spans[i].length > 0 ? spans[i].length : (int) ustrlen(spans[i].source);
+        if (lengths[i] > ZINT_MAX_FILE_LEN - length) {
+            strcpy(symbol->errtxt, "267: Input spans too long");
+            error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+            return ZINT_ERROR_TOO_LONG;
+        }
+        length += lengths[i];
+    }
+
+    if (!(buffer = (unsigned char *) z_malloc(symbol, length + 1))) {
+        strcpy(symbol->errtxt, "268: Insufficient memory for input spans");
+        error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+        return ZINT_ERROR_MEMORY;
+    }
+    for (i = 0, b = buffer; i < count; b += lengths[i], i++) {
+        memcpy(b, spans[i].source, lengths[i]);
+    }
+    *b = '\0';
+
+    ret = ZBarcode_Encode(symbol, buffer, length);
+    z_free(symbol, buffer);
     return ret;
 }
 
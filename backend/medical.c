@@ -41,7 +41,7 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], const size_
 #define CALCIUM         "0123456789-$:/.+ABCD"
 #define CALCIUM_INNER   "0123456789-$:/.+"
 
-static const char *CodaTable[20] = {
+static const char CodaTable[20][8] = {
     "11111221", "11112211", "11121121", "22111111", "11211211", "21111211",
     "12111121", "12112111", "12211111", "21121111", "11122111", "11221111", "21112121", "21211121",
     "21212111", "11212121", "11221211", "12121121", "11121221", "11122211"
@@ -63,8 +63,9 @@ INTERNAL int pharma_one(struct zint_symbol *symbol, unsigned char source[], int
 
     unsigned long int tester;
     int counter, error_number, h;
-    char inter[18] = {0}; /* 131070 -> 17 bits */
+    char inter[18]; /* 131070 -> 17 bits */
     char dest[64]; /* 17 * 2 + 1 */
+    char *d = dest;
 
     if (length > 6) {
         strcpy(symbol->errtxt, "350: Input too long");
@@ -83,27 +84,22 @@ INTERNAL int pharma_one(struct zint_symbol *symbol, unsigned char source[], int
         return ZINT_ERROR_INVALID_DATA;
     }
 
+    h = 0;
     do {
         if (!(tester & 1)) {
-            strcat(inter, "W");
+            inter[h++] = 'W';
             tester = (tester - 2) / 2;
         } else {
-            strcat(inter, "N");
+            inter[h++] = 'N';
             tester = (tester - 1) / 2;
         }
     } while (tester != 0);
 
-    h = strlen(inter) - 1;
-    *dest = '\0';
-    for (counter = h; counter >= 0; counter--) {
-        if (inter[counter] == 'W') {
-            strcat(dest, "32");
-        } else {
-            strcat(dest, "12");
-        }
+    for (counter = h - 1; counter >= 0; counter--, d += 2) {
+        memcpy(d, inter[counter] == 'W' ? "32" : "12", 2);
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     return error_number;
 }
@@ -197,11 +193,11 @@ INTERNAL int pharma_two(struct zint_symbol *symbol, unsigned char source[], int
 INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int length) {
 
     int i, error_number;
-    char dest[512];
+    int posns[60];
+    char dest[512]; /* 61 * 8 + 1 */
+    char *d = dest;
     int add_checksum, count, checksum;
 
-    strcpy(dest, "");
-
     if (length > 60) { /* No stack smashing please */
         strcpy(symbol->errtxt, "356: Input too long");
         return ZINT_ERROR_TOO_LONG;
@@ -227,11 +223,13 @@ INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     /* And must not use A, B, C or D otherwise (BS EN 798:1995 4.3.2) */
-    error_number = is_sane(CALCIUM_INNER, source + 1, length - 2);
+    error_number = is_sane_lookup(CALCIUM_INNER, 16, source + 1, length - 2, posns + 1);
     if (error_number) {
         strcpy(symbol->errtxt, "363: Cannot contain \"A\", \"B\", \"C\" or \"D\"");
         return error_number;
     }
+    posns[0] = source[0] - 'A' + 16;
+    posns[length - 1] = source[length - 1] - 'A' + 16;
 
     add_checksum = symbol->option_2 == 1;
     if (add_checksum) {
@@ -240,7 +238,7 @@ INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int len
 
     for (i = 0; i < length; i++) {
         if (add_checksum) {
-            count += strchr(CALCIUM, source[i]) - CALCIUM;
+            count += posns[i];
             if (i + 1 == length) {
                 checksum = count % 16;
                 if (checksum) {
@@ -249,13 +247,15 @@ INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int len
                 if (symbol->debug & ZINT_DEBUG_PRINT) {
                     printf("Codabar: %s, count %d, checksum %d\n", source, count, checksum);
                 }
-                strcat(dest, CodaTable[checksum]);
+                memcpy(d, CodaTable[checksum], 8);
+                d += 8;
             }
         }
-        lookup(CALCIUM, CodaTable, source[i], dest);
+        memcpy(d, CodaTable[posns[i]], 8);
+        d += 8;
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return error_number;
 }
@@ -585,3 +585,51 @@ INTERNAL void output_upcean_split_text(int upceanflag, unsigned char text[],
         textpart3[6] = '\0';
     }
 }
+
+/* Switch the calling thread only to the "C" numeric locale, so that vector output always uses '.' as decimal
+   point, saving its current one in `saved`. Where per-thread locales aren't available the process's locale is
+   switched, which isn't thread-safe */
+INTERNAL void output_c_locale(struct output_locale *saved) {
+#if defined(_WIN32)
+    const char *name;
+
+    saved->per_thread = _configthreadlocale(_ENABLE_PER_THREAD_LOCALE);
+    name = setlocale(LC_NUMERIC, NULL);
+    if (name && strlen(name) < sizeof(saved->name)) {
+        strcpy(saved->name, name);
+        setlocale(LC_NUMERIC, "C");
+    } else {
+        saved->name[0] = '\0';
+    }
+#elif defined(LC_NUMERIC_MASK)
+    saved->c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0);
+    saved->previous = saved->c_locale ? uselocale(saved->c_locale) : (locale_t) 0;
+#else
+    const char *name = setlocale(LC_NUMERIC, NULL);
+    if (name && strlen(name) < sizeof(saved->name)) {
+        strcpy(saved->name, name);
+        setlocale(LC_NUMERIC, "C");
+    } else {
+        saved->name[0] = '\0';
+    }
+#endif
+}
+
+/* Restore the numeric locale saved by `output_c_locale()` */
+INTERNAL void output_restore_locale(struct output_locale *saved) {
+#if defined(_WIN32)
+    if (saved->name[0]) {
+        setlocale(LC_NUMERIC, saved->name);
+    }
+    _configthreadlocale(saved->per_thread);
+#elif defined(LC_NUMERIC_MASK)
+    if (saved->c_locale) {
+        uselocale(saved->previous);
+        freelocale(saved->c_locale);
+    }
+#else
+    if (saved->name[0]) {
+        setlocale(LC_NUMERIC, saved->name);
+    }
+#endif
+}
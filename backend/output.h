@@ -33,6 +33,21 @@
 #ifndef OUTPUT_H
 #define OUTPUT_H
 
+#include <locale.h>
+
+/* Numeric locale of the calling thread as saved by `output_c_locale()` */
+struct output_locale {
+#if defined(_WIN32)
+    int per_thread; /* Previous `_configthreadlocale()` setting */
+    char name[128];
+#elif defined(LC_NUMERIC_MASK)
+    locale_t c_locale;
+    locale_t previous;
+#else
+    char name[128];
+#endif
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -43,6 +58,8 @@ INTERNAL int output_process_upcean(struct zint_symbol *symbol, int *p_main_width
 INTERNAL float output_large_bar_height(struct zint_symbol *symbol);
 INTERNAL void output_upcean_split_text(int upceanflag, unsigned char text[],
                 unsigned char textpart1[], unsigned char textpart2[], unsigned char textpart3[], unsigned char textpart4[]);
+INTERNAL void output_c_locale(struct output_locale *saved);
+INTERNAL void output_restore_locale(struct output_locale *saved);
 
 #ifdef __cplusplus
 }
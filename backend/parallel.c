@@ -0,0 +1,161 @@
+/* parallel.c - Spread independent candidate evaluations over threads */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+#include "common.h"
+#include "parallel.h"
+
+struct parallel_worker {
+    parallel_job job;
+    void *ctx;
+    int count;
+    int threads;
+    int thread;
+};
+
+/* Do the jobs allotted to a thread, i.e. every `threads`th one starting at `thread` */
+static void parallel_run(const struct parallel_worker *worker) {
+    int i;
+
+    for (i = worker->thread; i < worker->count; i += worker->threads) {
+        worker->job(worker->ctx, i, worker->thread);
+    }
+}
+
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+static DWORD WINAPI parallel_thread(LPVOID arg) {
+    parallel_run((const struct parallel_worker *) arg);
+    return 0;
+}
+#else
+static void *parallel_thread(void *arg) {
+    parallel_run((const struct parallel_worker *) arg);
+    return NULL;
+}
+#endif
+#endif /* ZINT_NO_THREADS */
+
+/* Return number of threads (including the calling one) to use for a search of `count` candidates on a symbol of
+   `modules` modules. This is 1 unless `symbol->threads` is greater than 1 and the symbol large enough to benefit */
+INTERNAL int parallel_threads(const struct zint_symbol *symbol, const int modules, const int count) {
+#ifdef ZINT_NO_THREADS
+    (void)symbol; (void)modules; (void)count;
+    return 1;
+#else
+    int threads = symbol->threads;
+
+    if (threads <= 1 || count <= 1 || modules < PARALLEL_MIN_MODULES) {
+        return 1;
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    return threads;
+#endif
+}
+
+/* Call `job(ctx, index, thread)` for each `index` 0 to `count - 1`, spread over `threads` threads including the
+   calling one, and wait for all to finish. Each index is always given to the same thread, and jobs of a thread that
+   can't be started are done by the calling thread afterwards, so per-thread scratch space is never shared */
+INTERNAL void parallel_for(int threads, const int count, parallel_job job, void *ctx) {
+    struct parallel_worker workers[PARALLEL_MAX_THREADS];
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+    HANDLE handles[PARALLEL_MAX_THREADS];
+#else
+    pthread_t handles[PARALLEL_MAX_THREADS];
+#endif
+    int started[PARALLEL_MAX_THREADS];
+#endif
+    int t;
+
+#ifdef ZINT_NO_THREADS
+    threads = 1;
+#else
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+#endif
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    for (t = 0; t < threads; t++) {
+        workers[t].job = job;
+        workers[t].ctx = ctx;
+        workers[t].count = count;
+        workers[t].threads = threads;
+        workers[t].thread = t;
+    }
+
+#ifndef ZINT_NO_THREADS
+    for (t = 1; t < threads; t++) {
+#ifdef _WIN32
+        handles[t] = CreateThread(NULL, 0, parallel_thread, &workers[t], 0, NULL);
+        started[t] = handles[t] != NULL;
+#else
+        started[t] = pthread_create(&handles[t], NULL, parallel_thread, &workers[t]) == 0;
+#endif
+    }
+#endif
+
+    parallel_run(&workers[0]);
+
+#ifndef ZINT_NO_THREADS
+    for (t = 1; t < threads; t++) {
+        if (started[t]) {
+#ifdef _WIN32
+            WaitForSingleObject(handles[t], INFINITE);
+            CloseHandle(handles[t]);
+#else
+            pthread_join(handles[t], NULL);
+#endif
+        } else {
+            parallel_run(&workers[t]);
+        }
+    }
+#endif
+}
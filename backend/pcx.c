@@ -35,31 +35,26 @@
 #include <stdio.h>
 #include <string.h>
 #include "common.h"
+#include "scratch.h"
 #include "pcx.h"        /* PCX header structure */
 #include <math.h>
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#include <malloc.h>
-#endif
+#include "filemem.h"
 
 INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
     int row, column, i, colour;
     int run_count;
-    FILE *pcx_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     pcx_header_t header;
     int bytes_per_line = symbol->bitmap_width + (symbol->bitmap_width & 1); // Must be even
     unsigned char previous;
-#ifdef _MSC_VER
-    unsigned char* rle_row;
-#endif
+    unsigned char *rle_row = (unsigned char *) scratch_alloc(symbol, bytes_per_line);
 
-#ifndef _MSC_VER
-    unsigned char rle_row[bytes_per_line];
-#else
-    rle_row = (unsigned char *) _alloca(bytes_per_line);
-#endif /* _MSC_VER */
+    if (!rle_row) {
+        strcpy(symbol->errtxt, "623: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     rle_row[bytes_per_line - 1] = 0; // Will remain zero if bitmap_width odd
 
@@ -100,22 +95,12 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "620: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        pcx_file = stdout;
-    } else {
-        if (!(pcx_file = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "621: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "621: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
-    fwrite(&header, sizeof (pcx_header_t), 1, pcx_file);
+    fm_write(&header, sizeof (pcx_header_t), 1, fmp);
 
     for (row = 0; row < symbol->bitmap_height; row++) {
         for (colour = 0; colour < 3; colour++) {
@@ -200,9 +185,9 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
                 } else {
                     if (run_count > 1 || (previous & 0xc0) == 0xc0) {
                         run_count += 0xc0;
-                        fputc(run_count, pcx_file);
+                        fm_putc(run_count, fmp);
                     }
-                    fputc(previous, pcx_file);
+                    fm_putc(previous, fmp);
                     previous = rle_row[column];
                     run_count = 1;
                 }
@@ -210,13 +195,16 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
             if (run_count > 1 || (previous & 0xc0) == 0xc0) {
                 run_count += 0xc0;
-                fputc(run_count, pcx_file);
+                fm_putc(run_count, fmp);
             }
-            fputc(previous, pcx_file);
+            fm_putc(previous, fmp);
         }
     }
 
-    fclose(pcx_file);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "622: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
 
     return 0;
 }
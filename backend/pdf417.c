@@ -229,6 +229,29 @@ static void pdfsmooth(int liste[2][PDF417_MAX_LEN], int *indexliste) {
     regroupe(liste, indexliste);
 }
 
+/* Split the data into blocks of the same mode and smooth them, returning the number of blocks */
+static int pdf_quelmode_blocks(int liste[2][PDF417_MAX_LEN], const unsigned char chaine[], const int length) {
+    int indexliste = 0;
+    int indexchaine = 0;
+    int mode = quelmode(chaine[indexchaine]);
+
+    /* 463 */
+    do {
+        liste[1][indexliste] = mode;
+        while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
+            liste[0][indexliste]++;
+            indexchaine++;
+            mode = quelmode(chaine[indexchaine]);
+        }
+        indexliste++;
+    } while (indexchaine < length);
+
+    /* 474 */
+    pdfsmooth(liste, &indexliste);
+
+    return indexliste;
+}
+
 /* 547 */
 static void textprocess(int *chainemc, int *mclength, char chaine[], int start, int length, int is_micro) {
     int j, indexlistet, curtable, listet[2][PDF417_MAX_LEN] = {{0}}, chainet[PDF417_MAX_LEN], wnet;
@@ -391,6 +414,22 @@ static void textprocess(int *chainemc, int *mclength, char chaine[], int start,
     }
 }
 
+/* Set the `length` modules given by `bits` (most significant first) in row `row` starting at column `posn`, returning
+   the column following. Used to lay out the row start/stop, RAP and codeword patterns directly into the symbol */
+INTERNAL int pdf_set_modules(struct zint_symbol *symbol, const int row, const unsigned int bits, const int length,
+            int posn) {
+    unsigned char *row_data = symbol->encoded_data[row];
+    unsigned int mask;
+
+    for (mask = 1U << (length - 1); mask; mask >>= 1, posn++) {
+        if (bits & mask) {
+            row_data[posn >> 3] |= (unsigned char) (1 << (posn & 7));
+        }
+    }
+
+    return posn;
+}
+
 /* 671 */
 INTERNAL void byteprocess(int *chainemc, int *mclength, unsigned char chaine[], int start, int length, int debug) {
 
@@ -501,12 +540,229 @@ static void numbprocess(int *chainemc, int *mclength, char chaine[], int start,
     }
 }
 
+/* Minimal encodation states: Text sub-mode (Alpha, Lower, Mixed, Punctuation) times parity of the number of Text
+   values so far (odd requiring padding on leaving), Byte count mod 6, and Numeric count in the current group of 44 */
+#define PDF_TEX_STATE   0
+#define PDF_BYT_STATE   8
+#define PDF_NUM_STATE   14
+#define PDF_STATES      58
+#define PDF_NEW_BLOCK   0x80 /* Flags state reached by starting a new block */
+
+/* Put the Text values needed to encode `c` when going from sub-mode `sub` to `new_sub` into `vals`, returning their
+   number or 0 if not possible. Sub-modes are 0 Alpha, 1 Lower, 2 Mixed, 3 Punctuation (bit values 1 << sub in
+   `asciix[]`) */
+static int pdf_text_vals(const int sub, const int new_sub, const unsigned char c, int vals[]) {
+    static const char latches[4][4][3] = { /* Count followed by latch values */
+        /* Alpha          Lower          Mixed          Punctuation */
+        { { 0, 0, 0 },  { 1, 27, 0 },  { 1, 28, 0 },  { 2, 28, 25 } }, /* Alpha */
+        { { 2, 28, 28 }, { 0, 0, 0 },  { 1, 28, 0 },  { 2, 28, 25 } }, /* Lower */
+        { { 1, 28, 0 },  { 1, 27, 0 },  { 0, 0, 0 },  { 1, 25, 0 } },  /* Mixed */
+        { { 1, 29, 0 },  { 2, 29, 27 }, { 2, 29, 28 }, { 0, 0, 0 } },  /* Punctuation */
+    };
+    const int tables = asciix[c];
+    int cnt = 0;
+
+    if (sub == new_sub) {
+        if (!(tables & (1 << sub))) {
+            if ((tables & 8) && sub != 3) {
+                vals[cnt++] = 29; /* ps - Punctuation Shift */
+            } else if ((tables & 1) && sub == 1) {
+                vals[cnt++] = 27; /* as - Alpha Shift */
+            } else {
+                return 0;
+            }
+        }
+    } else {
+        if (!(tables & (1 << new_sub))) {
+            return 0;
+        }
+        for (cnt = 0; cnt < latches[sub][new_sub][0]; cnt++) {
+            vals[cnt] = latches[sub][new_sub][cnt + 1];
+        }
+    }
+    vals[cnt++] = asciiy[c];
+
+    return cnt;
+}
+
+/* Cost (in half codewords) of leaving state `s` */
+static int pdf_exit_cost(const int s) {
+    return s < PDF_BYT_STATE ? s & 1 : 0;
+}
+
+/* Choose compaction modes and Text sub-modes giving the least number of codewords by doing a shortest path search
+   over the states above (costs in half codewords), then append the codewords to `chainemc` */
+static int pdf_minimal(struct zint_symbol *symbol, unsigned char chaine[], const int length, int *chainemc,
+            int *p_mclength, const int is_micro, const int debug) {
+    int cur[PDF_STATES], next[PDF_STATES];
+    unsigned char *prev; /* Previous state for each position and state, flagged if new block */
+    unsigned char *states; /* State after each character */
+    int i, j, s, t, best, enter, vals[3];
+    int in_text;
+    const int text_free = !*p_mclength && !is_micro; /* Initial Text Alpha needs no latch */
+    const int inf = 0x7FFFFFFF / 2;
+
+    prev = (unsigned char *) z_malloc(symbol, (size_t) (length + 1) * PDF_STATES + length);
+    if (!prev) {
+        strcpy(symbol->errtxt, "475: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+    states = prev + (size_t) (length + 1) * PDF_STATES;
+
+    best = 0;
+    enter = 0;
+    for (i = 0; i < length; i++) {
+        const unsigned char c = chaine[i];
+        const int is_text = c < 127 && asciix[c];
+        const int is_digit = c >= '0' && c <= '9';
+        unsigned char *p = prev + (size_t) (i + 1) * PDF_STATES;
+
+        for (t = 0; t < PDF_STATES; t++) {
+            next[t] = inf;
+        }
+
+        if (i) {
+            /* Continue current block */
+            for (s = PDF_TEX_STATE; s < PDF_BYT_STATE; s++) {
+                if (cur[s] < inf && is_text) {
+                    for (j = 0; j < 4; j++) {
+                        const int cnt = pdf_text_vals(s >> 1, j, c, vals);
+                        if (cnt) {
+                            t = PDF_TEX_STATE + j * 2 + ((s + cnt) & 1);
+                            if (cur[s] + cnt < next[t]) {
+                                next[t] = cur[s] + cnt;
+                                p[t] = s;
+                            }
+                        }
+                    }
+                }
+            }
+            for (s = PDF_BYT_STATE; s < PDF_NUM_STATE; s++) {
+                if (cur[s] < inf) {
+                    const int r = (s - PDF_BYT_STATE + 1) % 6; /* 6 bytes take 5 codewords */
+                    t = PDF_BYT_STATE + r;
+                    if (cur[s] + (r ? 2 : 0) < next[t]) {
+                        next[t] = cur[s] + (r ? 2 : 0);
+                        p[t] = s;
+                    }
+                }
+            }
+            for (s = PDF_NUM_STATE; s < PDF_STATES; s++) {
+                if (cur[s] < inf && is_digit) {
+                    const int g = s - PDF_NUM_STATE + 1; /* 1 to 44 digits in group, which takes g / 3 + 1 codewords */
+                    t = g == 44 ? PDF_NUM_STATE : s + 1;
+                    if (cur[s] + (g == 44 || (g + 1) % 3 == 0 ? 2 : 0) < next[t]) {
+                        next[t] = cur[s] + (g == 44 || (g + 1) % 3 == 0 ? 2 : 0);
+                        p[t] = s;
+                    }
+                }
+            }
+        }
+
+        /* Start new block */
+        if (is_text) {
+            const int latch = i == 0 && text_free ? 0 : 2;
+            for (j = 0; j < 4; j++) {
+                const int cnt = pdf_text_vals(0, j, c, vals);
+                if (cnt) {
+                    t = PDF_TEX_STATE + j * 2 + (cnt & 1);
+                    if (enter + latch + cnt < next[t]) {
+                        next[t] = enter + latch + cnt;
+                        p[t] = best | PDF_NEW_BLOCK;
+                    }
+                }
+            }
+        }
+        if (enter + 4 < next[PDF_BYT_STATE + 1]) {
+            next[PDF_BYT_STATE + 1] = enter + 4;
+            p[PDF_BYT_STATE + 1] = best | PDF_NEW_BLOCK;
+        }
+        if (is_digit && enter + 4 < next[PDF_NUM_STATE]) {
+            next[PDF_NUM_STATE] = enter + 4;
+            p[PDF_NUM_STATE] = best | PDF_NEW_BLOCK;
+        }
+
+        /* Best state to leave for a new block */
+        best = 0;
+        for (t = 0; t < PDF_STATES; t++) {
+            cur[t] = next[t];
+            if (cur[t] + pdf_exit_cost(t) < cur[best] + pdf_exit_cost(best)) {
+                best = t;
+            }
+        }
+        enter = cur[best] + pdf_exit_cost(best);
+    }
+
+    if (debug) {
+        printf("Minimal: %d codewords\n", (enter + 1) / 2);
+    }
+
+    /* Trace back states */
+    for (i = length, s = best; i > 0; i--) {
+        states[i - 1] = s;
+        s = prev[(size_t) i * PDF_STATES + s];
+        if (s & PDF_NEW_BLOCK) {
+            states[i - 1] |= PDF_NEW_BLOCK;
+            s &= ~PDF_NEW_BLOCK;
+        }
+    }
+
+    /* Text is the initial mode of PDF417 (ECIs don't change it), Byte that of MicroPDF417 */
+    in_text = !is_micro;
+    for (i = 0; i < length; i = j) {
+        const int mode = states[i] & ~PDF_NEW_BLOCK;
+        for (j = i + 1; j < length && !(states[j] & PDF_NEW_BLOCK); j++);
+
+        if (mode >= PDF_NUM_STATE) {
+            numbprocess(chainemc, p_mclength, (char *) chaine, i, j - i);
+            in_text = 0;
+        } else if (mode >= PDF_BYT_STATE) {
+            if (j - i == 1 && !in_text) {
+                /* 913 Byte Shift only valid in Text, so latch instead (same number of codewords) */
+                chainemc[(*p_mclength)++] = 901;
+                chainemc[(*p_mclength)++] = chaine[i];
+                if (debug) printf("\nEntering byte mode at position %d\n901 %d\n", i, chaine[i]);
+            } else {
+                byteprocess(chainemc, p_mclength, chaine, i, j - i, debug);
+                in_text = j - i == 1; /* Shifted back to Text after 913 */
+            }
+        } else {
+            int sub = 0, pending = -1;
+            /* See `textprocess()` */
+            if (*p_mclength || is_micro) {
+                chainemc[(*p_mclength)++] = 900;
+            }
+            for (s = i; s < j; s++) {
+                const int new_sub = (states[s] & ~PDF_NEW_BLOCK) >> 1;
+                const int cnt = pdf_text_vals(sub, new_sub, chaine[s], vals);
+                for (t = 0; t < cnt; t++) {
+                    if (pending < 0) {
+                        pending = vals[t];
+                    } else {
+                        chainemc[(*p_mclength)++] = 30 * pending + vals[t];
+                        pending = -1;
+                    }
+                }
+                sub = new_sub;
+            }
+            if (pending >= 0) {
+                chainemc[(*p_mclength)++] = 30 * pending + 29;
+            }
+            in_text = 1;
+        }
+    }
+
+    z_free(symbol, prev);
+
+    return 0;
+}
+
 /* 366 */
 static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int length) {
-    int i, k, j, indexchaine, indexliste, mode, longueur, loop, mccorrection[520] = {0}, offset;
+    int i, k, j, indexchaine, indexliste, longueur, loop, mccorrection[520] = {0}, offset;
     int total, chainemc[PDF417_MAX_LEN], mclength, c1, c2, c3, dummy[35], calcheight;
+    int p = 0;
     int liste[2][PDF417_MAX_LEN] = {{0}};
-    char pattern[580];
     int error_number = 0;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
 
@@ -517,23 +773,9 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
 
     /* 456 */
     indexliste = 0;
-    indexchaine = 0;
-
-    mode = quelmode(chaine[indexchaine]);
-
-    /* 463 */
-    do {
-        liste[1][indexliste] = mode;
-        while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
-            liste[0][indexliste]++;
-            indexchaine++;
-            mode = quelmode(chaine[indexchaine]);
-        }
-        indexliste++;
-    } while (indexchaine < length);
-
-    /* 474 */
-    pdfsmooth(liste, &indexliste);
+    if (symbol->option_3 != PDF_OPTIMAL) {
+        indexliste = pdf_quelmode_blocks(liste, chaine, length);
+    }
 
     if (debug) {
         printf("Initial block pattern:\n");
@@ -587,6 +829,14 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
         }
     }
 
+    /* Block list is empty if PDF_OPTIMAL, which encodes directly */
+    if (symbol->option_3 == PDF_OPTIMAL) {
+        int error = pdf_minimal(symbol, chaine, length, chainemc, &mclength, 0 /*is_micro*/, debug);
+        if (error) {
+            return error;
+        }
+    }
+
     for (i = 0; i < indexliste; i++) {
         switch (liste[1][i]) {
             case TEX: /* 547 - text mode */
@@ -733,7 +983,6 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
 
     /* we now encode each row */
     for (i = 0; i < symbol->rows; i++) {
-        int p;
         for (j = 0; j < symbol->option_2; j++) {
             dummy[j + 1] = chainemc[i * symbol->option_2 + j];
         }
@@ -755,26 +1004,19 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
                 offset = 1858; /* cluster(6) */
                 break;
         }
-        p = bin_append_posn(0x1FEA8, 17, pattern, 0); /* Row start */
+        p = pdf_set_modules(symbol, i, 0x1FEA8, 17, 0); /* Row start */
 
+        /* Codewords are 16 modules plus a trailing space */
         for (j = 0; j <= symbol->option_2; j++) {
-            p = bin_append_posn(pdf_bitpattern[offset + dummy[j]], 16, pattern, p);
-            pattern[p++] = '0';
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[j]], 16, p) + 1;
         }
 
         if (symbol->symbology != BARCODE_PDF417COMP) {
-            p = bin_append_posn(pdf_bitpattern[offset + dummy[j]], 16, pattern, p);
-            pattern[p++] = '0';
-            p = bin_append_posn(0x3FA29, 18, pattern, p); /* Row Stop */
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[j]], 16, p) + 1;
+            p = pdf_set_modules(symbol, i, 0x3FA29, 18, p); /* Row Stop */
         } else {
-            pattern[p++] = '1'; /* Compact PDF417 Stop pattern */
-        }
-        pattern[p] = '\0';
-
-        for (loop = 0; loop < p; loop++) {
-            if (pattern[loop] == '1') {
-                set_module(symbol, i, loop);
-            }
+            set_module(symbol, i, p); /* Compact PDF417 Stop pattern */
+            p++;
         }
     }
     
@@ -788,7 +1030,7 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
         symbol->row_height[j] = calcheight;
     }
     
-    symbol->width = (int) strlen(pattern);
+    symbol->width = p;
 
     /* 843 */
     return error_number;
@@ -833,12 +1075,11 @@ INTERNAL int pdf417enc(struct zint_symbol *symbol, unsigned char source[], int l
 
 /* like PDF417 only much smaller! */
 INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], int length) {
-    int i, k, j, indexchaine, indexliste, mode, longueur, mccorrection[50] = {0}, offset;
+    int i, k, j, indexchaine, indexliste, longueur, mccorrection[50] = {0}, offset;
     int total, chainemc[PDF417_MAX_LEN], mclength, dummy[5], codeerr;
     int liste[2][PDF417_MAX_LEN] = {{0}};
-    char pattern[580];
     int variant, LeftRAPStart, CentreRAPStart, RightRAPStart, StartCluster;
-    int LeftRAP, CentreRAP, RightRAP, Cluster, loop, calcheight;
+    int LeftRAP, CentreRAP, RightRAP, Cluster, loop, calcheight, p;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
 
     if (length > MICRO_PDF417_MAX_LEN) {
@@ -851,23 +1092,9 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
 
     /* 456 */
     indexliste = 0;
-    indexchaine = 0;
-
-    mode = quelmode(chaine[indexchaine]);
-
-    /* 463 */
-    do {
-        liste[1][indexliste] = mode;
-        while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
-            liste[0][indexliste]++;
-            indexchaine++;
-            mode = quelmode(chaine[indexchaine]);
-        }
-        indexliste++;
-    } while (indexchaine < length);
-
-    /* 474 */
-    pdfsmooth(liste, &indexliste);
+    if (symbol->option_3 != PDF_OPTIMAL) {
+        indexliste = pdf_quelmode_blocks(liste, chaine, length);
+    }
 
     if (debug) {
         printf("Initial mapping:\n");
@@ -924,6 +1151,14 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
         }
     }
 
+    /* Block list is empty if PDF_OPTIMAL, which encodes directly */
+    if (symbol->option_3 == PDF_OPTIMAL) {
+        int error = pdf_minimal(symbol, chaine, length, chainemc, &mclength, 1 /*is_micro*/, debug);
+        if (error) {
+            return error;
+        }
+    }
+
     for (i = 0; i < indexliste; i++) {
         switch (liste[1][i]) {
             case TEX: /* 547 - text mode */
@@ -1197,7 +1432,6 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
     if (debug) printf("\nInternal row representation:\n");
     for (i = 0; i < symbol->rows; i++) {
         if (debug) printf("row %d: ", i);
-        strcpy(pattern, "");
         offset = 929 * Cluster;
         for (j = 0; j < 5; j++) {
             dummy[j] = 0;
@@ -1208,39 +1442,35 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
         }
 
         /* Copy the data into codebarre */
-        bin_append(rap_side[LeftRAP - 1], 10, pattern);
-        bin_append(pdf_bitpattern[offset + dummy[1]], 16, pattern);
-        strcat(pattern, "0");
+        p = pdf_set_modules(symbol, i, rap_side[LeftRAP - 1], 10, 0);
+        p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[1]], 16, p) + 1;
         if (symbol->option_2 == 3) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (symbol->option_2 >= 2) {
-            bin_append(pdf_bitpattern[offset + dummy[2]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[2]], 16, p) + 1;
         }
         if (symbol->option_2 == 4) {
-            bin_append(rap_centre[CentreRAP - 1], 10, pattern);
+            p = pdf_set_modules(symbol, i, rap_centre[CentreRAP - 1], 10, p);
         }
         if (symbol->option_2 >= 3) {
-            bin_append(pdf_bitpattern[offset + dummy[3]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[3]], 16, p) + 1;
         }
         if (symbol->option_2 == 4) {
-            bin_append(pdf_bitpattern[offset + dummy[4]], 16, pattern);
-            strcat(pattern, "0");
+            p = pdf_set_modules(symbol, i, pdf_bitpattern[offset + dummy[4]], 16, p) + 1;
         }
-        bin_append(rap_side[RightRAP - 1], 10, pattern);
-        strcat(pattern, "1"); /* stop */
-        if (debug) printf("%s\n", pattern);
-
-        /* so now pattern[] holds the string of '1's and '0's. - copy this to the symbol */
-        for (loop = 0; loop < (int)strlen(pattern); loop++) {
-            if (pattern[loop] == '1') {
-                set_module(symbol, i, loop);
+        p = pdf_set_modules(symbol, i, rap_side[RightRAP - 1], 10, p);
+        set_module(symbol, i, p); /* stop */
+        p++;
+        if (debug) {
+            for (loop = 0; loop < p; loop++) {
+                putchar(module_is_set(symbol, i, loop) ? '1' : '0');
             }
+            putchar('\n');
         }
+
         symbol->row_height[i] = 2;
-        symbol->width = strlen(pattern);
+        symbol->width = p;
 
         /* Set up RAPs and Cluster for next row */
         LeftRAP++;
@@ -508,6 +508,8 @@ static const unsigned short int rap_centre[52] = {
     0x2DC, 0x2DE
 };
 
+INTERNAL int pdf_set_modules(struct zint_symbol *symbol, const int row, const unsigned int bits, const int length,
+            int posn);
 INTERNAL void byteprocess(int *chainemc, int *mclength, unsigned char chaine[], int start, int length, int debug);
 
 #endif /* __PDF417_H */
@@ -36,13 +36,13 @@
 
 #define SSET    "0123456789ABCDEF"
 
-static const char *PlessTable[16] = {
+static const char PlessTable[16][8] = {
     "13131313", "31131313", "13311313", "31311313", "13133113", "31133113",
     "13313113", "31313113", "13131331", "31131331", "13311331", "31311331", "13133131",
     "31133131", "13313131", "31313131"
 };
 
-static const char *MSITable[10] = {
+static const char MSITable[10][8] = {
     "12121212", "12121221", "12122112", "12122121", "12211212", "12211221",
     "12212112", "12212121", "21121212", "21121221"
 };
@@ -53,27 +53,30 @@ INTERNAL int plessey(struct zint_symbol *symbol, unsigned char source[], const s
     unsigned int i;
     unsigned char *checkptr;
     static const char grid[9] = {1, 1, 1, 1, 0, 1, 0, 0, 1};
+    int posns[65];
     char dest[1024]; /* 8 + 65 * 8 + 8 * 2 + 9 + 1 ~ 1024 */
+    char *d = dest;
     int error_number;
 
     if (length > 65) {
         strcpy(symbol->errtxt, "370: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(SSET, source, length);
+    error_number = is_sane_lookup(SSET, 16, source, (int) length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "371: Invalid characters in data");
         return error_number;
     }
-    checkptr = (unsigned char *) calloc(1, length * 4 + 8);
+    checkptr = (unsigned char *) z_calloc(symbol, length * 4 + 8);
 
     /* Start character */
-    strcpy(dest, "31311331");
+    memcpy(d, "31311331", 8);
+    d += 8;
 
     /* Data area */
-    for (i = 0; i < length; i++) {
-        unsigned int check = posn(SSET, source[i]);
-        lookup(SSET, PlessTable, source[i], dest);
+    for (i = 0; i < length; i++, d += 8) {
+        unsigned int check = posns[i];
+        memcpy(d, PlessTable[check], 8);
         checkptr[4 * i] = check & 1;
         checkptr[4 * i + 1] = (check >> 1) & 1;
         checkptr[4 * i + 2] = (check >> 2) & 1;
@@ -93,19 +96,21 @@ INTERNAL int plessey(struct zint_symbol *symbol, unsigned char source[], const s
 
     for (i = 0; i < 8; i++) {
         switch (checkptr[length * 4 + i]) {
-            case 0: strcat(dest, "13");
+            case 0: memcpy(d, "13", 2);
                 break;
-            case 1: strcat(dest, "31");
+            case 1: memcpy(d, "31", 2);
                 break;
         }
+        d += 2;
     }
 
     /* Stop character */
-    strcat(dest, "331311313");
+    memcpy(d, "331311313", 9);
+    d += 9;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
-    free(checkptr);
+    z_free(symbol, checkptr);
     return error_number;
 }
 
@@ -114,6 +119,7 @@ static int msi_plessey(struct zint_symbol *symbol, unsigned char source[], const
 
     int i;
     char dest[512]; /* 2 + 55 * 8 + 3 + 1 ~ 512 */
+    char *d = dest;
 
     if (length > 55) {
         strcpy(symbol->errtxt, "372: Input too long");
@@ -121,16 +127,19 @@ static int msi_plessey(struct zint_symbol *symbol, unsigned char source[], const
     }
 
     /* start character */
-    strcpy(dest, "21");
+    memcpy(d, "21", 2);
+    d += 2;
 
     for (i = 0; i < length; i++) {
-        lookup(NEON, MSITable, source[i], dest);
+        memcpy(d, MSITable[source[i] - '0'], 8);
+        d += 8;
     }
 
     /* Stop character */
-    strcat(dest, "121");
+    memcpy(d, "121", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, source);
     return 0;
 }
@@ -144,6 +153,7 @@ static int msi_plessey_mod10(struct zint_symbol *symbol, unsigned char source[],
     char un[200], tri[32];
     int error_number, h;
     char dest[1000];
+    char *d = dest;
 
     error_number = 0;
 
@@ -153,11 +163,13 @@ static int msi_plessey_mod10(struct zint_symbol *symbol, unsigned char source[],
     }
 
     /* start character */
-    strcpy(dest, "21");
+    memcpy(d, "21", 2);
+    d += 2;
 
     /* draw data section */
     for (i = 0; i < length; i++) {
-        lookup(NEON, MSITable, source[i], dest);
+        memcpy(d, MSITable[source[i] - '0'], 8);
+        d += 8;
     }
 
     /* calculate check digit */
@@ -190,11 +202,13 @@ static int msi_plessey_mod10(struct zint_symbol *symbol, unsigned char source[],
     }
 
     /* draw check digit */
-    lookup(NEON, MSITable, itoc(pump), dest);
+    memcpy(d, MSITable[pump], 8);
+    d += 8;
 
     /* Stop character */
-    strcat(dest, "121");
-    expand(symbol, dest);
+    memcpy(d, "121", 3);
+    d += 3;
+    expand(symbol, dest, d - dest);
 
     ustrcpy(symbol->text, source);
     symbol->text[length] = itoc(pump);
@@ -211,6 +225,7 @@ static int msi_plessey_mod1010(struct zint_symbol *symbol, unsigned char source[
     char un[16], tri[32];
     int error_number, h;
     char dest[1000];
+    char *d = dest;
 
     error_number = 0;
 
@@ -221,11 +236,13 @@ static int msi_plessey_mod1010(struct zint_symbol *symbol, unsigned char source[
     }
 
     /* start character */
-    strcpy(dest, "21");
+    memcpy(d, "21", 2);
+    d += 2;
 
     /* draw data section */
     for (i = 0; i < src_len; i++) {
-        lookup(NEON, MSITable, source[i], dest);
+        memcpy(d, MSITable[source[i] - '0'], 8);
+        d += 8;
     }
 
     /* calculate first check digit */
@@ -290,13 +307,16 @@ static int msi_plessey_mod1010(struct zint_symbol *symbol, unsigned char source[
     }
 
     /* Draw check digits */
-    lookup(NEON, MSITable, itoc(pump), dest);
-    lookup(NEON, MSITable, itoc(chwech), dest);
+    memcpy(d, MSITable[pump], 8);
+    d += 8;
+    memcpy(d, MSITable[chwech], 8);
+    d += 8;
 
     /* Stop character */
-    strcat(dest, "121");
+    memcpy(d, "121", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     ustrcpy(symbol->text, source);
     symbol->text[src_len] = itoc(pump);
@@ -314,6 +334,7 @@ static int msi_plessey_mod11(struct zint_symbol *symbol, unsigned char source[],
     unsigned long x;
     int error_number;
     char dest[1000];
+    char *d = dest;
 
     error_number = 0;
 
@@ -323,11 +344,13 @@ static int msi_plessey_mod11(struct zint_symbol *symbol, unsigned char source[],
     }
 
     /* start character */
-    strcpy(dest, "21");
+    memcpy(d, "21", 2);
+    d += 2;
 
     /* draw data section */
     for (i = 0; i < src_len; i++) {
-        lookup(NEON, MSITable, source[i], dest);
+        memcpy(d, MSITable[source[i] - '0'], 8);
+        d += 8;
     }
 
     /* calculate check digit */
@@ -343,16 +366,19 @@ static int msi_plessey_mod11(struct zint_symbol *symbol, unsigned char source[],
 
     check = (11 - (x % 11)) % 11;
     if (check == 10) {
-        lookup(NEON, MSITable, '1', dest);
-        lookup(NEON, MSITable, '0', dest);
+        memcpy(d, MSITable[1], 8);
+        memcpy(d + 8, MSITable[0], 8);
+        d += 16;
     } else {
-        lookup(NEON, MSITable, itoc(check), dest);
+        memcpy(d, MSITable[check], 8);
+        d += 8;
     }
 
     /* stop character */
-    strcat(dest, "121");
+    memcpy(d, "121", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     ustrcpy(symbol->text, source);
     if (check == 10) {
@@ -376,6 +402,7 @@ static int msi_plessey_mod1110(struct zint_symbol *symbol, unsigned char source[
     char un[16], tri[16];
     int error_number;
     char dest[1000];
+    char *d = dest;
     unsigned char temp[32];
     int temp_len;
 
@@ -387,11 +414,13 @@ static int msi_plessey_mod1110(struct zint_symbol *symbol, unsigned char source[
     }
 
     /* start character */
-    strcpy(dest, "21");
+    memcpy(d, "21", 2);
+    d += 2;
 
     /* draw data section */
     for (i = 0; i < src_len; i++) {
-        lookup(NEON, MSITable, source[i], dest);
+        memcpy(d, MSITable[source[i] - '0'], 8);
+        d += 8;
     }
 
     /* calculate first (mod 11) digit */
@@ -409,12 +438,14 @@ static int msi_plessey_mod1110(struct zint_symbol *symbol, unsigned char source[
     ustrcpy(temp, source);
     temp_len = src_len;
     if (check == 10) {
-        lookup(NEON, MSITable, '1', dest);
-        lookup(NEON, MSITable, '0', dest);
+        memcpy(d, MSITable[1], 8);
+        memcpy(d + 8, MSITable[0], 8);
+        d += 16;
         strcat((char*) temp, "10");
         temp_len += 2;
     } else {
-        lookup(NEON, MSITable, itoc(check), dest);
+        memcpy(d, MSITable[check], 8);
+        d += 8;
         temp[temp_len++] = itoc(check);
         temp[temp_len] = '\0';
     }
@@ -449,11 +480,13 @@ static int msi_plessey_mod1110(struct zint_symbol *symbol, unsigned char source[
     }
 
     /* draw check digit */
-    lookup(NEON, MSITable, itoc(pump), dest);
+    memcpy(d, MSITable[pump], 8);
+    d += 8;
 
     /* stop character */
-    strcat(dest, "121");
-    expand(symbol, dest);
+    memcpy(d, "121", 3);
+    d += 3;
+    expand(symbol, dest, d - dest);
 
     temp[temp_len++] = itoc(pump);
     temp[temp_len] = '\0';
@@ -32,14 +32,11 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <fcntl.h>
-#include <io.h>
-#include <malloc.h>
-#endif
 #include <stdlib.h>
 #include <string.h>
 #include "common.h"
+#include "scratch.h"
+#include "filemem.h"
 
 #ifndef NO_PNG
 #include <png.h>
@@ -51,7 +48,7 @@
 struct mainprog_info_type {
     long width;
     long height;
-    FILE *outfile;
+    struct filemem *fmp;
     jmp_buf jmpbuf;
 };
 
@@ -72,9 +69,32 @@ static void writepng_error_handler(png_structp png_ptr, png_const_charp msg) {
     longjmp(graphic->jmpbuf, 1);
 }
 
+/* Send libpng output to the file writer */
+static void writepng_write(png_structp png_ptr, png_bytep data, png_size_t length) {
+    struct mainprog_info_type *graphic = (struct mainprog_info_type *) png_get_io_ptr(png_ptr);
+
+    (void) fm_write(data, 1, length, graphic->fmp);
+}
+
+static void writepng_flush(png_structp png_ptr) {
+    (void) png_ptr;
+}
+
+#ifdef PNG_USER_MEM_SUPPORTED
+/* Have libpng allocate using the symbol's allocator */
+static png_voidp writepng_malloc(png_structp png_ptr, png_alloc_size_t size) {
+    return z_malloc((const struct zint_symbol *) png_get_mem_ptr(png_ptr), size);
+}
+
+static void writepng_free(png_structp png_ptr, png_voidp ptr) {
+    z_free((const struct zint_symbol *) png_get_mem_ptr(png_ptr), ptr);
+}
+#endif
+
 INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     struct mainprog_info_type wpng_info;
     struct mainprog_info_type *graphic;
+    struct filemem fm;
     png_structp png_ptr;
     png_infop info_ptr;
     int row, column;
@@ -98,12 +118,12 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     };
     int use_alpha, incr;
     unsigned char *image_data;
+    unsigned char *outdata = (unsigned char *) scratch_alloc(symbol, (size_t) symbol->bitmap_width * 4);
 
-#ifndef _MSC_VER
-    unsigned char outdata[symbol->bitmap_width * 4];
-#else
-    unsigned char* outdata = (unsigned char*) _alloca(symbol->bitmap_width * 4);
-#endif
+    if (!outdata) {
+        strcpy(symbol->errtxt, "637: Out of memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     graphic = &wpng_info;
 
@@ -135,24 +155,21 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "631: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        graphic->outfile = stdout;
-    } else {
-        if (!(graphic->outfile = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "632: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(&fm, symbol, "wb")) {
+        strcpy(symbol->errtxt, "632: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
+    graphic->fmp = &fm;
 
     /* Set up error handling routine as proc() above */
+#ifdef PNG_USER_MEM_SUPPORTED
+    png_ptr = png_create_write_struct_2(PNG_LIBPNG_VER_STRING, graphic, writepng_error_handler, NULL, symbol,
+                writepng_malloc, writepng_free);
+#else
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, graphic, writepng_error_handler, NULL);
+#endif
     if (!png_ptr) {
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "633: Out of memory");
         return ZINT_ERROR_MEMORY;
     }
@@ -160,6 +177,7 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     info_ptr = png_create_info_struct(png_ptr);
     if (!info_ptr) {
         png_destroy_write_struct(&png_ptr, NULL);
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "634: Out of memory");
         return ZINT_ERROR_MEMORY;
     }
@@ -167,12 +185,13 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* catch jumping here */
     if (setjmp(graphic->jmpbuf)) {
         png_destroy_write_struct(&png_ptr, &info_ptr);
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "635: libpng error occurred");
         return ZINT_ERROR_MEMORY;
     }
 
-    /* open output file with libpng */
-    png_init_io(png_ptr, graphic->outfile);
+    /* send output to file writer */
+    png_set_write_fn(png_ptr, graphic, writepng_write, writepng_flush);
 
     /* set compression */
     png_set_compression_level(png_ptr, 9);
@@ -210,10 +229,9 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
     /* make sure we have disengaged */
     if (png_ptr && info_ptr) png_destroy_write_struct(&png_ptr, &info_ptr);
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(wpng_info.outfile);
-    } else {
-        fclose(wpng_info.outfile);
+    if (!fm_close(&fm, symbol)) {
+        strcpy(symbol->errtxt, "636: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
     return 0;
 }
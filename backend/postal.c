@@ -33,9 +33,6 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
 
 #define DAFTSET "DAFT"
@@ -45,24 +42,24 @@
 #define SHKASUTSET "1234567890-ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 
 /* PostNet number encoding table - In this table L is long as S is short */
-static const char *PNTable[10] = {
+static const char PNTable[10][5] = {
     "LLSSS", "SSSLL", "SSLSL", "SSLLS", "SLSSL", "SLSLS", "SLLSS", "LSSSL",
     "LSSLS", "LSLSS"
 };
 
-static const char *PLTable[10] = {
+static const char PLTable[10][5] = {
     "SSLLL", "LLLSS", "LLSLS", "LLSSL", "LSLLS", "LSLSL", "LSSLL", "SLLLS",
     "SLLSL", "SLSLL"
 };
 
-static const char *RoyalValues[36] = {
+static const char RoyalValues[36][2] = {
     "11", "12", "13", "14", "15", "10", "21", "22", "23", "24", "25",
     "20", "31", "32", "33", "34", "35", "30", "41", "42", "43", "44", "45", "40", "51", "52",
     "53", "54", "55", "50", "01", "02", "03", "04", "05", "00"
 };
 
 /* 0 = Full, 1 = Ascender, 2 = Descender, 3 = Tracker */
-static const char *RoyalTable[36] = {
+static const char RoyalTable[36][4] = {
     "3300", "3210", "3201", "2310", "2301", "2211", "3120", "3030", "3021",
     "2130", "2121", "2031", "3102", "3012", "3003", "2112", "2103", "2013", "1320", "1230",
     "1221", "0330", "0321", "0231", "1302", "1212", "1203", "0312", "0303", "0213", "1122",
@@ -78,7 +75,7 @@ static const char *KoreaTable[10] = {
     "0413171313", "17171313", "1315061313", "0413131713", "17131713", "13171713"
 };
 
-static const char *JapanTable[19] = {
+static const char JapanTable[19][3] = {
     "114", "132", "312", "123", "141", "321", "213", "231", "411", "144",
     "414", "324", "342", "234", "432", "243", "423", "441", "111"
 };
@@ -87,6 +84,7 @@ static const char *JapanTable[19] = {
 static int postnet(struct zint_symbol *symbol, unsigned char source[], char dest[], int length) {
     int i, sum, check_digit;
     int error_number;
+    char *d = dest;
 
     if (length != 5 && length != 9 && length != 11) {
         strcpy(symbol->errtxt, "480: Input wrong length");
@@ -100,18 +98,20 @@ static int postnet(struct zint_symbol *symbol, unsigned char source[], char dest
     sum = 0;
 
     /* start character */
-    strcpy(dest, "L");
+    *d++ = 'L';
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, PNTable, source[i], dest);
-        sum += ctoi(source[i]);
+    for (i = 0; i < length; i++, d += 5) {
+        const int val = source[i] - '0';
+        memcpy(d, PNTable[val], 5);
+        sum += val;
     }
 
     check_digit = (10 - (sum % 10)) % 10;
-    strcat(dest, PNTable[check_digit]);
+    memcpy(d, PNTable[check_digit], 5);
+    d += 5;
 
     /* stop character */
-    strcat(dest, "L");
+    strcpy(d, "L");
 
     return error_number;
 }
@@ -149,6 +149,7 @@ INTERNAL int post_plot(struct zint_symbol *symbol, unsigned char source[], int l
 static int planet(struct zint_symbol *symbol, unsigned char source[], char dest[], int length) {
     int i, sum, check_digit;
     int error_number;
+    char *d = dest;
 
     if (length != 11 && length != 13) {
         strcpy(symbol->errtxt, "482: Input wrong length");
@@ -162,18 +163,20 @@ static int planet(struct zint_symbol *symbol, unsigned char source[], char dest[
     sum = 0;
 
     /* start character */
-    strcpy(dest, "L");
+    *d++ = 'L';
 
-    for (i = 0; i < length; i++) {
-        lookup(NEON, PLTable, source[i], dest);
-        sum += ctoi(source[i]);
+    for (i = 0; i < length; i++, d += 5) {
+        const int val = source[i] - '0';
+        memcpy(d, PLTable[val], 5);
+        sum += val;
     }
 
     check_digit = (10 - (sum % 10)) % 10;
-    strcat(dest, PLTable[check_digit]);
+    memcpy(d, PLTable[check_digit], 5);
+    d += 5;
 
     /* stop character */
-    strcat(dest, "L");
+    strcpy(d, "L");
 
     return error_number;
 }
@@ -211,6 +214,8 @@ INTERNAL int planet_plot(struct zint_symbol *symbol, unsigned char source[], int
 INTERNAL int korea_post(struct zint_symbol *symbol, unsigned char source[], int length) {
     int total, loop, check, zeroes, error_number;
     char localstr[8], dest[80];
+    char *d = dest;
+    const char *p;
 
     if (length > 6) {
         strcpy(symbol->errtxt, "484: Input too long");
@@ -235,12 +240,15 @@ INTERNAL int korea_post(struct zint_symbol *symbol, unsigned char source[], int
     }
     localstr[6] = itoc(check);
     localstr[7] = '\0';
-    *dest = '\0';
     for (loop = 5; loop >= 0; loop--) {
-        lookup(NEON, KoreaTable, localstr[loop], dest);
+        for (p = KoreaTable[localstr[loop] - '0']; *p; p++) {
+            *d++ = *p;
+        }
     }
-    lookup(NEON, KoreaTable, localstr[6], dest);
-    expand(symbol, dest);
+    for (p = KoreaTable[check]; *p; p++) {
+        *d++ = *p;
+    }
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, (unsigned char*) localstr);
 
     return error_number;
@@ -249,7 +257,7 @@ INTERNAL int korea_post(struct zint_symbol *symbol, unsigned char source[], int
 /* The simplest barcode symbology ever! Supported by MS Word, so here it is!
     glyphs from http://en.wikipedia.org/wiki/Facing_Identification_Mark */
 INTERNAL int fim(struct zint_symbol *symbol, unsigned char source[], int length) {
-    char dest[16] = {0};
+    const char *dest;
 
     if (length > 1) {
         strcpy(symbol->errtxt, "486: Input too long");
@@ -259,19 +267,19 @@ INTERNAL int fim(struct zint_symbol *symbol, unsigned char source[], int length)
     switch ((char) source[0]) {
         case 'a':
         case 'A':
-            strcpy(dest, "111515111");
+            dest = "111515111";
             break;
         case 'b':
         case 'B':
-            strcpy(dest, "13111311131");
+            dest = "13111311131";
             break;
         case 'c':
         case 'C':
-            strcpy(dest, "11131313111");
+            dest = "11131313111";
             break;
         case 'd':
         case 'D':
-            strcpy(dest, "1111131311111");
+            dest = "1111131311111";
             break;
         default:
             strcpy(symbol->errtxt, "487: Invalid characters in data");
@@ -279,28 +287,28 @@ INTERNAL int fim(struct zint_symbol *symbol, unsigned char source[], int length)
             break;
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, (int) strlen(dest));
 
     return 0;
 }
 
 /* Handles the 4 State barcodes used in the UK by Royal Mail */
-static char rm4scc(unsigned char source[], char dest[], int length) {
+static char rm4scc(const int posns[], char dest[], int length) {
     int i;
     int top, bottom, row, column, check_digit;
-    char values[3], set_copy[] = KRSET;
+    char *d = dest;
+    char set_copy[] = KRSET;
 
     top = 0;
     bottom = 0;
 
     /* start character */
-    strcpy(dest, "1");
+    *d++ = '1';
 
-    for (i = 0; i < length; i++) {
-        lookup(KRSET, RoyalTable, source[i], dest);
-        strcpy(values, RoyalValues[posn(KRSET, source[i])]);
-        top += ctoi(values[0]);
-        bottom += ctoi(values[1]);
+    for (i = 0; i < length; i++, d += 4) {
+        memcpy(d, RoyalTable[posns[i]], 4);
+        top += RoyalValues[posns[i]][0] - '0';
+        bottom += RoyalValues[posns[i]][1] - '0';
     }
 
     /* Calculate the check digit */
@@ -313,10 +321,11 @@ static char rm4scc(unsigned char source[], char dest[], int length) {
         column = 5;
     }
     check_digit = (6 * row) + column;
-    strcat(dest, RoyalTable[check_digit]);
+    memcpy(d, RoyalTable[check_digit], 4);
+    d += 4;
 
     /* stop character */
-    strcat(dest, "0");
+    strcpy(d, "0");
 
     return set_copy[check_digit];
 }
@@ -324,22 +333,22 @@ static char rm4scc(unsigned char source[], char dest[], int length) {
 /* Puts RM4SCC into the data matrix */
 INTERNAL int royal_plot(struct zint_symbol *symbol, unsigned char source[], int length) {
     char height_pattern[210];
+    int posns[50];
     int loopey, h;
     int writer;
     int error_number;
-    strcpy(height_pattern, "");
 
     if (length > 50) {
         strcpy(symbol->errtxt, "488: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(KRSET, source, length);
+    error_number = is_sane_lookup(KRSET, 36, source, length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "489: Invalid characters in data");
         return error_number;
     }
-    /*check = */rm4scc(source, height_pattern, length);
+    /*check = */rm4scc(posns, height_pattern, length);
 
     writer = 0;
     h = strlen(height_pattern);
@@ -367,41 +376,36 @@ INTERNAL int royal_plot(struct zint_symbol *symbol, unsigned char source[], int
    The same as RM4SCC but without check digit
    Specification at http://www.tntpost.nl/zakelijk/klantenservice/downloads/kIX_code/download.aspx */
 INTERNAL int kix_code(struct zint_symbol *symbol, unsigned char source[], int length) {
-    char height_pattern[75], localstr[20];
+    int posns[18];
     int loopey;
-    int writer, i, h;
+    int writer, i;
     int error_number;
-    strcpy(height_pattern, "");
 
     if (length > 18) {
         strcpy(symbol->errtxt, "490: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(KRSET, source, length);
+    error_number = is_sane_lookup(KRSET, 36, source, length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "491: Invalid characters in data");
         return error_number;
     }
 
-    strcpy(localstr, (char *) source);
-
-    /* Encode data */
-    for (i = 0; i < length; i++) {
-        lookup(KRSET, RoyalTable, localstr[i], height_pattern);
-    }
-
+    /* Encode data straight from the table */
     writer = 0;
-    h = strlen(height_pattern);
-    for (loopey = 0; loopey < h; loopey++) {
-        if ((height_pattern[loopey] == '1') || (height_pattern[loopey] == '0')) {
-            set_module(symbol, 0, writer);
-        }
-        set_module(symbol, 1, writer);
-        if ((height_pattern[loopey] == '2') || (height_pattern[loopey] == '0')) {
-            set_module(symbol, 2, writer);
+    for (i = 0; i < length; i++) {
+        const char *const bars = RoyalTable[posns[i]];
+        for (loopey = 0; loopey < 4; loopey++) {
+            if ((bars[loopey] == '1') || (bars[loopey] == '0')) {
+                set_module(symbol, 0, writer);
+            }
+            set_module(symbol, 1, writer);
+            if ((bars[loopey] == '2') || (bars[loopey] == '0')) {
+                set_module(symbol, 2, writer);
+            }
+            writer += 2;
         }
-        writer += 2;
     }
 
     symbol->row_height[0] = 3;
@@ -415,10 +419,7 @@ INTERNAL int kix_code(struct zint_symbol *symbol, unsigned char source[], int le
 
 /* Handles DAFT Code symbols */
 INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int length) {
-    char height_pattern[100];
-    unsigned int loopey, h;
     int writer, i, error_number;
-    strcpy(height_pattern, "");
 
     if (length > 50) {
         strcpy(symbol->errtxt, "492: Input too long");
@@ -432,29 +433,13 @@ INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int l
         return error_number;
     }
 
-    for (i = 0; i < length; i++) {
-        if (source[i] == 'D') {
-            strcat(height_pattern, "2");
-        }
-        if (source[i] == 'A') {
-            strcat(height_pattern, "1");
-        }
-        if (source[i] == 'F') {
-            strcat(height_pattern, "0");
-        }
-        if (source[i] == 'T') {
-            strcat(height_pattern, "3");
-        }
-    }
-
     writer = 0;
-    h = strlen(height_pattern);
-    for (loopey = 0; loopey < h; loopey++) {
-        if ((height_pattern[loopey] == '1') || (height_pattern[loopey] == '0')) {
+    for (i = 0; i < length; i++) {
+        if ((source[i] == 'A') || (source[i] == 'F')) {
             set_module(symbol, 0, writer);
         }
         set_module(symbol, 1, writer);
-        if ((height_pattern[loopey] == '2') || (height_pattern[loopey] == '0')) {
+        if ((source[i] == 'D') || (source[i] == 'F')) {
             set_module(symbol, 2, writer);
         }
         writer += 2;
@@ -473,6 +458,8 @@ INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int l
 INTERNAL int flattermarken(struct zint_symbol *symbol, unsigned char source[], int length) {
     int loop, error_number;
     char dest[512]; /* 90 * 4 + 1 ~ */
+    char *d = dest;
+    const char *p;
 
     if (length > 90) {
         strcpy(symbol->errtxt, "494: Input too long");
@@ -483,12 +470,13 @@ INTERNAL int flattermarken(struct zint_symbol *symbol, unsigned char source[], i
         strcpy(symbol->errtxt, "495: Invalid characters in data");
         return error_number;
     }
-    *dest = '\0';
     for (loop = 0; loop < length; loop++) {
-        lookup(NEON, FlatTable, source[loop], dest);
+        for (p = FlatTable[source[loop] - '0']; *p; p++) {
+            *d++ = *p;
+        }
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     return error_number;
 }
@@ -500,12 +488,9 @@ INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int
     int writer, loopey, inter_posn, i, sum, check;
     char check_char;
     char inter[23];
+    int inter_posns[20], check_posns[20];
 
-#ifndef _MSC_VER
-    char local_source[length + 1];
-#else
-    char* local_source = (char*) _alloca(length + 1);
-#endif
+    char local_source[20 + 1];
 
     if (length > 20) {
         strcpy(symbol->errtxt, "496: Input too long");
@@ -551,12 +536,15 @@ INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int
     } while ((i < length) && (inter_posn < 20));
     inter[20] = '\0';
 
-    strcpy(pattern, "13"); /* Start */
+    memcpy(pattern, "13", 2); /* Start */
+    h = 2;
 
+    is_sane_lookup(KASUTSET, 19, (const unsigned char *) inter, 20, inter_posns);
+    is_sane_lookup(CHKASUTSET, 19, (const unsigned char *) inter, 20, check_posns);
     sum = 0;
-    for (i = 0; i < 20; i++) {
-        strcat(pattern, JapanTable[posn(KASUTSET, inter[i])]);
-        sum += posn(CHKASUTSET, inter[i]);
+    for (i = 0; i < 20; i++, h += 3) {
+        memcpy(pattern + h, JapanTable[inter_posns[i]], 3);
+        sum += check_posns[i];
     }
 
     /* Calculate check digit */
@@ -571,13 +559,14 @@ INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int
     } else {
         check_char = (check - 11) + 'a';
     }
-    strcat(pattern, JapanTable[posn(KASUTSET, check_char)]);
+    memcpy(pattern + h, JapanTable[posn(KASUTSET, check_char)], 3);
+    h += 3;
 
-    strcat(pattern, "31"); /* Stop */
+    memcpy(pattern + h, "31", 2); /* Stop */
+    h += 2;
 
     /* Resolve pattern to 4-state symbols */
     writer = 0;
-    h = strlen(pattern);
     for (loopey = 0; loopey < h; loopey++) {
         if ((pattern[loopey] == '2') || (pattern[loopey] == '1')) {
             set_module(symbol, 0, writer);
@@ -31,13 +31,12 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-#include <locale.h>
 #include <stdio.h>
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
+#include "filemem.h"
+#include "output.h"
 
 static void colour_to_pscolor(int option, int colour, char* output) {
     strcpy(output, "");
@@ -132,7 +131,8 @@ STATIC_UNLESS_ZINT_TEST void ps_convert(const unsigned char *string, unsigned ch
 }
 
 INTERNAL int ps_plot(struct zint_symbol *symbol) {
-    FILE *feps;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
     float red_ink, green_ink, blue_ink, red_paper, green_paper, blue_paper;
     float cyan_ink, magenta_ink, yellow_ink, black_ink;
@@ -148,14 +148,12 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
     struct zint_vector_hexagon *hex;
     struct zint_vector_circle *circle;
     struct zint_vector_string *string;
-    const char *locale = NULL;
+    struct output_locale locale;
     const char *font;
     int i, len;
     int ps_len = 0;
     int iso_latin1 = 0;
-#ifdef _MSC_VER
     unsigned char *ps_string;
-#endif
 
     if (strlen(symbol->bgcolour) > 6) {
         if ((ctoi(symbol->bgcolour[6]) == 0) && (ctoi(symbol->bgcolour[7]) == 0)) {
@@ -163,17 +161,34 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
         }
     }
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        feps = stdout;
-    } else {
-        feps = fopen(symbol->outfile, "w");
+    for (i = 0, len = (int) ustrlen(symbol->text); i < len; i++) {
+        switch (symbol->text[i]) {
+            case '(':
+            case ')':
+            case '\\':
+                ps_len += 2;
+                break;
+            default:
+                if (!iso_latin1 && symbol->text[i] >= 0x80) {
+                    iso_latin1 = 1;
+                }
+                ps_len++; /* Will overcount 2 byte UTF-8 chars */
+                break;
+        }
     }
-    if (feps == NULL) {
+
+    ps_string = (unsigned char *) scratch_alloc(symbol, ps_len + 1);
+    if (!ps_string) {
+        strcpy(symbol->errtxt, "647: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+
+    if (!fm_open(fmp, symbol, "w")) {
         strcpy(symbol->errtxt, "645: Could not open output file");
         return ZINT_ERROR_FILE_ACCESS;
     }
 
-    locale = setlocale(LC_ALL, "C");
+    output_c_locale(&locale);
 
     fgred = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
     fggrn = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
@@ -235,69 +250,47 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
         yellow_paper = 0.0f;
     }
 
-    for (i = 0, len = (int) ustrlen(symbol->text); i < len; i++) {
-        switch (symbol->text[i]) {
-            case '(':
-            case ')':
-            case '\\':
-                ps_len += 2;
-                break;
-            default:
-                if (!iso_latin1 && symbol->text[i] >= 0x80) {
-                    iso_latin1 = 1;
-                }
-                ps_len++; /* Will overcount 2 byte UTF-8 chars */
-                break;
-        }
-    }
-
-#ifndef _MSC_VER
-    unsigned char ps_string[ps_len + 1];
-#else
-    ps_string = (unsigned char *) _alloca(ps_len + 1);
-#endif
-
     /* Start writing the header */
-    fprintf(feps, "%%!PS-Adobe-3.0 EPSF-3.0\n");
+    fm_printf(fmp, "%%!PS-Adobe-3.0 EPSF-3.0\n");
     if (ZINT_VERSION_BUILD) {
-        fprintf(feps, "%%%%Creator: Zint %d.%d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE, ZINT_VERSION_BUILD);
+        fm_printf(fmp, "%%%%Creator: Zint %d.%d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE, ZINT_VERSION_BUILD);
     } else {
-        fprintf(feps, "%%%%Creator: Zint %d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE);
+        fm_printf(fmp, "%%%%Creator: Zint %d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE);
     }
-    fprintf(feps, "%%%%Title: Zint Generated Symbol\n");
-    fprintf(feps, "%%%%Pages: 0\n");
-    fprintf(feps, "%%%%BoundingBox: 0 0 %d %d\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
-    fprintf(feps, "%%%%EndComments\n");
+    fm_printf(fmp, "%%%%Title: Zint Generated Symbol\n");
+    fm_printf(fmp, "%%%%Pages: 0\n");
+    fm_printf(fmp, "%%%%BoundingBox: 0 0 %d %d\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
+    fm_printf(fmp, "%%%%EndComments\n");
 
     /* Definitions */
-    fprintf(feps, "/TL { setlinewidth moveto lineto stroke } bind def\n");
-    fprintf(feps, "/TD { newpath 0 360 arc fill } bind def\n");
-    fprintf(feps, "/TH { 0 setlinewidth moveto lineto lineto lineto lineto lineto closepath fill } bind def\n");
-    fprintf(feps, "/TB { 2 copy } bind def\n");
-    fprintf(feps, "/TR { newpath 4 1 roll exch moveto 1 index 0 rlineto 0 exch rlineto neg 0 rlineto closepath fill } bind def\n");
-    fprintf(feps, "/TE { pop pop } bind def\n");
+    fm_printf(fmp, "/TL { setlinewidth moveto lineto stroke } bind def\n");
+    fm_printf(fmp, "/TD { newpath 0 360 arc fill } bind def\n");
+    fm_printf(fmp, "/TH { 0 setlinewidth moveto lineto lineto lineto lineto lineto closepath fill } bind def\n");
+    fm_printf(fmp, "/TB { 2 copy } bind def\n");
+    fm_printf(fmp, "/TR { newpath 4 1 roll exch moveto 1 index 0 rlineto 0 exch rlineto neg 0 rlineto closepath fill } bind def\n");
+    fm_printf(fmp, "/TE { pop pop } bind def\n");
 
-    fprintf(feps, "newpath\n");
+    fm_printf(fmp, "newpath\n");
 
     /* Now the actual representation */
     
     //Background
     if (draw_background) {
         if ((symbol->output_options & CMYK_COLOUR) == 0) {
-            fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
+            fm_printf(fmp, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
         } else {
-            fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
+            fm_printf(fmp, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
         }
         
-        fprintf(feps, "%.2f 0.00 TB 0.00 %.2f TR\n", symbol->vector->height, symbol->vector->width);
-        fprintf(feps, "TE\n");
+        fm_printf(fmp, "%.2f 0.00 TB 0.00 %.2f TR\n", symbol->vector->height, symbol->vector->width);
+        fm_printf(fmp, "TE\n");
     }
 
     if (symbol->symbology != BARCODE_ULTRA) {
         if ((symbol->output_options & CMYK_COLOUR) == 0) {
-            fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
+            fm_printf(fmp, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
         } else {
-            fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
+            fm_printf(fmp, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
         }
     }
 
@@ -311,11 +304,11 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
                     if (colour_rect_counter == 0) {
                         //Set new colour
                         colour_to_pscolor(symbol->output_options, colour_index, ps_color);
-                        fprintf(feps, "%s\n", ps_color);
+                        fm_printf(fmp, "%s\n", ps_color);
                     }
                     colour_rect_counter++;
-                    fprintf(feps, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
-                    fprintf(feps, "TE\n");
+                    fm_printf(fmp, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
+                    fm_printf(fmp, "TE\n");
                 }
                 rect = rect->next;
             }
@@ -323,8 +316,8 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
     } else {
         rect = symbol->vector->rectangles;
         while (rect) {
-            fprintf(feps, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
-            fprintf(feps, "TE\n");
+            fm_printf(fmp, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
+            fm_printf(fmp, "TE\n");
             rect = rect->next;
         }
     }
@@ -366,7 +359,7 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
             ex = hex->x + half_radius;
             fx = hex->x - half_radius;
         }
-        fprintf(feps, "%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f TH\n", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
+        fm_printf(fmp, "%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f TH\n", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
         hex = hex->next;
     }
 
@@ -381,21 +374,21 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
         if (circle->colour) {
             // A 'white' circle
             if ((symbol->output_options & CMYK_COLOUR) == 0) {
-                fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
+                fm_printf(fmp, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
             } else {
-                fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
+                fm_printf(fmp, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
             }
-            fprintf(feps, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
+            fm_printf(fmp, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
             if (circle->next) {
                 if ((symbol->output_options & CMYK_COLOUR) == 0) {
-                    fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
+                    fm_printf(fmp, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
                 } else {
-                    fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
+                    fm_printf(fmp, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
                 }
             }
         } else {
             // A 'black' circle
-            fprintf(feps, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
+            fm_printf(fmp, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
         }
         circle = circle->next;
     }
@@ -411,51 +404,49 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
             font = "Helvetica";
         }
         if (iso_latin1) { /* Change encoding to ISO 8859-1, see Postscript Language Reference Manual 2nd Edition Example 5.6 */
-            fprintf(feps, "/%s findfont\n", font);
-            fprintf(feps, "dup length dict begin\n");
-            fprintf(feps, "{1 index /FID ne {def} {pop pop} ifelse} forall\n");
-            fprintf(feps, "/Encoding ISOLatin1Encoding def\n");
-            fprintf(feps, "currentdict\n");
-            fprintf(feps, "end\n");
-            fprintf(feps, "/Helvetica-ISOLatin1 exch definefont pop\n");
+            fm_printf(fmp, "/%s findfont\n", font);
+            fm_printf(fmp, "dup length dict begin\n");
+            fm_printf(fmp, "{1 index /FID ne {def} {pop pop} ifelse} forall\n");
+            fm_printf(fmp, "/Encoding ISOLatin1Encoding def\n");
+            fm_printf(fmp, "currentdict\n");
+            fm_printf(fmp, "end\n");
+            fm_printf(fmp, "/Helvetica-ISOLatin1 exch definefont pop\n");
             font = "Helvetica-ISOLatin1";
         }
     }
     while (string) {
         ps_convert(string->text, ps_string);
-        fprintf(feps, "matrix currentmatrix\n");
-        fprintf(feps, "/%s findfont\n", font);
-        fprintf(feps, "%.2f scalefont setfont\n", string->fsize);
-        fprintf(feps, " 0 0 moveto %.2f %.2f translate 0.00 rotate 0 0 moveto\n", string->x, (symbol->vector->height - string->y));
+        fm_printf(fmp, "matrix currentmatrix\n");
+        fm_printf(fmp, "/%s findfont\n", font);
+        fm_printf(fmp, "%.2f scalefont setfont\n", string->fsize);
+        fm_printf(fmp, " 0 0 moveto %.2f %.2f translate 0.00 rotate 0 0 moveto\n", string->x, (symbol->vector->height - string->y));
         if (string->halign == 0 || string->halign == 2) { /* Need width for middle or right align */
-            fprintf(feps, " (%s) stringwidth\n", ps_string);
+            fm_printf(fmp, " (%s) stringwidth\n", ps_string);
         }
         if (string->rotation != 0) {
-            fprintf(feps, "gsave\n");
-            fprintf(feps, "%d rotate\n", 360 - string->rotation);
+            fm_printf(fmp, "gsave\n");
+            fm_printf(fmp, "%d rotate\n", 360 - string->rotation);
         }
         if (string->halign == 0 || string->halign == 2) {
-            fprintf(feps, "pop\n");
-            fprintf(feps, "%s 0 rmoveto\n", string->halign == 2 ? "neg" : "-2 div");
+            fm_printf(fmp, "pop\n");
+            fm_printf(fmp, "%s 0 rmoveto\n", string->halign == 2 ? "neg" : "-2 div");
         }
-        fprintf(feps, " (%s) show\n", ps_string);
+        fm_printf(fmp, " (%s) show\n", ps_string);
         if (string->rotation != 0) {
-            fprintf(feps, "grestore\n");
+            fm_printf(fmp, "grestore\n");
         }
-        fprintf(feps, "setmatrix\n");
+        fm_printf(fmp, "setmatrix\n");
         string = string->next;
     }
 
-    //fprintf(feps, "\nshowpage\n");
+    //fm_printf(fmp, "\nshowpage\n");
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(feps);
-    } else {
-        fclose(feps);
-    }
+    output_restore_locale(&locale);
 
-    if (locale)
-        setlocale(LC_ALL, locale);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "646: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
 
     return error_number;
 }
@@ -31,14 +31,13 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
 #include <stdio.h>
 #include "sjis.h"
 #include "qr.h"
+#include "scratch.h"
 #include "reedsol.h"
+#include "parallel.h"
 #include <assert.h>
 
 /* Convert Unicode to other encodings */
@@ -200,8 +199,8 @@ static unsigned int *qr_head_costs(unsigned int state[10]) {
 }
 
 /* Calculate optimized encoding modes. Adapted from Project Nayuki */
-static void qr_define_mode(char mode[], const unsigned int jisdata[], const int length, const int gs1,
-            const int version, const int debug_print) {
+static void qr_define_mode(char mode[], char char_modes[], const unsigned int jisdata[], const int length,
+            const int gs1, const int version, const int debug_print) {
     /*
      * Copyright (c) Project Nayuki. (MIT License)
      * https://www.nayuki.io/page/qr-code-generator-library
@@ -227,11 +226,6 @@ static void qr_define_mode(char mode[], const unsigned int jisdata[], const int
     char cur_mode;
     unsigned int prev_costs[QR_NUM_MODES];
     unsigned int cur_costs[QR_NUM_MODES];
-#ifndef _MSC_VER
-    char char_modes[length * QR_NUM_MODES];
-#else
-    char *char_modes = (char *) _alloca(length * QR_NUM_MODES);
-#endif
 
     /* char_modes[i * QR_NUM_MODES + j] represents the mode to encode the code point at index i such that the final
      * segment ends in mode_types[j] and the total number of bits is minimized over all possible choices */
@@ -382,21 +376,21 @@ static int terminator_bits(const int version) {
 }
 
 /* Convert input data to a binary stream and add padding */
-static void qr_binary(unsigned char datastream[], const int version, const int target_codewords, const char mode[],
-            const unsigned int jisdata[], const int length, const int gs1, const int eci, const int est_binlen,
-            const int debug_print) {
+static int qr_binary(struct zint_symbol *symbol, unsigned char datastream[], const int version,
+            const int target_codewords, const char mode[], const unsigned int jisdata[], const int length,
+            const int gs1, const int eci, const int est_binlen, const int debug_print) {
     int position = 0;
     int i, j, bp;
     int termbits, padbits, modebits;
     int current_bytes;
     int toggle, percent;
     int percent_count;
+    char *binary = (char *) scratch_alloc(symbol, est_binlen + 12);
 
-#ifndef _MSC_VER
-    char binary[est_binlen + 12];
-#else
-    char* binary = (char *) _alloca(est_binlen + 12);
-#endif
+    if (!binary) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
     *binary = '\0';
     bp = 0;
 
@@ -659,7 +653,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
         /* MICROQR does its own terminating/padding */
         binary[bp] = '\0';
         strcpy((char*)datastream, binary);
-        return;
+        return 0;
     }
 
     /* Terminator */
@@ -715,11 +709,13 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
         }
         printf("\n");
     }
+
+    return 0;
 }
 
 /* Split data into blocks, add error correction and then interleave the blocks and error correction data */
-static void add_ecc(unsigned char fullstream[], const unsigned char datastream[], const int version, const int data_cw,
-            const int blocks, int debug_print) {
+static int add_ecc(struct zint_symbol *symbol, unsigned char fullstream[], const unsigned char datastream[],
+            const int version, const int data_cw, const int blocks, int debug_print) {
     int ecc_cw;
     int short_data_block_length;
     int qty_long_blocks;
@@ -727,12 +723,10 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
     int ecc_block_length;
     int i, j, length_this_block, in_posn;
     rs_t rs;
-#ifdef _MSC_VER
-    unsigned char* data_block;
-    unsigned char* ecc_block;
-    unsigned char* interleaved_data;
-    unsigned char* interleaved_ecc;
-#endif
+    unsigned char *data_block;
+    unsigned char *ecc_block;
+    unsigned char *interleaved_data;
+    unsigned char *interleaved_ecc;
 
     if (version < RMQR_VERSION) {
         ecc_cw = qr_total_codewords[version - 1] - data_cw;
@@ -749,17 +743,14 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
     assert(short_data_block_length >= 0);
     assert(ecc_block_length * blocks == ecc_cw);
 
-#ifndef _MSC_VER
-    unsigned char data_block[short_data_block_length + 1];
-    unsigned char ecc_block[ecc_block_length];
-    unsigned char interleaved_data[data_cw];
-    unsigned char interleaved_ecc[ecc_cw];
-#else
-    data_block = (unsigned char *) _alloca(short_data_block_length + 1);
-    ecc_block = (unsigned char *) _alloca(ecc_block_length);
-    interleaved_data = (unsigned char *) _alloca(data_cw);
-    interleaved_ecc = (unsigned char *) _alloca(ecc_cw);
-#endif
+    data_block = (unsigned char *) scratch_alloc(symbol, short_data_block_length + 1);
+    ecc_block = (unsigned char *) scratch_alloc(symbol, ecc_block_length);
+    interleaved_data = (unsigned char *) scratch_alloc(symbol, data_cw);
+    interleaved_ecc = (unsigned char *) scratch_alloc(symbol, ecc_cw);
+    if (!data_block || !ecc_block || !interleaved_data || !interleaved_ecc) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     rs_init_gf(&rs, 0x11d);
     rs_init_code(&rs, ecc_block_length, 0);
@@ -827,6 +818,8 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
         }
         printf("\n");
     }
+
+    return 0;
 }
 
 static void place_finder(unsigned char grid[], const int size, const int x, const int y) {
@@ -995,28 +988,6 @@ static void populate_grid(unsigned char *grid, const int h_size, const int v_siz
     }
 }
 
-#ifdef ZINTLOG
-
-static int append_log(char log) {
-    FILE *file;
-
-    file = fopen("zintlog.txt", "a+");
-    fprintf(file, "%c", log);
-    fclose(file);
-    return 0;
-}
-
-static int write_log(char log[]) {
-    FILE *file;
-
-    file = fopen("zintlog.txt", "a+");
-    fprintf(file, log); /*writes*/
-    fprintf(file, "\r\n"); /*writes*/
-    fclose(file);
-    return 0;
-}
-#endif
-
 static int evaluate(unsigned char *local, const int size) {
     static const unsigned char h1011101[7] = { 1, 0, 1, 1, 1, 0, 1 };
 
@@ -1026,27 +997,10 @@ static int evaluate(unsigned char *local, const int size) {
     int dark_mods;
     double percentage;
     int a, b, afterCount, beforeCount;
-#ifdef ZINTLOG
-    int result_b = 0;
-    char str[15];
-#endif
 
     /* Suppresses clang-tidy clang-analyzer-core.UndefinedBinaryOperatorResult warnings */
     assert(size > 0);
 
-#ifdef ZINTLOG
-    //bitmask output
-    for (y = 0; y < size; y++) {
-        strcpy(str, "");
-        for (x = 0; x < size; x++) {
-            state = local[(y * size) + x];
-            append_log(state);
-        }
-        write_log("");
-    }
-    write_log("");
-#endif
-
     /* Test 1: Adjacent modules in row/column in same colour */
     /* Vertical */
     for (x = 0; x < size; x++) {
@@ -1093,13 +1047,6 @@ static int evaluate(unsigned char *local, const int size) {
         }
     }
 
-#ifdef ZINTLOG
-    /* output Test 1 */
-    sprintf(str, "%d", result);
-    result_b = result;
-    write_log(str);
-#endif
-
     /* Test 2: Block of modules in same color */
     for (x = 0; x < size - 1; x++) {
         for (y = 0; y < size - 1; y++) {
@@ -1112,13 +1059,6 @@ static int evaluate(unsigned char *local, const int size) {
         }
     }
 
-#ifdef ZINTLOG
-    /* output Test 2 */
-    sprintf(str, "%d", result - result_b);
-    result_b = result;
-    write_log(str);
-#endif
-
     /* Test 3: 1:1:3:1:1 ratio pattern in row/column */
     /* Vertical */
     for (x = 0; x < size; x++) {
@@ -1206,28 +1146,12 @@ static int evaluate(unsigned char *local, const int size) {
         }
     }
 
-#ifdef ZINTLOG
-    /* output Test 3 */
-    sprintf(str, "%d", result - result_b);
-    result_b = result;
-    write_log(str);
-#endif
-
     /* Test 4: Proportion of dark modules in entire symbol */
     percentage = (100.0 * dark_mods) / (size * size);
     k = (int) (fabs(percentage - 50.0) / 5.0);
 
     result += 10 * k;
 
-#ifdef ZINTLOG
-    /* output Test 4+summary */
-    sprintf(str, "%d", result - result_b);
-    write_log(str);
-    write_log("==========");
-    sprintf(str, "%d", result);
-    write_log(str);
-#endif
-
     return result;
 }
 
@@ -1269,22 +1193,61 @@ static void add_format_info(unsigned char *grid, const int size, const int ecc_l
     grid[(8 * size) + 7] |= (seq >> 8) & 0x01;
 }
 
-static int apply_bitmask(unsigned char *grid, const int size, const int ecc_level, const int user_mask,
-            const int debug_print) {
+struct qr_mask_ctx {
+    const unsigned char *grid;
+    const unsigned char *mask;
+    unsigned char *locals; /* `size_squared` scratch per thread */
+    int size;
+    int ecc_level;
+    int penalty[8];
+};
+
+/* Evaluate bitmask `pattern` (`parallel_job`) */
+static void qr_mask_job(void *vctx, const int pattern, const int thread) {
+    struct qr_mask_ctx *ctx = (struct qr_mask_ctx *) vctx;
+    const int size_squared = ctx->size * ctx->size;
+    unsigned char *local = ctx->locals + thread * size_squared;
+    const int bit = 1 << pattern;
+    int k;
+
+    for (k = 0; k < size_squared; k++) {
+        if (ctx->mask[k] & bit) {
+            local[k] = ctx->grid[k] ^ 0x01;
+        } else {
+            local[k] = ctx->grid[k] & 0x0f;
+        }
+    }
+    add_format_info(local, ctx->size, ctx->ecc_level, pattern);
+
+    ctx->penalty[pattern] = evaluate(local, ctx->size);
+}
+
+/* Returns best (or user) mask pattern, or -1 if out of memory */
+static int apply_bitmask(struct zint_symbol *symbol, unsigned char *grid, const int size, const int ecc_level,
+            const int user_mask, int threads, const int debug_print) {
     int x, y;
-    int r, k;
+    int r;
     int bit;
     int pattern, penalty[8];
     int best_pattern;
     int size_squared = size * size;
+    struct qr_mask_ctx ctx;
+    unsigned char *mask = (unsigned char *) scratch_alloc(symbol, size_squared);
+    unsigned char *local = NULL;
 
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char local[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-    unsigned char *local = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    if (mask && !user_mask) {
+        /* Per-thread evaluation buffers, the first doubling as `local` if not spread */
+        if (threads > 1 && !(local = (unsigned char *) scratch_alloc(symbol, (size_t) threads * size_squared))) {
+            threads = 1; /* Fall back to evaluating in turn */
+        }
+        if (!local) {
+            local = (unsigned char *) scratch_alloc(symbol, size_squared);
+        }
+    }
+    if (!mask || (!user_mask && !local)) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return -1;
+    }
 
     /* Perform data masking */
     memset(mask, 0, size_squared);
@@ -1328,21 +1291,16 @@ static int apply_bitmask(unsigned char *grid, const int size, const int ecc_leve
         /* all eight bitmask variants have been encoded in the 8 bits of the bytes
          * that make up the mask array. select them for evaluation according to the
          * desired pattern.*/
+        ctx.grid = grid;
+        ctx.mask = mask;
+        ctx.locals = local;
+        ctx.size = size;
+        ctx.ecc_level = ecc_level;
+        parallel_for(threads, 8, qr_mask_job, &ctx);
+
         best_pattern = 0;
         for (pattern = 0; pattern < 8; pattern++) {
-
-            bit = 1 << pattern;
-            for (k = 0; k < size_squared; k++) {
-                if (mask[k] & bit) {
-                    local[k] = grid[k] ^ 0x01;
-                } else {
-                    local[k] = grid[k] & 0x0f;
-                }
-            }
-            add_format_info(local, size, ecc_level, pattern);
-
-            penalty[pattern] = evaluate(local, size);
-
+            penalty[pattern] = ctx.penalty[pattern];
             if (penalty[pattern] < penalty[best_pattern]) {
                 best_pattern = pattern;
             }
@@ -1357,15 +1315,8 @@ static int apply_bitmask(unsigned char *grid, const int size, const int ecc_leve
         printf("\n");
     }
 
-#ifdef ZINTLOG
-    char str[15];
-    sprintf(str, "%d", best_val);
-    write_log("choosed pattern:");
-    write_log(str);
-#endif
-
     /* Apply mask */
-    if (!user_mask && best_pattern == 7) { /* Reuse last */
+    if (!user_mask && best_pattern == 7 && threads == 1) { /* Reuse last */
         memcpy(grid, local, size_squared);
     } else {
         bit = 1 << best_pattern;
@@ -1410,8 +1361,8 @@ static int blockLength(const int start, const char inputMode[], const int inputL
     return count;
 }
 
-static int getBinaryLength(const int version, char inputMode[], const unsigned int inputData[], const int inputLength,
-            const int gs1, const int eci, const int debug_print) {
+static int getBinaryLength(const int version, char inputMode[], char char_modes[], const unsigned int inputData[],
+            const int inputLength, const int gs1, const int eci, const int debug_print) {
     /* Calculate the actual bitlength of the proposed binary string */
     int i, j;
     char currentMode;
@@ -1419,7 +1370,7 @@ static int getBinaryLength(const int version, char inputMode[], const unsigned i
     int alphalength;
     int blocklength;
 
-    qr_define_mode(inputMode, inputData, inputLength, gs1, version, debug_print);
+    qr_define_mode(inputMode, char_modes, inputData, inputLength, gs1, version, debug_print);
 
     currentMode = ' '; // Null
 
@@ -1515,19 +1466,18 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
     int canShrink;
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
+    unsigned char *datastream;
+    unsigned char *fullstream;
+    unsigned char *grid;
+    unsigned int *jisdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (length + 1));
+    char *mode = (char *) scratch_alloc(symbol, length);
+    char *prev_mode = (char *) scratch_alloc(symbol, length);
+    char *char_modes = (char *) scratch_alloc(symbol, (size_t) length * QR_NUM_MODES);
 
-#ifndef _MSC_VER
-    unsigned int jisdata[length + 1];
-    char mode[length];
-    char prev_mode[length];
-#else
-    unsigned char* datastream;
-    unsigned char* fullstream;
-    unsigned char* grid;
-    unsigned int* jisdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-    char *mode = (char *) _alloca(length);
-    char *prev_mode = (char *) _alloca(length);
-#endif
+    if (!jisdata || !mode || !prev_mode || !char_modes) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     gs1 = ((symbol->input_mode & 0x07) == GS1_MODE);
     /* If ZINT_FULL_MULTIBYTE use Kanji mode in DATA_MODE or for single-byte Latin */
@@ -1543,10 +1493,12 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         int done = 0;
         if (symbol->eci != 20) { /* Unless ECI 20 (Shift JIS) */
             /* Try single byte (Latin) conversion first */
-            int error_number = sjis_utf8tosb(symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source, &length,
-                                    jisdata, full_multibyte);
+            int error_number = sjis_utf8tosb(symbol, symbol->eci && symbol->eci <= 899 ? symbol->eci : 3, source,
+                                    &length, jisdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                return error_number;
             } else if (symbol->eci && symbol->eci <= 899) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
                 return error_number;
@@ -1561,7 +1513,7 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    est_binlen = getBinaryLength(40, mode, jisdata, length, gs1, symbol->eci, debug_print);
+    est_binlen = getBinaryLength(40, mode, char_modes, jisdata, length, gs1, symbol->eci, debug_print);
 
     ecc_level = LEVEL_L;
     max_cw = 2956;
@@ -1612,7 +1564,7 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
     if (autosize != 40) {
-        est_binlen = getBinaryLength(autosize, mode, jisdata, length, gs1, symbol->eci, debug_print);
+        est_binlen = getBinaryLength(autosize, mode, char_modes, jisdata, length, gs1, symbol->eci, debug_print);
     }
 
     // Now see if the optimised binary will fit in a smaller symbol.
@@ -1624,7 +1576,8 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         } else {
             prev_est_binlen = est_binlen;
             memcpy(prev_mode, mode, length);
-            est_binlen = getBinaryLength(autosize - 1, mode, jisdata, length, gs1, symbol->eci, debug_print);
+            est_binlen = getBinaryLength(autosize - 1, mode, char_modes, jisdata, length,
+                    gs1, symbol->eci, debug_print);
 
             switch (ecc_level) {
                 case LEVEL_L:
@@ -1669,7 +1622,8 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
          */
         if (symbol->option_2 > version) {
             version = symbol->option_2;
-            est_binlen = getBinaryLength(symbol->option_2, mode, jisdata, length, gs1, symbol->eci, debug_print);
+            est_binlen = getBinaryLength(symbol->option_2, mode, char_modes, jisdata, length,
+                    gs1, symbol->eci, debug_print);
         }
 
         if (symbol->option_2 < version) {
@@ -1705,27 +1659,26 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
             break;
     }
 
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[qr_total_codewords[version - 1] + 1];
-#else
-    datastream = (unsigned char *) _alloca(target_codewords + 1);
-    fullstream = (unsigned char *) _alloca(qr_total_codewords[version - 1] + 1);
-#endif
+    size = qr_sizes[version - 1];
+    size_squared = size * size;
+    datastream = (unsigned char *) scratch_alloc(symbol, target_codewords + 1);
+    fullstream = (unsigned char *) scratch_alloc(symbol, qr_total_codewords[version - 1] + 1);
+    grid = (unsigned char *) scratch_alloc(symbol, size_squared);
+    if (!datastream || !fullstream || !grid) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
-    qr_binary(datastream, version, target_codewords, mode, jisdata, length, gs1, symbol->eci, est_binlen, debug_print);
+    if (qr_binary(symbol, datastream, version, target_codewords, mode, jisdata, length, gs1, symbol->eci, est_binlen,
+            debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
-    add_ecc(fullstream, datastream, version, target_codewords, blocks, debug_print);
-
-    size = qr_sizes[version - 1];
-    size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    if (add_ecc(symbol, fullstream, datastream, version, target_codewords, blocks, debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     memset(grid, 0, size_squared);
 
@@ -1736,7 +1689,11 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         add_version_info(grid, size, version);
     }
 
-    bitmask = apply_bitmask(grid, size, ecc_level, user_mask, debug_print);
+    bitmask = apply_bitmask(symbol, grid, size, ecc_level, user_mask, parallel_threads(symbol, size * size, 8),
+                debug_print);
+    if (bitmask < 0) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     add_format_info(grid, size, ecc_level, bitmask);
 
@@ -2264,14 +2221,8 @@ static int micro_apply_bitmask(unsigned char *grid, const int size, const int us
     int pattern, value[4];
     int best_pattern;
     int size_squared = size * size;
-
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char eval[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-    unsigned char *eval = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    unsigned char mask[17 * 17]; /* Largest Micro QR is M4 17x17 */
+    unsigned char eval[17 * 17];
 
     /* Perform data masking */
     memset(mask, 0, size_squared);
@@ -2352,6 +2303,7 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
 
     unsigned int jisdata[40];
     char mode[40];
+    char char_modes[40 * QR_NUM_MODES];
     int alpha_used = 0, byte_or_kanji_used = 0;
     int version_valid[4];
     int binary_count[4];
@@ -2359,9 +2311,7 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
     int bitmask, format, format_full;
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
-#ifdef _MSC_VER
-    unsigned char* grid;
-#endif
+    unsigned char grid[17 * 17];
 
     if (length > 35) {
         strcpy(symbol->errtxt, "562: Input data too long");
@@ -2399,7 +2349,7 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         sjis_cpy(source, &length, jisdata, full_multibyte);
     } else {
         /* Try ISO 8859-1 conversion first */
-        int error_number = sjis_utf8tosb(3, source, &length, jisdata, full_multibyte);
+        int error_number = sjis_utf8tosb(symbol, 3, source, &length, jisdata, full_multibyte);
         if (error_number != 0) {
             /* Try Shift-JIS */
             error_number = sjis_utf8tomb(symbol, source, &length, jisdata);
@@ -2444,7 +2394,8 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
     /* Determine length of binary data */
     for (i = 0; i < 4; i++) {
         if (version_valid[i]) {
-            binary_count[i] = getBinaryLength(MICROQR_VERSION + i, mode, jisdata, length, 0 /*gs1*/, 0 /*eci*/, debug_print);
+            binary_count[i] = getBinaryLength(MICROQR_VERSION + i, mode, char_modes, jisdata, length,
+                    0 /*gs1*/, 0 /*eci*/, debug_print);
         } else {
             binary_count[i] = 128 + 1;
         }
@@ -2526,10 +2477,12 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    qr_define_mode(mode, jisdata, length, 0 /*gs1*/, MICROQR_VERSION + version, debug_print);
+    qr_define_mode(mode, char_modes, jisdata, length, 0 /*gs1*/, MICROQR_VERSION + version, debug_print);
 
-    qr_binary((unsigned char *) full_stream, MICROQR_VERSION + version, 0 /*target_codewords*/, mode, jisdata, length,
-            0 /*gs1*/, 0 /*eci*/, binary_count[version], debug_print);
+    if (qr_binary(symbol, (unsigned char *) full_stream, MICROQR_VERSION + version, 0 /*target_codewords*/, mode,
+            jisdata, length, 0 /*gs1*/, 0 /*eci*/, binary_count[version], debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     switch (version) {
         case 0: micro_qr_m1(symbol, full_stream);
@@ -2544,11 +2497,6 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
 
     size = micro_qr_sizes[version];
     size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
 
     memset(grid, 0, size_squared);
 
@@ -2654,23 +2602,18 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
     int bitmask, error_number;
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
+    unsigned char *datastream;
+    unsigned char *fullstream;
+    unsigned char *grid;
+    unsigned int *jisdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (length + 1));
+    char *mode = (char *) scratch_alloc(symbol, length + 1);
+    char *char_modes = (char *) scratch_alloc(symbol, (size_t) length * QR_NUM_MODES);
+    unsigned char *preprocessed = (unsigned char *) scratch_alloc(symbol, length + 1);
 
-#ifndef _MSC_VER
-    unsigned int jisdata[length + 1];
-    char mode[length + 1];
-#else
-    unsigned char* datastream;
-    unsigned char* fullstream;
-    unsigned char* grid;
-    unsigned int* jisdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-    char* mode = (char *) _alloca(length + 1);
-#endif
-
-#ifndef _MSC_VER
-    unsigned char preprocessed[length + 1];
-#else
-    unsigned char* preprocessed = (unsigned char*) _alloca(length + 1);
-#endif
+    if (!jisdata || !mode || !char_modes || !preprocessed) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     symbol->eci = 4; /* Set before any processing */
 
@@ -2699,7 +2642,7 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
             break;
     }
 
-    est_binlen = getBinaryLength(15, mode, jisdata, length, 0, symbol->eci, debug_print);
+    est_binlen = getBinaryLength(15, mode, char_modes, jisdata, length, 0, symbol->eci, debug_print);
 
     ecc_level = LEVEL_M;
 
@@ -2712,27 +2655,26 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
 
     target_codewords = qr_data_codewords_M[version - 1];
     blocks = qr_blocks_M[version - 1];
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[qr_total_codewords[version - 1] + 1];
-#else
-    datastream = (unsigned char *) _alloca(target_codewords + 1);
-    fullstream = (unsigned char *) _alloca(qr_total_codewords[version - 1] + 1);
-#endif
+    size = qr_sizes[version - 1];
+    size_squared = size * size;
+    datastream = (unsigned char *) scratch_alloc(symbol, target_codewords + 1);
+    fullstream = (unsigned char *) scratch_alloc(symbol, qr_total_codewords[version - 1] + 1);
+    grid = (unsigned char *) scratch_alloc(symbol, size_squared);
+    if (!datastream || !fullstream || !grid) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
-    qr_binary(datastream, version, target_codewords, mode, jisdata, length, 0, symbol->eci, est_binlen, debug_print);
+    if (qr_binary(symbol, datastream, version, target_codewords, mode, jisdata, length, 0, symbol->eci, est_binlen,
+            debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
-    add_ecc(fullstream, datastream, version, target_codewords, blocks, debug_print);
-
-    size = qr_sizes[version - 1];
-    size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    if (add_ecc(symbol, fullstream, datastream, version, target_codewords, blocks, debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     memset(grid, 0, size_squared);
 
@@ -2741,7 +2683,11 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
 
     add_version_info(grid, size, version);
 
-    bitmask = apply_bitmask(grid, size, ecc_level, 0 /*user_mask*/, debug_print);
+    bitmask = apply_bitmask(symbol, grid, size, ecc_level, 0 /*user_mask*/, parallel_threads(symbol, size * size, 8),
+                debug_print);
+    if (bitmask < 0) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     add_format_info(grid, size, ecc_level, bitmask);
 
@@ -2884,17 +2830,17 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
     int footprint, best_footprint, format_data;
     unsigned int left_format_info, right_format_info;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
+    unsigned char *datastream;
+    unsigned char *fullstream;
+    unsigned char *grid;
+    unsigned int *jisdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (length + 1));
+    char *mode = (char *) scratch_alloc(symbol, length + 1);
+    char *char_modes = (char *) scratch_alloc(symbol, (size_t) length * QR_NUM_MODES);
 
-#ifndef _MSC_VER
-    unsigned int jisdata[length + 1];
-    char mode[length + 1];
-#else
-    unsigned char* datastream;
-    unsigned char* fullstream;
-    unsigned char* grid;
-    unsigned int* jisdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-    char* mode = (char *) _alloca(length + 1);
-#endif
+    if (!jisdata || !mode || !char_modes) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     gs1 = ((symbol->input_mode & 0x07) == GS1_MODE);
     /* If ZINT_FULL_MULTIBYTE use Kanji mode in DATA_MODE or for single-byte Latin */
@@ -2904,7 +2850,7 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         sjis_cpy(source, &length, jisdata, full_multibyte);
     } else {
         /* Try ISO 8859-1 conversion first */
-        int error_number = sjis_utf8tosb(3, source, &length, jisdata, full_multibyte);
+        int error_number = sjis_utf8tosb(symbol, 3, source, &length, jisdata, full_multibyte);
         if (error_number != 0) {
             /* Try Shift-JIS */
             error_number = sjis_utf8tomb(symbol, source, &length, jisdata);
@@ -2914,7 +2860,7 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         }
     }
 
-    est_binlen = getBinaryLength(RMQR_VERSION + 31, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+    est_binlen = getBinaryLength(RMQR_VERSION + 31, mode, char_modes, jisdata, length, gs1, 0 /*eci*/, debug_print);
 
     ecc_level = LEVEL_M;
     max_cw = 152;
@@ -2950,7 +2896,8 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         autosize = 31;
         best_footprint = rmqr_height[31] * rmqr_width[31];
         for (version = 30; version >= 0; version--) {
-            est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+            est_binlen = getBinaryLength(RMQR_VERSION + version, mode, char_modes, jisdata, length,
+                    gs1, 0 /*eci*/, debug_print);
             footprint = rmqr_height[version] * rmqr_width[version];
             if (ecc_level == LEVEL_M) {
                 if (8 * rmqr_data_codewords_M[version] >= est_binlen) {
@@ -2969,20 +2916,23 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
             }
         }
         version = autosize;
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, char_modes, jisdata, length,
+                gs1, 0 /*eci*/, debug_print);
     }
 
     if ((symbol->option_2 >= 1) && (symbol->option_2 <= 32)) {
         // User specified symbol size
         version = symbol->option_2 - 1;
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, char_modes, jisdata, length,
+                gs1, 0 /*eci*/, debug_print);
     }
 
     if (symbol->option_2 >= 33) {
         // User has specified symbol height only
         version = rmqr_fixed_height_upper_bound[symbol->option_2 - 32];
         for(i = version - 1; i > rmqr_fixed_height_upper_bound[symbol->option_2 - 33]; i--) {
-            est_binlen = getBinaryLength(RMQR_VERSION + i, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+            est_binlen = getBinaryLength(RMQR_VERSION + i, mode, char_modes, jisdata, length,
+                    gs1, 0 /*eci*/, debug_print);
             if (ecc_level == LEVEL_M) {
                 if (8 * rmqr_data_codewords_M[i] >= est_binlen) {
                     version = i;
@@ -2993,7 +2943,8 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
                 }
             }
         }
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, char_modes, jisdata, length,
+                gs1, 0 /*eci*/, debug_print);
     }
 
     if (symbol->option_1 == -1) {
@@ -3029,28 +2980,26 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         printf("Number of ECC blocks = %d\n", blocks);
     }
 
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[rmqr_total_codewords[version] + 1];
-#else
-    datastream = (unsigned char *) _alloca((target_codewords + 1) * sizeof (unsigned char));
-    fullstream = (unsigned char *) _alloca((rmqr_total_codewords[version] + 1) * sizeof (unsigned char));
-#endif
-
-    qr_binary(datastream, RMQR_VERSION + version, target_codewords, mode, jisdata, length, gs1, 0 /*eci*/, est_binlen, debug_print);
-#ifdef ZINT_TEST
-    if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
-#endif
-    add_ecc(fullstream, datastream, RMQR_VERSION + version, target_codewords, blocks, debug_print);
-
     h_size = rmqr_width[version];
     v_size = rmqr_height[version];
+    datastream = (unsigned char *) scratch_alloc(symbol, target_codewords + 1);
+    fullstream = (unsigned char *) scratch_alloc(symbol, rmqr_total_codewords[version] + 1);
+    grid = (unsigned char *) scratch_alloc(symbol, h_size * v_size);
+    if (!datastream || !fullstream || !grid) {
+        strcpy(symbol->errtxt, "588: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
-#ifndef _MSC_VER
-    unsigned char grid[h_size * v_size];
-#else
-    grid = (unsigned char *) _alloca((h_size * v_size) * sizeof (unsigned char));
+    if (qr_binary(symbol, datastream, RMQR_VERSION + version, target_codewords, mode, jisdata, length, gs1,
+            0 /*eci*/, est_binlen, debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
+#ifdef ZINT_TEST
+    if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
+    if (add_ecc(symbol, fullstream, datastream, RMQR_VERSION + version, target_codewords, blocks, debug_print)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     memset(grid, 0, h_size * v_size);
 
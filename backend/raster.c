@@ -61,30 +61,20 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
 static const char ultra_colour[] = "0CBMRYGKW";
 
-static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
-    /* Place pixelbuffer into symbol */
-    int fgalpha, bgalpha;
-    unsigned char fg[3], bg[3];
-    unsigned char white[3] =   { 0xff, 0xff, 0xff };
-    unsigned char cyan[3] =    {    0, 0xff, 0xff };
-    unsigned char blue[3] =    {    0,    0, 0xff };
-    unsigned char magenta[3] = { 0xff,    0, 0xff };
-    unsigned char red[3] =     { 0xff,    0,    0 };
-    unsigned char yellow[3] =  { 0xff, 0xff,    0 };
-    unsigned char green[3] =   {    0, 0xff,    0 };
-    unsigned char black[3] =   {    0,    0,    0 };
-    unsigned char *map[91] = {
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x00-0F */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x10-1F */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x20-2F */
-        bg, fg, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0-9 */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* :;<=>?@ */
-        NULL, blue, cyan, NULL, NULL, NULL, green, NULL, NULL, NULL, black, NULL, magenta, /* A-M */
-        NULL, NULL, NULL, NULL, red, NULL, NULL, NULL, NULL, white, NULL, yellow, NULL /* N-Z */
+/* Set `colours` to the RGBA of each intermediate pixel value, '0' paper, '1' ink and the Ultracode colour letters,
+   returning 1 if foreground or background has alpha */
+static int pixel_colours(const struct zint_symbol *symbol, unsigned char colours[91][4]) {
+    static const char letters[] = "WCBMRYGK";
+    static const unsigned char letter_rgb[8][3] = {
+        { 0xff, 0xff, 0xff }, {    0, 0xff, 0xff }, {    0,    0, 0xff }, { 0xff,    0, 0xff },
+        { 0xff,    0,    0 }, { 0xff, 0xff,    0 }, {    0, 0xff,    0 }, {    0,    0,    0 },
     };
-    int row, column;
+    unsigned char *fg = colours[DEFAULT_INK];
+    unsigned char *bg = colours[DEFAULT_PAPER];
     int plot_alpha = 0;
-    unsigned char *bitmap;
+    int i;
+
+    memset(colours, 0, 91 * 4);
 
     fg[0] = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
     fg[1] = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
@@ -94,37 +84,54 @@ static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     bg[2] = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
 
     if (strlen(symbol->fgcolour) > 6) {
-        fgalpha = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
+        fg[3] = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
         plot_alpha = 1;
     } else {
-        fgalpha = 0xff;
+        fg[3] = 0xff;
     }
 
     if (strlen(symbol->bgcolour) > 6) {
-        bgalpha = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
+        bg[3] = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
         plot_alpha = 1;
     } else {
-        bgalpha = 0xff;
+        bg[3] = 0xff;
+    }
+
+    for (i = 0; i < 8; i++) {
+        memcpy(colours[(int) letters[i]], letter_rgb[i], 3);
+        colours[(int) letters[i]][3] = fg[3]; /* Ultracode colours take the foreground alpha */
     }
 
+    return plot_alpha;
+}
+
+static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    /* Place pixelbuffer into symbol */
+    unsigned char colours[91][4];
+    int row, column;
+    int plot_alpha;
+    unsigned char *bitmap;
+
+    plot_alpha = pixel_colours(symbol, colours);
+
     /* Free any previous bitmap */
     if (symbol->bitmap != NULL) {
-        free(symbol->bitmap);
+        z_free(symbol, symbol->bitmap);
         symbol->bitmap = NULL;
     }
     if (symbol->alphamap != NULL) {
-        free(symbol->alphamap);
+        z_free(symbol, symbol->alphamap);
         symbol->alphamap = NULL;
     }
 
-    symbol->bitmap = (unsigned char *) malloc((size_t) symbol->bitmap_width * symbol->bitmap_height * 3);
+    symbol->bitmap = (unsigned char *) z_malloc(symbol, (size_t) symbol->bitmap_width * symbol->bitmap_height * 3);
     if (symbol->bitmap == NULL) {
         strcpy(symbol->errtxt, "661: Insufficient memory for bitmap buffer");
         return ZINT_ERROR_MEMORY;
     }
 
     if (plot_alpha) {
-        symbol->alphamap = (unsigned char *) malloc((size_t) symbol->bitmap_width * symbol->bitmap_height);
+        symbol->alphamap = (unsigned char *) z_malloc(symbol, (size_t) symbol->bitmap_width * symbol->bitmap_height);
         if (symbol->alphamap == NULL) {
             strcpy(symbol->errtxt, "662: Insufficient memory for alphamap buffer");
             return ZINT_ERROR_MEMORY;
@@ -133,8 +140,8 @@ static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
             int p = row * symbol->bitmap_width;
             bitmap = symbol->bitmap + p * 3;
             for (column = 0; column < symbol->bitmap_width; column++, p++, bitmap += 3) {
-                memcpy(bitmap, map[pixelbuf[p]], 3);
-                symbol->alphamap[p] = pixelbuf[p] == DEFAULT_PAPER ? bgalpha : fgalpha;
+                memcpy(bitmap, colours[pixelbuf[p]], 3);
+                symbol->alphamap[p] = colours[pixelbuf[p]][3];
             }
         }
     } else {
@@ -143,7 +150,7 @@ static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
             unsigned char *pb = pixelbuf + r;
             bitmap = symbol->bitmap + r * 3;
             for (column = 0; column < symbol->bitmap_width; column++, pb++, bitmap += 3) {
-                memcpy(bitmap, map[*pb], 3);
+                memcpy(bitmap, colours[*pb], 3);
             }
         }
     }
@@ -172,7 +179,7 @@ static int save_raster_image_to_file(struct zint_symbol *symbol, int image_heigh
     }
 
     if (rotate_angle) {
-        if (!(rotated_pixbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
+        if (!(rotated_pixbuf = (unsigned char *) z_malloc(symbol, (size_t) image_width * image_height))) {
             strcpy(symbol->errtxt, "650: Insufficient memory for pixel buffer");
             return ZINT_ERROR_ENCODING_PROBLEM;
         }
@@ -213,11 +220,11 @@ static int save_raster_image_to_file(struct zint_symbol *symbol, int image_heigh
         case OUT_BUFFER:
             if (symbol->output_options & OUT_BUFFER_INTERMEDIATE) {
                 if (symbol->bitmap != NULL) {
-                    free(symbol->bitmap);
+                    z_free(symbol, symbol->bitmap);
                     symbol->bitmap = NULL;
                 }
                 if (symbol->alphamap != NULL) {
-                    free(symbol->alphamap);
+                    z_free(symbol, symbol->alphamap);
                     symbol->alphamap = NULL;
                 }
                 symbol->bitmap = rotated_pixbuf;
@@ -232,7 +239,7 @@ static int save_raster_image_to_file(struct zint_symbol *symbol, int image_heigh
             error_number = png_pixel_plot(symbol, rotated_pixbuf);
 #else
             if (rotate_angle) {
-                free(rotated_pixbuf);
+                z_free(symbol, rotated_pixbuf);
             }
             return ZINT_ERROR_INVALID_OPTION;
 #endif
@@ -252,7 +259,7 @@ static int save_raster_image_to_file(struct zint_symbol *symbol, int image_heigh
     }
 
     if (rotate_angle) {
-        free(rotated_pixbuf);
+        z_free(symbol, rotated_pixbuf);
     }
     return error_number;
 }
@@ -568,7 +575,7 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, int rotate_angle, in
     image_width = ceil((double) (300 + 2 * (xoffset + roffset)) * scaler);
     image_height = ceil((double) (300 + 2 * (yoffset + boffset)) * scaler);
 
-    if (!(pixelbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
+    if (!(pixelbuf = (unsigned char *) z_malloc(symbol, (size_t) image_width * image_height))) {
         strcpy(symbol->errtxt, "655: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
@@ -576,9 +583,9 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, int rotate_angle, in
 
     hexagon_size = ceil(scaler * 10);
 
-    if (!(scaled_hexagon = (unsigned char *) malloc((size_t) hexagon_size * hexagon_size))) {
+    if (!(scaled_hexagon = (unsigned char *) z_malloc(symbol, (size_t) hexagon_size * hexagon_size))) {
         strcpy(symbol->errtxt, "656: Insufficient memory for pixel buffer");
-        free(pixelbuf);
+        z_free(symbol, pixelbuf);
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
     memset(scaled_hexagon, DEFAULT_PAPER, (size_t) hexagon_size * hexagon_size);
@@ -622,9 +629,9 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, int rotate_angle, in
     }
 
     error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, rotate_angle, file_type);
-    free(scaled_hexagon);
+    z_free(symbol, scaled_hexagon);
     if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-        free(pixelbuf);
+        z_free(symbol, pixelbuf);
     }
     return error_number;
 }
@@ -665,7 +672,7 @@ static int plot_raster_dotty(struct zint_symbol *symbol, int rotate_angle, int f
     scale_height = (symbol->height + yoffset + boffset) * scaler + dot_overspill_scaled;
 
     /* Apply scale options by creating another pixel buffer */
-    if (!(scaled_pixelbuf = (unsigned char *) malloc((size_t) scale_width * scale_height))) {
+    if (!(scaled_pixelbuf = (unsigned char *) z_malloc(symbol, (size_t) scale_width * scale_height))) {
         strcpy(symbol->errtxt, "657: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
@@ -690,7 +697,7 @@ static int plot_raster_dotty(struct zint_symbol *symbol, int rotate_angle, int f
 
     error_number = save_raster_image_to_file(symbol, scale_height, scale_width, scaled_pixelbuf, rotate_angle, file_type);
     if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-        free(scaled_pixelbuf);
+        z_free(symbol, scaled_pixelbuf);
     }
 
     return error_number;
@@ -823,7 +830,7 @@ static int plot_raster_default(struct zint_symbol *symbol, int rotate_angle, int
     image_width = (symbol->width + xoffset + roffset) * si;
     image_height = (symbol->height + textoffset + yoffset + boffset) * si;
 
-    if (!(pixelbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
+    if (!(pixelbuf = (unsigned char *) z_malloc(symbol, (size_t) image_width * image_height))) {
         strcpy(symbol->errtxt, "658: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
@@ -1126,8 +1133,8 @@ static int plot_raster_default(struct zint_symbol *symbol, int rotate_angle, int
         scale_height = image_height * scaler;
 
         /* Apply scale options by creating another pixel buffer */
-        if (!(scaled_pixelbuf = (unsigned char *) malloc((size_t) scale_width * scale_height))) {
-            free(pixelbuf);
+        if (!(scaled_pixelbuf = (unsigned char *) z_malloc(symbol, (size_t) scale_width * scale_height))) {
+            z_free(symbol, pixelbuf);
             strcpy(symbol->errtxt, "659: Insufficient memory for pixel buffer");
             return ZINT_ERROR_ENCODING_PROBLEM;
         }
@@ -1143,13 +1150,13 @@ static int plot_raster_default(struct zint_symbol *symbol, int rotate_angle, int
 
         error_number = save_raster_image_to_file(symbol, scale_height, scale_width, scaled_pixelbuf, rotate_angle, file_type);
         if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-            free(scaled_pixelbuf);
+            z_free(symbol, scaled_pixelbuf);
         }
-        free(pixelbuf);
+        z_free(symbol, pixelbuf);
     } else {
         error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, rotate_angle, file_type);
         if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-            free(pixelbuf);
+            z_free(symbol, pixelbuf);
         }
     }
     return error_number;
@@ -1180,3 +1187,172 @@ INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_
 
     return error;
 }
+
+/* Render `symbol` onto the page of `sheet` with its top left corner at pixel `x`, `y`. The page is held in
+   `sheet->bitmap` one byte per pixel, as for OUT_BUFFER_INTERMEDIATE, so only the symbol's own pixel buffer is needed */
+INTERNAL int plot_raster_sheet(struct zint_symbol *sheet, struct zint_symbol *symbol, const int x, const int y,
+            const int rotate_angle) {
+    const int output_options = symbol->output_options;
+    unsigned char *page;
+    int row;
+    int error_number;
+
+    symbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+    error_number = plot_raster(symbol, rotate_angle, OUT_BUFFER);
+    symbol->output_options = output_options;
+    if (error_number >= ZINT_ERROR) {
+        return error_number;
+    }
+
+    if (x < 0 || y < 0 || x + symbol->bitmap_width > sheet->bitmap_width
+            || y + symbol->bitmap_height > sheet->bitmap_height) {
+        strcpy(symbol->errtxt, "663: Symbol does not fit on sheet");
+        error_number = ZINT_ERROR_INVALID_OPTION;
+    } else {
+        page = sheet->bitmap + (size_t) y * sheet->bitmap_width + x;
+        for (row = 0; row < symbol->bitmap_height; row++, page += sheet->bitmap_width) {
+            memcpy(page, symbol->bitmap + (size_t) row * symbol->bitmap_width, symbol->bitmap_width);
+        }
+    }
+
+    z_free(symbol, symbol->bitmap);
+    symbol->bitmap = NULL;
+    symbol->bitmap_width = symbol->bitmap_height = 0;
+
+    return error_number;
+}
+
+/* Set `values` to the pixel of `format` (first byte only if less than 4 bytes) for each intermediate pixel value */
+static void pixel_values(const struct zint_symbol *symbol, const int format, unsigned char values[91][4]) {
+    static const char palette[] = "01WCBMRYGK";
+    unsigned char colours[91][4];
+    unsigned char *colour;
+    int i, alpha;
+
+    pixel_colours(symbol, colours);
+
+    switch (format) {
+        case ZINT_PIXEL_MONO1:
+            memset(values, 0, 91 * 4);
+            for (i = 0; i < 10; i++) {
+                values[(int) palette[i]][0] = i != 0 && i != 2; /* Background and Ultracode white clear */
+            }
+            break;
+        case ZINT_PIXEL_PALETTE8:
+            memset(values, 0, 91 * 4);
+            for (i = 0; i < 10; i++) {
+                values[(int) palette[i]][0] = i;
+            }
+            break;
+        case ZINT_PIXEL_GRAY8:
+            for (i = 0; i < 91; i++) {
+                colour = colours[i];
+                /* ITU-R BT.601 luma weights scaled by 256 */
+                values[i][0] = (unsigned char) ((77 * colour[0] + 150 * colour[1] + 29 * colour[2]) >> 8);
+            }
+            break;
+        case ZINT_PIXEL_RGBA32_PRE:
+        case ZINT_PIXEL_BGRA32_PRE:
+            for (i = 0; i < 91; i++) {
+                colour = colours[i];
+                alpha = colour[3];
+                values[i][0] = (unsigned char) ((colour[0] * alpha + 127) / 255);
+                values[i][1] = (unsigned char) ((colour[1] * alpha + 127) / 255);
+                values[i][2] = (unsigned char) ((colour[2] * alpha + 127) / 255);
+                values[i][3] = (unsigned char) alpha;
+                if (format == ZINT_PIXEL_BGRA32_PRE) {
+                    values[i][0] = values[i][2];
+                    values[i][2] = (unsigned char) ((colour[0] * alpha + 127) / 255);
+                }
+            }
+            break;
+        default: /* ZINT_PIXEL_RGB24, ZINT_PIXEL_RGBA32 */
+            memcpy(values, colours, 91 * 4);
+            break;
+    }
+}
+
+/* Render `symbol` into the caller's pixel memory `dst` with its top left corner at pixel `x`, `y`, converting
+   directly from the one byte per pixel buffer of OUT_BUFFER_INTERMEDIATE. `bitmap_width` and `bitmap_height` are
+   left set to the size of the symbol, even if it doesn't fit, so that the caller may resize `dst` and retry */
+INTERNAL int plot_raster_into(struct zint_symbol *symbol, const int rotate_angle, const struct zint_pixbuf *dst,
+            const int x, const int y) {
+    const int output_options = symbol->output_options;
+    unsigned char values[91][4];
+    const unsigned char *pb;
+    unsigned char *out;
+    int row, column;
+    int error_number;
+
+    symbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+    error_number = plot_raster(symbol, rotate_angle, OUT_BUFFER);
+    symbol->output_options = output_options;
+    if (error_number >= ZINT_ERROR) {
+        return error_number;
+    }
+
+    if (x < 0 || y < 0 || x + symbol->bitmap_width > dst->width || y + symbol->bitmap_height > dst->height) {
+        strcpy(symbol->errtxt, "666: Symbol does not fit in pixel buffer");
+        error_number = ZINT_ERROR_INVALID_OPTION;
+    } else {
+        pixel_values(symbol, dst->format, values);
+        pb = symbol->bitmap;
+        for (row = 0; row < symbol->bitmap_height; row++) {
+            out = dst->pixels + (size_t) (y + row) * dst->stride;
+            switch (dst->format) {
+                case ZINT_PIXEL_MONO1:
+                    for (column = x; column < x + symbol->bitmap_width; column++, pb++) {
+                        if (values[*pb][0]) {
+                            out[column >> 3] |= 0x80 >> (column & 7);
+                        } else {
+                            out[column >> 3] &= ~(0x80 >> (column & 7));
+                        }
+                    }
+                    break;
+                case ZINT_PIXEL_GRAY8:
+                case ZINT_PIXEL_PALETTE8:
+                    out += x;
+                    for (column = 0; column < symbol->bitmap_width; column++, pb++, out++) {
+                        *out = values[*pb][0];
+                    }
+                    break;
+                case ZINT_PIXEL_RGB24:
+                    out += x * 3;
+                    for (column = 0; column < symbol->bitmap_width; column++, pb++, out += 3) {
+                        memcpy(out, values[*pb], 3);
+                    }
+                    break;
+                default: /* 4 byte formats */
+                    out += x * 4;
+                    for (column = 0; column < symbol->bitmap_width; column++, pb++, out += 4) {
+                        memcpy(out, values[*pb], 4);
+                    }
+                    break;
+            }
+        }
+    }
+
+    z_free(symbol, symbol->bitmap);
+    symbol->bitmap = NULL;
+
+    return error_number;
+}
+
+/* Write the page of `sheet` to file */
+INTERNAL int plot_raster_page(struct zint_symbol *sheet, int file_type) {
+    int error;
+
+#ifdef NO_PNG
+    if (file_type == OUT_PNG_FILE) {
+        strcpy(sheet->errtxt, "664: PNG format disabled at compile time");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+#endif /* NO_PNG */
+
+    error = output_check_colour_options(sheet);
+    if (error != 0) {
+        return error;
+    }
+
+    return save_raster_image_to_file(sheet, sheet->bitmap_height, sheet->bitmap_width, sheet->bitmap, 0, file_type);
+}
@@ -48,7 +48,8 @@
 // replaced with constants in the obvious way, and additionally
 // malloc/free can be avoided by using static arrays of a suitable
 // size.
-// Note: use of statics has been done for (up to) 8-bit tables.
+// Note: the (up to) 8-bit tables are precalculated constants, and all other state is held in `rs_t`, so encoding
+// is thread-safe.
 
 #ifdef _MSC_VER
 #include <malloc.h>
@@ -186,20 +187,27 @@ INTERNAL void rs_encode_uint(const rs_t *rs, const int datalen, const unsigned i
 /* Versions of the above for bitlengths > 8 and <= 30 and unsigned int data and results - Aztec code compatible */
 
 // Usage:
-// First call rs_uint_init_gf(&rs_uint, prime_poly, logmod) to set up the Galois Field parameters.
+// First call rs_uint_init_gf(&rs_uint, symbol, prime_poly, logmod) to set up the Galois Field parameters.
 // Then  call rs_uint_init_code(&rs_uint, nsym, index) to set the encoding size
 // Then  call rs_uint_encode(&rs_uint, datalen, data, out) to encode the data.
 // Then  call rs_uint_free(&rs_uint) to free the log tables.
 
-/* `logmod` (field characteristic) will be 2**bitlength - 1, eg 1023 for bitlength 10, 4095 for bitlength 12 */
-INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly, const int logmod) {
+/* `logmod` (field characteristic) will be 2**bitlength - 1, eg 1023 for bitlength 10, 4095 for bitlength 12.
+   The log tables are allocated using `symbol`'s allocator (system's if NULL). Returns 0 if out of memory */
+INTERNAL int rs_uint_init_gf(rs_uint_t *rs_uint, const struct zint_symbol *symbol, const unsigned int prime_poly,
+                const int logmod) {
     int b, p, v;
     unsigned int *logt, *alog;
 
     b = logmod + 1;
 
-    logt = (unsigned int *) malloc(sizeof(unsigned int) * b);
-    alog = (unsigned int *) malloc(sizeof(unsigned int) * b * 2);
+    logt = (unsigned int *) z_malloc(symbol, sizeof(unsigned int) * b);
+    alog = (unsigned int *) z_malloc(symbol, sizeof(unsigned int) * b * 2);
+    if (!logt || !alog) {
+        z_free(symbol, logt);
+        z_free(symbol, alog);
+        return 0;
+    }
 
     // Calculate the log/alog tables
     for (p = 1, v = 0; v < logmod; v++) {
@@ -212,6 +220,9 @@ INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly,
     }
     rs_uint->logt = logt;
     rs_uint->alog = alog;
+    rs_uint->symbol = symbol;
+
+    return 1;
 }
 
 INTERNAL void rs_uint_init_code(rs_uint_t *rs_uint, const int nsym, int index) {
@@ -262,6 +273,6 @@ INTERNAL void rs_uint_encode(const rs_uint_t *rs_uint, const int datalen, const
 }
 
 INTERNAL void rs_uint_free(rs_uint_t *rs_uint) {
-    free(rs_uint->logt);
-    free(rs_uint->alog);
+    z_free(rs_uint->symbol, rs_uint->logt);
+    z_free(rs_uint->symbol, rs_uint->alog);
 }
@@ -48,6 +48,7 @@ typedef struct {
 typedef struct {
     unsigned int *logt; /* These are malloced */
     unsigned int *alog;
+    const struct zint_symbol *symbol; /* Whose allocator `logt` & `alog` come from */
     unsigned short rspoly[4096]; /* 12-bit max - needs to be enlarged if > 12-bit used */
     int nsym;
 } rs_uint_t;
@@ -58,7 +59,8 @@ INTERNAL void rs_encode(const rs_t *rs, const int datalen, const unsigned char *
 INTERNAL void rs_encode_uint(const rs_t *rs, const int datalen, const unsigned int *data, unsigned int *res);
 /* No free needed as log tables static */
 
-INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly, const int logmod);
+INTERNAL int rs_uint_init_gf(rs_uint_t *rs_uint, const struct zint_symbol *symbol, const unsigned int prime_poly,
+                const int logmod);
 INTERNAL void rs_uint_init_code(rs_uint_t *rs_uint, const int nsym, int index);
 INTERNAL void rs_uint_encode(const rs_uint_t *rs_uint, const int datalen, const unsigned int *data, unsigned int *res);
 INTERNAL void rs_uint_free(rs_uint_t *rs_uint);
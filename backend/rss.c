@@ -64,10 +64,8 @@
  */
 
 #include <stdio.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "large.h"
 #include "rss.h"
 #include "gs1.h"
@@ -157,6 +155,18 @@ static void getRSSwidths(int widths[], int val, int n, int elements, int maxWidt
     return;
 }
 
+/* Look up widths of 4-element (RSS-14 & Expanded) subset value `val` of group `group` from table pre-calculated
+ * by "getRSSwidths()" (see tools/gen_rss_widths_table.php), avoiding the combinatorics */
+static void getRSSwidths4(int widths[], const unsigned short table[], const unsigned short table_idx[],
+            int group, int val) {
+    int packed = table[table_idx[group] + val];
+
+    widths[0] = packed >> 12;
+    widths[1] = (packed >> 8) & 0x0F;
+    widths[2] = (packed >> 4) & 0x0F;
+    widths[3] = packed & 0x0F;
+}
+
 /* Calculate check digit from Annex A */
 static int calc_check_digit(unsigned char *src) {
     int i, check_digit;
@@ -404,23 +414,23 @@ INTERNAL int rss14(struct zint_symbol *symbol, unsigned char source[], int src_l
     /* Use RSS subset width algorithm */
     for (i = 0; i < 4; i++) {
         if ((i == 0) || (i == 2)) {
-            getRSSwidths(widths, v_odd[i], modules_odd[data_group[i]], 4, widest_odd[data_group[i]], 1);
+            getRSSwidths4(widths, widths_odd, widths_odd_idx, data_group[i], v_odd[i]);
             data_widths[0][i] = widths[0];
             data_widths[2][i] = widths[1];
             data_widths[4][i] = widths[2];
             data_widths[6][i] = widths[3];
-            getRSSwidths(widths, v_even[i], modules_even[data_group[i]], 4, widest_even[data_group[i]], 0);
+            getRSSwidths4(widths, widths_even, widths_even_idx, data_group[i], v_even[i]);
             data_widths[1][i] = widths[0];
             data_widths[3][i] = widths[1];
             data_widths[5][i] = widths[2];
             data_widths[7][i] = widths[3];
         } else {
-            getRSSwidths(widths, v_odd[i], modules_odd[data_group[i]], 4, widest_odd[data_group[i]], 0);
+            getRSSwidths4(widths, widths_odd, widths_odd_idx, data_group[i], v_odd[i]);
             data_widths[0][i] = widths[0];
             data_widths[2][i] = widths[1];
             data_widths[4][i] = widths[2];
             data_widths[6][i] = widths[3];
-            getRSSwidths(widths, v_even[i], modules_even[data_group[i]], 4, widest_even[data_group[i]], 1);
+            getRSSwidths4(widths, widths_even, widths_even_idx, data_group[i], v_even[i]);
             data_widths[1][i] = widths[0];
             data_widths[3][i] = widths[1];
             data_widths[5][i] = widths[2];
@@ -769,14 +779,15 @@ INTERNAL int rsslimited(struct zint_symbol *symbol, unsigned char source[], int
 static int rss_binary_string(struct zint_symbol *symbol, char source[], char binary_string[]) {
     int encoding_method, i, j, read_posn, last_digit, debug = (symbol->debug & ZINT_DEBUG_PRINT), mode = NUMERIC;
     int symbol_characters, characters_per_row;
-#ifndef _MSC_VER
-    char general_field[strlen(source) + 1];
-#else
-    char* general_field = (char*) _alloca(strlen(source) + 1);
-#endif
+    char *general_field = (char *) scratch_alloc(symbol, strlen(source) + 1);
     int remainder, d1, d2;
     char padstring[40];
 
+    if (!general_field) {
+        strcpy(symbol->errtxt, "378: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
+
     /* Decide whether a compressed data field is required and if so what
     method to use - method 2 = no compressed data field */
 
@@ -1285,12 +1296,13 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
     int separator_row;
     unsigned int bin_len = 13 * src_len + 200 + 1; /* Allow for 8 bits + 5-bit latch per char + 200 bits overhead/padding */
     int widths[4];
-#ifndef _MSC_VER
-    char reduced[src_len + 1], binary_string[bin_len];
-#else
-    char* reduced = (char*) _alloca(src_len + 1);
-    char* binary_string = (char*) _alloca(bin_len);
-#endif
+    char *reduced = (char *) scratch_alloc(symbol, src_len + 1);
+    char *binary_string = (char *) scratch_alloc(symbol, bin_len);
+
+    if (!reduced || !binary_string) {
+        strcpy(symbol->errtxt, "379: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     separator_row = 0;
 
@@ -1356,12 +1368,12 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
         v_odd[i] = (vs[i] - g_sum_exp[group[i] - 1]) / t_even_exp[group[i] - 1];
         v_even[i] = (vs[i] - g_sum_exp[group[i] - 1]) % t_even_exp[group[i] - 1];
 
-        getRSSwidths(widths, v_odd[i], modules_odd_exp[group[i] - 1], 4, widest_odd_exp[group[i] - 1], 0);
+        getRSSwidths4(widths, widths_odd_exp, widths_odd_exp_idx, group[i] - 1, v_odd[i]);
         char_widths[i][0] = widths[0];
         char_widths[i][2] = widths[1];
         char_widths[i][4] = widths[2];
         char_widths[i][6] = widths[3];
-        getRSSwidths(widths, v_even[i], modules_even_exp[group[i] - 1], 4, widest_even_exp[group[i] - 1], 1);
+        getRSSwidths4(widths, widths_even_exp, widths_even_exp_idx, group[i] - 1, v_even[i]);
         char_widths[i][1] = widths[0];
         char_widths[i][3] = widths[1];
         char_widths[i][5] = widths[2];
@@ -1405,12 +1417,12 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
     c_odd = (check_char - g_sum_exp[c_group - 1]) / t_even_exp[c_group - 1];
     c_even = (check_char - g_sum_exp[c_group - 1]) % t_even_exp[c_group - 1];
 
-    getRSSwidths(widths, c_odd, modules_odd_exp[c_group - 1], 4, widest_odd_exp[c_group - 1], 0);
+    getRSSwidths4(widths, widths_odd_exp, widths_odd_exp_idx, c_group - 1, c_odd);
     check_widths[0] = widths[0];
     check_widths[2] = widths[1];
     check_widths[4] = widths[2];
     check_widths[6] = widths[3];
-    getRSSwidths(widths, c_even, modules_even_exp[c_group - 1], 4, widest_even_exp[c_group - 1], 1);
+    getRSSwidths4(widths, widths_even_exp, widths_even_exp_idx, c_group - 1, c_even);
     check_widths[1] = widths[0];
     check_widths[3] = widths[1];
     check_widths[5] = widths[2];
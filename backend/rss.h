@@ -40,22 +40,6 @@ static const char t_table[9] = {
     1, 10, 34, 70, 126, 4, 20, 48, 81
 };
 
-static const char modules_odd[9] = {
-    12, 10, 8, 6, 4, 5, 7, 9, 11
-};
-
-static const char modules_even[9] = {
-    4, 6, 8, 10, 12, 10, 8, 6, 4
-};
-
-static const char widest_odd[9] = {
-    8, 6, 4, 3, 1, 2, 4, 6, 8
-};
-
-static const char widest_even[9] = {
-    1, 3, 5, 6, 8, 7, 5, 3, 1
-};
-
 static const char finder_pattern[45] = {
     3, 8, 2, 1, 1,
     3, 5, 5, 1, 1,
@@ -204,22 +188,6 @@ static const unsigned short int t_even_exp[5] = {
     4, 20, 52, 104, 204
 };
 
-static const char modules_odd_exp[5] = {
-    12, 10, 8, 6, 4
-};
-
-static const char modules_even_exp[5] = {
-    5, 7, 9, 11, 13
-};
-
-static const char widest_odd_exp[5] = {
-    7, 5, 4, 3, 1
-};
-
-static const char widest_even_exp[5] = {
-    2, 4, 5, 6, 8
-};
-
 static const unsigned short int checksum_weight_exp[184] = {
     /* Table 14 */
     1, 3, 9, 27, 81, 32, 96, 77,
@@ -290,3 +258,175 @@ static const char weight_rows[210] = {
     0, 1, 2, 3, 4, 5, 6, 7, 8, 13, 14, 11, 12, 17, 18, 15, 16, 21, 22, 19, 20
 };
 
+/* Generated by tools/gen_rss_widths_table.php */
+
+/* RSS-14 odd element widths, indexed by `widths_odd_idx[group] + v_odd` */
+static const unsigned short widths_odd_idx[9] = {
+    0, 161, 241, 272, 282, 283, 287, 307, 355
+};
+
+static const unsigned short widths_odd[436] = {
+    0x1128, 0x1137, 0x1146, 0x1155, 0x1164, 0x1173, 0x1182, 0x1218, 0x1227, 0x1236,
+    0x1245, 0x1254, 0x1263, 0x1272, 0x1281, 0x1317, 0x1326, 0x1335, 0x1344, 0x1353,
+    0x1362, 0x1371, 0x1416, 0x1425, 0x1434, 0x1443, 0x1452, 0x1461, 0x1515, 0x1524,
+    0x1533, 0x1542, 0x1551, 0x1614, 0x1623, 0x1632, 0x1641, 0x1713, 0x1722, 0x1731,
+    0x1812, 0x1821, 0x2118, 0x2127, 0x2136, 0x2145, 0x2154, 0x2163, 0x2172, 0x2181,
+    0x2217, 0x2226, 0x2235, 0x2244, 0x2253, 0x2262, 0x2271, 0x2316, 0x2325, 0x2334,
+    0x2343, 0x2352, 0x2361, 0x2415, 0x2424, 0x2433, 0x2442, 0x2451, 0x2514, 0x2523,
+    0x2532, 0x2541, 0x2613, 0x2622, 0x2631, 0x2712, 0x2721, 0x2811, 0x3117, 0x3126,
+    0x3135, 0x3144, 0x3153, 0x3162, 0x3171, 0x3216, 0x3225, 0x3234, 0x3243, 0x3252,
+    0x3261, 0x3315, 0x3324, 0x3333, 0x3342, 0x3351, 0x3414, 0x3423, 0x3432, 0x3441,
+    0x3513, 0x3522, 0x3531, 0x3612, 0x3621, 0x3711, 0x4116, 0x4125, 0x4134, 0x4143,
+    0x4152, 0x4161, 0x4215, 0x4224, 0x4233, 0x4242, 0x4251, 0x4314, 0x4323, 0x4332,
+    0x4341, 0x4413, 0x4422, 0x4431, 0x4512, 0x4521, 0x4611, 0x5115, 0x5124, 0x5133,
+    0x5142, 0x5151, 0x5214, 0x5223, 0x5232, 0x5241, 0x5313, 0x5322, 0x5331, 0x5412,
+    0x5421, 0x5511, 0x6114, 0x6123, 0x6132, 0x6141, 0x6213, 0x6222, 0x6231, 0x6312,
+    0x6321, 0x6411, 0x7113, 0x7122, 0x7131, 0x7212, 0x7221, 0x7311, 0x8112, 0x8121,
+    0x8211, 0x1126, 0x1135, 0x1144, 0x1153, 0x1162, 0x1216, 0x1225, 0x1234, 0x1243,
+    0x1252, 0x1261, 0x1315, 0x1324, 0x1333, 0x1342, 0x1351, 0x1414, 0x1423, 0x1432,
+    0x1441, 0x1513, 0x1522, 0x1531, 0x1612, 0x1621, 0x2116, 0x2125, 0x2134, 0x2143,
+    0x2152, 0x2161, 0x2215, 0x2224, 0x2233, 0x2242, 0x2251, 0x2314, 0x2323, 0x2332,
+    0x2341, 0x2413, 0x2422, 0x2431, 0x2512, 0x2521, 0x2611, 0x3115, 0x3124, 0x3133,
+    0x3142, 0x3151, 0x3214, 0x3223, 0x3232, 0x3241, 0x3313, 0x3322, 0x3331, 0x3412,
+    0x3421, 0x3511, 0x4114, 0x4123, 0x4132, 0x4141, 0x4213, 0x4222, 0x4231, 0x4312,
+    0x4321, 0x4411, 0x5113, 0x5122, 0x5131, 0x5212, 0x5221, 0x5311, 0x6112, 0x6121,
+    0x6211, 0x1124, 0x1133, 0x1142, 0x1214, 0x1223, 0x1232, 0x1241, 0x1313, 0x1322,
+    0x1331, 0x1412, 0x1421, 0x2114, 0x2123, 0x2132, 0x2141, 0x2213, 0x2222, 0x2231,
+    0x2312, 0x2321, 0x2411, 0x3113, 0x3122, 0x3131, 0x3212, 0x3221, 0x3311, 0x4112,
+    0x4121, 0x4211, 0x1113, 0x1122, 0x1131, 0x1212, 0x1221, 0x1311, 0x2112, 0x2121,
+    0x2211, 0x3111, 0x1111, 0x1112, 0x1121, 0x1211, 0x2111, 0x1114, 0x1123, 0x1132,
+    0x1141, 0x1213, 0x1222, 0x1231, 0x1312, 0x1321, 0x1411, 0x2113, 0x2122, 0x2131,
+    0x2212, 0x2221, 0x2311, 0x3112, 0x3121, 0x3211, 0x4111, 0x1116, 0x1125, 0x1134,
+    0x1143, 0x1152, 0x1161, 0x1215, 0x1224, 0x1233, 0x1242, 0x1251, 0x1314, 0x1323,
+    0x1332, 0x1341, 0x1413, 0x1422, 0x1431, 0x1512, 0x1521, 0x1611, 0x2115, 0x2124,
+    0x2133, 0x2142, 0x2151, 0x2214, 0x2241, 0x2313, 0x2331, 0x2412, 0x2421, 0x2511,
+    0x3114, 0x3123, 0x3132, 0x3141, 0x3213, 0x3231, 0x3312, 0x3321, 0x3411, 0x4113,
+    0x4122, 0x4131, 0x4212, 0x4221, 0x4311, 0x1118, 0x1127, 0x1136, 0x1145, 0x1154,
+    0x1163, 0x1172, 0x1181, 0x1217, 0x1226, 0x1235, 0x1244, 0x1253, 0x1262, 0x1271,
+    0x1316, 0x1325, 0x1334, 0x1343, 0x1352, 0x1361, 0x1415, 0x1424, 0x1433, 0x1442,
+    0x1451, 0x1514, 0x1523, 0x1532, 0x1541, 0x1613, 0x1622, 0x1631, 0x1712, 0x1721,
+    0x1811, 0x2117, 0x2126, 0x2135, 0x2144, 0x2153, 0x2162, 0x2171, 0x2216, 0x2261,
+    0x2315, 0x2351, 0x2414, 0x2441, 0x2513, 0x2531, 0x2612, 0x2621, 0x2711, 0x3116,
+    0x3125, 0x3134, 0x3143, 0x3152, 0x3161, 0x3215, 0x3251, 0x3314, 0x3341, 0x3413,
+    0x3431, 0x3512, 0x3521, 0x3611, 0x4115, 0x4124, 0x4133, 0x4142, 0x4151, 0x4214,
+    0x4241, 0x4313, 0x4331, 0x4412, 0x4421, 0x4511,
+};
+
+/* RSS-14 even element widths, indexed by `widths_even_idx[group] + v_even` */
+static const unsigned short widths_even_idx[9] = {
+    0, 1, 11, 45, 115, 241, 325, 360, 370
+};
+
+static const unsigned short widths_even[371] = {
+    0x1111, 0x1113, 0x1122, 0x1131, 0x1212, 0x1221, 0x1311, 0x2112, 0x2121, 0x2211,
+    0x3111, 0x1115, 0x1124, 0x1133, 0x1142, 0x1151, 0x1214, 0x1223, 0x1232, 0x1241,
+    0x1313, 0x1322, 0x1331, 0x1412, 0x1421, 0x1511, 0x2114, 0x2123, 0x2132, 0x2141,
+    0x2213, 0x2231, 0x2312, 0x2321, 0x2411, 0x3113, 0x3122, 0x3131, 0x3212, 0x3221,
+    0x3311, 0x4112, 0x4121, 0x4211, 0x5111, 0x1126, 0x1135, 0x1144, 0x1153, 0x1162,
+    0x1216, 0x1225, 0x1234, 0x1243, 0x1252, 0x1261, 0x1315, 0x1324, 0x1333, 0x1342,
+    0x1351, 0x1414, 0x1423, 0x1432, 0x1441, 0x1513, 0x1522, 0x1531, 0x1612, 0x1621,
+    0x2116, 0x2125, 0x2134, 0x2143, 0x2152, 0x2161, 0x2215, 0x2251, 0x2314, 0x2341,
+    0x2413, 0x2431, 0x2512, 0x2521, 0x2611, 0x3115, 0x3124, 0x3133, 0x3142, 0x3151,
+    0x3214, 0x3241, 0x3313, 0x3331, 0x3412, 0x3421, 0x3511, 0x4114, 0x4123, 0x4132,
+    0x4141, 0x4213, 0x4231, 0x4312, 0x4321, 0x4411, 0x5113, 0x5122, 0x5131, 0x5212,
+    0x5221, 0x5311, 0x6112, 0x6121, 0x6211, 0x1128, 0x1137, 0x1146, 0x1155, 0x1164,
+    0x1173, 0x1182, 0x1218, 0x1227, 0x1236, 0x1245, 0x1254, 0x1263, 0x1272, 0x1281,
+    0x1317, 0x1326, 0x1335, 0x1344, 0x1353, 0x1362, 0x1371, 0x1416, 0x1425, 0x1434,
+    0x1443, 0x1452, 0x1461, 0x1515, 0x1524, 0x1533, 0x1542, 0x1551, 0x1614, 0x1623,
+    0x1632, 0x1641, 0x1713, 0x1722, 0x1731, 0x1812, 0x1821, 0x2118, 0x2127, 0x2136,
+    0x2145, 0x2154, 0x2163, 0x2172, 0x2181, 0x2217, 0x2271, 0x2316, 0x2361, 0x2415,
+    0x2451, 0x2514, 0x2541, 0x2613, 0x2631, 0x2712, 0x2721, 0x2811, 0x3117, 0x3126,
+    0x3135, 0x3144, 0x3153, 0x3162, 0x3171, 0x3216, 0x3261, 0x3315, 0x3351, 0x3414,
+    0x3441, 0x3513, 0x3531, 0x3612, 0x3621, 0x3711, 0x4116, 0x4125, 0x4134, 0x4143,
+    0x4152, 0x4161, 0x4215, 0x4251, 0x4314, 0x4341, 0x4413, 0x4431, 0x4512, 0x4521,
+    0x4611, 0x5115, 0x5124, 0x5133, 0x5142, 0x5151, 0x5214, 0x5241, 0x5313, 0x5331,
+    0x5412, 0x5421, 0x5511, 0x6114, 0x6123, 0x6132, 0x6141, 0x6213, 0x6231, 0x6312,
+    0x6321, 0x6411, 0x7113, 0x7122, 0x7131, 0x7212, 0x7221, 0x7311, 0x8112, 0x8121,
+    0x8211, 0x1117, 0x1126, 0x1135, 0x1144, 0x1153, 0x1162, 0x1171, 0x1216, 0x1225,
+    0x1234, 0x1243, 0x1252, 0x1261, 0x1315, 0x1324, 0x1333, 0x1342, 0x1351, 0x1414,
+    0x1423, 0x1432, 0x1441, 0x1513, 0x1522, 0x1531, 0x1612, 0x1621, 0x1711, 0x2116,
+    0x2125, 0x2134, 0x2143, 0x2152, 0x2161, 0x2215, 0x2224, 0x2233, 0x2242, 0x2251,
+    0x2314, 0x2323, 0x2332, 0x2341, 0x2413, 0x2422, 0x2431, 0x2512, 0x2521, 0x2611,
+    0x3115, 0x3124, 0x3133, 0x3142, 0x3151, 0x3214, 0x3223, 0x3232, 0x3241, 0x3313,
+    0x3322, 0x3331, 0x3412, 0x3421, 0x3511, 0x4114, 0x4123, 0x4132, 0x4141, 0x4213,
+    0x4222, 0x4231, 0x4312, 0x4321, 0x4411, 0x5113, 0x5122, 0x5131, 0x5212, 0x5221,
+    0x5311, 0x6112, 0x6121, 0x6211, 0x7111, 0x1115, 0x1124, 0x1133, 0x1142, 0x1151,
+    0x1214, 0x1223, 0x1232, 0x1241, 0x1313, 0x1322, 0x1331, 0x1412, 0x1421, 0x1511,
+    0x2114, 0x2123, 0x2132, 0x2141, 0x2213, 0x2222, 0x2231, 0x2312, 0x2321, 0x2411,
+    0x3113, 0x3122, 0x3131, 0x3212, 0x3221, 0x3311, 0x4112, 0x4121, 0x4211, 0x5111,
+    0x1113, 0x1122, 0x1131, 0x1212, 0x1221, 0x1311, 0x2112, 0x2121, 0x2211, 0x3111,
+    0x1111,
+};
+
+/* RSS Expanded odd element widths, indexed by `widths_odd_exp_idx[group] + v_odd` */
+static const unsigned short widths_odd_exp_idx[5] = {
+    0, 87, 139, 169, 179
+};
+
+static const unsigned short widths_odd_exp[180] = {
+    0x1137, 0x1146, 0x1155, 0x1164, 0x1173, 0x1227, 0x1236, 0x1245, 0x1254, 0x1263,
+    0x1272, 0x1317, 0x1326, 0x1335, 0x1344, 0x1353, 0x1362, 0x1371, 0x1416, 0x1425,
+    0x1434, 0x1443, 0x1452, 0x1461, 0x1515, 0x1524, 0x1533, 0x1542, 0x1551, 0x1614,
+    0x1623, 0x1632, 0x1641, 0x1713, 0x1722, 0x1731, 0x2127, 0x2136, 0x2145, 0x2154,
+    0x2163, 0x2172, 0x2217, 0x2271, 0x2316, 0x2361, 0x2415, 0x2451, 0x2514, 0x2541,
+    0x2613, 0x2631, 0x2712, 0x2721, 0x3117, 0x3126, 0x3135, 0x3144, 0x3153, 0x3162,
+    0x3171, 0x3216, 0x3261, 0x3315, 0x3351, 0x3414, 0x3441, 0x3513, 0x3531, 0x3612,
+    0x3621, 0x3711, 0x4116, 0x4125, 0x4134, 0x4143, 0x4152, 0x4161, 0x4215, 0x4251,
+    0x4314, 0x4341, 0x4413, 0x4431, 0x4512, 0x4521, 0x4611, 0x1135, 0x1144, 0x1153,
+    0x1225, 0x1234, 0x1243, 0x1252, 0x1315, 0x1324, 0x1333, 0x1342, 0x1351, 0x1414,
+    0x1423, 0x1432, 0x1441, 0x1513, 0x1522, 0x1531, 0x2125, 0x2134, 0x2143, 0x2152,
+    0x2215, 0x2251, 0x2314, 0x2341, 0x2413, 0x2431, 0x2512, 0x2521, 0x3115, 0x3124,
+    0x3133, 0x3142, 0x3151, 0x3214, 0x3241, 0x3313, 0x3331, 0x3412, 0x3421, 0x3511,
+    0x4114, 0x4123, 0x4132, 0x4141, 0x4213, 0x4231, 0x4312, 0x4321, 0x4411, 0x1124,
+    0x1133, 0x1142, 0x1214, 0x1223, 0x1232, 0x1241, 0x1313, 0x1322, 0x1331, 0x1412,
+    0x1421, 0x2114, 0x2123, 0x2132, 0x2141, 0x2213, 0x2231, 0x2312, 0x2321, 0x2411,
+    0x3113, 0x3122, 0x3131, 0x3212, 0x3221, 0x3311, 0x4112, 0x4121, 0x4211, 0x1113,
+    0x1122, 0x1131, 0x1212, 0x1221, 0x1311, 0x2112, 0x2121, 0x2211, 0x3111, 0x1111,
+};
+
+/* RSS Expanded even element widths, indexed by `widths_even_exp_idx[group] + v_even` */
+static const unsigned short widths_even_exp_idx[5] = {
+    0, 4, 24, 76, 180
+};
+
+static const unsigned short widths_even_exp[384] = {
+    0x1112, 0x1121, 0x1211, 0x2111, 0x1114, 0x1123, 0x1132, 0x1141, 0x1213, 0x1222,
+    0x1231, 0x1312, 0x1321, 0x1411, 0x2113, 0x2122, 0x2131, 0x2212, 0x2221, 0x2311,
+    0x3112, 0x3121, 0x3211, 0x4111, 0x1125, 0x1134, 0x1143, 0x1152, 0x1215, 0x1224,
+    0x1233, 0x1242, 0x1251, 0x1314, 0x1323, 0x1332, 0x1341, 0x1413, 0x1422, 0x1431,
+    0x1512, 0x1521, 0x2115, 0x2124, 0x2133, 0x2142, 0x2151, 0x2214, 0x2223, 0x2232,
+    0x2241, 0x2313, 0x2322, 0x2331, 0x2412, 0x2421, 0x2511, 0x3114, 0x3123, 0x3132,
+    0x3141, 0x3213, 0x3222, 0x3231, 0x3312, 0x3321, 0x3411, 0x4113, 0x4122, 0x4131,
+    0x4212, 0x4221, 0x4311, 0x5112, 0x5121, 0x5211, 0x1136, 0x1145, 0x1154, 0x1163,
+    0x1226, 0x1235, 0x1244, 0x1253, 0x1262, 0x1316, 0x1325, 0x1334, 0x1343, 0x1352,
+    0x1361, 0x1415, 0x1424, 0x1433, 0x1442, 0x1451, 0x1514, 0x1523, 0x1532, 0x1541,
+    0x1613, 0x1622, 0x1631, 0x2126, 0x2135, 0x2144, 0x2153, 0x2162, 0x2216, 0x2225,
+    0x2234, 0x2243, 0x2252, 0x2261, 0x2315, 0x2324, 0x2333, 0x2342, 0x2351, 0x2414,
+    0x2423, 0x2432, 0x2441, 0x2513, 0x2522, 0x2531, 0x2612, 0x2621, 0x3116, 0x3125,
+    0x3134, 0x3143, 0x3152, 0x3161, 0x3215, 0x3224, 0x3233, 0x3242, 0x3251, 0x3314,
+    0x3323, 0x3332, 0x3341, 0x3413, 0x3422, 0x3431, 0x3512, 0x3521, 0x3611, 0x4115,
+    0x4124, 0x4133, 0x4142, 0x4151, 0x4214, 0x4223, 0x4232, 0x4241, 0x4313, 0x4322,
+    0x4331, 0x4412, 0x4421, 0x4511, 0x5114, 0x5123, 0x5132, 0x5141, 0x5213, 0x5222,
+    0x5231, 0x5312, 0x5321, 0x5411, 0x6113, 0x6122, 0x6131, 0x6212, 0x6221, 0x6311,
+    0x1138, 0x1147, 0x1156, 0x1165, 0x1174, 0x1183, 0x1228, 0x1237, 0x1246, 0x1255,
+    0x1264, 0x1273, 0x1282, 0x1318, 0x1327, 0x1336, 0x1345, 0x1354, 0x1363, 0x1372,
+    0x1381, 0x1417, 0x1426, 0x1435, 0x1444, 0x1453, 0x1462, 0x1471, 0x1516, 0x1525,
+    0x1534, 0x1543, 0x1552, 0x1561, 0x1615, 0x1624, 0x1633, 0x1642, 0x1651, 0x1714,
+    0x1723, 0x1732, 0x1741, 0x1813, 0x1822, 0x1831, 0x2128, 0x2137, 0x2146, 0x2155,
+    0x2164, 0x2173, 0x2182, 0x2218, 0x2227, 0x2236, 0x2245, 0x2254, 0x2263, 0x2272,
+    0x2281, 0x2317, 0x2326, 0x2335, 0x2344, 0x2353, 0x2362, 0x2371, 0x2416, 0x2425,
+    0x2434, 0x2443, 0x2452, 0x2461, 0x2515, 0x2524, 0x2533, 0x2542, 0x2551, 0x2614,
+    0x2623, 0x2632, 0x2641, 0x2713, 0x2722, 0x2731, 0x2812, 0x2821, 0x3118, 0x3127,
+    0x3136, 0x3145, 0x3154, 0x3163, 0x3172, 0x3181, 0x3217, 0x3226, 0x3235, 0x3244,
+    0x3253, 0x3262, 0x3271, 0x3316, 0x3325, 0x3334, 0x3343, 0x3352, 0x3361, 0x3415,
+    0x3424, 0x3433, 0x3442, 0x3451, 0x3514, 0x3523, 0x3532, 0x3541, 0x3613, 0x3622,
+    0x3631, 0x3712, 0x3721, 0x3811, 0x4117, 0x4126, 0x4135, 0x4144, 0x4153, 0x4162,
+    0x4171, 0x4216, 0x4225, 0x4234, 0x4243, 0x4252, 0x4261, 0x4315, 0x4324, 0x4333,
+    0x4342, 0x4351, 0x4414, 0x4423, 0x4432, 0x4441, 0x4513, 0x4522, 0x4531, 0x4612,
+    0x4621, 0x4711, 0x5116, 0x5125, 0x5134, 0x5143, 0x5152, 0x5161, 0x5215, 0x5224,
+    0x5233, 0x5242, 0x5251, 0x5314, 0x5323, 0x5332, 0x5341, 0x5413, 0x5422, 0x5431,
+    0x5512, 0x5521, 0x5611, 0x6115, 0x6124, 0x6133, 0x6142, 0x6151, 0x6214, 0x6223,
+    0x6232, 0x6241, 0x6313, 0x6322, 0x6331, 0x6412, 0x6421, 0x6511, 0x7114, 0x7123,
+    0x7132, 0x7141, 0x7213, 0x7222, 0x7231, 0x7312, 0x7321, 0x7411, 0x8113, 0x8122,
+    0x8131, 0x8212, 0x8221, 0x8311,
+};
@@ -0,0 +1,187 @@
+/* scratch.c - per-symbol arena for working buffers sized by input or symbol */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Working buffers whose size depends on the input length or symbol size are taken from an arena attached to the
+ * symbol rather than from the stack (C99 VLAs or `_alloca()`), so that a large input can't overflow a (thread) stack
+ * and the most memory used by an encode can be measured. The arena is a list of chunks which allocations are bumped
+ * off, released in LIFO order by `scratch_release()` and kept between calls for reuse */
+
+#include "common.h"
+#include "scratch.h"
+
+/* Allocations (and chunk headers) are rounded up to this to keep any type aligned */
+#define SCRATCH_ALIGN   16
+#define SCRATCH_ROUND(s) (((s) + (SCRATCH_ALIGN - 1)) & ~((size_t) (SCRATCH_ALIGN - 1)))
+
+struct scratch_chunk {
+    struct scratch_chunk *prev; /* Chunk allocated before this one */
+    size_t size; /* Bytes available in chunk */
+    size_t used; /* Bytes allocated from chunk */
+    size_t offset; /* Bytes in use in previous chunks when this one was started */
+};
+
+#define SCRATCH_HEADER  SCRATCH_ROUND(sizeof(struct scratch_chunk))
+
+struct zint_scratch {
+    struct scratch_chunk *chunk; /* Chunk currently being allocated from */
+    struct scratch_chunk *spare; /* Largest released chunk, kept for reuse */
+    size_t in_use; /* Bytes currently allocated (including any unused tails of previous chunks) */
+    size_t peak; /* Most bytes allocated at once since last `scratch_reset()` with `new_peak` set */
+};
+
+/* Return a chunk able to hold `size` bytes, re-using the spare one if big enough */
+static struct scratch_chunk *scratch_chunk_new(struct zint_symbol *symbol, const size_t size) {
+    struct zint_scratch *scratch = symbol->scratch;
+    struct scratch_chunk *chunk;
+    size_t chunk_size = scratch->chunk ? scratch->chunk->size * 2 : SCRATCH_CHUNK_SIZE;
+
+    if (chunk_size < size) {
+        chunk_size = size;
+    }
+    if (scratch->spare && scratch->spare->size >= size) {
+        chunk = scratch->spare;
+        scratch->spare = NULL;
+    } else {
+        if (!(chunk = (struct scratch_chunk *) z_malloc(symbol, SCRATCH_HEADER + chunk_size))) {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+    }
+    chunk->prev = scratch->chunk;
+    chunk->used = 0;
+    chunk->offset = scratch->in_use;
+
+    return chunk;
+}
+
+/* Allocate `size` bytes of uninitialized memory from `symbol`'s arena, valid until the next `scratch_release()` to a
+ * mark taken before it or the next API call on `symbol`. Returns NULL if out of memory */
+INTERNAL void *scratch_alloc(struct zint_symbol *symbol, const size_t size) {
+    struct zint_scratch *scratch = symbol->scratch;
+    struct scratch_chunk *chunk;
+    const size_t rounded = SCRATCH_ROUND(size ? size : 1);
+    void *ret;
+
+    if (rounded < size) { /* Overflow */
+        return NULL;
+    }
+    if (!scratch) {
+        if (!(scratch = (struct zint_scratch *) z_calloc(symbol, sizeof(struct zint_scratch)))) {
+            return NULL;
+        }
+        symbol->scratch = scratch;
+    }
+    chunk = scratch->chunk;
+    if (!chunk || chunk->size - chunk->used < rounded) {
+        if (!(chunk = scratch_chunk_new(symbol, rounded))) {
+            return NULL;
+        }
+        scratch->chunk = chunk;
+    }
+    ret = (unsigned char *) chunk + SCRATCH_HEADER + chunk->used;
+    chunk->used += rounded;
+    scratch->in_use = chunk->offset + chunk->used;
+    if (scratch->in_use > scratch->peak) {
+        scratch->peak = scratch->in_use;
+    }
+
+    return ret;
+}
+
+/* Return a mark that `scratch_release()` can free back to */
+INTERNAL size_t scratch_mark(const struct zint_symbol *symbol) {
+    return symbol->scratch ? symbol->scratch->in_use : 0;
+}
+
+/* Free all allocations made since `mark` was taken */
+INTERNAL void scratch_release(struct zint_symbol *symbol, const size_t mark) {
+    struct zint_scratch *scratch = symbol->scratch;
+    struct scratch_chunk *chunk;
+
+    if (!scratch) {
+        return;
+    }
+    while ((chunk = scratch->chunk) && chunk->offset >= mark && chunk->prev) {
+        scratch->chunk = chunk->prev;
+        if (scratch->spare && scratch->spare->size >= chunk->size) {
+            z_free(symbol, chunk);
+        } else {
+            z_free(symbol, scratch->spare);
+            scratch->spare = chunk;
+        }
+    }
+    if (chunk) {
+        if (chunk->offset >= mark) { /* First chunk - swap for spare if larger so arena settles on one chunk */
+            if (scratch->spare && scratch->spare->size > chunk->size) {
+                scratch->spare->prev = NULL;
+                scratch->spare->offset = 0;
+                scratch->chunk = scratch->spare;
+                scratch->spare = chunk;
+            }
+            scratch->chunk->used = 0;
+        } else {
+            chunk->used = mark - chunk->offset;
+        }
+    }
+    scratch->in_use = mark < scratch->in_use ? mark : scratch->in_use;
+}
+
+/* Free all allocations, also resetting peak usage if `new_peak` set. Called on entry to API functions */
+INTERNAL void scratch_reset(struct zint_symbol *symbol, const int new_peak) {
+    scratch_release(symbol, 0);
+    if (new_peak && symbol->scratch) {
+        symbol->scratch->peak = 0;
+    }
+}
+
+/* Return the most bytes allocated at once since peak was last reset */
+INTERNAL size_t scratch_peak(const struct zint_symbol *symbol) {
+    return symbol->scratch ? symbol->scratch->peak : 0;
+}
+
+/* Free the arena and all its chunks */
+INTERNAL void scratch_free(struct zint_symbol *symbol) {
+    struct zint_scratch *scratch = symbol->scratch;
+    struct scratch_chunk *chunk;
+
+    if (!scratch) {
+        return;
+    }
+    while ((chunk = scratch->chunk)) {
+        scratch->chunk = chunk->prev;
+        z_free(symbol, chunk);
+    }
+    z_free(symbol, scratch->spare);
+    z_free(symbol, scratch);
+    symbol->scratch = NULL;
+}
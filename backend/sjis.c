@@ -52,10 +52,8 @@
  * License along with the GNU LIBICONV Library; see the file COPYING.LIB.
  * If not, see <https://www.gnu.org/licenses/>.
  */
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "scratch.h"
 #include "sjis.h"
 
 /* Convert Unicode to other encodings */
@@ -1520,11 +1518,13 @@ INTERNAL int sjis_utf8tomb(struct zint_symbol *symbol, const unsigned char sourc
             unsigned int *jisdata) {
     int error_number;
     unsigned int i, length;
-#ifndef _MSC_VER
-    unsigned int utfdata[*p_length + 1];
-#else
-    unsigned int *utfdata = (unsigned int *) _alloca((*p_length + 1) * sizeof(unsigned int));
-#endif
+    const size_t mark = scratch_mark(symbol);
+    unsigned int *utfdata = (unsigned int *) scratch_alloc(symbol, sizeof(unsigned int) * (*p_length + 1));
+
+    if (!utfdata) {
+        strcpy(symbol->errtxt, "801: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     error_number = utf8_to_unicode(symbol, source, utfdata, p_length, 1 /*disallow_4byte*/);
     if (error_number != 0) {
@@ -1538,18 +1538,22 @@ INTERNAL int sjis_utf8tomb(struct zint_symbol *symbol, const unsigned char sourc
         }
     }
 
+    scratch_release(symbol, mark);
+
     return 0;
 }
 
 /* Convert UTF-8 string to single byte ECI and place in array of ints */
-INTERNAL int sjis_utf8tosb(int eci, const unsigned char source[], int *p_length, unsigned int *jisdata,
-            int full_multibyte) {
+INTERNAL int sjis_utf8tosb(struct zint_symbol *symbol, int eci, const unsigned char source[], int *p_length,
+            unsigned int *jisdata, int full_multibyte) {
     int error_number;
-#ifndef _MSC_VER
-    unsigned char single_byte[*p_length + 1];
-#else
-    unsigned char *single_byte = (unsigned char *) _alloca(*p_length + 1);
-#endif
+    const size_t mark = scratch_mark(symbol);
+    unsigned char *single_byte = (unsigned char *) scratch_alloc(symbol, *p_length + 1);
+
+    if (!single_byte) {
+        strcpy(symbol->errtxt, "802: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     error_number = utf_to_eci(eci, source, single_byte, p_length);
     if (error_number != 0) {
@@ -1558,6 +1562,7 @@ INTERNAL int sjis_utf8tosb(int eci, const unsigned char source[], int *p_length,
     }
 
     sjis_cpy(single_byte, p_length, jisdata, full_multibyte);
+    scratch_release(symbol, mark);
 
     return 0;
 }
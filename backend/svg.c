@@ -31,15 +31,14 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-#include <locale.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 
 #include "common.h"
+#include "scratch.h"
+#include "filemem.h"
+#include "output.h"
 
 static void pick_colour(int colour, char colour_code[]) {
     switch(colour) {
@@ -115,9 +114,10 @@ static void make_html_friendly(unsigned char * string, char * html_version) {
 }
 
 INTERNAL int svg_plot(struct zint_symbol *symbol) {
-    FILE *fsvg;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int error_number = 0;
-    const char *locale = NULL;
+    struct output_locale locale;
     float ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy;
     float previous_diameter;
     float radius, half_radius, half_sqrt3_radius;
@@ -138,9 +138,7 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
     char colour_code[7];
     int html_len;
 
-#ifdef _MSC_VER
-    char* html_string;
-#endif
+    char *html_string;
 
     for (i = 0; i < 6; i++) {
         fgcolour_string[i] = symbol->fgcolour[i];
@@ -176,58 +174,53 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
         }
     }
 
-#ifndef _MSC_VER
-    char html_string[html_len];
-#else
-    html_string = (char*) _alloca(html_len);
-#endif
+    html_string = (char *) scratch_alloc(symbol, html_len);
+    if (!html_string) {
+        strcpy(symbol->errtxt, "682: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* Check for no created vector set */
     /* E-Mail Christian Schmitz 2019-09-10: reason unknown  Ticket #164*/
     if (symbol->vector == NULL) {
         return ZINT_ERROR_INVALID_DATA;
     }
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fsvg = stdout;
-    } else {
-        fsvg = fopen(symbol->outfile, "w");
-    }
-    if (fsvg == NULL) {
+    if (!fm_open(fmp, symbol, "w")) {
         strcpy(symbol->errtxt, "680: Could not open output file");
         return ZINT_ERROR_FILE_ACCESS;
     }
 
-    locale = setlocale(LC_ALL, "C");
+    output_c_locale(&locale);
 
     /* Start writing the header */
-    fprintf(fsvg, "<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    fprintf(fsvg, "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"\n");
-    fprintf(fsvg, "   \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
-    fprintf(fsvg, "<svg width=\"%d\" height=\"%d\" version=\"1.1\"\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
-    fprintf(fsvg, "   xmlns=\"http://www.w3.org/2000/svg\">\n");
-    fprintf(fsvg, "   <desc>Zint Generated Symbol\n");
-    fprintf(fsvg, "   </desc>\n");
-    fprintf(fsvg, "\n   <g id=\"barcode\" fill=\"#%s\">\n", fgcolour_string);
+    fm_printf(fmp, "<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    fm_printf(fmp, "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"\n");
+    fm_printf(fmp, "   \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
+    fm_printf(fmp, "<svg width=\"%d\" height=\"%d\" version=\"1.1\"\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
+    fm_printf(fmp, "   xmlns=\"http://www.w3.org/2000/svg\">\n");
+    fm_printf(fmp, "   <desc>Zint Generated Symbol\n");
+    fm_printf(fmp, "   </desc>\n");
+    fm_printf(fmp, "\n   <g id=\"barcode\" fill=\"#%s\">\n", fgcolour_string);
 
     if (bg_alpha != 0) {
-        fprintf(fsvg, "      <rect x=\"0\" y=\"0\" width=\"%d\" height=\"%d\" fill=\"#%s\"", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height), bgcolour_string);
+        fm_printf(fmp, "      <rect x=\"0\" y=\"0\" width=\"%d\" height=\"%d\" fill=\"#%s\"", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height), bgcolour_string);
         if (bg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", bg_alpha_opacity);
+            fm_printf(fmp, " opacity=\"%.3f\"", bg_alpha_opacity);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
     }
 
     rect = symbol->vector->rectangles;
     while (rect) {
-        fprintf(fsvg, "      <rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\"", rect->x, rect->y, rect->width, rect->height);
+        fm_printf(fmp, "      <rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\"", rect->x, rect->y, rect->width, rect->height);
         if (rect->colour != -1) {
             pick_colour(rect->colour, colour_code);
-            fprintf(fsvg, " fill=\"#%s\"", colour_code);
+            fm_printf(fmp, " fill=\"#%s\"", colour_code);
         }
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_printf(fmp, " opacity=\"%.3f\"", fg_alpha_opacity);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         rect = rect->next;
     }
 
@@ -267,11 +260,11 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
             ex = hex->x + half_radius;
             fx = hex->x - half_radius;
         }
-        fprintf(fsvg, "      <path d=\"M %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f Z\"", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
+        fm_printf(fmp, "      <path d=\"M %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f Z\"", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_printf(fmp, " opacity=\"%.3f\"", fg_alpha_opacity);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         hex = hex->next;
     }
 
@@ -282,20 +275,20 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
             previous_diameter = circle->diameter;
             radius = (float) (0.5 * previous_diameter);
         }
-        fprintf(fsvg, "      <circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\"", circle->x, circle->y, radius);
+        fm_printf(fmp, "      <circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\"", circle->x, circle->y, radius);
         
         if (circle->colour) {
-            fprintf(fsvg, " fill=\"#%s\"", bgcolour_string);
+            fm_printf(fmp, " fill=\"#%s\"", bgcolour_string);
             if (bg_alpha != 0xff) {
                 // This doesn't work how the user is likely to expect - more work needed!
-                fprintf(fsvg, " opacity=\"%.3f\"", bg_alpha_opacity);
+                fm_printf(fmp, " opacity=\"%.3f\"", bg_alpha_opacity);
             }
         } else {
             if (fg_alpha != 0xff) {
-                fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+                fm_printf(fmp, " opacity=\"%.3f\"", fg_alpha_opacity);
             }
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         circle = circle->next;
     }
 
@@ -303,35 +296,33 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
     string = symbol->vector->strings;
     while (string) {
         const char *halign = string->halign == 2 ? "end" : string->halign == 1 ? "start" : "middle";
-        fprintf(fsvg, "      <text x=\"%.2f\" y=\"%.2f\" text-anchor=\"%s\"\n", string->x, string->y, halign);
-        fprintf(fsvg, "         font-family=\"%s\" font-size=\"%.1f\"", font_family, string->fsize);
+        fm_printf(fmp, "      <text x=\"%.2f\" y=\"%.2f\" text-anchor=\"%s\"\n", string->x, string->y, halign);
+        fm_printf(fmp, "         font-family=\"%s\" font-size=\"%.1f\"", font_family, string->fsize);
         if (bold) {
-            fprintf(fsvg, " font-weight=\"bold\"");
+            fm_printf(fmp, " font-weight=\"bold\"");
         }
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_printf(fmp, " opacity=\"%.3f\"", fg_alpha_opacity);
         }
         if (string->rotation != 0) {
-            fprintf(fsvg, " transform=\"rotate(%d,%.2f,%.2f)\"", string->rotation, string->x, string->y);
+            fm_printf(fmp, " transform=\"rotate(%d,%.2f,%.2f)\"", string->rotation, string->x, string->y);
         }
-        fprintf(fsvg, " >\n");
+        fm_printf(fmp, " >\n");
         make_html_friendly(string->text, html_string);
-        fprintf(fsvg, "         %s\n", html_string);
-        fprintf(fsvg, "      </text>\n");
+        fm_printf(fmp, "         %s\n", html_string);
+        fm_printf(fmp, "      </text>\n");
         string = string->next;
     }
 
-    fprintf(fsvg, "   </g>\n");
-    fprintf(fsvg, "</svg>\n");
+    fm_printf(fmp, "   </g>\n");
+    fm_printf(fmp, "</svg>\n");
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(fsvg);
-    } else {
-        fclose(fsvg);
-    }
+    output_restore_locale(&locale);
 
-    if (locale)
-        setlocale(LC_ALL, locale);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "681: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
 
     return error_number;
 }
@@ -38,7 +38,7 @@
 #include <stdio.h>
 #include "common.h"
 
-static char *TeleTable[] = {
+static const char *const TeleTable[] = {
     "31313131", "1131313111", "33313111", "1111313131", "3111313111", "11333131", "13133131", "111111313111",
     "31333111", "1131113131", "33113131", "1111333111", "3111113131", "1113133111", "1311133111", "111111113131",
     "3131113111", "11313331", "333331", "111131113111", "31113331", "1133113111", "1313113111", "1111113331",
@@ -57,10 +57,23 @@ static char *TeleTable[] = {
     "3113111113", "11311111111111", "331111111111", "111113111113", "31111111111111", "111311111113", "131111111113", "1111111111111111",
 };
 
+/* Lengths of `TeleTable` entries */
+static const char TeleLens[128] = {
+    8, 10, 8, 10, 10, 8, 8, 12, 8, 10, 8, 10, 10, 10, 10, 12,
+    10, 8, 6, 12, 8, 10, 10, 10, 8, 12, 10, 10, 12, 10, 10, 14,
+    8, 10, 8, 10, 10, 8, 8, 12, 8, 10, 8, 10, 10, 10, 10, 12,
+    10, 10, 8, 12, 10, 10, 10, 12, 10, 12, 10, 12, 12, 12, 12, 14,
+    10, 8, 6, 12, 8, 10, 10, 10, 6, 12, 10, 8, 12, 8, 8, 14,
+    8, 10, 8, 10, 10, 8, 8, 12, 10, 10, 8, 12, 10, 12, 12, 12,
+    8, 12, 10, 10, 12, 8, 8, 14, 10, 10, 8, 12, 10, 12, 12, 12,
+    12, 10, 8, 14, 10, 12, 12, 12, 10, 14, 12, 12, 14, 12, 12, 16,
+};
+
 INTERNAL int telepen(struct zint_symbol *symbol, unsigned char source[], const size_t src_len) {
     unsigned int i, count, check_digit;
     int error_number;
     char dest[521]; /* 12 (start) + 30 * 16 (max for DELs) + 16 (check digit) + 12 (stop) + 1 = 521 */
+    char *d = dest;
 
     error_number = 0;
 
@@ -71,7 +84,8 @@ INTERNAL int telepen(struct zint_symbol *symbol, unsigned char source[], const s
         return ZINT_ERROR_TOO_LONG;
     }
     /* Start character */
-    strcpy(dest, TeleTable['_']);
+    memcpy(d, TeleTable['_'], TeleLens['_']);
+    d += TeleLens['_'];
 
     for (i = 0; i < src_len; i++) {
         if (source[i] > 127) {
@@ -79,7 +93,8 @@ INTERNAL int telepen(struct zint_symbol *symbol, unsigned char source[], const s
             strcpy(symbol->errtxt, "391: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
-        strcat(dest, TeleTable[source[i]]);
+        memcpy(d, TeleTable[source[i]], TeleLens[source[i]]);
+        d += TeleLens[source[i]];
         count += source[i];
     }
 
@@ -87,12 +102,14 @@ INTERNAL int telepen(struct zint_symbol *symbol, unsigned char source[], const s
     if (check_digit == 127) {
         check_digit = 0;
     }
-    strcat(dest, TeleTable[check_digit]);
+    memcpy(d, TeleTable[check_digit], TeleLens[check_digit]);
+    d += TeleLens[check_digit];
 
     /* Stop character */
-    strcat(dest, TeleTable['z']);
+    memcpy(d, TeleTable['z'], TeleLens['z']);
+    d += TeleLens['z'];
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     for (i = 0; i < src_len; i++) {
         if (source[i] == '\0') {
             symbol->text[i] = ' ';
@@ -109,6 +126,7 @@ INTERNAL int telepen_num(struct zint_symbol *symbol, unsigned char source[], con
     int error_number;
     size_t i, temp_length = src_len;
     char dest[521]; /* 12 (start) + 30 * 16 (max for DELs) + 16 (check digit) + 12 (stop) + 1 = 521 */
+    char *d = dest;
     unsigned char temp[64];
 
     count = 0;
@@ -134,7 +152,8 @@ INTERNAL int telepen_num(struct zint_symbol *symbol, unsigned char source[], con
     }
 
     /* Start character */
-    strcpy(dest, TeleTable['_']);
+    memcpy(d, TeleTable['_'], TeleLens['_']);
+    d += TeleLens['_'];
 
     for (i = 0; i < temp_length; i += 2) {
         if (temp[i] == 'X') {
@@ -150,19 +169,22 @@ INTERNAL int telepen_num(struct zint_symbol *symbol, unsigned char source[], con
             glyph += 27;
             count += glyph;
         }
-        strcat(dest, TeleTable[glyph]);
+        memcpy(d, TeleTable[glyph], TeleLens[glyph]);
+        d += TeleLens[glyph];
     }
 
     check_digit = 127 - (count % 127);
     if (check_digit == 127) {
         check_digit = 0;
     }
-    strcat(dest, TeleTable[check_digit]);
+    memcpy(d, TeleTable[check_digit], TeleLens[check_digit]);
+    d += TeleLens[check_digit];
 
     /* Stop character */
-    strcat(dest, TeleTable['z']);
+    memcpy(d, TeleTable['z'], TeleLens['z']);
+    d += TeleLens['z'];
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
     ustrcpy(symbol->text, temp);
     return error_number;
 }
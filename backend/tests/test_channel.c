@@ -397,7 +397,97 @@ static void test_encode(int index, int generate, int debug) {
     testFinish();
 }
 
-// Dummy to generate pre-calculated tables for channels 7/8
+// Check that the characters of each channel are valid and in increasing lexicographic order of their widths, as
+// enumerated by CHNCHR (ANSI/AIM BC12-1998 Annex D), for all values of channels 3 to 6 and a sample of 7 and 8
+static void test_range(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int channels;
+        long max_value;
+        long step;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { 3, 26, 1 },
+        /* 1*/ { 4, 292, 1 },
+        /* 2*/ { 5, 3493, 1 },
+        /* 3*/ { 6, 44072, 1 },
+        /* 4*/ { 7, 576688, 97 },
+        /* 5*/ { 8, 7742862, 1013 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char data_buf[8];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        int num_elements = 2 * data[i].channels;
+        int prev_widths[16] = {0};
+        long value = 0;
+
+        while (value <= data[i].max_value) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            sprintf(data_buf, "%ld", value);
+            int length = testUtilSetSymbol(symbol, BARCODE_CHANNEL, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].channels, -1, -1 /*output_options*/, data_buf, -1, debug);
+
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+            assert_zero(ret, "i:%d value %ld ZBarcode_Encode ret %d != 0 (%s)\n", i, value, ret, symbol->errtxt);
+            assert_equal(symbol->width, 4 * data[i].channels + 7, "i:%d value %ld width %d != %d\n", i, value, symbol->width, 4 * data[i].channels + 7);
+
+            // Widths of the spaces and bars following the 9-module finder
+            int widths[16];
+            int num_widths = 0;
+            for (int x = 9; x < symbol->width; num_widths++) {
+                int dark = module_is_set(symbol, 0, x);
+                assert_equal(dark, num_widths & 1, "i:%d value %ld element %d dark %d\n", i, value, num_widths, dark);
+                assert_nonzero(num_widths < num_elements, "i:%d value %ld too many elements\n", i, value);
+                for (widths[num_widths] = 0; x < symbol->width && module_is_set(symbol, 0, x) == dark; x++) {
+                    widths[num_widths]++;
+                }
+            }
+            assert_equal(num_widths, num_elements, "i:%d value %ld elements %d != %d\n", i, value, num_widths, num_elements);
+
+            // No narrow bar ends a run of 5 narrow elements, counting the implied narrow elements of channels < 8
+            int p = 2 * (8 - data[i].channels);
+            int run = p < 4 ? p : 4;
+            for (int j = 0; j < num_elements; j++, p++) {
+                if ((p & 1) && widths[j] == 1) {
+                    int max_run = p == 1 ? 1 : p == 3 ? 3 : 4;
+                    assert_nonzero(run < max_run, "i:%d value %ld narrow bar %d ends run of narrow elements\n", i, value, j);
+                }
+                run = widths[j] == 1 ? (run < 4 ? run + 1 : 4) : 0;
+            }
+
+            if (value) {
+                int j = 0;
+                while (j < num_elements && prev_widths[j] == widths[j]) {
+                    j++;
+                }
+                assert_nonzero(j < num_elements && prev_widths[j] < widths[j], "i:%d value %ld not greater than previous\n", i, value);
+            }
+            memcpy(prev_widths, widths, sizeof(widths));
+
+            ZBarcode_Delete(symbol);
+
+            if (value < data[i].max_value && value + data[i].step > data[i].max_value) {
+                value = data[i].max_value;
+            } else {
+                value += data[i].step;
+            }
+        }
+    }
+
+    testFinish();
+}
+
+// Dummy to generate pre-calculated table of numbers of characters
 static void test_generate(int generate) {
 
     if (!generate) {
@@ -408,7 +498,7 @@ static void test_generate(int generate) {
     struct item {
         char *data;
     };
-    struct item data[] = { { "576688" }, { "7742862" } };
+    struct item data[] = { { "7742862" } };
     int data_size = ARRAY_SIZE(data);
 
     for (int i = 0; i < data_size; i++) {
@@ -429,6 +519,7 @@ int main(int argc, char *argv[]) {
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_input", test_input, 1, 0, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
+        { "test_range", test_range, 1, 0, 1 },
         { "test_generate", test_generate, 0, 1, 0 },
     };
 
@@ -326,6 +326,7 @@ static void test_input(int index, int generate, int debug) {
         /* 31*/ { UNICODE_MODE, "aééééébcdeéé", -1, 0, 233, "(21) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 100 73 100 73 19 106", "StartB a Latch é (5) Unlatch b c d e FNC4 é (2)" },
         /* 32*/ { UNICODE_MODE, "aééééébcdeééé", -1, 0, 244, "(22) 104 65 100 100 73 73 73 73 73 100 66 100 67 100 68 100 69 73 73 73 83 106", "StartB a Latch é (5) Shift b Shift c Shift d Shift e é (3)" },
         /* 33*/ { UNICODE_MODE, "aééééébcdefééé", -1, 0, 255, "(23) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 70 100 100 73 73 73 67 106", "StartB a Latch é (5) Unlatch b c d e f Latch é (3)" },
+        /* 34*/ { DATA_MODE, "QNWHQC00405 8\265\355\312\252\213277191", -1, 0, 310, "(28) 104 49 46 55 40 49 35 16 99 4 5 100 0 24 100 100 21 77 42 10 98 75 99 27 71 91 73 106", "StartB Q N W H Q C 0 CodeC 04 05 CodeB space 8 Latch µ í Ê ª Shift ‹ CodeC 27 71 91 (no extended latch in C)" },
     };
     int data_size = sizeof(data) / sizeof(struct item);
 
@@ -432,6 +433,99 @@ static void test_ean128_input(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_optimal(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int output_options;
+        char *data;
+        int length;
+        int ret;
+        int expected_width;
+        char *expected;
+        char *comment;
+    };
+    // NUL U+0000, CodeA-only
+    // US U+001F (\037, 31), CodeA-only
+    // a U+0061 (\141, 97), CodeB-only
+    // ß U+00DF (\337, 223), UTF-8 C39F, CodeA and CodeB extended ASCII
+    // é U+00E9 (\351, 233), UTF-8 C3A9, CodeB-only extended ASCII
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, UNICODE_MODE, -1, "AIM1234", -1, 0, 101, "(9) 104 33 41 45 99 12 34 87 106", "Same as default" },
+        /*  1*/ { BARCODE_CODE128, UNICODE_MODE, -1, "12345", -1, 0, 79, "(7) 105 12 34 100 21 54 106", "Same as default" },
+        /*  2*/ { BARCODE_CODE128, UNICODE_MODE, -1, "a\037Aa\037\037a\037aa\037a", -1, 0, 222, "(20) 104 65 98 95 33 65 98 95 98 95 65 98 95 65 65 98 95 65 48 106", "StartB a Shift US A a Shift US Shift US a Shift US a a Shift US a (same width as default)" },
+        /*  3*/ { BARCODE_CODE128, DATA_MODE, -1, "\351\341\001\102\062\001\133", -1, 0, 145, "(13) 104 100 73 100 65 101 65 34 18 65 59 66 106", "StartB FNC4 é FNC4 á CodeA SOH B 2 SOH [ (default 1 longer)" },
+        /*  4*/ { BARCODE_CODE128, UNICODE_MODE, -1, "A1234B1234C", -1, 0, 156, "(14) 104 33 17 18 19 20 34 17 18 19 20 35 79 106", "StartB A 1 2 3 4 B 1 2 3 4 C (CodeC same width)" },
+        /*  5*/ { BARCODE_CODE128, UNICODE_MODE, -1, "aééééébcdeééé", -1, 0, 244, "(22) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 100 100 73 73 73 40 106", "StartB a Latch é (5) Unlatch b c d e Latch é (3) (same width as default)" },
+        /*  6*/ { BARCODE_CODE128, UNICODE_MODE, -1, "ééé", -1, 0, 90, "(8) 104 100 100 73 73 73 44 106", "StartB LatchFNC4 é é é" },
+        /*  7*/ { BARCODE_CODE128, UNICODE_MODE, -1, "é12345678é", -1, 0, 145, "(13) 104 100 73 99 12 34 56 78 100 100 73 57 106", "StartB FNC4 é CodeC 12 34 56 78 CodeB FNC4 é" },
+        /*  8*/ { BARCODE_CODE128, UNICODE_MODE, -1, "\000\037éa", 5, 0, 101, "(9) 103 64 95 100 100 73 65 61 106", "StartA NUL US LatchB FNC4 é a" },
+        /*  9*/ { BARCODE_CODE128, UNICODE_MODE, READER_INIT, "12", -1, 0, 68, "(6) 104 96 17 18 82 106", "StartB FNC3 1 2 (CodeC same width)" },
+        /* 10*/ { BARCODE_CODE128, UNICODE_MODE, READER_INIT, "A", -1, 0, 57, "(5) 104 96 33 60 106", "StartB FNC3 A" },
+        /* 11*/ { BARCODE_CODE128B, UNICODE_MODE, -1, "1234", -1, 0, 79, "(7) 104 17 18 19 20 88 106", "StartB 1 2 3 4 (CodeC not allowed)" },
+        /* 12*/ { BARCODE_CODE128, UNICODE_MODE, -1, "123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890", -1, 0, 695, "(63) 105 12 34 56 78 90 12 34 56 78 90 12 34 56 78 90 12 34 56 78 90 12 34 56 78 90 12 34", "StartC 12 (60)" },
+        /* 13*/ { BARCODE_CODE128, UNICODE_MODE, -1, "1234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901", -1, ZINT_ERROR_TOO_LONG, 0, "Error 341: Input too long", "StartC 12 (60) CodeB 1 > 60" },
+        /* 14*/ { BARCODE_GS1_128, GS1_MODE, -1, "[90]620B171644[91]9c82", -1, 0, 222, "(20) 105 102 90 62 100 16 34 99 17 16 44 102 91 100 25 67 24 18 92 106", "StartC FNC1 90 62 CodeB 0 B CodeC 17 16 44 FNC1 91 CodeB 9 c 8 2 (default 2 longer)" },
+        /* 15*/ { BARCODE_GS1_128, GS1_MODE, -1, "[90]2[91]2!", -1, 0, 134, "(12) 104 102 25 16 18 102 25 17 18 1 72 106", "StartB FNC1 9 0 2 FNC1 9 1 2 ! (default 1 longer)" },
+        /* 16*/ { BARCODE_GS1_128, GS1_MODE, READER_INIT, "[90]12", -1, 0, 68, "(6) 105 102 90 12 11 106", "StartC FNC1 90 12 (Reader Initialise not supported by GS1 barcodes)" },
+        /* 17*/ { BARCODE_HIBC_128, UNICODE_MODE, -1, "A123BJC5D6E71", -1, 0, 200, "(18) 104 11 33 17 18 19 34 42 35 21 36 22 37 23 17 39 32 106", "StartB + A 1 2 3 B J C 5 D 6 E 7 1 + check" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char escaped[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->debug = ZINT_DEBUG_TEST; // Needed to get codeword dump in errtxt
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, C128_OPTIMAL, data[i].output_options, data[i].data, data[i].length, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, %s, \"%s\", %d, %s, %d, \"%s\", \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode), testUtilOutputOptionsName(data[i].output_options),
+                    testUtilEscape(data[i].data, length, escaped, sizeof(escaped)), data[i].length,
+                    testUtilErrorName(data[i].ret), symbol->width, symbol->errtxt, data[i].comment);
+        } else {
+            if (ret < 5) {
+                assert_equal(symbol->width, data[i].expected_width, "i:%d symbol->width %d != %d (%s)\n", i, symbol->width, data[i].expected_width, data[i].data);
+                assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+            } else {
+                assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+            }
+
+            if (ret < 5) {
+                // Never wider than default encodation
+                struct zint_symbol *symbol2 = ZBarcode_Create();
+                assert_nonnull(symbol2, "Symbol2 not created\n");
+
+                length = testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, data[i].length, debug);
+
+                ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data, length);
+                assert_zero(ret, "i:%d ZBarcode_Encode default ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+                assert_nonzero(symbol->width <= symbol2->width, "i:%d symbol->width %d > default %d\n", i, symbol->width, symbol2->width);
+
+                ZBarcode_Delete(symbol2);
+            }
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_hibc_input(int index, int generate, int debug) {
 
     testStart("");
@@ -695,6 +789,7 @@ int main(int argc, char *argv[]) {
         { "test_reader_init", test_reader_init, 1, 1, 1 },
         { "test_input", test_input, 1, 1, 1 },
         { "test_ean128_input", test_ean128_input, 1, 1, 1 },
+        { "test_optimal", test_optimal, 1, 1, 1 },
         { "test_hibc_input", test_hibc_input, 1, 1, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
     };
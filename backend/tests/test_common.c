@@ -79,6 +79,103 @@ static void test_utf8_to_unicode(int index, int debug) {
     testFinish();
 }
 
+static void test_is_sane_lookup(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char *test_string;
+        int test_length;
+        char *data;
+        int length;
+        int ret;
+        int expected_posns[20];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "0123456789", -1, "1234", -1, 0, { 1, 2, 3, 4 } },
+        /*  1*/ { "0123456789-", -1, "-09", -1, 0, { 10, 0, 9 } },
+        /*  2*/ { "0123456789", -1, "12A4", -1, ZINT_ERROR_INVALID_DATA, {} },
+        /*  3*/ { "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%abcd", 43, "A%Z", -1, 0, { 10, 42, 35 } },
+        /*  4*/ { "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%abcd", 43, "Aa", -1, ZINT_ERROR_INVALID_DATA, {} }, // Beyond `test_length`
+        /*  5*/ { "0123456789", -1, "1\0002", 3, ZINT_ERROR_INVALID_DATA, {} },
+        /*  6*/ { "\377\001", 2, "\001\377", 2, 0, { 1, 0 } },
+        /*  7*/ { "0123456789", -1, "", 0, 0, {} },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    int posns[20];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        int test_length = data[i].test_length == -1 ? (int) strlen(data[i].test_string) : data[i].test_length;
+        int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
+
+        ret = is_sane_lookup(data[i].test_string, test_length, (const unsigned char *) data[i].data, length, posns);
+        assert_equal(ret, data[i].ret, "i:%d is_sane_lookup ret %d != %d\n", i, ret, data[i].ret);
+        if (ret == 0) {
+            for (int j = 0; j < length; j++) {
+                assert_equal(posns[j], data[i].expected_posns[j], "i:%d posns[%d] %d != %d\n", i, j, posns[j], data[i].expected_posns[j]);
+            }
+        }
+
+        if (test_length == (int) strlen(data[i].test_string)) {
+            ret = is_sane(data[i].test_string, (const unsigned char *) data[i].data, length);
+            assert_equal(ret, data[i].ret, "i:%d is_sane ret %d != %d\n", i, ret, data[i].ret);
+        }
+    }
+
+    testFinish();
+}
+
+static void test_expand(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        char *data;
+        int expected_width;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "1", 1, "1" },
+        /*  1*/ { "1111", 4, "1010" },
+        /*  2*/ { "9", 9, "111111111" },
+        /*  3*/ { "1713", 12, "100000001000" },
+        /*  4*/ { "2112211111", 13, "1101001101010" },
+        /*  5*/ { "3899", 29, "11100000000111111111000000000" }, // Runs across byte boundaries
+        /*  6*/ { "0211", 4, "0010" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol symbol;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        memset(&symbol, 0, sizeof(symbol));
+        symbol.symbology = BARCODE_CODE128;
+        symbol.debug = debug;
+
+        expand(&symbol, data[i].data, (int) strlen(data[i].data));
+        assert_equal(symbol.rows, 1, "i:%d symbol.rows %d != 1\n", i, symbol.rows);
+        assert_equal(symbol.width, data[i].expected_width, "i:%d symbol.width %d != %d\n", i, symbol.width, data[i].expected_width);
+        for (int j = 0; j < symbol.width; j++) {
+            assert_equal(module_is_set(&symbol, 0, j), data[i].expected[j] - '0', "i:%d module %d %d != %d\n", i, j, module_is_set(&symbol, 0, j), data[i].expected[j] - '0');
+        }
+        for (int j = symbol.width; j < 64; j++) {
+            assert_zero(module_is_set(&symbol, 0, j), "i:%d module %d set\n", i, j);
+        }
+    }
+
+    testFinish();
+}
+
 static void test_debug_test_codeword_dump_int(int index, int debug) {
 
     testStart("");
@@ -114,6 +211,8 @@ int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_utf8_to_unicode", test_utf8_to_unicode, 1, 0, 1 },
+        { "test_is_sane_lookup", test_is_sane_lookup, 1, 0, 0 },
+        { "test_expand", test_expand, 1, 0, 1 },
         { "test_debug_test_codeword_dump_int", test_debug_test_codeword_dump_int, 1, 0, 1 },
     };
 
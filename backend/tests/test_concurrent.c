@@ -0,0 +1,286 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2019 - 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+
+#include "testcommon.h"
+#include <locale.h>
+#include <pthread.h>
+
+#define CONC_THREADS    8
+#define CONC_ROUNDS     3
+
+/* Symbology and data to encode, chosen on the main thread */
+struct conc_case {
+    int symbology;
+    const char *data;
+    const char *primary;
+    const char *outfile;
+};
+
+/* Result of encoding and rendering a case, images reduced to hashes */
+struct conc_result {
+    int ret;
+    char errtxt[100];
+    int rows;
+    int width;
+    unsigned int matrix_hash; /* `encoded_data`, `row_height` and `text` */
+    int bitmap_width;
+    int bitmap_height;
+    unsigned int bitmap_hash;
+    int memfile_size;
+    unsigned int memfile_hash;
+};
+
+struct conc_worker {
+    const struct conc_case *cases;
+    const struct conc_result *expected;
+    int count;
+    int thread;
+    int mismatches;
+    int first_mismatch;
+};
+
+/* FNV-1a */
+static unsigned int conc_hash(unsigned int hash, const unsigned char *data, const size_t length) {
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619;
+    }
+    return hash;
+}
+
+/* Encode `c` and render it to bitmap and (in memory) vector file, recording the outcome in `r`. Uses nothing from
+   testcommon, which isn't thread-safe */
+static void conc_run(const struct conc_case *c, struct conc_result *r) {
+    struct zint_symbol *symbol = ZBarcode_Create();
+
+    memset(r, 0, sizeof(*r));
+    if (!symbol) {
+        r->ret = -1;
+        return;
+    }
+    symbol->symbology = c->symbology;
+    symbol->input_mode = UNICODE_MODE;
+    if (c->primary) {
+        strcpy(symbol->primary, c->primary);
+    }
+
+    r->ret = ZBarcode_Encode(symbol, (const unsigned char *) c->data, 0);
+    strcpy(r->errtxt, symbol->errtxt);
+    r->rows = symbol->rows;
+    r->width = symbol->width;
+    if (r->ret < ZINT_ERROR) {
+        r->matrix_hash = conc_hash(2166136261u, (const unsigned char *) symbol->encoded_data,
+                                    sizeof(symbol->encoded_data[0]) * symbol->rows);
+        r->matrix_hash = conc_hash(r->matrix_hash, (const unsigned char *) symbol->row_height,
+                                    sizeof(int) * symbol->rows);
+        r->matrix_hash = conc_hash(r->matrix_hash, symbol->text, sizeof(symbol->text));
+
+        if (ZBarcode_Buffer(symbol, 0) < ZINT_ERROR) {
+            r->bitmap_width = symbol->bitmap_width;
+            r->bitmap_height = symbol->bitmap_height;
+            r->bitmap_hash = conc_hash(2166136261u, symbol->bitmap,
+                                        (size_t) symbol->bitmap_width * symbol->bitmap_height * 3);
+        }
+
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, c->outfile);
+        if (ZBarcode_Print(symbol, 0) < ZINT_ERROR) {
+            r->memfile_size = symbol->memfile_size;
+            r->memfile_hash = conc_hash(2166136261u, symbol->memfile, symbol->memfile_size);
+        }
+    }
+
+    ZBarcode_Delete(symbol);
+}
+
+/* Run all cases `CONC_ROUNDS` times, each thread starting at a different case, counting results that differ */
+static void *conc_thread(void *arg) {
+    struct conc_worker *worker = (struct conc_worker *) arg;
+    struct conc_result result;
+    int round, i;
+
+    for (round = 0; round < CONC_ROUNDS; round++) {
+        for (i = 0; i < worker->count; i++) {
+            const int j = (i + worker->thread * 17 + round) % worker->count;
+            conc_run(&worker->cases[j], &result);
+            if (memcmp(&result, &worker->expected[j], sizeof(result)) != 0) {
+                if (worker->mismatches++ == 0) {
+                    worker->first_mismatch = j;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Set up a case for each symbology with the first data that encodes (or the last if none do), and work out the
+   expected results on this thread alone */
+static int conc_cases(int index, int debug, struct conc_case cases[], struct conc_result expected[]) {
+    static const char *const datas[] = {
+        "123456", "1234567", "12345678901", "123456789012", "1234567890123", "[01]12345678901231", "FADT",
+        "A123456B", "A", "12345678901234567",
+    };
+    static const char *const primaries[] = { "331234567890", "[01]12345678901231", "12345678901", "1234567" };
+    static const char *const outfiles[] = { "out.svg", "out.eps", "out.emf" };
+    int count = 0;
+    int symbology, i;
+
+    for (symbology = 1; symbology <= 145; symbology++) {
+        const int composite = symbology >= BARCODE_EANX_CC && symbology <= BARCODE_DBAR_EXPSTK_CC;
+        struct conc_case *c = &cases[count];
+
+        if (!ZBarcode_ValidID(symbology)) {
+            continue;
+        }
+        c->symbology = symbology;
+        c->outfile = outfiles[count % ARRAY_SIZE(outfiles)];
+        c->primary = NULL;
+        for (i = 0; i < (int) (composite ? ARRAY_SIZE(primaries) : ARRAY_SIZE(datas)); i++) {
+            if (composite) {
+                c->data = "[21]A12345678";
+                c->primary = primaries[i];
+            } else {
+                c->data = datas[i];
+            }
+            conc_run(c, &expected[count]);
+            if (expected[count].ret < ZINT_ERROR) {
+                break;
+            }
+        }
+        if (debug & ZINT_DEBUG_PRINT) {
+            printf("%d: symbology %d data %s primary %s ret %d %s\n", count, symbology, c->data,
+                    c->primary ? c->primary : "", expected[count].ret, expected[count].errtxt);
+        }
+        count++;
+    }
+    if (index != -1) {
+        /* Only case `index` wanted */
+        if (index >= count) {
+            return 0;
+        }
+        cases[0] = cases[index];
+        expected[0] = expected[index];
+        return 1;
+    }
+    return count;
+}
+
+/* Run the cases on `CONC_THREADS` threads at once and assert all results match the single-threaded ones */
+static void conc_check(const struct conc_case cases[], const struct conc_result expected[], const int count) {
+    struct conc_worker workers[CONC_THREADS];
+    pthread_t handles[CONC_THREADS];
+    int t;
+
+    for (t = 0; t < CONC_THREADS; t++) {
+        workers[t].cases = cases;
+        workers[t].expected = expected;
+        workers[t].count = count;
+        workers[t].thread = t;
+        workers[t].mismatches = 0;
+        workers[t].first_mismatch = -1;
+        assert_zero(pthread_create(&handles[t], NULL, conc_thread, &workers[t]), "t:%d pthread_create failed\n", t);
+    }
+    for (t = 0; t < CONC_THREADS; t++) {
+        assert_zero(pthread_join(handles[t], NULL), "t:%d pthread_join failed\n", t);
+    }
+    for (t = 0; t < CONC_THREADS; t++) {
+        assert_zero(workers[t].mismatches, "t:%d mismatches %d, first case %d (symbology %d)\n",
+                    t, workers[t].mismatches, workers[t].first_mismatch,
+                    workers[t].first_mismatch == -1 ? 0 : cases[workers[t].first_mismatch].symbology);
+    }
+}
+
+static struct conc_case cases[146];
+static struct conc_result expected[146];
+
+/* Every symbology encoded and rendered on many threads at once gives the same results as on one */
+static void test_encode_render(int index, int debug) {
+
+    testStart("");
+
+    static const char *const locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German" };
+    int count = conc_cases(index, debug, cases, expected);
+    assert_nonzero(count, "no cases\n");
+
+    /* Vector output must not be affected by a locale using ',' as decimal point */
+    for (int i = 0; i < (int) ARRAY_SIZE(locales); i++) {
+        if (setlocale(LC_NUMERIC, locales[i])) {
+            if (debug & ZINT_DEBUG_PRINT) printf("Locale %s\n", locales[i]);
+            break;
+        }
+    }
+
+    conc_check(cases, expected, count);
+
+    setlocale(LC_NUMERIC, "C");
+
+    testFinish();
+}
+
+/* Same with the encode cache shared by all threads, small enough to be evicting all the time */
+static void test_cache(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    unsigned long hits, misses;
+    int count = conc_cases(index, debug, cases, expected);
+    assert_nonzero(count, "no cases\n");
+
+    ret = ZBarcode_Cache_Size(count / 4 + 1);
+    assert_zero(ret, "ZBarcode_Cache_Size ret %d != 0\n", ret);
+
+    conc_check(cases, expected, count);
+
+    ZBarcode_Cache_Stats(&hits, &misses, NULL);
+    assert_nonzero(hits + misses, "no cache lookups\n");
+
+    ret = ZBarcode_Cache_Size(0);
+    assert_zero(ret, "ZBarcode_Cache_Size(0) ret %d != 0\n", ret);
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_encode_render", test_encode_render, 1, 0, 1 },
+        { "test_cache", test_cache, 1, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
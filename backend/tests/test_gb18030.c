@@ -32,6 +32,7 @@
 #include "testcommon.h"
 #include "test_gb18030_tab.h"
 #include "../gb18030.h"
+#include "../scratch.h"
 
 // As control convert to GB 18030 using table generated from GB18030.TXT plus simple processing.
 // The version of GB18030.TXT is libiconv-1.11/GB18030.TXT taken from https://haible.de/bruno/charsets/conversion-tables/GB18030.html
@@ -185,6 +186,8 @@ static void test_gb18030_utf8tomb(int index) {
     struct zint_symbol symbol;
     unsigned int gbdata[30];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -202,6 +205,8 @@ static void test_gb18030_utf8tomb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
@@ -258,8 +263,11 @@ static void test_gb18030_utf8tosb(int index) {
 
     int data_size = sizeof(data) / sizeof(struct item);
 
+    struct zint_symbol symbol;
     unsigned int gbdata[30];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -267,7 +275,7 @@ static void test_gb18030_utf8tosb(int index) {
         int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
         int ret_length = length;
 
-        ret = gb18030_utf8tosb(data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
+        ret = gb18030_utf8tosb(&symbol, data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
         if (ret == 0) {
             assert_equal(ret_length, data[i].ret_length, "i:%d ret_length %d != %d\n", i, ret_length, data[i].ret_length);
@@ -277,6 +285,8 @@ static void test_gb18030_utf8tosb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
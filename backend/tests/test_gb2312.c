@@ -32,6 +32,7 @@
 #include "testcommon.h"
 #include "test_gb2312_tab.h"
 #include "../gb2312.h"
+#include "../scratch.h"
 
 // As control convert to GB 2312 using simple table generated from unicode.org GB2312.TXT plus simple processing
 // GB2312.TXT no longer on unicode.org site but available from https://haible.de/bruno/charsets/conversion-tables/GB2312.html
@@ -125,6 +126,8 @@ static void test_gb2312_utf8tomb(int index) {
     struct zint_symbol symbol;
     unsigned int gbdata[20];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -142,6 +145,8 @@ static void test_gb2312_utf8tomb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
@@ -196,8 +201,11 @@ static void test_gb2312_utf8tosb(int index) {
 
     int data_size = sizeof(data) / sizeof(struct item);
 
+    struct zint_symbol symbol;
     unsigned int gbdata[20];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -205,7 +213,7 @@ static void test_gb2312_utf8tosb(int index) {
         int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
         int ret_length = length;
 
-        ret = gb2312_utf8tosb(data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
+        ret = gb2312_utf8tosb(&symbol, data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
         if (ret == 0) {
             assert_equal(ret_length, data[i].ret_length, "i:%d ret_length %d != %d\n", i, ret_length, data[i].ret_length);
@@ -215,6 +223,8 @@ static void test_gb2312_utf8tosb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
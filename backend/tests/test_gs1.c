@@ -814,6 +814,130 @@ static void test_gs1_verify(int index) {
     testFinish();
 }
 
+static void test_gs1_verify_strict(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int warn_level;
+        char *data;
+        int ret;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, "[00]123456789012345675", 0, "00123456789012345675" },
+        /*  1*/ { -1, "[00]123456789012345678", ZINT_ERROR_INVALID_DATA, "" },
+        /*  2*/ { -1, "[01]12345678901231", 0, "0112345678901231" },
+        /*  3*/ { -1, "[01]12345678901234", ZINT_ERROR_INVALID_DATA, "" },
+        /*  4*/ { -1, "[01]1234567890123A", ZINT_ERROR_INVALID_DATA, "" },
+        /*  5*/ { -1, "[10]ABCD-12/34", 0, "10ABCD-12/34" },
+        /*  6*/ { -1, "[10]ABCD 1234", ZINT_ERROR_INVALID_DATA, "" },
+        /*  7*/ { -1, "[10]ABCD#1234", ZINT_ERROR_INVALID_DATA, "" },
+        /*  8*/ { -1, "[11]990102", 0, "11990102" },
+        /*  9*/ { -1, "[11]991301", ZINT_ERROR_INVALID_DATA, "" },
+        /* 10*/ { -1, "[15]210200", 0, "15210200" },
+        /* 11*/ { -1, "[15]210230", ZINT_ERROR_INVALID_DATA, "" },
+        /* 12*/ { -1, "[16]000000", ZINT_ERROR_INVALID_DATA, "" },
+        /* 13*/ { -1, "[253]1313131313130ABC", 0, "2531313131313130ABC" },
+        /* 14*/ { -1, "[253]1313131313134ABC", ZINT_ERROR_INVALID_DATA, "" },
+        /* 15*/ { -1, "[255]131313131313012345678901", 0, "255131313131313012345678901" },
+        /* 16*/ { -1, "[255]13131313131301234567890A", ZINT_ERROR_INVALID_DATA, "" },
+        /* 17*/ { -1, "[421]826AB12", 0, "421826AB12" },
+        /* 18*/ { -1, "[421]82AAB12", ZINT_ERROR_INVALID_DATA, "" },
+        /* 19*/ { -1, "[8003]01234567890128ABC", 0, "800301234567890128ABC" },
+        /* 20*/ { -1, "[8003]01234567890123ABC", ZINT_ERROR_INVALID_DATA, "" },
+        /* 21*/ { -1, "[8010]ABC#-/123", 0, "8010ABC#-/123" },
+        /* 22*/ { -1, "[8010]ABC#-/12a", ZINT_ERROR_INVALID_DATA, "" },
+        /* 23*/ { -1, "[01]12345678901231[7006]200229", 0, "01123456789012317006200229" },
+        /* 24*/ { -1, "[01]12345678901231[7006]200230", ZINT_ERROR_INVALID_DATA, "" },
+        /* 25*/ { WARN_ZPL_COMPAT, "[01]12345678901234[7006]200230", ZINT_WARN_NONCOMPLIANT, "01123456789012347006200230" },
+        /* 26*/ { -1, "[3900]1234567890[01]12345678901231", 0, "39001234567890[0112345678901231" },
+        /* 27*/ { -1, "[7007]200101201231", 0, "7007200101201231" },
+        /* 28*/ { -1, "[7007]200101201331", ZINT_ERROR_INVALID_DATA, "" },
+    };
+    int data_size = sizeof(data) / sizeof(struct item);
+
+    char reduced[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->input_mode = GS1_MODE | GS1STRICT_MODE;
+        if (data[i].warn_level != -1) {
+            symbol->warn_level = data[i].warn_level;
+        }
+
+        int length = strlen(data[i].data);
+
+        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, reduced);
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d (length %d \"%s\") %s\n", i, ret, data[i].ret, length, data[i].data, symbol->errtxt);
+
+        if (ret < ZINT_ERROR) {
+            assert_zero(strcmp(reduced, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, reduced, data[i].expected);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_gs1_verify_errtxt(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char *data;
+        int length;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "1234", -1, ZINT_ERROR_INVALID_DATA, "252: Data does not start with an AI" },
+        /*  1*/ { "1234\200", -1, ZINT_ERROR_INVALID_DATA, "250: Extended ASCII characters are not supported by GS1" },
+        /*  2*/ { "1234\001", -1, ZINT_ERROR_INVALID_DATA, "251: Control characters are not supported by GS1" },
+        /*  3*/ { "1234\000", 5, ZINT_ERROR_INVALID_DATA, "262: NUL characters not permitted in GS1 mode" },
+        /*  4*/ { "1234\177", -1, ZINT_ERROR_INVALID_DATA, "263: DEL characters are not supported by GS1" },
+        /*  5*/ { "[01]12345678901231[2[3]4", -1, ZINT_ERROR_INVALID_DATA, "254: Found nested brackets in input data" },
+        /*  6*/ { "[01]12345678901231[2[3]4\200", -1, ZINT_ERROR_INVALID_DATA, "250: Extended ASCII characters are not supported by GS1" },
+        /*  7*/ { "[0A]1234", -1, ZINT_ERROR_INVALID_DATA, "257: Invalid AI in input data (non-numeric characters in AI)" },
+        /*  8*/ { "[0A]1234\001", -1, ZINT_ERROR_INVALID_DATA, "251: Control characters are not supported by GS1" },
+        /*  9*/ { "[01]", -1, ZINT_ERROR_INVALID_DATA, "258: Empty data field in input data" },
+        /* 10*/ { "[01]\177", -1, ZINT_ERROR_INVALID_DATA, "263: DEL characters are not supported by GS1" },
+    };
+    int data_size = sizeof(data) / sizeof(struct item);
+
+    char reduced[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->input_mode = GS1_MODE;
+
+        int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
+
+        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, reduced);
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d (length %d \"%s\") %s\n", i, ret, data[i].ret, length, data[i].data, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected_errtxt);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_input_mode(int index, int debug) {
 
     testStart("");
@@ -914,6 +1038,8 @@ int main(int argc, char *argv[]) {
         { "test_gs1_reduce", test_gs1_reduce, 1, 1, 1 },
         { "test_hrt", test_hrt, 1, 0, 1 },
         { "test_gs1_verify", test_gs1_verify, 1, 0, 0 },
+        { "test_gs1_verify_strict", test_gs1_verify_strict, 1, 0, 0 },
+        { "test_gs1_verify_errtxt", test_gs1_verify_errtxt, 1, 0, 0 },
         { "test_input_mode", test_input_mode, 1, 0, 1 },
     };
 
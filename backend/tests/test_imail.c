@@ -284,6 +284,93 @@ static void test_encode(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_batch(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char *data;
+        int length;
+        int ret;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { "01234567094987654321-01234567891", -1, 0, "AADTFFDFTDADTAADAATFDTDDAAADDTDTTDAFADADDDTFFFDDTTTADFAAADFTDAADA" }, // USPS-B-3200 Rev. H (2015) Figure 5
+        /* 1*/ { "01234567094987654321", -1, 0, NULL },
+        /* 2*/ { "01234567094987654321-01234", -1, 0, NULL },
+        /* 3*/ { "01234567094987654321-012345678", -1, 0, NULL },
+        /* 4*/ { "01234567094987654321-0123456789", -1, ZINT_ERROR_INVALID_DATA, "" },
+        /* 5*/ { "0123456709498765432A", -1, ZINT_ERROR_INVALID_DATA, "" },
+        /* 6*/ { "01234567094987654321-012345678912", -1, ZINT_ERROR_TOO_LONG, "" },
+        /* 7*/ { "01234567094987654321-01234567891XXX", 32, 0, "AADTFFDFTDADTAADAATFDTDDAAADDTDTTDAFADADDDTFFFDDTTTADFAAADFTDAADA" }, // Length given
+        /* 8*/ { "99999999999999999999-99999999999", -1, ZINT_ERROR_INVALID_DATA, "" }, // Invalid Barcode Identifier
+        /* 9*/ { "00049999999999999999-99999999999", -1, 0, NULL }, // Maximum value
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    const unsigned char *sources[ARRAY_SIZE(data)];
+    int lengths[ARRAY_SIZE(data)];
+    int errors[ARRAY_SIZE(data)];
+    char bar_states[ARRAY_SIZE(data) * ZINT_IMAIL_BAR_STATES];
+    char expected[ZINT_IMAIL_BAR_STATES];
+    int expected_ret = 0;
+
+    for (int i = 0; i < data_size; i++) {
+        sources[i] = (const unsigned char *) data[i].data;
+        lengths[i] = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
+        if (data[i].ret > expected_ret) {
+            expected_ret = data[i].ret;
+        }
+    }
+
+    ret = ZBarcode_Encode_IMail_Batch(NULL, lengths, data_size, bar_states, errors);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Encode_IMail_Batch(NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+
+    ret = ZBarcode_Encode_IMail_Batch(sources, lengths, data_size, bar_states, errors);
+    assert_equal(ret, expected_ret, "ZBarcode_Encode_IMail_Batch ret %d != %d\n", ret, expected_ret);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        const char *actual = bar_states + i * ZINT_IMAIL_BAR_STATES;
+
+        assert_equal(errors[i], data[i].ret, "i:%d errors[i] %d != %d\n", i, errors[i], data[i].ret);
+
+        if (data[i].expected) {
+            strcpy(expected, data[i].expected);
+        } else {
+            /* Compare with symbol encoding */
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, BARCODE_USPS_IMAIL, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, lengths[i], debug);
+
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+            assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+            for (int j = 0; j < 65; j++) {
+                int ascender = module_is_set(symbol, 0, j * 2);
+                int descender = module_is_set(symbol, 2, j * 2);
+                expected[j] = ascender ? descender ? 'F' : 'A' : descender ? 'D' : 'T';
+            }
+            expected[65] = '\0';
+
+            ZBarcode_Delete(symbol);
+        }
+        assert_zero(strcmp(actual, expected), "i:%d bar states\n  actual: %s\nexpected: %s\n", i, actual, expected);
+    }
+
+    /* NUL-terminated if no lengths */
+    ret = ZBarcode_Encode_IMail_Batch(sources, NULL, 1, bar_states, NULL);
+    assert_zero(ret, "ZBarcode_Encode_IMail_Batch (no lengths) ret %d != 0\n", ret);
+    assert_zero(strcmp(bar_states, data[0].expected), "bar states (no lengths) %s != %s\n", bar_states, data[0].expected);
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -291,6 +378,7 @@ int main(int argc, char *argv[]) {
         { "test_hrt", test_hrt, 1, 0, 1 },
         { "test_input", test_input, 1, 0, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
+        { "test_batch", test_batch, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -261,6 +261,678 @@ static void test_cap(int index) {
     testFinish();
 }
 
+static void test_threads(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int option_2;
+        int length;
+        int threads;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_QRCODE, -1, 20, 4 }, // Too small to use threads
+        /* 1*/ { BARCODE_QRCODE, -1, 500, 2 },
+        /* 2*/ { BARCODE_QRCODE, -1, 2000, 8 },
+        /* 3*/ { BARCODE_QRCODE, -1, 2000, 100 }, // Capped at PARALLEL_MAX_THREADS
+        /* 4*/ { BARCODE_UPNQR, -1, 300, 3 },
+        /* 5*/ { BARCODE_HANXIN, -1, 500, 2 },
+        /* 6*/ { BARCODE_HANXIN, -1, 3000, 4 },
+        /* 7*/ { BARCODE_DOTCODE, -1, 300, 3 },
+        /* 8*/ { BARCODE_DOTCODE, 200, 500, 8 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char data_buf[3001];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        for (int j = 0; j < data[i].length; j++) {
+            data_buf[j] = ' ' + (j * 7 + j / 13) % 95;
+        }
+        data_buf[data[i].length] = '\0';
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, UNICODE_MODE, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data_buf, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        struct zint_symbol *symbol_threads = ZBarcode_Create();
+        assert_nonnull(symbol_threads, "Symbol not created\n");
+
+        length = testUtilSetSymbol(symbol_threads, data[i].symbology, UNICODE_MODE, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data_buf, -1, debug);
+        symbol_threads->threads = data[i].threads;
+
+        ret = ZBarcode_Encode(symbol_threads, (unsigned char *) data_buf, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode threads %d ret %d != 0 (%s)\n", i, data[i].threads, ret, symbol_threads->errtxt);
+
+        ret = testUtilSymbolCmp(symbol_threads, symbol);
+        assert_zero(ret, "i:%d testUtilSymbolCmp threads %d ret %d != 0\n", i, data[i].threads, ret);
+
+        ZBarcode_Delete(symbol_threads);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_memfile(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *outfile;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, "test_memfile.bmp", "123456" },
+        /* 1*/ { BARCODE_QRCODE, "test_memfile.emf", "123456" },
+        /* 2*/ { BARCODE_EANX, "test_memfile.eps", "123456789012" },
+        /* 3*/ { BARCODE_DATAMATRIX, "test_memfile.gif", "123456" },
+        /* 4*/ { BARCODE_PDF417, "test_memfile.pcx", "123456" },
+#ifndef NO_PNG
+        /* 5*/ { BARCODE_MAXICODE, "test_memfile.png", "123456" },
+#endif
+        /* 6*/ { BARCODE_ULTRA, "test_memfile.svg", "123456" },
+        /* 7*/ { BARCODE_AZTEC, "test_memfile.tif", "123456" },
+        /* 8*/ { BARCODE_DOTCODE, "test_memfile.txt", "123456" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    static unsigned char file_buf[65536];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        strcpy(symbol->outfile, data[i].outfile);
+
+        ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_null(symbol->memfile, "i:%d memfile non-NULL\n", i);
+
+        FILE *fp = fopen(symbol->outfile, "rb");
+        assert_nonnull(fp, "i:%d fopen(%s) failed\n", i, symbol->outfile);
+        int file_size = (int) fread(file_buf, 1, sizeof(file_buf), fp);
+        assert_nonzero(file_size > 0 && file_size < (int) sizeof(file_buf), "i:%d file_size %d\n", i, file_size);
+        assert_zero(fclose(fp), "i:%d fclose(%s) != 0\n", i, symbol->outfile);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+
+        /* Same again to memory - file not created */
+        ZBarcode_Clear(symbol);
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+
+        ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Print memory ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+        assert_equal(symbol->memfile_size, file_size, "i:%d memfile_size %d != file_size %d\n", i, symbol->memfile_size, file_size);
+        assert_zero(memcmp(symbol->memfile, file_buf, file_size), "i:%d memcmp(memfile, file_buf) != 0\n", i);
+        assert_zero(testUtilExists(symbol->outfile), "i:%d testUtilExists(%s) != 0\n", i, symbol->outfile);
+
+        ZBarcode_Clear(symbol);
+        assert_null(symbol->memfile, "i:%d memfile non-NULL after clear\n", i);
+        assert_zero(symbol->memfile_size, "i:%d memfile_size %d != 0 after clear\n", i, symbol->memfile_size);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_sheet(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *outfile;
+        int width;
+        int height;
+        float x;
+        float y;
+        int rotate_angle;
+        char *data;
+        int ret_begin;
+        int ret_add;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, "out.bmp", 400, 300, 10, 20, 0, "123456", 0, 0, "" },
+        /* 1*/ { BARCODE_QRCODE, "out.gif", 400, 300, 100, 50, 90, "123456", 0, 0, "" },
+        /* 2*/ { BARCODE_DATAMATRIX, "out.pcx", 400, 300, 0, 0, 180, "123456", 0, 0, "" },
+        /* 3*/ { BARCODE_MAXICODE, "out.tif", 400, 400, 50, 50, 270, "123456", 0, 0, "" },
+        /* 4*/ { BARCODE_EANX, "out.eps", 400, 300, 10.5f, 20.5f, 0, "123456789012", 0, 0, "" },
+        /* 5*/ { BARCODE_AZTEC, "out.svg", 400, 300, 100, 50, 90, "123456", 0, 0, "" },
+        /* 6*/ { BARCODE_CODE128, "out.bmp", 40, 300, 0, 0, 0, "123456", 0, ZINT_ERROR_INVALID_OPTION, "Error 663: Symbol does not fit on sheet" },
+        /* 7*/ { BARCODE_CODE128, "out.svg", 400, 300, 0, 290, 0, "123456", 0, ZINT_ERROR_INVALID_OPTION, "Error 665: Symbol does not fit on sheet" },
+        /* 8*/ { BARCODE_CODE128, "out.bmp", 400, 300, 0, 0, 45, "123456", 0, ZINT_ERROR_INVALID_OPTION, "Error 248: Invalid rotation angle" },
+        /* 9*/ { BARCODE_ULTRA, "out.bmp", 400, 300, 0, 0, 0, "123456", 0, ZINT_ERROR_INVALID_OPTION, "Error 298: Ultracode can only be placed on sheets of symbology Ultracode" },
+        /*10*/ { BARCODE_CODE128, "out.emf", 400, 300, 0, 0, 0, "123456", ZINT_ERROR_INVALID_OPTION, -1, "Error 244: Unknown or unsupported output format for sheet" },
+        /*11*/ { BARCODE_CODE128, "out.txt", 400, 300, 0, 0, 0, "123456", ZINT_ERROR_INVALID_OPTION, -1, "Error 244: Unknown or unsupported output format for sheet" },
+        /*12*/ { BARCODE_CODE128, "out.bmp", 0, 300, 0, 0, 0, "123456", ZINT_ERROR_INVALID_OPTION, -1, "Error 245: Invalid sheet size (1 to 65535 only)" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *sheet = ZBarcode_Create();
+        assert_nonnull(sheet, "Sheet not created\n");
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        strcpy(sheet->outfile, data[i].outfile);
+        sheet->output_options |= BARCODE_MEMORY_FILE;
+
+        ret = ZBarcode_Sheet_Begin(sheet, data[i].width, data[i].height);
+        assert_equal(ret, data[i].ret_begin, "i:%d ZBarcode_Sheet_Begin ret %d != %d (%s)\n", i, ret, data[i].ret_begin, sheet->errtxt);
+        if (ret) {
+            assert_zero(strcmp(sheet->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, sheet->errtxt, data[i].expected_errtxt);
+            ZBarcode_Delete(symbol);
+            ZBarcode_Delete(sheet);
+            continue;
+        }
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        ret = ZBarcode_Sheet_Add(sheet, symbol, data[i].x, data[i].y, data[i].rotate_angle);
+        assert_equal(ret, data[i].ret_add, "i:%d ZBarcode_Sheet_Add ret %d != %d (%s)\n", i, ret, data[i].ret_add, sheet->errtxt);
+        assert_zero(strcmp(sheet->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, sheet->errtxt, data[i].expected_errtxt);
+        assert_null(symbol->bitmap, "i:%d symbol bitmap non-NULL\n", i);
+        assert_null(symbol->vector, "i:%d symbol vector non-NULL\n", i);
+        if (ret) {
+            ZBarcode_Delete(symbol);
+            ZBarcode_Delete(sheet);
+            continue;
+        }
+
+        if (sheet->bitmap) {
+            /* Region of page should match symbol rendered on its own */
+            symbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+            ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            for (int row = 0; row < symbol->bitmap_height; row++) {
+                const unsigned char *page = sheet->bitmap + ((int) data[i].y + row) * sheet->bitmap_width + (int) data[i].x;
+                assert_zero(memcmp(page, symbol->bitmap + row * symbol->bitmap_width, symbol->bitmap_width),
+                            "i:%d row %d memcmp(page, bitmap) != 0\n", i, row);
+            }
+            assert_equal(sheet->bitmap[(data[i].height - 1) * data[i].width + data[i].width - 1], '0',
+                            "i:%d last pixel 0x%02X != '0'\n", i, sheet->bitmap[(data[i].height - 1) * data[i].width + data[i].width - 1]);
+        } else {
+            /* Vector elements moved over and offset */
+            assert_nonnull(sheet->vector, "i:%d sheet vector NULL\n", i);
+            assert_nonnull(sheet->vector->rectangles, "i:%d sheet rectangles NULL\n", i);
+            assert_nonzero(sheet->vector->rectangles->x >= data[i].x, "i:%d rectangle x %g < %g\n", i, sheet->vector->rectangles->x, data[i].x);
+            assert_nonzero(sheet->vector->rectangles->y >= data[i].y, "i:%d rectangle y %g < %g\n", i, sheet->vector->rectangles->y, data[i].y);
+        }
+
+        ret = ZBarcode_Sheet_Print(sheet);
+        assert_zero(ret, "i:%d ZBarcode_Sheet_Print ret %d != 0 (%s)\n", i, ret, sheet->errtxt);
+        assert_nonnull(sheet->memfile, "i:%d memfile NULL\n", i);
+        assert_nonzero(sheet->memfile_size, "i:%d memfile_size zero\n", i);
+
+        ZBarcode_Delete(symbol);
+        ZBarcode_Delete(sheet);
+    }
+
+    testFinish();
+}
+
+static void test_cache(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_2;
+        char *data;
+        int ret;
+        int expected_hit;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_QRCODE, -1, -1, "1234", 0, 0 },
+        /* 1*/ { BARCODE_QRCODE, -1, -1, "1234", 0, 1 },
+        /* 2*/ { BARCODE_QRCODE, -1, 2, "1234", 0, 0 }, // Different options
+        /* 3*/ { BARCODE_QRCODE, -1, -1, "12345", 0, 0 }, // Different data, evicts 0
+        /* 4*/ { BARCODE_QRCODE, -1, 2, "1234", 0, 1 },
+        /* 5*/ { BARCODE_QRCODE, -1, -1, "1234", 0, 0 }, // Evicted
+        /* 6*/ { BARCODE_DATAMATRIX, UNICODE_MODE, -1, "Ж", ZINT_WARN_USES_ECI, 0 },
+        /* 7*/ { BARCODE_DATAMATRIX, UNICODE_MODE, -1, "Ж", ZINT_WARN_USES_ECI, 1 }, // Warnings cached
+        /* 8*/ { BARCODE_EANX, -1, -1, "A", ZINT_ERROR_INVALID_DATA, 0 },
+        /* 9*/ { BARCODE_EANX, -1, -1, "A", ZINT_ERROR_INVALID_DATA, 0 }, // Errors not cached
+        /*10*/ { BARCODE_CODE128, ESCAPE_MODE, -1, "\\x41", 0, 0 },
+        /*11*/ { BARCODE_CODE128, ESCAPE_MODE, -1, "\\x41", 0, 1 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    unsigned long hits, misses;
+    int entries;
+    unsigned long expected_hits = 0, expected_misses = 0;
+
+    ret = ZBarcode_Cache_Size(-1);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Cache_Size(-1) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+
+    ret = ZBarcode_Cache_Size(2);
+    assert_zero(ret, "ZBarcode_Cache_Size(2) ret %d != 0\n", ret);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        struct zint_symbol *uncached = ZBarcode_Create();
+        assert_nonnull(uncached, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        (void) testUtilSetSymbol(uncached, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        uncached->debug |= ZINT_DEBUG_TEST; /* Any debug flag bypasses cache */
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        ZBarcode_Cache_Stats(&hits, &misses, &entries);
+        if (!symbol->debug) {
+            if (data[i].expected_hit) {
+                expected_hits++;
+            } else {
+                expected_misses++;
+            }
+            if (index == -1) {
+                assert_equal(hits, expected_hits, "i:%d hits %lu != %lu\n", i, hits, expected_hits);
+                assert_equal(misses, expected_misses, "i:%d misses %lu != %lu\n", i, misses, expected_misses);
+            }
+            assert_nonzero(entries <= 2, "i:%d entries %d > 2\n", i, entries);
+        }
+
+        if (ret < ZINT_ERROR) {
+            /* Result must be same as uncached encode */
+            ret = ZBarcode_Encode(uncached, (unsigned char *) data[i].data, length);
+            assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode uncached ret %d != %d (%s)\n", i, ret, data[i].ret, uncached->errtxt);
+            assert_equal(symbol->rows, uncached->rows, "i:%d rows %d != %d\n", i, symbol->rows, uncached->rows);
+            assert_equal(symbol->width, uncached->width, "i:%d width %d != %d\n", i, symbol->width, uncached->width);
+            assert_equal(symbol->eci, uncached->eci, "i:%d eci %d != %d\n", i, symbol->eci, uncached->eci);
+            assert_equal(symbol->input_mode, uncached->input_mode, "i:%d input_mode %d != %d\n", i, symbol->input_mode, uncached->input_mode);
+            assert_zero(strcmp((char *) symbol->text, (char *) uncached->text), "i:%d text %s != %s\n", i, symbol->text, uncached->text);
+            assert_zero(memcmp(symbol->row_height, uncached->row_height, sizeof(int) * symbol->rows), "i:%d row_height differ\n", i);
+            assert_zero(memcmp(symbol->encoded_data, uncached->encoded_data, sizeof(symbol->encoded_data)), "i:%d encoded_data differ\n", i);
+        }
+
+        ZBarcode_Delete(uncached);
+        ZBarcode_Delete(symbol);
+    }
+
+    ret = ZBarcode_Cache_Size(0);
+    assert_zero(ret, "ZBarcode_Cache_Size(0) ret %d != 0\n", ret);
+    ZBarcode_Cache_Stats(&hits, &misses, &entries);
+    assert_zero(hits + misses, "hits %lu + misses %lu != 0\n", hits, misses);
+    assert_zero(entries, "entries %d != 0\n", entries);
+
+    testFinish();
+}
+
+static void test_scratch(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *pattern;
+        int repeat;
+        int ret;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_QRCODE, -1, "1234567890", 700, 0 },
+        /* 1*/ { BARCODE_QRCODE, UNICODE_MODE, "点茗テ", 100, 0 },
+        /* 2*/ { BARCODE_RMQR, -1, "1234567890", 30, 0 },
+        /* 3*/ { BARCODE_HANXIN, -1, "1234567890", 700, 0 },
+        /* 4*/ { BARCODE_GRIDMATRIX, -1, "1234567890", 200, 0 },
+        /* 5*/ { BARCODE_DATAMATRIX, -1, "1234567890", 300, 0 },
+        /* 6*/ { BARCODE_AZTEC, -1, "1234567890", 300, 0 },
+        /* 7*/ { BARCODE_DOTCODE, -1, "1234567890", 20, 0 },
+        /* 8*/ { BARCODE_ULTRA, -1, "1234567890", 10, 0 },
+        /* 9*/ { BARCODE_CODABLOCKF, -1, "ABCDEFGHIJ", 50, 0 },
+        /*10*/ { BARCODE_DBAR_EXP, GS1_MODE, "[01]12345678901231", 1, 0 },
+        /*11*/ { BARCODE_QRCODE, -1, "1234567890", 800, ZINT_ERROR_TOO_LONG },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char data_buf[8192];
+    unsigned long peak, first_peak;
+
+    assert_zero(ZBarcode_Scratch_Peak(NULL), "ZBarcode_Scratch_Peak(NULL) != 0\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        assert_zero(ZBarcode_Scratch_Peak(symbol), "i:%d ZBarcode_Scratch_Peak(new) != 0\n", i);
+
+        data_buf[0] = '\0';
+        for (int j = 0; j < data[i].repeat; j++) {
+            strcat(data_buf, data[i].pattern);
+        }
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data_buf, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        first_peak = ZBarcode_Scratch_Peak(symbol);
+        assert_nonzero(first_peak, "i:%d ZBarcode_Scratch_Peak zero\n", i);
+
+        /* Arena is reused, and peak reset, by next encode */
+        ZBarcode_Clear(symbol);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode (2nd) ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        peak = ZBarcode_Scratch_Peak(symbol);
+        assert_equal(peak, first_peak, "i:%d peak %lu != first peak %lu\n", i, peak, first_peak);
+
+        if (ret < ZINT_ERROR) {
+            ret = ZBarcode_Buffer(symbol, 0);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+struct test_allocator_counts {
+    int allocs;
+    int frees;
+    int fail; /* Fail allocations if set */
+};
+
+static void *test_allocator_malloc(void *context, size_t size) {
+    struct test_allocator_counts *counts = (struct test_allocator_counts *) context;
+    void *ptr;
+
+    if (counts->fail || !(ptr = malloc(size))) {
+        return NULL;
+    }
+    counts->allocs++;
+    return ptr;
+}
+
+static void *test_allocator_realloc(void *context, void *ptr, size_t size) {
+    struct test_allocator_counts *counts = (struct test_allocator_counts *) context;
+    void *new_ptr;
+
+    if (counts->fail || !(new_ptr = realloc(ptr, size))) {
+        return NULL;
+    }
+    if (!ptr) {
+        counts->allocs++;
+    }
+    return new_ptr;
+}
+
+static void test_allocator_free(void *context, void *ptr) {
+    struct test_allocator_counts *counts = (struct test_allocator_counts *) context;
+
+    counts->frees++;
+    free(ptr);
+}
+
+static void test_allocator(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *outfile;
+        int fail;
+        char *data;
+        char *primary;
+        int ret;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, "out.png", 0, "1234", "", 0 },
+        /* 1*/ { BARCODE_CODE128, "out.bmp", 0, "1234", "", 0 },
+        /* 2*/ { BARCODE_CODE128, "out.svg", 0, "1234", "", 0 },
+        /* 3*/ { BARCODE_CODE128, "out.emf", 0, "1234", "", 0 },
+        /* 4*/ { BARCODE_DATAMATRIX, "out.gif", 0, "1234", "", 0 },
+        /* 5*/ { BARCODE_AZTEC, "out.pcx", 0, "1234567890123456789012345678901234567890123456789012345678901234567890", "", 0 }, // 10-bit codewords
+        /* 6*/ { BARCODE_MAXICODE, "out.tif", 0, "1234", "", 0 },
+        /* 7*/ { BARCODE_PDF417, "out.eps", 0, "1234", "", 0 },
+        /* 8*/ { BARCODE_QRCODE, "out.png", 0, "1234", "", 0 },
+        /* 9*/ { BARCODE_QRCODE, "out.png", 1, "1234", "", ZINT_ERROR_MEMORY },
+        /*10*/ { BARCODE_CODE128, "out.png", 2, "1234", "", ZINT_ERROR_MEMORY }, // Fail output only
+        /*11*/ { BARCODE_GS1_128_CC, "out.png", 0, "[20]12", "[01]12345678901231", 0 }, // Linear dummy run and linear component
+        /*12*/ { BARCODE_EANX_CC, "out.svg", 0, "[20]12", "1234567", 0 },
+        /*13*/ { BARCODE_DBAR_EXP_CC, "out.eps", 0, "[20]12", "[01]12345678901231[10]ABC", 0 }, // Linear component uses scratch
+        /*14*/ { BARCODE_GS1_128_CC, "out.png", 1, "[20]12", "[01]12345678901231", ZINT_ERROR_MEMORY },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct test_allocator_counts counts;
+    struct zint_allocator allocator = { test_allocator_malloc, test_allocator_realloc, test_allocator_free, &counts };
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        memset(&counts, 0, sizeof(counts));
+        counts.fail = data[i].fail == 1;
+
+        ret = ZBarcode_SetAllocator(symbol, &allocator);
+        assert_zero(ret, "i:%d ZBarcode_SetAllocator ret %d != 0\n", i, ret);
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, BARCODE_MEMORY_FILE, data[i].data, -1, debug);
+        strcpy(symbol->outfile, data[i].outfile);
+        strcpy(symbol->primary, data[i].primary);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        if (data[i].fail == 2) {
+            assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            counts.fail = 1;
+            ret = ZBarcode_Buffer(symbol, 0);
+            assert_nonzero(ret >= ZINT_ERROR, "i:%d ZBarcode_Buffer ret %d < ZINT_ERROR\n", i, ret);
+            ret = ZBarcode_Buffer_Vector(symbol, 0);
+        } else if (ret < ZINT_ERROR) {
+            ret = ZBarcode_Print(symbol, 0);
+            assert_zero(ret, "i:%d ZBarcode_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+
+            ret = ZBarcode_Buffer(symbol, 0);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            ret = ZBarcode_Buffer_Vector(symbol, 0);
+            assert_zero(ret, "i:%d ZBarcode_Buffer_Vector ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            assert_nonzero(counts.allocs, "i:%d no allocs\n", i);
+        }
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        ZBarcode_Delete(symbol);
+
+        assert_equal(counts.allocs, counts.frees, "i:%d allocs %d != frees %d\n", i, counts.allocs, counts.frees);
+    }
+
+    testFinish();
+}
+
+static void test_allocator_set(void) {
+
+    testStart("");
+
+    int ret;
+    struct test_allocator_counts counts = {0};
+    struct zint_allocator allocator = { test_allocator_malloc, test_allocator_realloc, NULL, &counts };
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+
+    ret = ZBarcode_SetAllocator(NULL, NULL);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_SetAllocator(NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+
+    ret = ZBarcode_SetAllocator(symbol, &allocator);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_SetAllocator(no free) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    assert_zero(strcmp(symbol->errtxt, "Error 264: Allocator requires malloc, realloc and free functions"), "errtxt %s wrong\n", symbol->errtxt);
+
+    /* Switching frees what was allocated with the previous allocator */
+    allocator.free_fn = test_allocator_free;
+    ret = ZBarcode_SetAllocator(symbol, &allocator);
+    assert_zero(ret, "ZBarcode_SetAllocator ret %d != 0\n", ret);
+
+    ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) "1234", 0, 0);
+    assert_zero(ret, "ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", ret, symbol->errtxt);
+    assert_nonzero(counts.allocs, "no allocs\n");
+
+    ret = ZBarcode_SetAllocator(symbol, NULL);
+    assert_zero(ret, "ZBarcode_SetAllocator(NULL) ret %d != 0\n", ret);
+    assert_equal(counts.allocs, counts.frees, "allocs %d != frees %d\n", counts.allocs, counts.frees);
+    assert_null(symbol->bitmap, "bitmap not NULL\n");
+
+    ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) "1234", 0, 0);
+    assert_zero(ret, "ZBarcode_Encode_and_Buffer (system) ret %d != 0 (%s)\n", ret, symbol->errtxt);
+    assert_equal(counts.allocs, counts.frees, "allocs %d != frees %d after reset\n", counts.allocs, counts.frees);
+
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
+static void test_encode_spans(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *spans[3];
+        int lengths[3];
+        int count;
+        char *expected;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, -1, { "1234" }, { -1 }, 1, "1234", 0, "" },
+        /* 1*/ { BARCODE_CODE128, -1, { "AB", "CD", "12" }, { -1, -1, -1 }, 3, "ABCD12", 0, "" },
+        /* 2*/ { BARCODE_CODE128, -1, { "ABXX", "CD" }, { 2, 0 }, 2, "ABCD", 0, "" }, // Length used, 0 NUL-terminated
+        /* 3*/ { BARCODE_QRCODE, -1, { "HDR:", "body", "" }, { -1, -1, -1 }, 3, "HDR:body", 0, "" },
+        /* 4*/ { BARCODE_GS1_128, GS1_MODE, { "[01]12345678901231", "[10]", "ABC" }, { -1, -1, -1 }, 3, "[01]12345678901231[10]ABC", 0, "" },
+        /* 5*/ { BARCODE_CODE128, -1, { "AB", NULL }, { -1, -1 }, 2, NULL, ZINT_ERROR_INVALID_DATA, "Error 266: Span 1 data NULL" },
+        /* 6*/ { BARCODE_CODE128, -1, { "AB" }, { -1 }, 0, NULL, ZINT_ERROR_INVALID_DATA, "Error 265: Spans NULL or count 0 not in range 1 to 256" },
+        /* 7*/ { BARCODE_EANX, -1, { "12", "A" }, { -1, -1 }, 2, "12A", ZINT_ERROR_INVALID_DATA, "Error 284: Invalid characters in data" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        struct zint_symbol *expected = ZBarcode_Create();
+        assert_nonnull(expected, "Symbol not created\n");
+
+        struct zint_span spans[3];
+        for (int j = 0; j < data[i].count; j++) {
+            spans[j].source = (const unsigned char *) data[i].spans[j];
+            spans[j].length = data[i].lengths[j];
+        }
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, "", 0, debug);
+
+        ret = ZBarcode_Encode_Spans(symbol, spans, data[i].count);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode_Spans ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        if (ret) {
+            assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt %s != %s\n", i, symbol->errtxt, data[i].expected_errtxt);
+        }
+
+        if (ret < ZINT_ERROR) {
+            /* Result must be same as encoding the concatenated data */
+            int length = testUtilSetSymbol(expected, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].expected, -1, debug);
+            ret = ZBarcode_Encode(expected, (unsigned char *) data[i].expected, length);
+            assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, expected->errtxt);
+            ret = testUtilSymbolCmp(symbol, expected);
+            assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
+            assert_zero(strcmp((char *) symbol->text, (char *) expected->text), "i:%d text %s != %s\n", i, symbol->text, expected->text);
+        }
+
+        ZBarcode_Delete(expected);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_encode_file(void) {
+
+    testStart("");
+
+    int ret;
+    char filename[] = "in.bin";
+    char data[] = "1234567890ABCDEFGHIJ";
+    FILE *fp;
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+    struct zint_symbol *expected = ZBarcode_Create();
+    assert_nonnull(expected, "Symbol not created\n");
+    symbol->symbology = expected->symbology = BARCODE_QRCODE;
+
+    (void)remove(filename); // In case junk hanging around
+    fp = fopen(filename, "wb");
+    assert_nonnull(fp, "fopen(%s) failed\n", filename);
+    assert_equal((int) fwrite(data, 1, strlen(data), fp), (int) strlen(data), "fwrite(%s) failed\n", filename);
+    assert_zero(fclose(fp), "fclose(%s) != 0\n", filename);
+
+    ret = ZBarcode_Encode_File(symbol, filename);
+    assert_zero(ret, "ZBarcode_Encode_File ret %d != 0 (%s)\n", ret, symbol->errtxt);
+
+    ret = ZBarcode_Encode(expected, (unsigned char *) data, (int) strlen(data));
+    assert_zero(ret, "ZBarcode_Encode ret %d != 0 (%s)\n", ret, expected->errtxt);
+    ret = testUtilSymbolCmp(symbol, expected);
+    assert_zero(ret, "testUtilSymbolCmp ret %d != 0\n", ret);
+
+    assert_zero(remove(filename), "remove(%s) != 0\n", filename);
+
+    ZBarcode_Delete(expected);
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
 // #181 Nico Gunkel OSS-Fuzz
 static void test_encode_file_zero_length(void) {
 
@@ -425,6 +1097,15 @@ int main(int argc, char *argv[]) {
         { "test_input_mode", test_input_mode, 1, 0, 1 },
         { "test_escape_char_process", test_escape_char_process, 1, 1, 1 },
         { "test_cap", test_cap, 1, 0, 0 },
+        { "test_threads", test_threads, 1, 0, 1 },
+        { "test_memfile", test_memfile, 1, 0, 1 },
+        { "test_sheet", test_sheet, 1, 0, 1 },
+        { "test_cache", test_cache, 1, 0, 1 },
+        { "test_scratch", test_scratch, 1, 0, 1 },
+        { "test_allocator", test_allocator, 1, 0, 1 },
+        { "test_allocator_set", test_allocator_set, 0, 0, 0 },
+        { "test_encode_spans", test_encode_spans, 1, 0, 1 },
+        { "test_encode_file", test_encode_file, 0, 0, 0 },
         { "test_encode_file_zero_length", test_encode_file_zero_length, 0, 0, 0 },
         { "test_encode_file_directory", test_encode_file_directory, 0, 0, 0 },
         { "test_bad_args", test_bad_args, 0, 0, 0 },
@@ -254,6 +254,76 @@ static void test_input(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_optimal(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int eci;
+        char *data;
+        int ret;
+        int expected_rows;
+        int expected_width;
+        char *expected;
+        char *comment;
+    };
+    // é U+00E9 (\351, 233), UTF-8 C3A9
+    struct item data[] = {
+        /*  0*/ { BARCODE_PDF417, UNICODE_MODE, -1, "12345", 0, 6, 103, "(12) 4 841 63 125 469 610 291 696 470 11 488 173", "Text Mixed (same length as Numeric, default)" },
+        /*  1*/ { BARCODE_PDF417, UNICODE_MODE, -1, "ABCDEFabcdef", 0, 8, 103, "(16) 8 1 63 125 810 32 94 179 796 5 111 208 246 453 387 282", "Text Alpha ... ll abcdef (same as default)" },
+        /*  2*/ { BARCODE_PDF417, UNICODE_MODE, -1, "AB{}  C#+  de{}  {}F  12{}  G{}  H", 0, 11, 120, "(33) 25 1 896 897 806 88 470 836 783 148 776 839 806 896 897 176 808 32 776 839 806 209 809", "Text throughout, using ps shifts rather than latches to Punctuation (default 3 data codewords longer)" },
+        /*  3*/ { BARCODE_PDF417, UNICODE_MODE, -1, "1234567890123", 0, 8, 103, "(16) 8 902 17 110 836 811 223 900 261 25 489 400 886 315 34 673", "Numeric (same as default)" },
+        /*  4*/ { BARCODE_PDF417, DATA_MODE, -1, "\001\002ABC\001", 0, 8, 103, "(16) 8 924 1 621 478 271 37 900 153 573 701 77 719 401 474 262", "Byte 6 (same as default)" },
+        /*  5*/ { BARCODE_PDF417, DATA_MODE, -1, "\141\142\351\351\351\351\143\144", 0, 9, 103, "(18) 10 810 59 924 391 899 481 476 36 900 834 261 738 199 294 919 309 505", "Text ab, Byte 924 éééécd (default Byte 901 éééé, Text cd 2 codewords longer)" },
+        /*  6*/ { BARCODE_PDF417, UNICODE_MODE, 3, "é", 0, 7, 103, "(14) 6 927 3 913 233 900 162 81 551 529 607 384 164 108", "ECI, Byte Shift (same as default)" },
+        /*  7*/ { BARCODE_PDF417, UNICODE_MODE, -1, "a1b2c3d4e5f6", 0, 7, 120, "(21) 13 924 162 790 763 812 339 167 833 298 772 582 900 467 108 236 864 764 227 679 297", "Byte 924 (same length as default Text)" },
+        /*  8*/ { BARCODE_MICROPDF417, UNICODE_MODE, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLM", 0, 17, 55, "(34) 900 1 63 125 187 249 311 373 435 497 559 621 683 745 1 63 125 187 249 311 389 900 900", "Text Alpha (same as default)" },
+        /*  9*/ { BARCODE_MICROPDF417, UNICODE_MODE, -1, "é", 0, 11, 38, "(11) 901 233 900 900 310 142 569 141 677 300 494", "Byte 901 (Byte is initial mode, default 913 Byte Shift only valid in Text)" },
+        /* 10*/ { BARCODE_MICROPDF417, UNICODE_MODE, -1, "1234567890ab", 0, 8, 55, "(16) 900 841 63 125 187 249 27 1 541 170 915 860 150 381 635 251", "Text Mixed 1234567890 ll ab (default Numeric, Text 1 data codeword longer)" },
+        /* 11*/ { BARCODE_PDF417, DATA_MODE, -1, "1234567890123\200", 0, 9, 103, "(18) 10 902 17 110 836 811 223 901 128 900 158 618 309 151 456 747 145 858", "Numeric, Byte 901 (not 913 Byte Shift, only valid in Text)" },
+        /* 12*/ { BARCODE_PDF417, DATA_MODE, -1, "AB\2001234567890123\200CD", 0, 8, 120, "(24) 16 1 913 128 902 17 110 836 811 223 901 128 900 63 900 900 395 624 421 322 625 381 16", "Text AB, Byte Shift, Numeric, Byte 901, Text CD" },
+        /* 13*/ { BARCODE_MICROPDF417, DATA_MODE, -1, "1234567890123\200", 0, 8, 55, "(16) 902 17 110 836 811 223 901 128 197 511 33 489 196 28 720 822", "Numeric, Byte 901" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char escaped[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->debug = ZINT_DEBUG_TEST; // Needed to get codeword dump in errtxt
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, data[i].eci, -1 /*option_1*/, -1, PDF_OPTIMAL, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, %d, \"%s\", %s, %d, %d, \"%s\", \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode), data[i].eci,
+                    testUtilEscape(data[i].data, length, escaped, sizeof(escaped)),
+                    testUtilErrorName(data[i].ret), symbol->rows, symbol->width, symbol->errtxt, data[i].comment);
+        } else {
+            if (ret < 5) {
+                assert_equal(symbol->rows, data[i].expected_rows, "i:%d symbol->rows %d != %d (%s)\n", i, symbol->rows, data[i].expected_rows, data[i].data);
+                assert_equal(symbol->width, data[i].expected_width, "i:%d symbol->width %d != %d (%s)\n", i, symbol->width, data[i].expected_width, data[i].data);
+            }
+            assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_encode(int index, int generate, int debug) {
 
     testStart("");
@@ -1177,6 +1247,7 @@ int main(int argc, char *argv[]) {
         { "test_options", test_options, 1, 0, 1 },
         { "test_reader_init", test_reader_init, 1, 1, 1 },
         { "test_input", test_input, 1, 1, 1 },
+        { "test_optimal", test_optimal, 1, 1, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
         { "test_fuzz", test_fuzz, 1, 0, 1 },
         { "test_perf", test_perf, 1, 0, 1 },
@@ -114,7 +114,7 @@ static void test_print(int index, int generate, int debug) {
             ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
             assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
 
-            strcpy(symbol->outfile, "out.");
+            strcpy(symbol->outfile, "test_print.");
             strcat(symbol->outfile, exts[j]);
 
             strcpy(expected_file, data_dir);
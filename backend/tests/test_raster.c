@@ -804,8 +804,10 @@ static void test_draw_string_wrap(int index, int debug) {
 
         if (index != -1 && (debug & ZINT_DEBUG_TEST_PRINT)) testUtilBitmapPrint(symbol, NULL, NULL);
 
+        strcpy(symbol->outfile, "test_raster.png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         int text_bits_set = 0;
         int row = data[i].expected_no_text_row;
@@ -870,8 +872,10 @@ static void test_code128_utf8(int index, int debug) {
 
         if (index != -1 && (debug & ZINT_DEBUG_TEST_PRINT)) testUtilBitmapPrint(symbol, NULL, NULL);
 
+        strcpy(symbol->outfile, "test_raster.png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, BARCODE_CODE128, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         int text_bits_set = 0;
         int row = data[i].expected_text_row;
@@ -980,8 +984,10 @@ static void test_scale(int index, int debug) {
         assert_equal(symbol->bitmap_width, data[i].expected_bitmap_width, "i:%d (%d) symbol->bitmap_width %d != %d\n", i, data[i].symbology, symbol->bitmap_width, data[i].expected_bitmap_width);
         assert_equal(symbol->bitmap_height, data[i].expected_bitmap_height, "i:%d (%d) symbol->bitmap_height %d != %d\n", i, data[i].symbology, symbol->bitmap_height, data[i].expected_bitmap_height);
 
+        strcpy(symbol->outfile, "test_raster.png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         assert_nonzero(symbol->bitmap_height >= data[i].expected_set_rows, "i:%d (%d) symbol->bitmap_height %d < expected_set_rows %d\n",
                 i, data[i].symbology, symbol->bitmap_height, data[i].expected_set_rows);
@@ -1185,6 +1191,180 @@ static void test_buffer_plot(int index, int generate, int debug) {
     testFinish();
 }
 
+/* Expected byte `byte` of pixel `x`, `y` of format `format` given reference RGB `bitmap`, `alphamap` (if any) and
+   OUT_BUFFER_INTERMEDIATE `inter` renderings, or for ZINT_PIXEL_MONO1 the expected bit */
+static int buffer_into_expected(int format, const unsigned char *bitmap, const unsigned char *alphamap,
+            const unsigned char *inter, int bitmap_width, int x, int y, int byte) {
+    int p = y * bitmap_width + x;
+    const unsigned char *rgb = bitmap + p * 3;
+    int alpha = alphamap ? alphamap[p] : 0xFF;
+    const char *palette = "01WCBMRYGK";
+
+    switch (format) {
+        case ZINT_PIXEL_MONO1:
+            return inter[p] != '0' && inter[p] != 'W';
+        case ZINT_PIXEL_GRAY8:
+            return (77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8;
+        case ZINT_PIXEL_PALETTE8:
+            return (int) (strchr(palette, inter[p]) - palette);
+        case ZINT_PIXEL_RGB24:
+            return rgb[byte];
+        case ZINT_PIXEL_RGBA32:
+            return byte == 3 ? alpha : rgb[byte];
+        case ZINT_PIXEL_RGBA32_PRE:
+            return byte == 3 ? alpha : (rgb[byte] * alpha + 127) / 255;
+        case ZINT_PIXEL_BGRA32_PRE:
+            return byte == 3 ? alpha : (rgb[2 - byte] * alpha + 127) / 255;
+    }
+    return -1;
+}
+
+static void test_buffer_into(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *fgcolour;
+        char *bgcolour;
+        int rotate_angle;
+        int format;
+        int extra_width; /* Added to symbol bitmap width to give pixel buffer width */
+        int extra_height;
+        int extra_stride; /* Row padding in bytes */
+        int x;
+        int y;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_RGB24, 0, 0, 0, 0, 0, 0, "" },
+        /*  1*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_RGBA32, 0, 0, 0, 0, 0, 0, "" },
+        /*  2*/ { BARCODE_CODE128, "112233", "445566", 0, ZINT_PIXEL_RGB24, 7, 5, 3, 4, 2, 0, "" },
+        /*  3*/ { BARCODE_CODE128, "11223344", "55667788", 90, ZINT_PIXEL_RGBA32, 3, 3, 8, 3, 3, 0, "" },
+        /*  4*/ { BARCODE_QRCODE, "", "FFFFFF00", 180, ZINT_PIXEL_RGBA32, 1, 1, 0, 1, 0, 0, "" },
+        /*  5*/ { BARCODE_ULTRA, "", "", 270, ZINT_PIXEL_RGB24, 0, 0, 1, 0, 0, 0, "" },
+        /*  6*/ { BARCODE_MAXICODE, "", "", 0, ZINT_PIXEL_RGBA32, 0, 0, 0, 0, 0, 0, "" },
+        /*  7*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_MONO1, 0, 0, 0, 0, 0, 0, "" },
+        /*  8*/ { BARCODE_CODE128, "", "", 90, ZINT_PIXEL_MONO1, 13, 2, 1, 5, 1, 0, "" },
+        /*  9*/ { BARCODE_ULTRA, "", "", 0, ZINT_PIXEL_MONO1, 9, 0, 0, 3, 0, 0, "" },
+        /* 10*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_GRAY8, 0, 0, 0, 0, 0, 0, "" },
+        /* 11*/ { BARCODE_QRCODE, "3366CC", "FFCC99", 0, ZINT_PIXEL_GRAY8, 2, 2, 5, 1, 1, 0, "" },
+        /* 12*/ { BARCODE_CODE128, "11223380", "FFFFFF40", 0, ZINT_PIXEL_RGBA32_PRE, 0, 0, 0, 0, 0, 0, "" },
+        /* 13*/ { BARCODE_QRCODE, "11223380", "FFEEDD00", 180, ZINT_PIXEL_RGBA32_PRE, 4, 4, 4, 2, 2, 0, "" },
+        /* 14*/ { BARCODE_CODE128, "11223380", "FFEEDDC0", 0, ZINT_PIXEL_BGRA32_PRE, 0, 0, 0, 0, 0, 0, "" },
+        /* 15*/ { BARCODE_MAXICODE, "112233", "", 90, ZINT_PIXEL_BGRA32_PRE, 1, 2, 0, 1, 2, 0, "" },
+        /* 16*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_PALETTE8, 0, 0, 0, 0, 0, 0, "" },
+        /* 17*/ { BARCODE_ULTRA, "", "", 90, ZINT_PIXEL_PALETTE8, 3, 3, 3, 1, 2, 0, "" },
+        /* 18*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_RGB24, 0, 0, 0, 1, 0, ZINT_ERROR_INVALID_OPTION, "Error 666: Symbol does not fit in pixel buffer" },
+        /* 19*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_RGB24, 2, 2, 0, -1, 0, ZINT_ERROR_INVALID_OPTION, "Error 666: Symbol does not fit in pixel buffer" },
+        /* 20*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_MONO1, 0, -1, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 666: Symbol does not fit in pixel buffer" },
+        /* 21*/ { BARCODE_CODE128, "", "", 45, ZINT_PIXEL_RGB24, 0, 0, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 294: Invalid rotation angle" },
+        /* 22*/ { BARCODE_CODE128, "", "", 0, 0, 0, 0, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 296: Unknown pixel buffer format" },
+        /* 23*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_PALETTE8 + 1, 0, 0, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 296: Unknown pixel buffer format" },
+        /* 24*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_RGBA32, 0, 0, -1, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 297: Invalid pixel buffer" },
+        /* 25*/ { BARCODE_CODE128, "", "", 0, ZINT_PIXEL_MONO1, 0, 0, -1, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 297: Invalid pixel buffer" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if (debug & ZINT_DEBUG_TEST_PRINT) printf("i:%d\n", i);
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, UNICODE_MODE, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, "1234", -1, debug);
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (*data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+        int rotate_angle = data[i].rotate_angle % 90 ? 0 : data[i].rotate_angle;
+
+        /* Reference renderings */
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) "1234", length, rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        int bitmap_width = symbol->bitmap_width;
+        int bitmap_height = symbol->bitmap_height;
+        size_t pixels = (size_t) bitmap_width * bitmap_height;
+        unsigned char *bitmap = (unsigned char *) malloc(pixels * 3);
+        assert_nonnull(bitmap, "i:%d malloc bitmap failed\n", i);
+        memcpy(bitmap, symbol->bitmap, pixels * 3);
+        unsigned char *alphamap = NULL;
+        if (symbol->alphamap) {
+            alphamap = (unsigned char *) malloc(pixels);
+            assert_nonnull(alphamap, "i:%d malloc alphamap failed\n", i);
+            memcpy(alphamap, symbol->alphamap, pixels);
+        }
+        symbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+        ret = ZBarcode_Buffer(symbol, rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        unsigned char *inter = (unsigned char *) malloc(pixels);
+        assert_nonnull(inter, "i:%d malloc inter failed\n", i);
+        memcpy(inter, symbol->bitmap, pixels);
+        symbol->output_options &= ~OUT_BUFFER_INTERMEDIATE;
+
+        int is_mono = data[i].format == ZINT_PIXEL_MONO1;
+        int pixel_size = data[i].format == ZINT_PIXEL_RGB24 ? 3 : data[i].format == ZINT_PIXEL_GRAY8 || data[i].format == ZINT_PIXEL_PALETTE8 || is_mono ? 1 : 4;
+        struct zint_pixbuf dst;
+        dst.width = bitmap_width + data[i].extra_width;
+        dst.height = bitmap_height + data[i].extra_height;
+        dst.stride = (is_mono ? (dst.width + 7) / 8 : dst.width * pixel_size) + data[i].extra_stride;
+        dst.format = data[i].format;
+        size_t size = (size_t) (dst.stride > 0 ? dst.stride : 1) * dst.height;
+        dst.pixels = (unsigned char *) malloc(size);
+        assert_nonnull(dst.pixels, "i:%d malloc pixels failed\n", i);
+        memset(dst.pixels, 0xAB, size);
+
+        ret = ZBarcode_Buffer_Into(symbol, data[i].rotate_angle, &dst, data[i].x, data[i].y);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Buffer_Into ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt %s != %s\n", i, symbol->errtxt, data[i].expected_errtxt);
+
+        if (ret == 0 || strncmp(symbol->errtxt, "Error 666", 9) == 0) {
+            /* Rendered, size set even if doesn't fit */
+            assert_null(symbol->bitmap, "i:%d bitmap not NULL\n", i);
+            assert_equal(symbol->bitmap_width, bitmap_width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, bitmap_width);
+            assert_equal(symbol->bitmap_height, bitmap_height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, bitmap_height);
+        }
+
+        if (ret == 0) {
+            for (int row = 0; row < dst.height; row++) {
+                int y = row - data[i].y;
+                for (int column = 0; column < dst.stride * (is_mono ? 8 : 1); column++) {
+                    /* For MONO1 `column` counts bits */
+                    int x = column / pixel_size - data[i].x;
+                    int got, expected;
+                    if (is_mono) {
+                        got = dst.pixels[row * dst.stride + column / 8];
+                        got = (got >> (7 - column % 8)) & 1;
+                    } else {
+                        got = dst.pixels[row * dst.stride + column];
+                    }
+                    if (x < 0 || y < 0 || x >= bitmap_width || y >= bitmap_height) {
+                        expected = is_mono ? (0xAB >> (7 - column % 8)) & 1 : 0xAB; /* Untouched */
+                    } else {
+                        expected = buffer_into_expected(data[i].format, bitmap, alphamap, inter, bitmap_width, x, y, column % pixel_size);
+                    }
+                    assert_equal(got, expected, "i:%d row %d column %d 0x%02X != 0x%02X\n", i, row, column, got, expected);
+                }
+            }
+        }
+
+        free(bitmap);
+        free(alphamap);
+        free(inter);
+        free(dst.pixels);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -1198,6 +1378,7 @@ int main(int argc, char *argv[]) {
         { "test_code128_utf8", test_code128_utf8, 1, 0, 1 },
         { "test_scale", test_scale, 1, 0, 1 },
         { "test_buffer_plot", test_buffer_plot, 1, 1, 1 },
+        { "test_buffer_into", test_buffer_into, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
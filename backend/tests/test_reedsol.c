@@ -195,7 +195,7 @@ static void test_encoding_uint(int index) {
 
         if (index != -1 && i != index) continue;
 
-        rs_uint_init_gf(&rs_uint, data[i].prime_poly, data[i].logmod);
+        assert_nonzero(rs_uint_init_gf(&rs_uint, NULL /*symbol*/, data[i].prime_poly, data[i].logmod), "i:%d rs_uint_init_gf() fail\n", i);
         rs_uint_init_code(&rs_uint, data[i].nsym, data[i].index);
         rs_uint_encode(&rs_uint, data[i].datalen, data[i].data, res);
         rs_uint_free(&rs_uint);
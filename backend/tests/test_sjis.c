@@ -32,6 +32,7 @@
 #include "testcommon.h"
 #include "test_sjis_tab.h"
 #include "../sjis.h"
+#include "../scratch.h"
 
 // As control convert to Shift JIS using simple table generated from https://www.unicode.org/Public/MAPPINGS/OBSOLETE/EASTASIA/JIS/SHIFTJIS.TXT plus simple processing
 static int sjis_wctomb_zint2(unsigned int *r, unsigned int wc) {
@@ -144,6 +145,8 @@ static void test_sjis_utf8tomb(int index) {
     struct zint_symbol symbol;
     unsigned int jisdata[20];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -161,6 +164,8 @@ static void test_sjis_utf8tomb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
@@ -208,8 +213,11 @@ static void test_sjis_utf8tosb(int index) {
 
     int data_size = sizeof(data) / sizeof(struct item);
 
+    struct zint_symbol symbol;
     unsigned int jisdata[20];
 
+    memset(&symbol, 0, sizeof(symbol));
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -217,7 +225,7 @@ static void test_sjis_utf8tosb(int index) {
         int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
         int ret_length = length;
 
-        ret = sjis_utf8tosb(data[i].eci, (unsigned char *) data[i].data, &ret_length, jisdata, data[i].full_multibyte);
+        ret = sjis_utf8tosb(&symbol, data[i].eci, (unsigned char *) data[i].data, &ret_length, jisdata, data[i].full_multibyte);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
         if (ret == 0) {
             assert_equal(ret_length, data[i].ret_length, "i:%d ret_length %d != %d\n", i, ret_length, data[i].ret_length);
@@ -227,6 +235,8 @@ static void test_sjis_utf8tosb(int index) {
         }
     }
 
+    scratch_free(&symbol);
+
     testFinish();
 }
 
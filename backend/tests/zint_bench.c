@@ -0,0 +1,591 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Micro-benchmarks of encoding and output for each symbology, writing CSV or JSON results (see README) */
+
+#include "testcommon.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/* Monotonic time in nanoseconds */
+static double bench_now(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1e9 / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+#endif
+}
+
+#define BENCH_MAX_REPS  1000
+
+/* Payloads */
+#define BENCH_SMALL     0
+#define BENCH_MEDIUM    1
+#define BENCH_MAX       2
+
+static const char *payload_names[] = { "small", "medium", "max" };
+static const int payload_targets[] = { 8, 64, 0 /*As long as accepted*/ };
+
+/* Outputs */
+#define BENCH_ENCODE    0
+#define BENCH_BUFFER    1
+#define BENCH_VECTOR    2
+#define BENCH_INTO      3
+#define BENCH_PRINT     4 /* Files from here on, in memory */
+
+static const char *output_names[] = {
+    "encode", "buffer", "vector", "into", "png", "gif", "tif", "bmp", "pcx", "svg", "eps", "emf"
+};
+#define BENCH_OUTPUTS   ((int) ARRAY_SIZE(output_names))
+
+/* Kinds of generated data tried in turn until one is accepted */
+#define GEN_DIGITS      0
+#define GEN_GS1         1 /* AIs (91) to (99) of digits */
+#define GEN_LETTERS     2
+#define GEN_FRAMED      3 /* Digits between start/stop "A" and "B" */
+#define GEN_LITERAL     4
+
+/* Data no generator manages */
+static const struct { int symbology; const char *data; } literals[] = {
+    { BARCODE_UPCE_CHK, "12345670" },
+    { BARCODE_MAILMARK, "1100000000000XY11" },
+};
+
+/* Linear parts of composites */
+static const struct { int symbology; const char *primary; } primaries[] = {
+    { BARCODE_EANX_CC, "331234567890" },
+    { BARCODE_GS1_128_CC, "[01]12345678901231" },
+    { BARCODE_DBAR_OMN_CC, "1234567890123" },
+    { BARCODE_DBAR_LTD_CC, "1234567890123" },
+    { BARCODE_DBAR_EXP_CC, "[01]12345678901231" },
+    { BARCODE_UPCA_CC, "12345678901" },
+    { BARCODE_UPCE_CC, "1234567" },
+    { BARCODE_DBAR_STK_CC, "1234567890123" },
+    { BARCODE_DBAR_OMNSTK_CC, "1234567890123" },
+    { BARCODE_DBAR_EXPSTK_CC, "[01]12345678901231" },
+};
+
+struct bench_symbol {
+    int symbology;
+    int gen;
+    int input_mode;
+    const char *primary;
+    int min_length; /* Shortest accepted */
+    int max_length; /* Longest accepted, 0 if not yet known */
+};
+
+/* Generate `length` characters of data of kind `gen` into `buf`, returning its length, which for GEN_GS1,
+   GEN_FRAMED and GEN_LITERAL differs */
+static int bench_generate(const struct bench_symbol *bs, int length, char *buf) {
+    int i, len = 0;
+
+    switch (bs->gen) {
+        case GEN_DIGITS:
+            for (i = 0; i < length; i++) {
+                buf[len++] = '0' + (i + 1) % 10;
+            }
+            break;
+        case GEN_GS1:
+            /* `length` digits split into AIs of up to 90 */
+            for (i = 0; i < length; i++) {
+                if (i % 90 == 0) {
+                    len += sprintf(buf + len, "[9%d]", 1 + (i / 90) % 9);
+                }
+                buf[len++] = '0' + (i + 1) % 10;
+            }
+            break;
+        case GEN_LETTERS:
+            for (i = 0; i < length; i++) {
+                buf[len++] = "ADFT"[i % 4];
+            }
+            break;
+        case GEN_FRAMED:
+            buf[len++] = 'A';
+            for (i = 0; i < length; i++) {
+                buf[len++] = '0' + (i + 1) % 10;
+            }
+            buf[len++] = 'B';
+            break;
+        default: /* GEN_LITERAL */
+            for (i = 0; i < (int) ARRAY_SIZE(literals); i++) {
+                if (literals[i].symbology == bs->symbology) {
+                    len = (int) strlen(literals[i].data);
+                    memcpy(buf, literals[i].data, len);
+                    break;
+                }
+            }
+            break;
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+/* Set up `symbol` for `bs` */
+static void bench_setup(struct zint_symbol *symbol, const struct bench_symbol *bs) {
+    symbol->symbology = bs->symbology;
+    symbol->input_mode = bs->input_mode;
+    symbol->eci = 0; /* Set by UPNQR when encoding */
+    if (bs->primary) {
+        strcpy(symbol->primary, bs->primary);
+    }
+}
+
+/* Whether data of `length` is accepted */
+static int bench_accepted(struct zint_symbol *symbol, const struct bench_symbol *bs, int length, char *buf) {
+    int len = bench_generate(bs, length, buf);
+    int ret;
+
+    ZBarcode_Clear(symbol);
+    bench_setup(symbol, bs);
+    ret = ZBarcode_Encode(symbol, (unsigned char *) buf, len);
+    return ret < ZINT_ERROR;
+}
+
+/* Find a kind of data accepted by `bs->symbology` and its shortest length, returning 0 if none */
+static int bench_find_data(struct zint_symbol *symbol, struct bench_symbol *bs, char *buf) {
+    int i, length;
+
+    bs->primary = NULL;
+    for (i = 0; i < (int) ARRAY_SIZE(primaries); i++) {
+        if (primaries[i].symbology == bs->symbology) {
+            bs->primary = primaries[i].primary;
+        }
+    }
+    for (bs->gen = GEN_DIGITS; bs->gen <= GEN_LITERAL; bs->gen++) {
+        bs->input_mode = bs->gen == GEN_GS1 ? GS1_MODE : UNICODE_MODE;
+        if (bs->gen == GEN_LITERAL) {
+            if (bench_accepted(symbol, bs, 0, buf)) {
+                bs->min_length = bs->max_length = 1;
+                return 1;
+            }
+            break;
+        }
+        for (length = 1; length <= 48; length++) {
+            if (bench_accepted(symbol, bs, length, buf)) {
+                bs->min_length = length;
+                bs->max_length = 0;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Find the longest accepted length, doubling then bisecting */
+static void bench_find_max(struct zint_symbol *symbol, struct bench_symbol *bs, char *buf) {
+    int lo = bs->min_length, hi, mid;
+    const int limit = bs->gen == GEN_GS1 ? ZINT_MAX_FILE_LEN * 90 / 94 : ZINT_MAX_FILE_LEN;
+
+    if (bs->max_length) {
+        return;
+    }
+    for (hi = lo * 2; hi <= limit && bench_accepted(symbol, bs, hi, buf); hi *= 2) {
+        lo = hi;
+    }
+    if (hi > limit) {
+        hi = limit + 1;
+    }
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (bench_accepted(symbol, bs, mid, buf)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    bs->max_length = lo;
+}
+
+/* Length for `payload`, the accepted length nearest below its target */
+static int bench_payload_length(struct zint_symbol *symbol, struct bench_symbol *bs, int payload, char *buf) {
+    int length;
+
+    if (bs->gen == GEN_LITERAL) {
+        return 0;
+    }
+    if (payload != BENCH_SMALL) {
+        bench_find_max(symbol, bs, buf);
+    }
+    if (payload == BENCH_MAX) {
+        return bs->max_length;
+    }
+    length = payload_targets[payload];
+    if (bs->max_length && length > bs->max_length) {
+        length = bs->max_length;
+    }
+    for (; length > bs->min_length; length--) {
+        if (bench_accepted(symbol, bs, length, buf)) {
+            return length;
+        }
+    }
+    return bs->min_length;
+}
+
+struct bench_case {
+    struct zint_symbol *symbol;
+    const struct bench_symbol *bs;
+    int output;
+    const char *data;
+    int length;
+    struct zint_pixbuf pixbuf;
+};
+
+/* Run the case once, returning the zint result */
+static int bench_run(struct bench_case *bc) {
+    struct zint_symbol *symbol = bc->symbol;
+
+    switch (bc->output) {
+        case BENCH_ENCODE:
+            ZBarcode_Clear(symbol);
+            bench_setup(symbol, bc->bs);
+            return ZBarcode_Encode(symbol, (const unsigned char *) bc->data, bc->length);
+        case BENCH_BUFFER:
+            return ZBarcode_Buffer(symbol, 0);
+        case BENCH_VECTOR:
+            return ZBarcode_Buffer_Vector(symbol, 0);
+        case BENCH_INTO:
+            return ZBarcode_Buffer_Into(symbol, 0, &bc->pixbuf, 0, 0);
+    }
+    return ZBarcode_Print(symbol, 0);
+}
+
+struct bench_result {
+    int iterations;
+    int reps;
+    double min, median, mean, max; /* Nanoseconds per run */
+};
+
+static int bench_cmp(const void *a, const void *b) {
+    const double da = *(const double *) a, db = *(const double *) b;
+    return da < db ? -1 : da > db;
+}
+
+/* Time the case, returning 0 if it failed */
+static int bench_time(struct bench_case *bc, int warmup, int reps, int iterations, double target,
+            struct bench_result *result) {
+    static double samples[BENCH_MAX_REPS];
+    double start, elapsed, total = 0.0;
+    int i, j;
+
+    for (i = 0; i < warmup; i++) {
+        if (bench_run(bc) >= ZINT_ERROR) {
+            return 0;
+        }
+    }
+    if (iterations <= 0) {
+        /* Calibrate so that a repetition takes at least `target` */
+        for (iterations = 1; ; iterations *= 2) {
+            start = bench_now();
+            for (j = 0; j < iterations; j++) {
+                if (bench_run(bc) >= ZINT_ERROR) {
+                    return 0;
+                }
+            }
+            if (bench_now() - start >= target || iterations >= 1 << 20) {
+                break;
+            }
+        }
+    }
+
+    for (i = 0; i < reps; i++) {
+        start = bench_now();
+        for (j = 0; j < iterations; j++) {
+            if (bench_run(bc) >= ZINT_ERROR) {
+                return 0;
+            }
+        }
+        elapsed = (bench_now() - start) / iterations;
+        samples[i] = elapsed;
+        total += elapsed;
+    }
+    qsort(samples, reps, sizeof(samples[0]), bench_cmp);
+
+    result->iterations = iterations;
+    result->reps = reps;
+    result->min = samples[0];
+    result->max = samples[reps - 1];
+    result->median = reps % 2 ? samples[reps / 2] : (samples[reps / 2 - 1] + samples[reps / 2]) / 2.0;
+    result->mean = total / reps;
+    return 1;
+}
+
+/* Parse comma-separated list of names (or for symbologies numbers) into `selected` flags, returning 0 on error */
+static int bench_select(const char *arg, const char **names, int size, int *selected) {
+    char buf[64];
+    const char *s = arg, *e;
+    int i, len;
+
+    memset(selected, 0, sizeof(int) * size);
+    while (*s) {
+        e = strchr(s, ',');
+        len = e ? (int) (e - s) : (int) strlen(s);
+        if (len >= (int) sizeof(buf)) {
+            return 0;
+        }
+        memcpy(buf, s, len);
+        buf[len] = '\0';
+        if (names) {
+            for (i = 0; i < size && strcmp(buf, names[i]) != 0; i++);
+        } else {
+            i = atoi(buf);
+        }
+        if (i < 0 || i >= size) {
+            return 0;
+        }
+        selected[i] = 1;
+        s += len + (e != NULL);
+    }
+    return 1;
+}
+
+static void bench_usage(void) {
+    printf("Usage: zint_bench [options]\n"
+        "  -s <list>   Symbology numbers, comma-separated (default all)\n"
+        "  -p <list>   Payloads small,medium,max (default all)\n"
+        "  -o <list>   Outputs encode,buffer,vector,into,png,gif,tif,bmp,pcx,svg,eps,emf (default all)\n"
+        "  -w <n>      Warm-up runs (default 3)\n"
+        "  -r <n>      Repetitions timed (default 10, maximum %d)\n"
+        "  -n <n>      Runs per repetition (default calibrated by -t)\n"
+        "  -t <ms>     Least time per repetition when calibrating (default 10)\n"
+        "  -j          Write JSON instead of CSV\n"
+        "  -O <file>   Write results to file (default stdout)\n", BENCH_MAX_REPS);
+}
+
+int main(int argc, char *argv[]) {
+    int symbologies[BARCODE_RMQR + 1];
+    int payloads[3] = { 1, 1, 1 };
+    int outputs[BENCH_OUTPUTS];
+    int warmup = 3, reps = 10, iterations = 0;
+    double target = 10.0;
+    int json = 0;
+    FILE *out = stdout;
+    int opt, i, payload, output;
+    int first = 1;
+    int prev_length;
+    char *buf;
+    struct zint_symbol *symbol;
+    struct bench_symbol bs;
+    struct bench_case bc;
+    struct bench_result result;
+    static const char *file_exts[] = { "png", "gif", "tif", "bmp", "pcx", "svg", "eps", "emf" };
+
+    for (i = 0; i <= BARCODE_RMQR; i++) {
+        symbologies[i] = 1;
+    }
+    for (i = 0; i < BENCH_OUTPUTS; i++) {
+        outputs[i] = 1;
+    }
+
+    while ((opt = getopt(argc, argv, "s:p:o:w:r:n:t:jO:h")) != -1) {
+        switch (opt) {
+            case 's':
+                if (!bench_select(optarg, NULL, BARCODE_RMQR + 1, symbologies)) {
+                    fprintf(stderr, "zint_bench: invalid symbology list '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'p':
+                if (!bench_select(optarg, payload_names, 3, payloads)) {
+                    fprintf(stderr, "zint_bench: invalid payload list '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'o':
+                if (!bench_select(optarg, output_names, BENCH_OUTPUTS, outputs)) {
+                    fprintf(stderr, "zint_bench: invalid output list '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'w':
+                warmup = atoi(optarg);
+                break;
+            case 'r':
+                reps = atoi(optarg);
+                if (reps < 1 || reps > BENCH_MAX_REPS) {
+                    fprintf(stderr, "zint_bench: repetitions %d not in range 1 to %d\n", reps, BENCH_MAX_REPS);
+                    return 1;
+                }
+                break;
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            case 't':
+                target = atof(optarg);
+                break;
+            case 'j':
+                json = 1;
+                break;
+            case 'O':
+                if (!(out = fopen(optarg, "w"))) {
+                    fprintf(stderr, "zint_bench: cannot open '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            default:
+                bench_usage();
+                return opt != 'h';
+        }
+    }
+    target *= 1e6; /* To nanoseconds */
+
+    if (!(buf = (char *) malloc(ZINT_MAX_FILE_LEN * 2))) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        return 1;
+    }
+    symbol = ZBarcode_Create();
+    if (!symbol) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        return 1;
+    }
+
+    if (json) {
+        fprintf(out, "{\n  \"version\": %d,\n  \"warmup\": %d,\n  \"results\": [", ZBarcode_Version(), warmup);
+    } else {
+        fprintf(out, "symbology,name,payload,length,output,iterations,repetitions,min_ns,median_ns,mean_ns,max_ns\n");
+    }
+
+    for (bs.symbology = 1; bs.symbology <= BARCODE_RMQR; bs.symbology++) {
+        if (!symbologies[bs.symbology] || !ZBarcode_ValidID(bs.symbology)) {
+            continue;
+        }
+        ZBarcode_Delete(symbol);
+        symbol = ZBarcode_Create();
+        if (!bench_find_data(symbol, &bs, buf)) {
+            fprintf(stderr, "zint_bench: %s: no data found, skipped\n", testUtilBarcodeName(bs.symbology));
+            continue;
+        }
+
+        prev_length = -1;
+        for (payload = BENCH_SMALL; payload <= BENCH_MAX; payload++) {
+            char *data;
+            int length;
+
+            if (!payloads[payload]) {
+                continue;
+            }
+            length = bench_payload_length(symbol, &bs, payload, buf);
+            if (length == prev_length) {
+                continue; /* Same as smaller payload */
+            }
+            prev_length = length;
+            length = bench_generate(&bs, length, buf);
+            data = buf + ZINT_MAX_FILE_LEN; /* Keep apart from probing */
+            memcpy(data, buf, length + 1);
+
+            ZBarcode_Delete(symbol);
+            symbol = ZBarcode_Create();
+            symbol->output_options |= BARCODE_MEMORY_FILE;
+            bench_setup(symbol, &bs);
+            if (ZBarcode_Encode(symbol, (unsigned char *) data, length) >= ZINT_ERROR) {
+                fprintf(stderr, "zint_bench: %s %s: %s, skipped\n", testUtilBarcodeName(bs.symbology),
+                        payload_names[payload], symbol->errtxt);
+                continue;
+            }
+
+            bc.symbol = symbol;
+            bc.bs = &bs;
+            bc.data = data;
+            bc.length = length;
+            bc.pixbuf.pixels = NULL;
+
+            for (output = 0; output < BENCH_OUTPUTS; output++) {
+                if (!outputs[output]) {
+                    continue;
+                }
+                bc.output = output;
+                if (output == BENCH_INTO && !bc.pixbuf.pixels) {
+                    /* Size the pixel buffer from a normal render */
+                    if (ZBarcode_Buffer(symbol, 0) >= ZINT_ERROR) {
+                        continue;
+                    }
+                    bc.pixbuf.width = symbol->bitmap_width;
+                    bc.pixbuf.height = symbol->bitmap_height;
+                    bc.pixbuf.stride = symbol->bitmap_width * 4;
+                    bc.pixbuf.format = ZINT_PIXEL_RGBA32;
+                    if (!(bc.pixbuf.pixels = (unsigned char *) malloc((size_t) bc.pixbuf.stride * bc.pixbuf.height))) {
+                        continue;
+                    }
+                } else if (output >= BENCH_PRINT) {
+                    sprintf(symbol->outfile, "bench.%s", file_exts[output - BENCH_PRINT]);
+                }
+                if (!bench_time(&bc, warmup, reps, iterations, target, &result)) {
+                    fprintf(stderr, "zint_bench: %s %s %s: %s, skipped\n", testUtilBarcodeName(bs.symbology),
+                            payload_names[payload], output_names[output], symbol->errtxt);
+                    if (output == BENCH_ENCODE) {
+                        break; /* Symbol cleared by failed encode */
+                    }
+                    continue;
+                }
+                if (json) {
+                    fprintf(out, "%s\n    { \"symbology\": %d, \"name\": \"%s\", \"payload\": \"%s\", \"length\": %d,"
+                            " \"output\": \"%s\", \"iterations\": %d, \"repetitions\": %d, \"min_ns\": %.0f,"
+                            " \"median_ns\": %.0f, \"mean_ns\": %.0f, \"max_ns\": %.0f }",
+                            first ? "" : ",", bs.symbology, testUtilBarcodeName(bs.symbology), payload_names[payload],
+                            length, output_names[output], result.iterations, result.reps, result.min, result.median,
+                            result.mean, result.max);
+                } else {
+                    fprintf(out, "%d,%s,%s,%d,%s,%d,%d,%.0f,%.0f,%.0f,%.0f\n",
+                            bs.symbology, testUtilBarcodeName(bs.symbology), payload_names[payload], length,
+                            output_names[output], result.iterations, result.reps, result.min, result.median,
+                            result.mean, result.max);
+                }
+                first = 0;
+                fflush(out);
+            }
+            free(bc.pixbuf.pixels);
+        }
+    }
+
+    if (json) {
+        fprintf(out, "\n  ]\n}\n");
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    ZBarcode_Delete(symbol);
+    free(buf);
+
+    return 0;
+}
@@ -34,14 +34,10 @@
 
 #include <stdio.h>
 #include <math.h>
-#include <assert.h>
 #include "common.h"
+#include "scratch.h"
 #include "tif.h"
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#include <malloc.h>
-#endif
+#include "filemem.h"
 
 INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
@@ -50,11 +46,10 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     unsigned int free_memory;
     int row, column, strip;
     unsigned int bytes_put;
-    FILE *tif_file;
-#ifdef _MSC_VER
-    uint32_t* strip_offset;
-    uint32_t* strip_bytes;
-#endif
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    uint32_t *strip_offset;
+    uint32_t *strip_bytes;
 
     tiff_header_t header;
     tiff_ifd_t ifd;
@@ -76,9 +71,6 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         rows_per_strip = 1;
     }
 
-    /* Suppresses clang-tidy clang-analyzer-core.VLASize warning */
-    assert(symbol->bitmap_height > 0);
-
     strip_count = symbol->bitmap_height / rows_per_strip;
     if ((symbol->bitmap_height % rows_per_strip) != 0) {
         strip_count++;
@@ -92,13 +84,12 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         printf("TIFF (%dx%d) Strip Count %d, Rows Per Strip %d\n", symbol->bitmap_width, symbol->bitmap_height, strip_count, rows_per_strip);
     }
 
-#ifndef _MSC_VER
-    uint32_t strip_offset[strip_count];
-    uint32_t strip_bytes[strip_count];
-#else
-    strip_offset = (uint32_t*) _alloca(strip_count * sizeof(uint32_t));
-    strip_bytes = (uint32_t*) _alloca(strip_count * sizeof(uint32_t));
-#endif
+    strip_offset = (uint32_t *) scratch_alloc(symbol, sizeof(uint32_t) * strip_count);
+    strip_bytes = (uint32_t *) scratch_alloc(symbol, sizeof(uint32_t) * strip_count);
+    if (!strip_offset || !strip_bytes) {
+        strcpy(symbol->errtxt, "671: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
     free_memory = 8;
 
     for(i = 0; i < strip_count; i++) {
@@ -124,19 +115,9 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "671: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        tif_file = stdout;
-    } else {
-        if (!(tif_file = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "672: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "672: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     /* Header */
@@ -144,7 +125,7 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     header.identity = 42;
     header.offset = free_memory;
 
-    fwrite(&header, sizeof(tiff_header_t), 1, tif_file);
+    fm_write(&header, sizeof(tiff_header_t), 1, fmp);
     free_memory += sizeof(tiff_ifd_t);
 
     /* Pixel data */
@@ -154,54 +135,54 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         for (column = 0; column < symbol->bitmap_width; column++) {
             switch(pixelbuf[(row * symbol->bitmap_width) + column]) {
                 case 'W': // White
-                    putc(255, tif_file);
-                    putc(255, tif_file);
-                    putc(255, tif_file);
+                    fm_putc(255, fmp);
+                    fm_putc(255, fmp);
+                    fm_putc(255, fmp);
                     break;
                 case 'C': // Cyan
-                    putc(0, tif_file);
-                    putc(255, tif_file);
-                    putc(255, tif_file);
+                    fm_putc(0, fmp);
+                    fm_putc(255, fmp);
+                    fm_putc(255, fmp);
                     break;
                 case 'B': // Blue
-                    putc(0, tif_file);
-                    putc(0, tif_file);
-                    putc(255, tif_file);
+                    fm_putc(0, fmp);
+                    fm_putc(0, fmp);
+                    fm_putc(255, fmp);
                     break;
                 case 'M': // Magenta
-                    putc(255, tif_file);
-                    putc(0, tif_file);
-                    putc(255, tif_file);
+                    fm_putc(255, fmp);
+                    fm_putc(0, fmp);
+                    fm_putc(255, fmp);
                     break;
                 case 'R': // Red
-                    putc(255, tif_file);
-                    putc(0, tif_file);
-                    putc(0, tif_file);
+                    fm_putc(255, fmp);
+                    fm_putc(0, fmp);
+                    fm_putc(0, fmp);
                     break;
                 case 'Y': // Yellow
-                    putc(255, tif_file);
-                    putc(255, tif_file);
-                    putc(0, tif_file);
+                    fm_putc(255, fmp);
+                    fm_putc(255, fmp);
+                    fm_putc(0, fmp);
                     break;
                 case 'G': // Green
-                    putc(0, tif_file);
-                    putc(255, tif_file);
-                    putc(0, tif_file);
+                    fm_putc(0, fmp);
+                    fm_putc(255, fmp);
+                    fm_putc(0, fmp);
                     break;
                 case 'K': // Black
-                    putc(0, tif_file);
-                    putc(0, tif_file);
-                    putc(0, tif_file);
+                    fm_putc(0, fmp);
+                    fm_putc(0, fmp);
+                    fm_putc(0, fmp);
                     break;
                 case '1':
-                    putc(fgred, tif_file);
-                    putc(fggrn, tif_file);
-                    putc(fgblu, tif_file);
+                    fm_putc(fgred, fmp);
+                    fm_putc(fggrn, fmp);
+                    fm_putc(fgblu, fmp);
                     break;
                 default:
-                    putc(bgred, tif_file);
-                    putc(bggrn, tif_file);
-                    putc(bgblu, tif_file);
+                    fm_putc(bgred, fmp);
+                    fm_putc(bggrn, fmp);
+                    fm_putc(bgblu, fmp);
                     break;
             }
             bytes_put += 3;
@@ -210,7 +191,7 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         if (strip < strip_count && (bytes_put + 3) >= strip_bytes[strip]) {
             // End of strip, pad if strip length is odd
             if (strip_bytes[strip] % 2 == 1) {
-                putc(0, tif_file);
+                fm_putc(0, fmp);
             }
             strip++;
             bytes_put = 0;
@@ -304,42 +285,41 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     ifd.resolution_unit.count = 1;
     ifd.resolution_unit.offset = 2; // Inches
 
-    fwrite(&ifd, sizeof(tiff_ifd_t), 1, tif_file);
+    fm_write(&ifd, sizeof(tiff_ifd_t), 1, fmp);
 
     /* Bits per sample */
     temp = 8;
-    fwrite(&temp, 2, 1, tif_file); // Red Bytes
-    fwrite(&temp, 2, 1, tif_file); // Green Bytes
-    fwrite(&temp, 2, 1, tif_file); // Blue Bytes
+    fm_write(&temp, 2, 1, fmp); // Red Bytes
+    fm_write(&temp, 2, 1, fmp); // Green Bytes
+    fm_write(&temp, 2, 1, fmp); // Blue Bytes
 
     if (strip_count != 1) {
         /* Strip offsets */
         for (i = 0; i < strip_count; i++) {
-            fwrite(&strip_offset[i], 4, 1, tif_file);
+            fm_write(&strip_offset[i], 4, 1, fmp);
         }
 
         /* Strip byte lengths */
         for (i = 0; i < strip_count; i++) {
-            fwrite(&strip_bytes[i], 4, 1, tif_file);
+            fm_write(&strip_bytes[i], 4, 1, fmp);
         }
     }
 
     /* X Resolution */
     temp32 = 72;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
     temp32 = 1;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
 
     /* Y Resolution */
     temp32 = 72;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
     temp32 = 1;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(tif_file);
-    } else {
-        fclose(tif_file);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "673: Failed to write output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     return 0;
@@ -0,0 +1,163 @@
+<?php
+/* Generate RSS-14 and RSS Expanded element widths tables for `getRSSwidths4()` in "rss.c" */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2020 Robin Stuart <rstuart114@gmail.com>
+*/
+/* vim: set ts=4 sw=4 et : */
+
+/* The functions "combins" and "getRSSwidths" are copyright BSI and are
+   released with permission under the following terms:
+
+   "Copyright subsists in all BSI publications. BSI also holds the copyright, in the
+   UK, of the international standardisation bodies. Except as
+   permitted under the Copyright, Designs and Patents Act 1988 no extract may be
+   reproduced, stored in a retrieval system or transmitted in any form or by any
+   means - electronic, photocopying, recording or otherwise - without prior written
+   permission from BSI.
+
+   "This does not preclude the free use, in the course of implementing the standard,
+   of necessary details such as symbols, and size, type or grade designations. If these
+   details are to be used for any other purpose than implementation then the prior
+   written permission of BSI must be obtained."
+
+   The date of publication for these functions is 30 November 2006
+ */
+
+function combins($n, $r) {
+    if ($n - $r > $r) {
+        $minDenom = $r;
+        $maxDenom = $n - $r;
+    } else {
+        $minDenom = $n - $r;
+        $maxDenom = $r;
+    }
+    $val = 1;
+    $j = 1;
+    for ($i = $n; $i > $maxDenom; $i--) {
+        $val *= $i;
+        if ($j <= $minDenom) {
+            $val = (int) ($val / $j);
+            $j++;
+        }
+    }
+    for (; $j <= $minDenom; $j++) {
+        $val = (int) ($val / $j);
+    }
+    return $val;
+}
+
+function getRSSwidths($val, $n, $elements, $maxWidth, $noNarrow) {
+    $widths = array();
+    $narrowMask = 0;
+    for ($bar = 0; $bar < $elements - 1; $bar++) {
+        for ($elmWidth = 1, $narrowMask |= (1 << $bar);
+                ;
+                $elmWidth++, $narrowMask &= ~(1 << $bar)) {
+            /* get all combinations */
+            $subVal = combins($n - $elmWidth - 1, $elements - $bar - 2);
+            /* less combinations with no single-module element */
+            if ((!$noNarrow) && (!$narrowMask) &&
+                    ($n - $elmWidth - ($elements - $bar - 1) >= $elements - $bar - 1)) {
+                $subVal -= combins($n - $elmWidth - ($elements - $bar), $elements - $bar - 2);
+            }
+            /* less combinations with elements > maxVal */
+            if ($elements - $bar - 1 > 1) {
+                $lessVal = 0;
+                for ($mxwElement = $n - $elmWidth - ($elements - $bar - 2);
+                        $mxwElement > $maxWidth;
+                        $mxwElement--) {
+                    $lessVal += combins($n - $elmWidth - $mxwElement - 1, $elements - $bar - 3);
+                }
+                $subVal -= $lessVal * ($elements - 1 - $bar);
+            } else if ($n - $elmWidth > $maxWidth) {
+                $subVal--;
+            }
+            $val -= $subVal;
+            if ($val < 0) break;
+        }
+        $val += $subVal;
+        $n -= $elmWidth;
+        $widths[$bar] = $elmWidth;
+    }
+    $widths[$bar] = $n;
+    return $widths;
+}
+
+/* Print widths of `$counts[$group]` values for each group as 4-bit nibbles, first element most significant,
+   preceded by index of each group's first entry */
+function print_table($name, $desc, $counts, $modules, $widest, $noNarrow) {
+    $idx = array();
+    $table = array();
+    for ($group = 0; $group < count($counts); $group++) {
+        $idx[] = count($table);
+        for ($val = 0; $val < $counts[$group]; $val++) {
+            $widths = getRSSwidths($val, $modules[$group], 4, $widest[$group], $noNarrow[$group]);
+            $table[] = ($widths[0] << 12) | ($widths[1] << 8) | ($widths[2] << 4) | $widths[3];
+        }
+    }
+
+    printf("/* %s */\n", $desc);
+    printf("static const unsigned short %s_idx[%d] = {\n    %s\n};\n\n", $name, count($idx), implode(", ", $idx));
+    printf("static const unsigned short %s[%d] = {\n", $name, count($table));
+    for ($i = 0; $i < count($table); $i += 10) {
+        $line = array();
+        for ($j = $i; $j < $i + 10 && $j < count($table); $j++) {
+            $line[] = sprintf("0x%04X", $table[$j]);
+        }
+        printf("    %s,\n", implode(", ", $line));
+    }
+    printf("};\n\n");
+}
+
+/* RSS-14 subset tables (`$g_sum_table` & `$t_table` as in "rss.h" with totals appended to `$g_sum_table`) */
+$g_sum_table = array(0, 161, 961, 2015, 2715, 2841, 0, 336, 1036, 1516, 1597);
+$t_table = array(1, 10, 34, 70, 126, 4, 20, 48, 81);
+$modules_odd = array(12, 10, 8, 6, 4, 5, 7, 9, 11);
+$modules_even = array(4, 6, 8, 10, 12, 10, 8, 6, 4);
+$widest_odd = array(8, 6, 4, 3, 1, 2, 4, 6, 8);
+$widest_even = array(1, 3, 5, 6, 8, 7, 5, 3, 1);
+
+/* Outside characters (groups 0-4) have odd value = (value - g_sum) / t, inside (groups 5-8) even value */
+$counts_odd = array();
+$counts_even = array();
+$no_narrow_odd = array();
+$no_narrow_even = array();
+for ($group = 0; $group < 9; $group++) {
+    $g_idx = $group < 5 ? $group : $group + 1;
+    $total = $g_sum_table[$g_idx + 1] - $g_sum_table[$g_idx];
+    if ($group < 5) {
+        $counts_odd[] = (int) ($total / $t_table[$group]);
+        $counts_even[] = $t_table[$group];
+    } else {
+        $counts_odd[] = $t_table[$group];
+        $counts_even[] = (int) ($total / $t_table[$group]);
+    }
+    $no_narrow_odd[] = $group < 5 ? 1 : 0;
+    $no_narrow_even[] = $group < 5 ? 0 : 1;
+}
+
+/* RSS Expanded subset tables (`$g_sum_exp` & `$t_even_exp` as in "rss.h" with total appended to `$g_sum_exp`) */
+$g_sum_exp = array(0, 348, 1388, 2948, 3988, 4192);
+$t_even_exp = array(4, 20, 52, 104, 204);
+$modules_odd_exp = array(12, 10, 8, 6, 4);
+$modules_even_exp = array(5, 7, 9, 11, 13);
+$widest_odd_exp = array(7, 5, 4, 3, 1);
+$widest_even_exp = array(2, 4, 5, 6, 8);
+
+$counts_odd_exp = array();
+$counts_even_exp = array();
+for ($group = 0; $group < 5; $group++) {
+    $counts_odd_exp[] = (int) (($g_sum_exp[$group + 1] - $g_sum_exp[$group]) / $t_even_exp[$group]);
+    $counts_even_exp[] = $t_even_exp[$group];
+}
+
+printf("/* Generated by tools/gen_rss_widths_table.php */\n\n");
+print_table("widths_odd", "RSS-14 odd element widths, indexed by `widths_odd_idx[group] + v_odd`",
+            $counts_odd, $modules_odd, $widest_odd, $no_narrow_odd);
+print_table("widths_even", "RSS-14 even element widths, indexed by `widths_even_idx[group] + v_even`",
+            $counts_even, $modules_even, $widest_even, $no_narrow_even);
+print_table("widths_odd_exp", "RSS Expanded odd element widths, indexed by `widths_odd_exp_idx[group] + v_odd`",
+            $counts_odd_exp, $modules_odd_exp, $widest_odd_exp, array(0, 0, 0, 0, 0));
+print_table("widths_even_exp", "RSS Expanded even element widths, indexed by `widths_even_exp_idx[group] + v_even`",
+            $counts_even_exp, $modules_even_exp, $widest_even_exp, array(1, 1, 1, 1, 1));
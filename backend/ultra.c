@@ -32,11 +32,9 @@
 
  /* This version was developed using AIMD/TSC15032-43 v0.99c Edit 60, dated 4th Nov 2015 */
 
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include <stdio.h>
 #include "common.h"
+#include "scratch.h"
 
 #define EIGHTBIT_MODE       10
 #define ASCII_MODE          20
@@ -419,7 +417,7 @@ static int get_subset(unsigned char source[], int in_length, int in_locn, int cu
 }
 
 /* Encode characters in the C43 compaction submode */
-static float look_ahead_c43(unsigned char source[], int in_length, int in_locn, char current_mode, int end_char, int subset, int cw[], int* cw_len, int* encoded, int gs1, int debug) {
+static float look_ahead_c43(unsigned char source[], int in_length, int in_locn, char current_mode, int end_char, int subset, int cw[], int subcw[], int* cw_len, int* encoded, int gs1, int debug) {
     int codeword_count = 0;
     int subcodeword_count = 0;
     int i;
@@ -431,12 +429,6 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
     int letters_encoded = 0;
     int pad;
 
-#ifndef _MSC_VER
-    int subcw[(in_length + 3) * 2];
-#else
-    int * subcw = (int *) _alloca((in_length + 3) * 2 * sizeof (int));
-#endif /* _MSC_VER */
-
     if (current_mode == EIGHTBIT_MODE) {
         /* Check for permissable URL C43 macro sequences, otherwise encode directly */
         fragno = ultra_find_fragment(source, in_length, sublocn);
@@ -611,7 +603,8 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
     }
 }
 
-/* Produces a set of codewords which are "somewhat" optimised - this could be improved on */
+/* Produces a set of codewords which are "somewhat" optimised - this could be improved on.
+   Returns number of codewords, or -1 if out of memory */
 static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned char source[], const size_t in_length, int codewords[]) {
     int i;
     int crop_length;
@@ -630,15 +623,15 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
     int gs1 = 0;
     int ascii_encoded, c43_encoded;
 
-#ifndef _MSC_VER
-    unsigned char crop_source[in_length + 1];
-    char mode[in_length + 1];
-    int cw_fragment[in_length * 2 + 1];
-#else
-    unsigned char * crop_source = (unsigned char *) _alloca((in_length + 1) * sizeof (unsigned char));
-    char * mode = (char *) _alloca((in_length + 1) * sizeof (char));
-    int * cw_fragment = (int *) _alloca((in_length * 2 + 1) * sizeof (int));
-#endif /* _MSC_VER */
+    unsigned char *crop_source = (unsigned char *) scratch_alloc(symbol, in_length + 1);
+    char *mode = (char *) scratch_alloc(symbol, in_length + 1);
+    int *cw_fragment = (int *) scratch_alloc(symbol, sizeof(int) * (in_length * 2 + 1));
+    int *subcw = (int *) scratch_alloc(symbol, sizeof(int) * (in_length + 3) * 2); /* For `look_ahead_c43()` */
+
+    if (!crop_source || !mode || !cw_fragment || !subcw) {
+        strcpy(symbol->errtxt, "592: Insufficient memory");
+        return -1;
+    }
 
     if ((symbol->input_mode & 0x07) == GS1_MODE) {
         gs1 = 1;
@@ -770,7 +763,7 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
             eightbit_score = look_ahead_eightbit(crop_source, crop_length, input_locn, current_mode, end_char, cw_fragment, &fragment_length, gs1);
             ascii_score = look_ahead_ascii(crop_source, crop_length, input_locn, current_mode, symbol_mode, end_char, cw_fragment, &fragment_length, &ascii_encoded, gs1);
             subset = c43_should_latch_other(crop_source, crop_length, input_locn, 1 /*subset*/, gs1) ? 2 : 1;
-            c43_score = look_ahead_c43(crop_source, crop_length, input_locn, current_mode, end_char, subset, cw_fragment, &fragment_length, &c43_encoded, gs1, 0 /*debug*/);
+            c43_score = look_ahead_c43(crop_source, crop_length, input_locn, current_mode, end_char, subset, cw_fragment, subcw, &fragment_length, &c43_encoded, gs1, 0 /*debug*/);
 
             mode[input_locn] = 'a';
             current_mode = ASCII_MODE;
@@ -827,7 +820,7 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
                 break;
             case 'c':
                 subset = c43_should_latch_other(crop_source, crop_length, input_locn, 1 /*subset*/, gs1) ? 2 : 1;
-                look_ahead_c43(crop_source, crop_length, input_locn, current_mode, input_locn + block_length, subset, cw_fragment, &fragment_length, NULL, gs1, symbol->debug);
+                look_ahead_c43(crop_source, crop_length, input_locn, current_mode, input_locn + block_length, subset, cw_fragment, subcw, &fragment_length, NULL, gs1, symbol->debug);
 
                 /* Substitute temporary latch if possible */
                 if ((current_mode == EIGHTBIT_MODE) && (cw_fragment[0] == 260) && (fragment_length >= 5) && (fragment_length <= 11)) {
@@ -874,10 +867,8 @@ INTERNAL int ultracode(struct zint_symbol *symbol, const unsigned char source[],
     char tilepat[6];
     int tilex, tiley;
     int dcc;
-#ifdef _MSC_VER
-    int* data_codewords;
-    char* pattern;
-#endif /* _MSC_VER */
+    int *data_codewords;
+    char *pattern;
 
     cw_memalloc = in_length * 2;
     if (cw_memalloc < 283) {
@@ -889,13 +880,15 @@ INTERNAL int ultracode(struct zint_symbol *symbol, const unsigned char source[],
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-#ifndef _MSC_VER
-    int data_codewords[cw_memalloc];
-#else
-    data_codewords = (int *) _alloca(cw_memalloc * sizeof (int));
-#endif /* _MSC_VER */
+    if (!(data_codewords = (int *) scratch_alloc(symbol, sizeof(int) * cw_memalloc))) {
+        strcpy(symbol->errtxt, "592: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     data_cw_count = ultra_generate_codewords(symbol, source, in_length, data_codewords);
+    if (data_cw_count < 0) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("Codewords returned = %d\n", data_cw_count);
@@ -1000,11 +993,10 @@ INTERNAL int ultracode(struct zint_symbol *symbol, const unsigned char source[],
     total_width = columns + 6;
 
     /* Build symbol */
-#ifndef _MSC_VER
-    char pattern[total_height * total_width];
-#else
-    pattern = (char *) _alloca(total_height * total_width * sizeof (char));
-#endif /* _MSC_VER */
+    if (!(pattern = (char *) scratch_alloc(symbol, total_height * total_width))) {
+        strcpy(symbol->errtxt, "592: Insufficient memory");
+        return ZINT_ERROR_MEMORY;
+    }
 
     for (i = 0; i < (total_height * total_width); i++) {
         pattern[i] = 'W';
@@ -30,7 +30,6 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-#define SODIUM  "0123456789+"
 #define EAN2    102
 #define EAN5    105
 
@@ -68,12 +67,12 @@ static const char *EAN13Parity[10] = {
     "BABBA", "BBABA"
 };
 
-static const char *EANsetA[10] = {
+static const char EANsetA[10][4] = {
     /* Representation set A and C (EN Table 1) */
     "3211", "2221", "2122", "1411", "1132", "1231", "1114", "1312", "1213", "3112"
 };
 
-static const char *EANsetB[10] = {
+static const char EANsetB[10][4] = {
     /* Representation set B (EN Table 1) */
     "1123", "1222", "2212", "1141", "2311", "1321", "4111", "2131", "3121", "2113"
 };
@@ -102,24 +101,27 @@ static char upc_check(char source[]) {
 /* UPC A is usually used for 12 digit numbers, but this function takes a source of any length */
 static void upca_draw(char source[], char dest[]) {
     unsigned int i, half_way, length = strlen(source);
+    char *d = dest + strlen(dest);
 
     half_way = length / 2;
 
     /* start character */
-    strcat(dest, "111");
+    memcpy(d, "111", 3);
+    d += 3;
 
-    for (i = 0; i < length; i++) {
+    for (i = 0; i < length; i++, d += 4) {
         if (i == half_way) {
             /* middle character - separates manufacturer no. from product no. */
             /* also inverts right hand characters */
-            strcat(dest, "11111");
+            memcpy(d, "11111", 5);
+            d += 5;
         }
 
-        lookup(NEON, EANsetA, source[i], dest);
+        memcpy(d, EANsetA[source[i] - '0'], 4);
     }
 
     /* stop character */
-    strcat(dest, "111");
+    memcpy(d, "111", 4); /* Including terminating NUL */
 }
 
 /* Make a UPC A barcode when we haven't been given the check digit */
@@ -157,9 +159,10 @@ static int upca(struct zint_symbol *symbol, unsigned char source[], char dest[])
 
 /* UPC E is a zero-compressed version of UPC A */
 static int upce(struct zint_symbol *symbol, unsigned char source[], char dest[]) {
-    unsigned int i, num_system, length;
+    unsigned int i, num_system;
     char emode, equivalent[12], check_digit, parity[8], temp[9];
     char hrt[9];
+    char *d;
     int error_number = 0;
 
     /* Two number systems can be used - system 0 and system 1 */
@@ -283,20 +286,16 @@ static int upce(struct zint_symbol *symbol, unsigned char source[], char dest[])
     /* Take all this information and make the barcode pattern */
 
     /* start character */
-    strcat(dest, "111");
+    d = dest + strlen(dest);
+    memcpy(d, "111", 3);
+    d += 3;
 
-    length = ustrlen(source);
-    for (i = 0; i < length; i++) {
-        switch (parity[i]) {
-            case 'A': lookup(NEON, EANsetA, source[i], dest);
-                break;
-            case 'B': lookup(NEON, EANsetB, source[i], dest);
-                break;
-        }
+    for (i = 0; i < 6; i++, d += 4) {
+        memcpy(d, parity[i] == 'B' ? EANsetB[source[i] - '0'] : EANsetA[source[i] - '0'], 4);
     }
 
     /* stop character */
-    strcat(dest, "111111");
+    memcpy(d, "111111", 7); /* Including terminating NUL */
 
     if (symbol->symbology != BARCODE_UPCE_CHK) {
         hrt[7] = check_digit;
@@ -323,16 +322,16 @@ static int upce(struct zint_symbol *symbol, unsigned char source[], char dest[])
 static void add_on(unsigned char source[], char dest[], int addon_gap) {
     char parity[6];
     unsigned int i, code_type, length;
+    char *d = dest + strlen(dest);
 
     /* If an add-on then append with space */
     if (addon_gap != 0) {
-        i = strlen(dest);
-        dest[i] = itoc(addon_gap);
-        dest[i + 1] = '\0';
+        *d++ = itoc(addon_gap);
     }
 
     /* Start character */
-    strcat(dest, "112");
+    memcpy(d, "112", 3);
+    d += 3;
 
     /* Determine EAN2 or EAN5 add-on */
     if (ustrlen(source) == 2) {
@@ -365,19 +364,16 @@ static void add_on(unsigned char source[], char dest[], int addon_gap) {
     }
 
     length = ustrlen(source);
-    for (i = 0; i < length; i++) {
-        switch (parity[i]) {
-            case 'A': lookup(NEON, EANsetA, source[i], dest);
-                break;
-            case 'B': lookup(NEON, EANsetB, source[i], dest);
-                break;
-        }
+    for (i = 0; i < length; i++, d += 4) {
+        memcpy(d, parity[i] == 'B' ? EANsetB[source[i] - '0'] : EANsetA[source[i] - '0'], 4);
 
         /* Glyph separator */
-        if (i != (ustrlen(source) - 1)) {
-            strcat(dest, "11");
+        if (i != length - 1) {
+            memcpy(d + 4, "11", 2);
+            d += 2;
         }
     }
+    *d = '\0';
 }
 
 /* ************************ EAN-13 ****************** */
@@ -408,9 +404,9 @@ static int ean13(struct zint_symbol *symbol, unsigned char source[], char dest[]
     unsigned int length, i, half_way;
     char parity[6];
     char gtin[15];
+    char *d;
     int error_number = 0;
 
-    strcpy(parity, "");
     strcpy(gtin, (char*) source);
 
     /* Add the appropriate check digit */
@@ -435,30 +431,33 @@ static int ean13(struct zint_symbol *symbol, unsigned char source[], char dest[]
     }
 
     /* Get parity for first half of the symbol */
-    lookup(SODIUM, EAN13Parity, gtin[0], parity);
+    strcpy(parity, EAN13Parity[gtin[0] - '0']);
 
     /* Now get on with the cipher */
     half_way = 7;
 
     /* start character */
-    strcat(dest, "111");
+    d = dest + strlen(dest);
+    memcpy(d, "111", 3);
+    d += 3;
     length = strlen(gtin);
-    for (i = 1; i < length; i++) {
+    for (i = 1; i < length; i++, d += 4) {
         if (i == half_way) {
             /* middle character - separates manufacturer no. from product no. */
             /* also inverses right hand characters */
-            strcat(dest, "11111");
+            memcpy(d, "11111", 5);
+            d += 5;
         }
 
         if (((i > 1) && (i < 7)) && (parity[i - 2] == 'B')) {
-            lookup(NEON, EANsetB, gtin[i], dest);
+            memcpy(d, EANsetB[gtin[i] - '0'], 4);
         } else {
-            lookup(NEON, EANsetA, gtin[i], dest);
+            memcpy(d, EANsetA[gtin[i] - '0'], 4);
         }
     }
 
     /* stop character */
-    strcat(dest, "111");
+    memcpy(d, "111", 4); /* Including terminating NUL */
     ustrcpy(symbol->text, gtin);
 
     return error_number;
@@ -940,7 +939,7 @@ INTERNAL int eanx(struct zint_symbol *symbol, unsigned char source[], int src_le
             return ZINT_ERROR_TOO_LONG;
     }
 
-    expand(symbol, (char*) dest);
+    expand(symbol, (char*) dest, (int) ustrlen(dest));
 
     switch (symbol->symbology) {
         case BARCODE_EANX_CC:
@@ -44,10 +44,10 @@ INTERNAL int ps_plot(struct zint_symbol *symbol);
 INTERNAL int svg_plot(struct zint_symbol *symbol);
 INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle);
 
-static struct zint_vector_rect *vector_plot_create_rect(float x, float y, float width, float height) {
+static struct zint_vector_rect *vector_plot_create_rect(struct zint_symbol *symbol, float x, float y, float width, float height) {
     struct zint_vector_rect *rect;
 
-    rect = (struct zint_vector_rect*) malloc(sizeof (struct zint_vector_rect));
+    rect = (struct zint_vector_rect*) z_malloc(symbol, sizeof (struct zint_vector_rect));
     if (!rect) return NULL;
 
     rect->next = NULL;
@@ -71,10 +71,10 @@ static int vector_plot_add_rect(struct zint_symbol *symbol, struct zint_vector_r
     return 1;
 }
 
-static struct zint_vector_hexagon *vector_plot_create_hexagon(float x, float y, float diameter) {
+static struct zint_vector_hexagon *vector_plot_create_hexagon(struct zint_symbol *symbol, float x, float y, float diameter) {
     struct zint_vector_hexagon *hexagon;
 
-    hexagon = (struct zint_vector_hexagon*) malloc(sizeof (struct zint_vector_hexagon));
+    hexagon = (struct zint_vector_hexagon*) z_malloc(symbol, sizeof (struct zint_vector_hexagon));
     if (!hexagon) return NULL;
     hexagon->next = NULL;
     hexagon->x = x;
@@ -96,10 +96,10 @@ static int vector_plot_add_hexagon(struct zint_symbol *symbol, struct zint_vecto
     return 1;
 }
 
-static struct zint_vector_circle *vector_plot_create_circle(float x, float y, float diameter, int colour) {
+static struct zint_vector_circle *vector_plot_create_circle(struct zint_symbol *symbol, float x, float y, float diameter, int colour) {
     struct zint_vector_circle *circle;
 
-    circle = (struct zint_vector_circle *) malloc(sizeof (struct zint_vector_circle));
+    circle = (struct zint_vector_circle *) z_malloc(symbol, sizeof (struct zint_vector_circle));
     if (!circle) return NULL;
     circle->next = NULL;
     circle->x = x;
@@ -126,7 +126,7 @@ static int vector_plot_add_string(struct zint_symbol *symbol,
         struct zint_vector_string **last_string) {
     struct zint_vector_string *string;
 
-    string = (struct zint_vector_string*) malloc(sizeof (struct zint_vector_string));
+    string = (struct zint_vector_string*) z_malloc(symbol, sizeof (struct zint_vector_string));
     if (!string) return 0;
     string->next = NULL;
     string->x = x;
@@ -136,8 +136,8 @@ static int vector_plot_add_string(struct zint_symbol *symbol,
     string->length = ustrlen(text);
     string->rotation = 0;
     string->halign = halign;
-    string->text = (unsigned char*) malloc(sizeof (unsigned char) * (ustrlen(text) + 1));
-    if (!string->text) { free(string); return 0; }
+    string->text = (unsigned char*) z_malloc(symbol, sizeof (unsigned char) * (ustrlen(text) + 1));
+    if (!string->text) { z_free(symbol, string); return 0; }
     ustrcpy(string->text, text);
 
     if (*last_string)
@@ -161,7 +161,7 @@ INTERNAL void vector_free(struct zint_symbol *symbol) {
         while (rect) {
             struct zint_vector_rect *r = rect;
             rect = rect->next;
-            free(r);
+            z_free(symbol, r);
         }
 
         // Free Hexagons
@@ -169,7 +169,7 @@ INTERNAL void vector_free(struct zint_symbol *symbol) {
         while (hex) {
             struct zint_vector_hexagon *h = hex;
             hex = hex->next;
-            free(h);
+            z_free(symbol, h);
         }
 
         // Free Circles
@@ -177,7 +177,7 @@ INTERNAL void vector_free(struct zint_symbol *symbol) {
         while (circle) {
             struct zint_vector_circle *c = circle;
             circle = circle->next;
-            free(c);
+            z_free(symbol, c);
         }
 
         // Free Strings
@@ -185,12 +185,12 @@ INTERNAL void vector_free(struct zint_symbol *symbol) {
         while (string) {
             struct zint_vector_string *s = string;
             string = string->next;
-            free(s->text);
-            free(s);
+            z_free(symbol, s->text);
+            z_free(symbol, s);
         }
 
         // Free vector
-        free(symbol->vector);
+        z_free(symbol, symbol->vector);
         symbol->vector = NULL;
     }
 }
@@ -369,7 +369,7 @@ static void vector_reduce_rectangles(struct zint_symbol *symbol) {
             if ((rect->x == target->x) && (rect->width == target->width) && ((rect->y + rect->height) == target->y) && (rect->colour == target->colour)) {
                 rect->height += target->height;
                 prev->next = target->next;
-                free(target);
+                z_free(symbol, target);
             } else {
                 prev = target;
             }
@@ -428,7 +428,7 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
     }
 
     // Allocate memory
-    vector = symbol->vector = (struct zint_vector *) malloc(sizeof (struct zint_vector));
+    vector = symbol->vector = (struct zint_vector *) z_malloc(symbol, sizeof (struct zint_vector));
     if (!vector) return ZINT_ERROR_MEMORY;
     vector->rectangles = NULL;
     vector->hexagons = NULL;
@@ -496,25 +496,25 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         vector->height = 36.0f + (yoffset + boffset);
 
         // Bullseye
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 10.85f, 0);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 10.85f, 0);
         vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 8.97f, 1);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 8.97f, 1);
         vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 7.10f, 0);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 7.10f, 0);
         vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 5.22f, 1);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 5.22f, 1);
         vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 3.31f, 0);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 3.31f, 0);
         vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(17.88f + xoffset, 17.8f + yoffset, 1.43f, 1);
+        circle = vector_plot_create_circle(symbol, 17.88f + xoffset, 17.8f + yoffset, 1.43f, 1);
         vector_plot_add_circle(symbol, circle, &last_circle);
 
         /* Hexagons */
         for (r = 0; r < symbol->rows; r++) {
             for (i = 0; i < symbol->width; i++) {
                 if (module_is_set(symbol, r, i)) {
-                    //struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(((i * 0.88) + ((r & 1) ? 1.76 : 1.32)), ((r * 0.76) + 0.76), hex_diameter);
-                    struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(((i * 1.23f) + 0.615f + ((r & 1) ? 0.615f : 0.0f)) + xoffset,
+                    //struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(symbol, ((i * 0.88) + ((r & 1) ? 1.76 : 1.32)), ((r * 0.76) + 0.76), hex_diameter);
+                    struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(symbol, ((i * 1.23f) + 0.615f + ((r & 1) ? 0.615f : 0.0f)) + xoffset,
                                                                                      ((r * 1.067f) + 0.715f) + yoffset, hex_diameter);
                     vector_plot_add_hexagon(symbol, hexagon, &last_hexagon);
                 }
@@ -526,7 +526,7 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         for (r = 0; r < symbol->rows; r++) {
             for (i = 0; i < symbol->width; i++) {
                 if (module_is_set(symbol, r, i)) {
-                    struct zint_vector_circle *circle = vector_plot_create_circle(i + dotradius + dotoffset + xoffset, r + dotradius + dotoffset + yoffset, symbol->dot_size, 0);
+                    struct zint_vector_circle *circle = vector_plot_create_circle(symbol, i + dotradius + dotoffset + xoffset, r + dotradius + dotoffset + yoffset, symbol->dot_size, 0);
                     vector_plot_add_circle(symbol, circle, &last_circle);
                 }
             }
@@ -551,7 +551,7 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
                     } while (i + block_width < symbol->width && module_colour_is_set(symbol, this_row, i + block_width) == module_fill);
                     if (module_fill) {
                         /* a colour block */
-                        rectangle = vector_plot_create_rect(i + xoffset, row_posn, block_width, row_height);
+                        rectangle = vector_plot_create_rect(symbol, i + xoffset, row_posn, block_width, row_height);
                         rectangle->colour = module_colour_is_set(symbol, this_row, i);
                         vector_plot_add_rect(symbol, rectangle, &last_rectangle);
                         rect_count++;
@@ -583,9 +583,9 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
                     if (module_fill) {
                         /* a bar */
                         if (addon_latch == 0) {
-                            rectangle = vector_plot_create_rect(i + xoffset, row_posn, block_width, row_height);
+                            rectangle = vector_plot_create_rect(symbol, i + xoffset, row_posn, block_width, row_height);
                         } else {
-                            rectangle = vector_plot_create_rect(i + xoffset, addon_text_posn - text_gap, block_width, addon_bar_height);
+                            rectangle = vector_plot_create_rect(symbol, i + xoffset, addon_text_posn - text_gap, block_width, addon_bar_height);
                         }
                         vector_plot_add_rect(symbol, rectangle, &last_rectangle);
                         rect_count++;
@@ -793,14 +793,14 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
             if (symbol->symbology != BARCODE_CODABLOCKF && symbol->symbology != BARCODE_HIBC_BLOCKF) {
                 for (r = 1; r < symbol->rows; r++) {
                     row_height = symbol->row_height[r - 1] ? symbol->row_height[r - 1] : large_bar_height;
-                    rectangle = vector_plot_create_rect(xoffset, (r * row_height) + yoffset - sep_height / 2, symbol->width, sep_height);
+                    rectangle = vector_plot_create_rect(symbol, xoffset, (r * row_height) + yoffset - sep_height / 2, symbol->width, sep_height);
                     vector_plot_add_rect(symbol, rectangle, &last_rectangle);
                 }
             } else {
                 for (r = 1; r < symbol->rows; r++) {
                     /* Avoid 11-module start and 13-module stop chars */
                     row_height = symbol->row_height[r - 1] ? symbol->row_height[r - 1] : large_bar_height;
-                    rectangle = vector_plot_create_rect(xoffset + 11, (r * row_height) + yoffset - sep_height / 2, symbol->width - 24, sep_height);
+                    rectangle = vector_plot_create_rect(symbol, xoffset + 11, (r * row_height) + yoffset - sep_height / 2, symbol->width - 24, sep_height);
                     vector_plot_add_rect(symbol, rectangle, &last_rectangle);
                 }
             }
@@ -809,14 +809,14 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
     if (symbol->border_width > 0) {
         if ((symbol->output_options & BARCODE_BOX) || (symbol->output_options & BARCODE_BIND)) {
             // Top
-            rectangle = vector_plot_create_rect(0.0f, 0.0f, vector->width, symbol->border_width);
+            rectangle = vector_plot_create_rect(symbol, 0.0f, 0.0f, vector->width, symbol->border_width);
             if (!(symbol->output_options & BARCODE_BOX) && (symbol->symbology == BARCODE_CODABLOCKF || symbol->symbology == BARCODE_HIBC_BLOCKF)) {
                 rectangle->x = xoffset;
                 rectangle->width -= (2.0f * xoffset);
             }
             vector_plot_add_rect(symbol, rectangle, &last_rectangle);
             // Bottom
-            rectangle = vector_plot_create_rect(0.0f, vector->height - symbol->border_width - textoffset, vector->width, symbol->border_width);
+            rectangle = vector_plot_create_rect(symbol, 0.0f, vector->height - symbol->border_width - textoffset, vector->width, symbol->border_width);
             if (!(symbol->output_options & BARCODE_BOX) && (symbol->symbology == BARCODE_CODABLOCKF || symbol->symbology == BARCODE_HIBC_BLOCKF)) {
                 rectangle->x = xoffset;
                 rectangle->width -= (2.0f * xoffset);
@@ -825,10 +825,10 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         }
         if (symbol->output_options & BARCODE_BOX) {
             // Left
-            rectangle = vector_plot_create_rect(0.0f, 0.0f, symbol->border_width, vector->height - textoffset);
+            rectangle = vector_plot_create_rect(symbol, 0.0f, 0.0f, symbol->border_width, vector->height - textoffset);
             vector_plot_add_rect(symbol, rectangle, &last_rectangle);
             // Right
-            rectangle = vector_plot_create_rect(vector->width - symbol->border_width, 0.0f, symbol->border_width, vector->height - textoffset);
+            rectangle = vector_plot_create_rect(symbol, vector->width - symbol->border_width, 0.0f, symbol->border_width, vector->height - textoffset);
             vector_plot_add_rect(symbol, rectangle, &last_rectangle);
         }
     }
@@ -857,3 +857,104 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
 
     return error_number;
 }
+
+/* Render `symbol` onto the page of `sheet` with its top left corner at `x`, `y`, moving its elements over to
+   `sheet->vector` rather than copying them */
+INTERNAL int plot_vector_sheet(struct zint_symbol *sheet, struct zint_symbol *symbol, const float x, const float y,
+            const int rotate_angle) {
+    struct zint_vector *vector;
+    struct zint_vector *page = sheet->vector;
+    struct zint_vector_rect *rect;
+    struct zint_vector_hexagon *hex;
+    struct zint_vector_circle *circle;
+    struct zint_vector_string *string;
+    const struct zint_allocator allocator = symbol->allocator;
+    int error_number;
+
+    /* The elements end up owned by `sheet` so must come from its allocator */
+    vector_free(symbol);
+    symbol->allocator = sheet->allocator;
+
+    error_number = plot_vector(symbol, rotate_angle, OUT_BUFFER);
+    if (error_number >= ZINT_ERROR) {
+        vector_free(symbol);
+        symbol->allocator = allocator;
+        return error_number;
+    }
+    vector = symbol->vector;
+
+    if (x < 0.0f || y < 0.0f || x + vector->width > page->width || y + vector->height > page->height) {
+        vector_free(symbol);
+        symbol->allocator = allocator;
+        strcpy(symbol->errtxt, "665: Symbol does not fit on sheet");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    /* Offset each element, then put the symbol's lists in front of the page's */
+    for (rect = vector->rectangles; rect; rect = rect->next) {
+        rect->x += x;
+        rect->y += y;
+        if (!rect->next) {
+            rect->next = page->rectangles;
+            page->rectangles = vector->rectangles;
+            vector->rectangles = NULL;
+            break;
+        }
+    }
+    for (hex = vector->hexagons; hex; hex = hex->next) {
+        hex->x += x;
+        hex->y += y;
+        if (!hex->next) {
+            hex->next = page->hexagons;
+            page->hexagons = vector->hexagons;
+            vector->hexagons = NULL;
+            break;
+        }
+    }
+    for (circle = vector->circles; circle; circle = circle->next) {
+        circle->x += x;
+        circle->y += y;
+        if (!circle->next) {
+            circle->next = page->circles;
+            page->circles = vector->circles;
+            vector->circles = NULL;
+            break;
+        }
+    }
+    for (string = vector->strings; string; string = string->next) {
+        string->x += x;
+        string->y += y;
+        if (!string->next) {
+            string->next = page->strings;
+            page->strings = vector->strings;
+            vector->strings = NULL;
+            break;
+        }
+    }
+
+    vector_free(symbol);
+    symbol->allocator = allocator;
+
+    return error_number;
+}
+
+/* Write the page of `sheet` to file */
+INTERNAL int plot_vector_page(struct zint_symbol *sheet, int file_type) {
+    int error_number;
+
+    error_number = output_check_colour_options(sheet);
+    if (error_number != 0) {
+        return error_number;
+    }
+
+    switch (file_type) {
+        case OUT_EPS_FILE:
+            error_number = ps_plot(sheet);
+            break;
+        case OUT_SVG_FILE:
+            error_number = svg_plot(sheet);
+            break;
+    }
+
+    return error_number;
+}
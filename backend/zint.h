@@ -33,6 +33,8 @@
 #ifndef ZINT_H
 #define ZINT_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -73,6 +75,31 @@ extern "C" {
         struct zint_vector_circle *circles; /* Points to first circle */
     };
 
+    struct zint_scratch; /* Opaque */
+
+    /* Memory functions used for all that libzint allocates on behalf of a symbol, see `ZBarcode_SetAllocator()` */
+    struct zint_allocator {
+        void *(*malloc_fn)(void *context, size_t size);
+        void *(*realloc_fn)(void *context, void *ptr, size_t size);
+        void (*free_fn)(void *context, void *ptr);
+        void *context; /* Passed as first argument to the above */
+    };
+
+    /* Fragment of input data, see `ZBarcode_Encode_Spans()` */
+    struct zint_span {
+        const unsigned char *source;
+        int length; /* Length of `source`, or if <= 0 `source` is NUL-terminated */
+    };
+
+    /* Caller-supplied pixel memory to render into, see `ZBarcode_Buffer_Into()` */
+    struct zint_pixbuf {
+        unsigned char *pixels; /* Top left pixel */
+        int width; /* In pixels */
+        int height; /* In pixels */
+        int stride; /* Bytes from the start of one row to the next */
+        int format; /* ZINT_PIXEL_XXX */
+    };
+
     struct zint_symbol {
         int symbology;
         int height;
@@ -108,6 +135,11 @@ extern "C" {
         struct zint_vector *vector;
         int debug;
         int warn_level;
+        int threads; /* Max threads for mask/size searches of large symbols, 0 or 1 for none (default) */
+        unsigned char *memfile; /* Output file contents if `BARCODE_MEMORY_FILE` set */
+        int memfile_size; /* Length of `memfile` */
+        struct zint_scratch *scratch; /* Internal working memory, kept between calls and freed by `ZBarcode_Delete()` */
+        struct zint_allocator allocator; /* Set by `ZBarcode_SetAllocator()`, all NULL for system allocator (default) */
     };
 
     /* Tbarcode 7 codes */
@@ -246,12 +278,14 @@ extern "C" {
 #define BARCODE_DOTTY_MODE      256
 #define GS1_GS_SEPARATOR        512
 #define OUT_BUFFER_INTERMEDIATE 1024
+#define BARCODE_MEMORY_FILE     2048
 
 // Input data types
 #define DATA_MODE               0
 #define UNICODE_MODE            1
 #define GS1_MODE                2
 #define ESCAPE_MODE             8
+#define GS1STRICT_MODE          16
 
 // Data Matrix specific options (option_3)
 #define DM_SQUARE               100
@@ -260,6 +294,12 @@ extern "C" {
 // QR, Han Xin, Grid Matrix specific options (option_3)
 #define ZINT_FULL_MULTIBYTE     200
 
+// Code 128, GS1-128 specific options (option_3)
+#define C128_OPTIMAL            300
+
+// PDF417, MicroPDF417 specific options (option_3)
+#define PDF_OPTIMAL             400
+
 // Ultracode specific option (option_3)
 #define ULTRA_COMPRESSION       128
 
@@ -309,6 +349,21 @@ extern "C" {
 // The largest amount of data that can be encoded is 4350 4-byte UTF-8 chars in Han Xin Code
 #define ZINT_MAX_FILE_LEN       17400
 
+// Maximum number of spans that may be given to `ZBarcode_Encode_Spans()`
+#define ZINT_MAX_SPANS          256
+
+// Pixel formats for `ZBarcode_Buffer_Into()`
+#define ZINT_PIXEL_RGB24        1   // 3 bytes red, green, blue
+#define ZINT_PIXEL_RGBA32       2   // 4 bytes red, green, blue, alpha (not premultiplied)
+#define ZINT_PIXEL_MONO1        3   // 1 bit, most significant first, set for foreground (ink)
+#define ZINT_PIXEL_GRAY8        4   // 1 byte luminance
+#define ZINT_PIXEL_RGBA32_PRE   5   // 4 bytes red, green, blue, alpha (premultiplied)
+#define ZINT_PIXEL_BGRA32_PRE   6   // 4 bytes blue, green, red, alpha (premultiplied)
+#define ZINT_PIXEL_PALETTE8     7   // 1 byte index, 0 background, 1 foreground, 2-9 Ultracode "WCBMRYGK"
+
+// Size of each bar-state string output by `ZBarcode_Encode_IMail_Batch()` (65 bars + NUL)
+#define ZINT_IMAIL_BAR_STATES   66
+
 // Debug flags
 #define ZINT_DEBUG_PRINT        1
 #define ZINT_DEBUG_TEST         2
@@ -331,17 +386,34 @@ extern "C" {
 
     ZINT_EXTERN int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length);
     ZINT_EXTERN int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename);
+    ZINT_EXTERN int ZBarcode_Encode_Spans(struct zint_symbol *symbol, const struct zint_span *spans, int count);
     ZINT_EXTERN int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_and_Print(struct zint_symbol *symbol, unsigned char *input, int length, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_File_and_Print(struct zint_symbol *symbol, char *filename, int rotate_angle);
 
     ZINT_EXTERN int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle);
+    ZINT_EXTERN int ZBarcode_Buffer_Into(struct zint_symbol *symbol, int rotate_angle, const struct zint_pixbuf *dst,
+                    int x, int y);
     ZINT_EXTERN int ZBarcode_Encode_and_Buffer(struct zint_symbol *symbol, unsigned char *input, int length, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_and_Buffer_Vector(struct zint_symbol *symbol, unsigned char *input, int length, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_File_and_Buffer(struct zint_symbol *symbol, char *filename, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_File_and_Buffer_Vector(struct zint_symbol *symbol, char *filename, int rotate_angle);
 
+    ZINT_EXTERN int ZBarcode_Sheet_Begin(struct zint_symbol *sheet, int width, int height);
+    ZINT_EXTERN int ZBarcode_Sheet_Add(struct zint_symbol *sheet, struct zint_symbol *symbol, float x, float y, int rotate_angle);
+    ZINT_EXTERN int ZBarcode_Sheet_Print(struct zint_symbol *sheet);
+
+    ZINT_EXTERN int ZBarcode_Cache_Size(int max_entries);
+    ZINT_EXTERN void ZBarcode_Cache_Stats(unsigned long *hits, unsigned long *misses, int *entries);
+
+    ZINT_EXTERN unsigned long ZBarcode_Scratch_Peak(const struct zint_symbol *symbol);
+
+    ZINT_EXTERN int ZBarcode_SetAllocator(struct zint_symbol *symbol, const struct zint_allocator *allocator);
+
+    ZINT_EXTERN int ZBarcode_Encode_IMail_Batch(const unsigned char *const *sources, const int *lengths, int count,
+                    char *bar_states, int *errors);
+
     ZINT_EXTERN int ZBarcode_ValidID(int symbol_id);
     ZINT_EXTERN unsigned int ZBarcode_Cap(int symbol_id, unsigned int cap_flag);
     ZINT_EXTERN int ZBarcode_Version();
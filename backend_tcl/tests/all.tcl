@@ -0,0 +1,8 @@
+# all.tcl --
+#
+# Run all tests of the zint package: tclsh all.tcl ?tcltest option value ...?
+
+package require tcltest 2
+namespace import ::tcltest::*
+configure {*}$argv -testdir [file dirname [file normalize [info script]]]
+runAllTests
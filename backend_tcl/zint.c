@@ -100,6 +100,12 @@
 - Alpha channel support added:
     - added option -nobackground
     - also allow RRGGBBAA for -fg and -bg options
+2026-10-19
+- added command "zint create" returning a handle command which keeps its
+  options between encodes (subcommands configure, encode, encodelist, destroy)
+- added command "zint encodelist" to encode a list of data in one call
+- render straight into a pixel buffer kept per interpreter using
+  ZBarcode_Buffer_Into(), which Tk_PhotoPutBlock() reads without copying
 */
 
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32)
@@ -156,6 +162,46 @@ static int Zint(ClientData unused, Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[]);
 static int Encode(Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[]);
+static int EncodeListCmd(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[]);
+static int Create(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[]);
+static int Handle(ClientData clientData, Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[]);
+static void HandleDelete(ClientData clientData);
+/*----------------------------------------------------------------------------*/
+/* >>>> Types */
+
+/* Encode settings decoded from options, kept between calls by handles */
+typedef struct {
+    struct zint_symbol *hSymbol;
+    int input_mode;     /* -format */
+    int option_1;       /* -secure, -mode, -rows */
+    int option_2;       /* -cols, -vers (before -addongap) */
+    int option_3;       /* -square, -dmre (before -fullmultibyte etc.) */
+    int height;
+    int whitespace_width;
+    int border_width;
+    int output_options;
+    int eci;
+    int rotate_angle;
+    int destX0;
+    int destY0;
+    int destWidth;
+    int destHeight;
+    int ECIIndex;
+    int fFullMultiByte;
+    int addon_gap;
+    int Separator;
+    int Mask;
+} ZintOptions;
+
+/* Pixel buffer of an interpreter that symbols are rendered into */
+typedef struct {
+    unsigned char *pPixels;
+    int Width;          /* Size in pixels of 4 bytes */
+    int Height;
+} ZintPixels;
 /*----------------------------------------------------------------------------*/
 /* >>>> File Global Variables */
 
@@ -450,6 +496,19 @@ static char help_message[] = "zint tcl(stub,obj) dll\n"
     "   -bold bool: use bold text\n"
     "   -to {x0 y0 ?width? ?height?}: place to put in photo image\n"
     "\n"
+    " zint encodelist dataList photoList option value...\n"
+    "  Encode each item of dataList into the photo at the same index of\n"
+    "  photoList. If photoList is empty, return a list of images instead,\n"
+    "  each a list {width height pixelsize bytes}, bytes RGB or RGBA if\n"
+    "  pixelsize 4. Options as above, warnings are not reported.\n"
+    "\n"
+    " zint create option value...\n"
+    "  Return a handle command keeping the given options (as above):\n"
+    "  handle configure option value...: change options\n"
+    "  handle encode data photo: as zint encode\n"
+    "  handle encodelist dataList photoList: as zint encodelist\n"
+    "  handle destroy: delete handle\n"
+    "\n"
     "zint symbologies: List available symbologies\n"
     "zint eci: List available eci tables\n"
     " zint help\n"
@@ -511,14 +570,16 @@ static int Zint(ClientData unused, Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[])
 {
     /* Option list and indexes */
-    enum iCommand {iEncode, iSymbologies, iECI, iVersion, iHelp};
+    enum iCommand {iEncode, iEncodeList, iCreate, iSymbologies, iECI,
+        iVersion, iHelp};
     /* choice of option */
     int Index;
     /*------------------------------------------------------------------------*/
     /* > Check if option argument is given and decode it */
     if (objc > 1)
     {
-    char *subCmds[] = {"encode", "symbologies", "eci", "version", "help", NULL};
+    char *subCmds[] = {"encode", "encodelist", "create", "symbologies", "eci",
+        "version", "help", NULL};
         if(Tcl_GetIndexFromObj(interp, objv[1], (const char **) subCmds,
             "option", 0, &Index)
             == TCL_ERROR)
@@ -536,6 +597,10 @@ static int Zint(ClientData unused, Tcl_Interp *interp, int objc,
     {
     case iEncode:
         return Encode(interp, objc, objv);
+    case iEncodeList:
+        return EncodeListCmd(interp, objc, objv);
+    case iCreate:
+        return Create(interp, objc, objv);
     case iSymbologies:
         {
             Tcl_Obj *oRes;
@@ -580,38 +645,36 @@ static int Zint(ClientData unused, Tcl_Interp *interp, int objc,
     }
 }
 /*----------------------------------------------------------------------------*/
-/* >>>>> Encode */
+/* >>>>> Options */
 /*----------------------------------------------------------------------------*/
-/* Encode image */
-static int Encode(Tcl_Interp *interp, int objc,
-    Tcl_Obj *CONST objv[])
+/* Initialise options to their defaults */
+static void InitOptions(ZintOptions *pOpts)
 {
-    struct zint_symbol *hSymbol;
-    Tcl_DString dsInput;
+    memset(pOpts, 0, sizeof(ZintOptions));
+    pOpts->hSymbol = ZBarcode_Create();
+    pOpts->input_mode = UNICODE_MODE;
+    pOpts->option_1 = -1;
+    pOpts->Separator = 1;
+}
+/*----------------------------------------------------------------------------*/
+/* Free option resources */
+static void FreeOptions(ZintOptions *pOpts)
+{
+    ZBarcode_Delete(pOpts->hSymbol);
+    pOpts->hSymbol = NULL;
+}
+/*----------------------------------------------------------------------------*/
+/* Decode option/value pairs from objv[firstPos] on into the options */
+static int ParseOptions(Tcl_Interp *interp, ZintOptions *pOpts, int objc,
+    Tcl_Obj *CONST objv[], int firstPos)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
     char *pStr = NULL;
     int lStr;
     Tcl_Encoding hZINTEncoding;
-    int rotate_angle=0;
     int fError = 0;
     Tcl_DString dString;
     int optionPos;
-    int destX0 = 0;
-    int destY0 = 0;
-    int destWidth = 0;
-    int destHeight = 0;
-    int ECIIndex = 0;
-    int fFullMultiByte = 0;
-    int addon_gap = 0;
-    int Separator = 1;
-    int Mask = 0;
-    /*------------------------------------------------------------------------*/
-    /* >> Check if at least data and object is given and a pair number of */
-    /* >> options */
-    if ( objc < 4 || (objc % 2) != 0 )
-    {
-        Tcl_WrongNumArgs(interp, 2, objv, "data photo ?-switch value?...");
-        return TCL_ERROR;
-    }
     /*------------------------------------------------------------------------*/
     /* >>> Prepare encoding */
     hZINTEncoding = Tcl_GetEncoding(interp, "utf-8");
@@ -619,13 +682,8 @@ static int Encode(Tcl_Interp *interp, int objc,
         return TCL_ERROR;
     }
     /*------------------------------------------------------------------------*/
-    /* >>> Prepare zint object */
-    hSymbol = ZBarcode_Create();
-    hSymbol->input_mode = UNICODE_MODE;
-    hSymbol->option_3 = 0;
-    /*------------------------------------------------------------------------*/
     /* >> Decode options */
-    for (optionPos = 4; optionPos < objc; optionPos+=2) {
+    for (optionPos = firstPos; optionPos < objc; optionPos+=2) {
         /*--------------------------------------------------------------------*/
         /* Option list and indexes */
         char *optionList[] = {
@@ -745,28 +803,28 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Invalid add-on gap value not within 7 to 12", -1));
                 fError = 1;
             } else {
-                addon_gap = intValue;
+                pOpts->addon_gap = intValue;
             }
             break;
         case iBind:
             if (intValue) {
-                hSymbol->output_options |= BARCODE_BIND;
+                pOpts->output_options |= BARCODE_BIND;
             } else {
-                hSymbol->output_options &= ~BARCODE_BIND;
+                pOpts->output_options &= ~BARCODE_BIND;
             }
             break;
         case iBold:
             if (intValue) {
-                hSymbol->output_options |= BOLD_TEXT;
+                pOpts->output_options |= BOLD_TEXT;
             } else {
-                hSymbol->output_options &= ~BOLD_TEXT;
+                pOpts->output_options &= ~BOLD_TEXT;
             }
             break;
         case iBox:
             if (intValue) {
-                hSymbol->output_options |= BARCODE_BOX;
+                pOpts->output_options |= BARCODE_BOX;
             } else {
-                hSymbol->output_options &= ~BARCODE_BOX;
+                pOpts->output_options &= ~BARCODE_BOX;
             }
             break;
         case iDotSize:
@@ -780,43 +838,43 @@ static int Encode(Tcl_Interp *interp, int objc,
             break;
         case iDotty:
             if (intValue) {
-                hSymbol->output_options |= BARCODE_DOTTY_MODE;
+                pOpts->output_options |= BARCODE_DOTTY_MODE;
             } else {
-                hSymbol->output_options &= ~BARCODE_DOTTY_MODE;
+                pOpts->output_options &= ~BARCODE_DOTTY_MODE;
             }
             break;
         case iGSSep:
             if (intValue) {
-                hSymbol->output_options |= GS1_GS_SEPARATOR;
+                pOpts->output_options |= GS1_GS_SEPARATOR;
             } else {
-                hSymbol->output_options &= ~GS1_GS_SEPARATOR;
+                pOpts->output_options &= ~GS1_GS_SEPARATOR;
             }
             break;
         case iFullMultiByte:
-            fFullMultiByte = intValue;
+            pOpts->fFullMultiByte = intValue;
             break;
         case iECI:
             if(Tcl_GetIndexFromObj(interp, objv[optionPos+1],
-                (const char **) s_eci_list,"-eci", optionPos, &ECIIndex)
+                (const char **) s_eci_list,"-eci", optionPos, &pOpts->ECIIndex)
                 == TCL_ERROR)
             {
                 fError = 1;
             } else {
-                hSymbol->eci = s_eci_number[ECIIndex];
+                pOpts->eci = s_eci_number[pOpts->ECIIndex];
             }
             break;
         case iInit:
             if (intValue) {
-                hSymbol->output_options |= READER_INIT;
+                pOpts->output_options |= READER_INIT;
             } else {
-                hSymbol->output_options &= ~READER_INIT;
+                pOpts->output_options &= ~READER_INIT;
             }
             break;
         case iSmallText:
             if (intValue) {
-                hSymbol->output_options |= SMALL_TEXT;
+                pOpts->output_options |= SMALL_TEXT;
             } else {
-                hSymbol->output_options &= ~SMALL_TEXT;
+                pOpts->output_options &= ~SMALL_TEXT;
             }
             break;
         case iFG:
@@ -838,12 +896,12 @@ static int Encode(Tcl_Interp *interp, int objc,
         case iSquare:
             /* DM_SQUARE overwrites DM_DMRE */
             if (intValue)
-                hSymbol->option_3 = DM_SQUARE;
+                pOpts->option_3 = DM_SQUARE;
             break;
         case iDMRE:
             /* DM_DMRE overwrites DM_SQUARE */
             if (intValue)
-                hSymbol->option_3 = DM_DMRE;
+                pOpts->option_3 = DM_DMRE;
             break;
         case iScale:
             if (doubleValue < 0.01) {
@@ -860,7 +918,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Border out of range", -1));
                 fError = 1;
             } else {
-                hSymbol->border_width = intValue;
+                pOpts->border_width = intValue;
             }
             break;
         case iHeight:
@@ -869,7 +927,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Height out of range", -1));
                 fError = 1;
             } else {
-                hSymbol->height = intValue;
+                pOpts->height = intValue;
             }
             break;
         case iSeparator:
@@ -878,7 +936,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Separator out of range", -1));
                 fError = 1;
             } else {
-                Separator = intValue;
+                pOpts->Separator = intValue;
             }
             break;
         case iMask:
@@ -887,7 +945,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Mask out of range", -1));
                 fError = 1;
             } else {
-                Mask = intValue + 1;
+                pOpts->Mask = intValue + 1;
             }
             break;
         case iCols:
@@ -901,7 +959,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("cols/vers out of range", -1));
                 fError = 1;
             } else {
-                hSymbol->option_2 = intValue;
+                pOpts->option_2 = intValue;
             }
             break;
         case iSecure:
@@ -916,7 +974,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("secure/mode/rows out of range", -1));
                 fError = 1;
             } else {
-                hSymbol->option_1 = intValue;
+                pOpts->option_1 = intValue;
             }
             break;
         case iPrimary:
@@ -939,10 +997,10 @@ static int Encode(Tcl_Interp *interp, int objc,
                     break;
                 }
                 switch (intValue) {
-                    case iRotate90: rotate_angle = 90; break;
-                    case iRotate180: rotate_angle = 180; break;
-                    case iRotate270: rotate_angle = 270; break;
-                    default: rotate_angle = 0; break;
+                    case iRotate90: pOpts->rotate_angle = 90; break;
+                    case iRotate180: pOpts->rotate_angle = 180; break;
+                    case iRotate270: pOpts->rotate_angle = 270; break;
+                    default: pOpts->rotate_angle = 0; break;
                 }
             }
             break;
@@ -957,7 +1015,7 @@ static int Encode(Tcl_Interp *interp, int objc,
             }
             break;
         case iWhiteSp:
-            hSymbol->whitespace_width = intValue;
+            pOpts->whitespace_width = intValue;
             break;
         case iTo:
             /* >> Decode the -to parameter as list of X0 Y0 ?Width Height? */
@@ -975,19 +1033,19 @@ static int Encode(Tcl_Interp *interp, int objc,
                 } else if ((
                     TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         0, &poParam)
-                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&destX0)
+                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&pOpts->destX0)
                     || TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         1, &poParam)
-                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&destY0)
+                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&pOpts->destY0)
                     || lStr == 4) && (
                     TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         2, &poParam)
                     || TCL_OK != Tcl_GetIntFromObj(interp,poParam,
-                        &destWidth)
+                        &pOpts->destWidth)
                     || TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         3, &poParam)
                     || TCL_OK != Tcl_GetIntFromObj(interp,poParam,
-                        &destHeight)
+                        &pOpts->destHeight)
                     ))
                 {
                     fError = 1;
@@ -1010,144 +1068,503 @@ static int Encode(Tcl_Interp *interp, int objc,
                     break;
                 }
                 switch (intValue) {
-                    case iBinary: hSymbol->input_mode = DATA_MODE; break;
-                    case iGS1: hSymbol->input_mode = GS1_MODE; break;
-                    default: hSymbol->input_mode = UNICODE_MODE; break;
+                    case iBinary: pOpts->input_mode = DATA_MODE; break;
+                    case iGS1: pOpts->input_mode = GS1_MODE; break;
+                    default: pOpts->input_mode = UNICODE_MODE; break;
                 }
             }
         }
     }
     /*------------------------------------------------------------------------*/
+    Tcl_FreeEncoding(hZINTEncoding);
+    if (fError) {
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Set the symbol fields the encoders may change or that depend on more */
+/* than one option, so that every encode of a handle starts the same */
+static void ApplyOptions(ZintOptions *pOpts)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
+    /*------------------------------------------------------------------------*/
+    hSymbol->input_mode = pOpts->input_mode;
+    hSymbol->option_1 = pOpts->option_1;
+    hSymbol->height = pOpts->height;
+    hSymbol->whitespace_width = pOpts->whitespace_width;
+    hSymbol->border_width = pOpts->border_width;
+    hSymbol->output_options = pOpts->output_options;
+    hSymbol->eci = pOpts->eci;
+    /* Not reset by ZBarcode_Clear() */
+    memset(hSymbol->row_height, 0, sizeof(hSymbol->row_height));
+    /*------------------------------------------------------------------------*/
     /* >>> option_3 is set by three values depending on the symbology */
     /* On wrong symbology, the option is ignored(as does the zint program)*/
-	if (fFullMultiByte && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_FULL_MULTIBYTE)) {
-		hSymbol->option_3 = ZINT_FULL_MULTIBYTE;
-	}
-	if (Mask && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_MASK)) {
-		hSymbol->option_3 |= Mask << 8;
-	}
-    if (Separator && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_STACKABLE)) {
-		hSymbol->option_3 = Separator;
-	}
+    hSymbol->option_3 = pOpts->option_3;
+    if (pOpts->fFullMultiByte
+        && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_FULL_MULTIBYTE))
+    {
+        hSymbol->option_3 = ZINT_FULL_MULTIBYTE;
+    }
+    if (pOpts->Mask && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_MASK)) {
+        hSymbol->option_3 |= pOpts->Mask << 8;
+    }
+    if (pOpts->Separator
+        && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_STACKABLE))
+    {
+        hSymbol->option_3 = pOpts->Separator;
+    }
     /*------------------------------------------------------------------------*/
     /* >>> option_2 is set by two values depending on the symbology */
     /* On wrong symbology, the option is ignored(as does the zint program)*/
-    if (addon_gap && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_EXTENDABLE)) {
-        hSymbol->option_2 = addon_gap;
+    hSymbol->option_2 = pOpts->option_2;
+    if (pOpts->addon_gap
+        && ZBarcode_Cap(hSymbol->symbology, ZINT_CAP_EXTENDABLE))
+    {
+        hSymbol->option_2 = pOpts->addon_gap;
+    }
+}
+/*----------------------------------------------------------------------------*/
+/* >>>>> Encode */
+/*----------------------------------------------------------------------------*/
+/* Get the encoding the input data is to be converted to, NULL for binary */
+static int GetDataEncoding(Tcl_Interp *interp, ZintOptions *pOpts,
+    Tcl_Encoding *phEncoding)
+{
+    *phEncoding = NULL;
+    if (pOpts->input_mode == DATA_MODE) {
+        return TCL_OK;
+    }
+    /* UTF8 Data (or ECI encoding) */
+    *phEncoding = Tcl_GetEncoding(interp,
+        s_eci_unicode_input[pOpts->ECIIndex]
+        ? "utf-8" : s_eci_list[pOpts->ECIIndex]);
+    if (NULL == *phEncoding) {
+        /* Interpreter has error message */
+        return TCL_ERROR;
     }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode data into the options symbol buffer. Any warning is left as the */
+/* interpreter result */
+static int EncodeData(Tcl_Interp *interp, ZintOptions *pOpts,
+    Tcl_Encoding hEncoding, Tcl_Obj *pData)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
+    Tcl_DString dsInput;
+    char *pStr;
+    int lStr;
+    int ErrorNumber;
+    /*------------------------------------------------------------------------*/
+    ZBarcode_Clear(hSymbol);
+    ApplyOptions(pOpts);
     /*------------------------------------------------------------------------*/
     /* >>> Prepare input dstring and encode it to ECI encoding*/
     Tcl_DStringInit(& dsInput);
-    /*------------------------------------------------------------------------*/
-    if (!fError) {
-        /*--------------------------------------------------------------------*/
-        /* >>> Get input mode */
-        if (hSymbol->input_mode == DATA_MODE) {
-            /* Binary data */
-            pStr = (char *) Tcl_GetByteArrayFromObj(objv[2], &lStr);
-        } else {
-            /* UTF8 Data (or ECI encoding) */
-            if ( ! s_eci_unicode_input[ECIIndex]) {
-                /* For this ECI, the Data must be encoded in the ECI encoding */
-                Tcl_FreeEncoding(hZINTEncoding);
-                hZINTEncoding = Tcl_GetEncoding(interp, s_eci_list[ECIIndex]);
-                if (NULL == hZINTEncoding) {
-                    /* Interpreter has error message */
-                    fError = 1;
-                }
-                /* we must indicate binary data */
-                hSymbol->input_mode = DATA_MODE;
-            }
-            if (! fError ) {
-                pStr = Tcl_GetStringFromObj(objv[2], &lStr);
-                Tcl_UtfToExternalDString( hZINTEncoding, pStr, lStr, &dsInput);
-                pStr = Tcl_DStringValue( &dsInput );
-                lStr = Tcl_DStringLength( &dsInput );
-            }
+    if (hEncoding == NULL) {
+        /* Binary data */
+        pStr = (char *) Tcl_GetByteArrayFromObj(pData, &lStr);
+    } else {
+        if ( ! s_eci_unicode_input[pOpts->ECIIndex]) {
+            /* For this ECI, the Data must be encoded in the ECI encoding */
+            /* we must indicate binary data */
+            hSymbol->input_mode = DATA_MODE;
         }
+        pStr = Tcl_GetStringFromObj(pData, &lStr);
+        Tcl_UtfToExternalDString( hEncoding, pStr, lStr, &dsInput);
+        pStr = Tcl_DStringValue( &dsInput );
+        lStr = Tcl_DStringLength( &dsInput );
     }
     /*------------------------------------------------------------------------*/
-    /* >>> Build symbol graphic */
-    if (! fError ) {
-        int ErrorNumber;
-        Tk_PhotoHandle hPhoto;
-        /*--------------------------------------------------------------------*/
-        /* call zint graphic creation to buffer */
-        ErrorNumber = ZBarcode_Encode_and_Buffer(hSymbol,
-            (unsigned char *) pStr, lStr, rotate_angle);
-        /*--------------------------------------------------------------------*/
-        /* >> Show a message */
-        if( 0 != ErrorNumber )
-        {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(hSymbol->errtxt, -1));
-        }        
-        if( ZINT_ERROR <= ErrorNumber )
-        {
-            /* >> Encode error */
-            fError = 1;
-        } else if (
-            NULL == (hPhoto = Tk_FindPhoto(interp, Tcl_GetString(objv[3]))))
+    /* call zint encode, the graphic is rendered by RenderPixels() */
+    ErrorNumber = ZBarcode_Encode(hSymbol, (unsigned char *) pStr, lStr);
+    Tcl_DStringFree(& dsInput);
+    /*------------------------------------------------------------------------*/
+    /* >> Show a message */
+    if( 0 != ErrorNumber )
+    {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(hSymbol->errtxt, -1));
+    }
+    if( ZINT_ERROR <= ErrorNumber )
+    {
+        /* >> Encode error */
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Free the interpreter pixel buffer */
+static void PixelsDelete(ClientData clientData, Tcl_Interp *interp)
+{
+    ZintPixels *pPixels = (ZintPixels *) clientData;
+    (void) interp;
+    if (pPixels->pPixels != NULL) {
+        ckfree((char *) pPixels->pPixels);
+    }
+    ckfree((char *) pPixels);
+}
+/*----------------------------------------------------------------------------*/
+/* Render the encoded options symbol straight into the pixel buffer of the */
+/* interpreter, which is kept between calls and grown as needed. */
+/* The rendering is described by *pPixbuf, rows of stride pPixbuf->stride */
+/* starting at pPixbuf->pixels, the size in hSymbol->bitmap_width/height */
+static int RenderPixels(Tcl_Interp *interp, ZintOptions *pOpts,
+    struct zint_pixbuf *pPixbuf)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
+    ZintPixels *pPixels;
+    int pixelSize;
+    int ErrorNumber;
+    /*------------------------------------------------------------------------*/
+    pPixels = (ZintPixels *) Tcl_GetAssocData(interp, "zint_pixels", NULL);
+    if (pPixels == NULL) {
+        pPixels = (ZintPixels *) ckalloc(sizeof(ZintPixels));
+        memset(pPixels, 0, sizeof(ZintPixels));
+        Tcl_SetAssocData(interp, "zint_pixels", PixelsDelete,
+            (ClientData) pPixels);
+    }
+    /* RGBA only if there is an alpha channel */
+    if (strlen(hSymbol->fgcolour) > 6 || strlen(hSymbol->bgcolour) > 6) {
+        pPixbuf->format = ZINT_PIXEL_RGBA32;
+        pixelSize = 4;
+    } else {
+        pPixbuf->format = ZINT_PIXEL_RGB24;
+        pixelSize = 3;
+    }
+    /*------------------------------------------------------------------------*/
+    for (;;) {
+        pPixbuf->pixels = pPixels->pPixels;
+        pPixbuf->width = pPixels->Width;
+        pPixbuf->height = pPixels->Height;
+        pPixbuf->stride = pPixels->Width * pixelSize;
+        ErrorNumber = ZBarcode_Buffer_Into(hSymbol, pOpts->rotate_angle,
+            pPixbuf, 0, 0);
+        if (ErrorNumber < ZINT_ERROR
+            || (hSymbol->bitmap_width <= pPixels->Width
+                && hSymbol->bitmap_height <= pPixels->Height))
         {
-            Tcl_SetObjResult(interp,
-                Tcl_NewStringObj("Unknown photo image", -1));
-            fError = 1;
-        } else {
-            Tk_PhotoImageBlock sImageBlock;
-            char * pImageRGBA = NULL;
-            if (hSymbol->alphamap == NULL) {
-                sImageBlock.pixelPtr = (unsigned char *) hSymbol->bitmap;
-                sImageBlock.width = hSymbol->bitmap_width;
-                sImageBlock.height = hSymbol->bitmap_height;
-                sImageBlock.pitch = 3*hSymbol->bitmap_width;
-                sImageBlock.pixelSize = 3;
-                sImageBlock.offset[0] = 0;
-                sImageBlock.offset[1] = 1;
-                sImageBlock.offset[2] = 2;
-                sImageBlock.offset[3] = 0;
+            break;
+        }
+        /* Does not fit: grow the buffer and render again */
+        if (pPixels->pPixels != NULL) {
+            ckfree((char *) pPixels->pPixels);
+        }
+        if (hSymbol->bitmap_width > pPixels->Width) {
+            pPixels->Width = hSymbol->bitmap_width;
+        }
+        if (hSymbol->bitmap_height > pPixels->Height) {
+            pPixels->Height = hSymbol->bitmap_height;
+        }
+        /* Always room for 4 byte pixels */
+        pPixels->pPixels = (unsigned char *) ckalloc(
+            pPixels->Width * pPixels->Height * 4);
+    }
+    if (ZINT_ERROR <= ErrorNumber) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(hSymbol->errtxt, -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Render the encoded options symbol into a photo image */
+static int PutPhoto(Tcl_Interp *interp, ZintOptions *pOpts, Tcl_Obj *pPhoto)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
+    Tk_PhotoHandle hPhoto;
+    Tk_PhotoImageBlock sImageBlock;
+    struct zint_pixbuf sPixbuf;
+    int destWidth = pOpts->destWidth;
+    int destHeight = pOpts->destHeight;
+    /*------------------------------------------------------------------------*/
+    if (NULL == (hPhoto = Tk_FindPhoto(interp, Tcl_GetString(pPhoto)))) {
+        Tcl_SetObjResult(interp,
+            Tcl_NewStringObj("Unknown photo image", -1));
+        return TCL_ERROR;
+    }
+    if (TCL_OK != RenderPixels(interp, pOpts, &sPixbuf)) {
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    /* The block points into the pixel buffer, no copy is made */
+    sImageBlock.pixelPtr = sPixbuf.pixels;
+    sImageBlock.width = hSymbol->bitmap_width;
+    sImageBlock.height = hSymbol->bitmap_height;
+    sImageBlock.pitch = sPixbuf.stride;
+    sImageBlock.offset[0] = 0;
+    sImageBlock.offset[1] = 1;
+    sImageBlock.offset[2] = 2;
+    if (sPixbuf.format == ZINT_PIXEL_RGBA32) {
+        sImageBlock.pixelSize = 4;
+        sImageBlock.offset[3] = 3;
+    } else {
+        sImageBlock.pixelSize = 3;
+        sImageBlock.offset[3] = 0;
+    }
+    if (0 == destWidth) {
+        destWidth = hSymbol->bitmap_width;
+    }
+    if (0 == destHeight) {
+        destHeight = hSymbol->bitmap_height;
+    }
+    return Tk_PhotoPutBlock(interp, hPhoto, &sImageBlock,
+        pOpts->destX0, pOpts->destY0, destWidth, destHeight,
+        TK_PHOTO_COMPOSITE_OVERLAY);
+}
+/*----------------------------------------------------------------------------*/
+/* Render the encoded options symbol as list {width height pixelsize bytes}, */
+/* the bytes RGB or, if pixelsize is 4, RGBA */
+static int BitmapObj(Tcl_Interp *interp, ZintOptions *pOpts,
+    Tcl_Obj **ppObj)
+{
+    struct zint_symbol *hSymbol = pOpts->hSymbol;
+    struct zint_pixbuf sPixbuf;
+    Tcl_Obj *aoElements[4];
+    int pixelSize;
+    int rowSize;
+    int row;
+    unsigned char *pBytes;
+    /*------------------------------------------------------------------------*/
+    if (TCL_OK != RenderPixels(interp, pOpts, &sPixbuf)) {
+        return TCL_ERROR;
+    }
+    pixelSize = sPixbuf.format == ZINT_PIXEL_RGBA32 ? 4 : 3;
+    rowSize = hSymbol->bitmap_width * pixelSize;
+    aoElements[0] = Tcl_NewIntObj(hSymbol->bitmap_width);
+    aoElements[1] = Tcl_NewIntObj(hSymbol->bitmap_height);
+    aoElements[2] = Tcl_NewIntObj(pixelSize);
+    aoElements[3] = Tcl_NewByteArrayObj(NULL, 0);
+    pBytes = Tcl_SetByteArrayLength(aoElements[3],
+        rowSize * hSymbol->bitmap_height);
+    for (row = 0; row < hSymbol->bitmap_height; row++) {
+        memcpy(pBytes + row * rowSize, sPixbuf.pixels + row * sPixbuf.stride,
+            rowSize);
+    }
+    *ppObj = Tcl_NewListObj(4, aoElements);
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode one data item into a photo */
+static int EncodePhoto(Tcl_Interp *interp, ZintOptions *pOpts,
+    Tcl_Obj *pData, Tcl_Obj *pPhoto)
+{
+    Tcl_Encoding hEncoding;
+    int Result;
+    /*------------------------------------------------------------------------*/
+    if (TCL_OK != GetDataEncoding(interp, pOpts, &hEncoding)) {
+        return TCL_ERROR;
+    }
+    Result = EncodeData(interp, pOpts, hEncoding, pData);
+    if (Result == TCL_OK) {
+        Result = PutPhoto(interp, pOpts, pPhoto);
+    }
+    if (hEncoding != NULL) {
+        Tcl_FreeEncoding(hEncoding);
+    }
+    return Result;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode a list of data items into a list of photos, or if the photo list */
+/* is empty, into a result list of raw images as given by BitmapObj(). */
+/* Warnings are not reported */
+static int EncodeList(Tcl_Interp *interp, ZintOptions *pOpts,
+    Tcl_Obj *pDataList, Tcl_Obj *pPhotoList)
+{
+    Tcl_Obj **ppData;
+    Tcl_Obj **ppPhoto;
+    Tcl_Obj *oRes = NULL;
+    int nData, nPhoto;
+    int index;
+    Tcl_Encoding hEncoding;
+    int Result = TCL_OK;
+    /*------------------------------------------------------------------------*/
+    if (TCL_OK != Tcl_ListObjGetElements(interp, pDataList, &nData, &ppData)
+        || TCL_OK != Tcl_ListObjGetElements(interp, pPhotoList, &nPhoto,
+            &ppPhoto))
+    {
+        return TCL_ERROR;
+    }
+    if (nPhoto != 0 && nPhoto != nData) {
+        Tcl_SetObjResult(interp,
+            Tcl_NewStringObj("Photo list not empty or same length as data list", -1));
+        return TCL_ERROR;
+    }
+    if (TCL_OK != GetDataEncoding(interp, pOpts, &hEncoding)) {
+        return TCL_ERROR;
+    }
+    if (nPhoto == 0) {
+        oRes = Tcl_NewObj();
+        Tcl_IncrRefCount(oRes);
+    }
+    /*------------------------------------------------------------------------*/
+    for (index = 0; index < nData && Result == TCL_OK; index++) {
+        Result = EncodeData(interp, pOpts, hEncoding, ppData[index]);
+        if (Result == TCL_OK) {
+            if (nPhoto != 0) {
+                Result = PutPhoto(interp, pOpts, ppPhoto[index]);
             } else {
-                int index;
-                /* Alpha channel present - prepare the image data in rgba order */
-                pImageRGBA = ckalloc(hSymbol->bitmap_width*hSymbol->bitmap_height*4);
-                for (index = 0; index < hSymbol->bitmap_width*hSymbol->bitmap_height; index++) {
-                    pImageRGBA[index*4] = hSymbol->bitmap[index*3];
-                    pImageRGBA[index*4+1] = hSymbol->bitmap[index*3+1];
-                    pImageRGBA[index*4+2] = hSymbol->bitmap[index*3+2];
-                    pImageRGBA[index*4+3] = hSymbol->alphamap[index];
+                Tcl_Obj *oBitmap;
+                Result = BitmapObj(interp, pOpts, &oBitmap);
+                if (Result == TCL_OK) {
+                    Result = Tcl_ListObjAppendElement(interp, oRes, oBitmap);
                 }
-                sImageBlock.pixelPtr = (unsigned char *) pImageRGBA;
-                sImageBlock.width = hSymbol->bitmap_width;
-                sImageBlock.height = hSymbol->bitmap_height;
-                sImageBlock.pitch = 4*hSymbol->bitmap_width;
-                sImageBlock.pixelSize = 4;
-                sImageBlock.offset[0] = 0;
-                sImageBlock.offset[1] = 1;
-                sImageBlock.offset[2] = 2;
-                sImageBlock.offset[3] = 3;
-            }
-            if (0 == destWidth) {
-                destWidth = hSymbol->bitmap_width;
-            }
-            if (0 == destHeight) {
-                destHeight = hSymbol->bitmap_height;
-            }
-            if (TCL_OK != Tk_PhotoPutBlock(interp, hPhoto, &sImageBlock,
-                destX0, destY0, destWidth, destHeight,
-                TK_PHOTO_COMPOSITE_OVERLAY))
-            {
-                fError = 1;
-            }
-            if (pImageRGBA != NULL) {
-                ckfree(pImageRGBA);
             }
         }
+        if (Result != TCL_OK) {
+            Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
+                "\n    (encoding list item %d)", index));
+        }
     }
     /*------------------------------------------------------------------------*/
-    Tcl_FreeEncoding(hZINTEncoding);
-    Tcl_DStringFree(& dsInput);
-    ZBarcode_Delete(hSymbol);
+    if (hEncoding != NULL) {
+        Tcl_FreeEncoding(hEncoding);
+    }
+    if (Result == TCL_OK) {
+        if (oRes != NULL) {
+            Tcl_SetObjResult(interp, oRes);
+        } else {
+            Tcl_ResetResult(interp);
+        }
+    }
+    if (oRes != NULL) {
+        Tcl_DecrRefCount(oRes);
+    }
+    return Result;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode image: zint encode data photo ?option value ...? */
+static int Encode(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    ZintOptions sOpts;
+    int Result;
     /*------------------------------------------------------------------------*/
-    if (fError) {
+    /* >> Check if at least data and object is given and a pair number of */
+    /* >> options */
+    if ( objc < 4 || (objc % 2) != 0 )
+    {
+        Tcl_WrongNumArgs(interp, 2, objv, "data photo ?-switch value?...");
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    InitOptions(&sOpts);
+    Result = ParseOptions(interp, &sOpts, objc, objv, 4);
+    if (Result == TCL_OK) {
+        Result = EncodePhoto(interp, &sOpts, objv[2], objv[3]);
+    }
+    FreeOptions(&sOpts);
+    return Result;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode images: zint encodelist dataList photoList ?option value ...? */
+static int EncodeListCmd(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    ZintOptions sOpts;
+    int Result;
+    /*------------------------------------------------------------------------*/
+    if ( objc < 4 || (objc % 2) != 0 )
+    {
+        Tcl_WrongNumArgs(interp, 2, objv,
+            "dataList photoList ?-switch value?...");
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    InitOptions(&sOpts);
+    Result = ParseOptions(interp, &sOpts, objc, objv, 4);
+    if (Result == TCL_OK) {
+        Result = EncodeList(interp, &sOpts, objv[2], objv[3]);
+    }
+    FreeOptions(&sOpts);
+    return Result;
+}
+/*----------------------------------------------------------------------------*/
+/* >>>>> Symbol handles */
+/*----------------------------------------------------------------------------*/
+/* Create a handle command keeping its options: zint create ?option value ...? */
+static int Create(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    static int s_handle_count = 0;
+    ZintOptions *pOpts;
+    char name[40];
+    /*------------------------------------------------------------------------*/
+    if ( (objc % 2) != 0 )
+    {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-switch value?...");
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    pOpts = (ZintOptions *) ckalloc(sizeof(ZintOptions));
+    InitOptions(pOpts);
+    if (TCL_OK != ParseOptions(interp, pOpts, objc, objv, 2)) {
+        FreeOptions(pOpts);
+        ckfree((char *) pOpts);
         return TCL_ERROR;
     }
+    sprintf(name, "zintsymbol%d", s_handle_count++);
+    Tcl_CreateObjCommand(interp, name, Handle, (ClientData) pOpts,
+        HandleDelete);
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(name, -1));
     return TCL_OK;
 }
+/*----------------------------------------------------------------------------*/
+/* Free a handle when its command is deleted */
+static void HandleDelete(ClientData clientData)
+{
+    ZintOptions *pOpts = (ZintOptions *) clientData;
+    FreeOptions(pOpts);
+    ckfree((char *) pOpts);
+}
+/*----------------------------------------------------------------------------*/
+/* Decode handle commands */
+static int Handle(ClientData clientData, Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    ZintOptions *pOpts = (ZintOptions *) clientData;
+    /* Option list and indexes */
+    char *subCmds[] = {"configure", "encode", "encodelist", "destroy", NULL};
+    enum iCommand {iConfigure, iEncode, iEncodeList, iDestroy};
+    int Index;
+    /*------------------------------------------------------------------------*/
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "option ?arg ...?");
+        return TCL_ERROR;
+    }
+    if(Tcl_GetIndexFromObj(interp, objv[1], (const char **) subCmds,
+        "option", 0, &Index)
+        == TCL_ERROR)
+    {
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    switch (Index) {
+    case iConfigure:
+        if ( (objc % 2) != 0 ) {
+            Tcl_WrongNumArgs(interp, 2, objv, "?-switch value?...");
+            return TCL_ERROR;
+        }
+        return ParseOptions(interp, pOpts, objc, objv, 2);
+    case iEncode:
+        if (objc != 4) {
+            Tcl_WrongNumArgs(interp, 2, objv, "data photo");
+            return TCL_ERROR;
+        }
+        return EncodePhoto(interp, pOpts, objv[2], objv[3]);
+    case iEncodeList:
+        if (objc != 4) {
+            Tcl_WrongNumArgs(interp, 2, objv, "dataList photoList");
+            return TCL_ERROR;
+        }
+        return EncodeList(interp, pOpts, objv[2], objv[3]);
+    case iDestroy:
+    default:
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, NULL);
+            return TCL_ERROR;
+        }
+        Tcl_DeleteCommandFromToken(interp, Tcl_GetCommandFromObj(interp, objv[0]));
+        return TCL_OK;
+    }
+}
@@ -108,6 +108,14 @@ SOURCE=..\backend\bmp.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\cache.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\backend\scratch.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\codablock.c
 # End Source File
 # Begin Source File
@@ -156,6 +164,10 @@ SOURCE=..\backend\emf.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\filemem.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\gb18030.c
 # End Source File
 # Begin Source File
@@ -212,6 +224,10 @@ SOURCE=..\backend\output.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\parallel.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\pcx.c
 # End Source File
 # Begin Source File
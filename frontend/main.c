@@ -23,6 +23,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+#ifndef ZINT_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
 #ifndef _MSC_VER
 #include <getopt.h>
 #include <zint.h>
@@ -97,6 +109,7 @@ static void usage(void) {
     printf( "Encode input data in a barcode and save as BMP/EMF/EPS/GIF/PCX/PNG/SVG/TIF/TXT\n\n"
             "  -b, --barcode=NUMBER  Number of barcode type. Default is 20 (Code 128)\n"
             "  --addongap=NUMBER     Set add-on gap in multiples of X-dimension for UPC/EAN\n"
+            "  --archive=FILE        Write batch output to single tar archive FILE\n"
             "  --batch               Treat each line of input file as a separate data set\n"
             "  --bg=COLOUR           Specify a background colour (in hex)\n"
             "  --binary              Treat input as raw binary data\n"
@@ -104,6 +117,7 @@ static void usage(void) {
             "  --bold                Use bold text\n"
             "  --border=NUMBER       Set width of border in multiples of X-dimension\n"
             "  --box                 Add a box around the symbol\n"
+            "  --c128opt             Use minimal width code set selection (Code 128/GS1-128)\n"
             "  --cmyk                Use CMYK colour space in EPS symbols\n"
             "  --cols=NUMBER         Set the number of data columns in symbol\n"
             "  -d, --data=DATA       Set the symbol content\n"
@@ -118,7 +132,9 @@ static void usage(void) {
             "  --fg=COLOUR           Specify a foreground colour (in hex)\n"
             "  --filetype=TYPE       Set output file type BMP/EMF/EPS/GIF/PCX/PNG/SVG/TIF/TXT\n"
             "  --fullmultibyte       Use multibyte for binary/Latin (QR/Han Xin/Grid Matrix)\n"
+            "  --grid=COLSxROWS      Arrange batch symbols in COLS x ROWS cells of sheet\n"
             "  --gs1                 Treat input as GS1 compatible data\n"
+            "  --gs1strict           Check GS1 data content (digits, check digits, dates)\n"
             "  --gssep               Use separator GS for GS1 (Data Matrix)\n"
             "  -h, --help            Display help message\n"
             "  --height=NUMBER       Set height of symbol in multiples of X-dimension\n"
@@ -130,15 +146,19 @@ static void usage(void) {
             "  --nobackground        Remove background (PNG/SVG/EPS only)\n"
             "  --notext              Remove human readable text\n"
             "  -o, --output=FILE     Send output to FILE. Default is out.png\n"
+            "  --pdfopt              Use minimal codeword compaction (PDF417/MicroPDF417)\n"
             "  --primary=STRING      Set structured primary message (Maxicode/Composite)\n"
+            "  --rawstream           Write batch bitmaps to stdout, each preceded by size\n"
             "  -r, --reverse         Reverse colours (white on black)\n"
             "  --rotate=NUMBER       Rotate symbol by NUMBER degrees\n"
             "  --rows=NUMBER         Set number of rows (Codablock-F)\n"
             "  --scale=NUMBER        Adjust size of X-dimension\n"
             "  --secure=NUMBER       Set error correction level (ECC)\n"
             "  --separator=NUMBER    Set height of row separator bars (stacked symbologies)\n"
+            "  --sheet=WIDTHxHEIGHT  Place batch symbols on pages of WIDTH x HEIGHT pixels\n"
             "  --small               Use small text\n"
             "  --square              Force Data Matrix symbols to be square\n"
+            "  --threads=NUMBER      Use NUMBER threads (batch lines, QR/Han Xin/DotCode masks)\n"
             "  -t, --types           Display table of barcode types\n"
             "  --vers=NUMBER         Set symbol version (size, check digits, other options)\n"
             "  -w, --whitesp=NUMBER  Set width of whitespace in multiples of X-dimension\n"
@@ -198,6 +218,24 @@ static int validator(char test_string[], char source[]) {
     return 0;
 }
 
+/* Parse "NUMBERxNUMBER" into `first` and `second`, both of which must be non-zero. Returns 0 if invalid */
+static int dimensions(const char *arg, int *first, int *second) {
+    char buf[22];
+    char *x;
+
+    if (strlen(arg) >= sizeof(buf) || !(x = strchr(strcpy(buf, arg), 'x'))) {
+        return 0;
+    }
+    *x = '\0';
+    if (!*buf || !x[1] || validator(NESET, buf) || validator(NESET, x + 1) || strlen(buf) > 9 || strlen(x + 1) > 9) {
+        return 0;
+    }
+    *first = atoi(buf);
+    *second = atoi(x + 1);
+
+    return *first && *second;
+}
+
 /* Converts an integer value to its hexadecimal character */
 static char itoc(int source) {
     if ((source >= 0) && (source <= 9)) {
@@ -294,18 +332,486 @@ static int is_raster(char *filetype) {
     return 0;
 }
 
-static int batch_process(struct zint_symbol *symbol, char *filename, int mirror_mode, char *filetype, int rotate_angle) {
+/* Number of lines read ahead and shared out between batch worker threads in one go, per thread */
+#define BATCH_LINES_PER_THREAD  64
+
+/* Maximum number of batch worker threads */
+#define BATCH_MAX_THREADS       64
+
+/* Batch output containers - separate files (default), tar archive, stream of raw bitmaps on stdout or sheets */
+#define BATCH_FILES             0
+#define BATCH_TAR               1
+#define BATCH_RAW               2
+#define BATCH_SHEET             3
+
+/* Page size and layout of batch sheets */
+struct batch_sheet {
+    int width;
+    int height;
+    int columns;
+    int rows;
+};
+
+/* Buffered reader of batch input lines */
+struct batch_reader {
     FILE *file;
-    unsigned char buffer[ZINT_MAX_FILE_LEN] = {0}; // Maximum HanXin input
-    unsigned char character = 0;
-    int posn = 0, error_number = 0, line_count = 1;
+    size_t chunk; /* Amount to read at a time, 1 for stdin so that lines are processed as they arrive */
+    size_t pos;
+    size_t len;
+    int last; /* Last character read, or EOF if none */
+    unsigned char buf[65536];
+};
+
+/* A line of batch input and the result of encoding it */
+struct batch_line {
+    size_t offset; /* Of data in `batch_round.data` */
+    int length;
+    int line_count;
+    int too_long;
+    int error_number;
     char output_file[256];
+    char errtxt[100];
+    unsigned char *output; /* Output file contents (BATCH_TAR) or bitmap (BATCH_RAW) */
+    size_t output_size;
+    int width; /* Bitmap dimensions (BATCH_RAW) */
+    int height;
+};
+
+/* Lines read in one go and the workers encoding them, each worker `thread` taking every `threads`th line */
+struct batch_round {
+    const struct zint_symbol *template_symbol;
+    struct zint_symbol *workers[BATCH_MAX_THREADS];
+    int threads;
+    int rotate_angle;
+    int container;
+    struct zint_symbol *sheet; /* Page being filled (BATCH_SHEET) */
+    const struct batch_sheet *layout;
+    int cell; /* Next free cell of page */
+    unsigned char *data;
+    size_t data_size;
+    struct batch_line *lines;
+    int count;
+};
+
+/* Make sure `round->data` can hold at least `size` bytes */
+static int batch_reserve(struct batch_round *round, const size_t size) {
+    if (size > round->data_size) {
+        size_t data_size = round->data_size * 2 > size ? round->data_size * 2 : size;
+        unsigned char *data = (unsigned char *) realloc(round->data, data_size);
+        if (!data) {
+            return 0;
+        }
+        round->data = data;
+        round->data_size = data_size;
+    }
+    return 1;
+}
+
+/* Read the next newline-terminated line into `round->data` at `offset` (NUL-terminated), returning 0 at end of input
+   (an unterminated last line is ignored). A line of ZINT_MAX_FILE_LEN or more is skipped and marked too long */
+static int batch_read_line(struct batch_reader *reader, struct batch_round *round, const size_t offset,
+            struct batch_line *line) {
+    size_t raw_len = 0;
+
+    line->offset = offset;
+    line->length = 0;
+    line->too_long = 0;
+
+    for (;;) {
+        unsigned char *start, *nl;
+        size_t avail, n;
+
+        if (reader->pos == reader->len) {
+            reader->len = fread(reader->buf, 1, reader->chunk, reader->file);
+            reader->pos = 0;
+            if (reader->len == 0) {
+                return 0;
+            }
+        }
+        start = reader->buf + reader->pos;
+        avail = reader->len - reader->pos;
+        nl = (unsigned char *) memchr(start, '\n', avail);
+        n = nl ? (size_t) (nl - start) : avail;
+
+        if (raw_len + n < ZINT_MAX_FILE_LEN) {
+            if (batch_reserve(round, offset + raw_len + n + 1)) {
+                memcpy(round->data + offset + raw_len, start, n);
+            } else {
+                line->too_long = 1; /* Treat lack of memory as too long */
+            }
+        }
+        raw_len += n;
+        reader->last = nl ? '\n' : start[avail - 1];
+        reader->pos += nl ? n + 1 : n;
+
+        if (nl) {
+            break;
+        }
+    }
+
+    if (raw_len >= ZINT_MAX_FILE_LEN || line->too_long || !batch_reserve(round, offset + raw_len + 1)) {
+        line->too_long = 1;
+        return 1;
+    }
+    line->length = (int) raw_len;
+    if (line->length > 0 && round->data[offset + line->length - 1] == '\r') {
+        /* CR+LF - assume Windows formatting and remove CR */
+        line->length--;
+    }
+    round->data[offset + line->length] = '\0';
+
+    return 1;
+}
+
+/* Set the output filename of a batch line, either numbered from `format_string` or named from the data */
+static void batch_output_file(const unsigned char data[], const int length, const int line_count, const int mirror_mode,
+            const char *format_string, const char *filetype, const int input_mode, char output_file[256]) {
     char number[12], reverse_number[12];
     int inpos, local_line_count;
-    char format_string[256], reversed_string[256], format_char;
+    char reversed_string[256], format_char;
     int format_len, i, o;
     char adjusted[2] = {0};
 
+    if (mirror_mode == 0) {
+        inpos = 0;
+        local_line_count = line_count;
+        memset(number, 0, sizeof(number));
+        memset(reverse_number, 0, sizeof(reverse_number));
+        memset(reversed_string, 0, sizeof(reversed_string));
+        memset(output_file, 0, 256);
+        do {
+            number[inpos] = itoc(local_line_count % 10);
+            local_line_count /= 10;
+            inpos++;
+        } while (local_line_count > 0);
+        number[inpos] = '\0';
+
+        for (i = 0; i < inpos; i++) {
+            reverse_number[i] = number[inpos - i - 1];
+        }
+
+        format_len = strlen(format_string);
+        for (i = format_len; i > 0; i--) {
+            format_char = format_string[i - 1];
+
+            switch (format_char) {
+                case '#':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = ' ';
+                    }
+                    break;
+                case '~':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = '0';
+                    }
+                    break;
+                case '@':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = '*';
+                    }
+                    break;
+                default:
+                    adjusted[0] = format_string[i - 1];
+                    break;
+            }
+            strcat(reversed_string, adjusted);
+        }
+
+        for (i = 0; i < format_len; i++) {
+            output_file[i] = reversed_string[format_len - i - 1];
+        }
+    } else {
+        /* Name the output file from the data being processed */
+        i = 0;
+        o = 0;
+        do {
+            if (data[i] < 0x20) {
+                output_file[o] = '_';
+            } else {
+                switch (data[i]) {
+                    case 0x21: // !
+                    case 0x22: // "
+                    case 0x2a: // *
+                    case 0x2f: // /
+                    case 0x3a: // :
+                    case 0x3c: // <
+                    case 0x3e: // >
+                    case 0x3f: // ?
+                    case 0x5c: // Backslash
+                    case 0x7c: // |
+                    case 0x7f: // DEL
+                        output_file[o] = '_';
+                        break;
+                    default:
+                        output_file[o] = data[i];
+                        break;
+                }
+            }
+
+            // Skip escape characters
+            if ((data[i] == 0x5c) && (input_mode & ESCAPE_MODE)) {
+                i++;
+                if (data[i] == 'x') {
+                    i += 2;
+                }
+            }
+            i++;
+            o++;
+        } while (i < length && o < 251);
+
+        /* Add file extension */
+        output_file[o] = '.';
+        output_file[o + 1] = '\0';
+
+        strcat(output_file, filetype);
+    }
+
+}
+
+/* Encode and output the lines allotted to worker `thread` */
+static void batch_encode(struct batch_round *round, const int thread) {
+    struct zint_symbol *symbol = round->workers[thread];
+    int i;
+
+    for (i = thread; i < round->count; i += round->threads) {
+        struct batch_line *line = &round->lines[i];
+        struct zint_scratch *scratch = symbol->scratch;
+        if (line->too_long) {
+            continue;
+        }
+        /* Start each line afresh from the user's settings */
+        memcpy(symbol, round->template_symbol, sizeof(*symbol));
+        symbol->fgcolor = &symbol->fgcolour[0];
+        symbol->bgcolor = &symbol->bgcolour[0];
+        symbol->scratch = scratch; /* Keep the worker's own working memory */
+
+        strcpy(symbol->outfile, line->output_file);
+        if (round->container == BATCH_SHEET) {
+            /* Place in next free cell, reading left to right, top to bottom */
+            line->error_number = ZBarcode_Encode(symbol, round->data + line->offset, line->length);
+            if (line->error_number < ZINT_ERROR) {
+                const int column = round->cell % round->layout->columns;
+                const int row = round->cell / round->layout->columns;
+                const int error_number = ZBarcode_Sheet_Add(round->sheet, symbol,
+                                            (float) (round->layout->width / round->layout->columns * column),
+                                            (float) (round->layout->height / round->layout->rows * row),
+                                            round->rotate_angle);
+                if (error_number < ZINT_ERROR) {
+                    round->cell++;
+                } else {
+                    line->error_number = error_number;
+                    strcpy(symbol->errtxt, round->sheet->errtxt);
+                }
+            }
+        } else if (round->container == BATCH_RAW) {
+            line->error_number = ZBarcode_Encode_and_Buffer(symbol, round->data + line->offset, line->length,
+                                    round->rotate_angle);
+            if (line->error_number < ZINT_ERROR) {
+                /* Take over the bitmap so it survives the clear */
+                line->output = symbol->bitmap;
+                line->output_size = (size_t) symbol->bitmap_width * symbol->bitmap_height * 3;
+                line->width = symbol->bitmap_width;
+                line->height = symbol->bitmap_height;
+                symbol->bitmap = NULL;
+            }
+        } else {
+            line->error_number = ZBarcode_Encode_and_Print(symbol, round->data + line->offset, line->length,
+                                    round->rotate_angle);
+            if (round->container == BATCH_TAR && line->error_number < ZINT_ERROR) {
+                line->output = symbol->memfile;
+                line->output_size = symbol->memfile_size;
+                symbol->memfile = NULL;
+            }
+        }
+        strcpy(line->errtxt, symbol->errtxt);
+        ZBarcode_Clear(symbol);
+    }
+}
+
+#ifndef ZINT_NO_THREADS
+struct batch_worker {
+    struct batch_round *round;
+    int thread;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI batch_thread(LPVOID arg) {
+    struct batch_worker *worker = (struct batch_worker *) arg;
+    batch_encode(worker->round, worker->thread);
+    return 0;
+}
+#else
+static void *batch_thread(void *arg) {
+    struct batch_worker *worker = (struct batch_worker *) arg;
+    batch_encode(worker->round, worker->thread);
+    return NULL;
+}
+#endif
+#endif /* ZINT_NO_THREADS */
+
+/* Share out the lines of a round between the workers and wait for them to finish. Workers that can't be started
+   have their lines done by the calling thread */
+static void batch_run(struct batch_round *round) {
+#ifndef ZINT_NO_THREADS
+    struct batch_worker workers[BATCH_MAX_THREADS];
+#ifdef _WIN32
+    HANDLE handles[BATCH_MAX_THREADS];
+#else
+    pthread_t handles[BATCH_MAX_THREADS];
+#endif
+    int started[BATCH_MAX_THREADS];
+    int t;
+
+    for (t = 1; t < round->threads && t < round->count; t++) {
+        workers[t].round = round;
+        workers[t].thread = t;
+#ifdef _WIN32
+        handles[t] = CreateThread(NULL, 0, batch_thread, &workers[t], 0, NULL);
+        started[t] = handles[t] != NULL;
+#else
+        started[t] = pthread_create(&handles[t], NULL, batch_thread, &workers[t]) == 0;
+#endif
+    }
+
+    batch_encode(round, 0);
+
+    for (t = 1; t < round->threads && t < round->count; t++) {
+        if (started[t]) {
+#ifdef _WIN32
+            WaitForSingleObject(handles[t], INFINITE);
+            CloseHandle(handles[t]);
+#else
+            pthread_join(handles[t], NULL);
+#endif
+        } else {
+            batch_encode(round, t);
+        }
+    }
+#else
+    batch_encode(round, 0);
+#endif /* ZINT_NO_THREADS */
+}
+
+/* Put `value` in tar header field `field` of `size` bytes as NUL-terminated zero-padded octal */
+static void batch_tar_octal(char *field, const int size, unsigned long long value) {
+    int i;
+
+    field[size - 1] = '\0';
+    for (i = size - 2; i >= 0; i--) {
+        field[i] = '0' + (char) (value & 7);
+        value >>= 3;
+    }
+}
+
+/* Write ustar archive member `name` with contents `output`. Returns 0 on failure */
+static int batch_tar_member(FILE *archive, const char *name, const unsigned char *output, const size_t output_size,
+            const time_t mtime) {
+    static const char zeroes[512] = {0};
+    char header[512];
+    const char *slash;
+    size_t name_len = strlen(name);
+    unsigned int checksum = 0;
+    int i;
+
+    memset(header, 0, sizeof(header));
+    if (name_len <= 100) {
+        memcpy(header, name, name_len);
+    } else {
+        /* Split at the first directory separator leaving a name short enough, the rest going in the prefix */
+        for (slash = strchr(name, '/'); slash && name_len - (slash - name) - 1 > 100; slash = strchr(slash + 1, '/'));
+        if (!slash || slash - name > 155) {
+            return 0;
+        }
+        memcpy(header, slash + 1, name + name_len - slash - 1);
+        memcpy(header + 345, name, slash - name);
+    }
+    batch_tar_octal(header + 100, 8, 0644); /* mode */
+    batch_tar_octal(header + 108, 8, 0); /* uid */
+    batch_tar_octal(header + 116, 8, 0); /* gid */
+    batch_tar_octal(header + 124, 12, output_size);
+    batch_tar_octal(header + 136, 12, (unsigned long long) mtime);
+    header[156] = '0'; /* Regular file */
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+
+    memset(header + 148, ' ', 8); /* Checksum is calculated with its own field as spaces */
+    for (i = 0; i < 512; i++) {
+        checksum += (unsigned char) header[i];
+    }
+    batch_tar_octal(header + 148, 7, checksum);
+
+    if (fwrite(header, 1, 512, archive) != 512 || fwrite(output, 1, output_size, archive) != output_size) {
+        return 0;
+    }
+    if (output_size % 512 && fwrite(zeroes, 1, 512 - output_size % 512, archive) != 512 - output_size % 512) {
+        return 0;
+    }
+    return 1;
+}
+
+/* Write raw RGB bitmap preceded by its width and height as 4-byte big-endian integers, all zero if none.
+   Returns 0 on failure */
+static int batch_raw_bitmap(FILE *stream, const unsigned char *output, const size_t output_size, const int width,
+            const int height) {
+    unsigned char header[8];
+
+    header[0] = (unsigned char) (width >> 24);
+    header[1] = (unsigned char) (width >> 16);
+    header[2] = (unsigned char) (width >> 8);
+    header[3] = (unsigned char) width;
+    header[4] = (unsigned char) (height >> 24);
+    header[5] = (unsigned char) (height >> 16);
+    header[6] = (unsigned char) (height >> 8);
+    header[7] = (unsigned char) height;
+
+    return fwrite(header, 1, 8, stream) == 8 && (!output_size || fwrite(output, 1, output_size, stream) == output_size);
+}
+
+/* Print the page of `round->sheet` as numbered `page` and begin the next. Returns 0 on failure */
+static int batch_sheet_page(struct batch_round *round, const char *format_string, const char *filetype,
+            const int page) {
+    int error_number;
+
+    if (round->cell) {
+        error_number = ZBarcode_Sheet_Print(round->sheet);
+        if (error_number >= ZINT_ERROR) {
+            return 0;
+        }
+        round->cell = 0;
+    }
+    batch_output_file(NULL, 0, page, 0 /*mirror_mode*/, format_string, filetype, round->sheet->input_mode,
+            round->sheet->outfile);
+
+    return ZBarcode_Sheet_Begin(round->sheet, round->layout->width, round->layout->height) < ZINT_ERROR;
+}
+
+/* Encode each line of `filename` as a separate symbol, output to separate files or, if `archive_file` given, to a
+   single tar archive, or if `raw_stream` set, as raw bitmaps to stdout, or if `layout` given, arranged on numbered
+   pages. With `symbol->threads` > 1 lines are encoded by that many worker threads (unless output is to separate files
+   on stdout or to pages), output and errors being in line order */
+static int batch_process(struct zint_symbol *symbol, char *filename, int mirror_mode, char *filetype, int rotate_angle,
+            const char *archive_file, const int raw_stream, const struct batch_sheet *layout) {
+    FILE *file;
+    FILE *output = NULL;
+    time_t mtime = 0;
+    struct batch_reader *reader;
+    struct batch_round round;
+    struct zint_symbol template_symbol;
+    int error_number = 0, line_count = 1;
+    char format_string[256];
+    int max_lines, eof = 0, write_error = 0;
+    int page = 1;
+    int i, t;
+
     if (symbol->outfile[0] == '\0') {
         strcpy(format_string, "~~~~~.");
         strcat(format_string, filetype);
@@ -324,152 +830,199 @@ static int batch_process(struct zint_symbol *symbol, char *filename, int mirror_
         }
     }
 
-    do {
-        int intChar;
-        intChar = fgetc(file);
-        if (intChar == EOF) {
+    memset(&round, 0, sizeof(round));
+    round.container = raw_stream ? BATCH_RAW : archive_file ? BATCH_TAR : layout ? BATCH_SHEET : BATCH_FILES;
+    if (round.container == BATCH_SHEET) {
+        /* Pages take their settings (colours, output options) from the user's as well */
+        if ((round.sheet = ZBarcode_Create())) {
+            memcpy(round.sheet, symbol, sizeof(*symbol));
+            round.sheet->fgcolor = &round.sheet->fgcolour[0];
+            round.sheet->bgcolor = &round.sheet->bgcolour[0];
+            round.sheet->scratch = NULL;
+            round.layout = layout;
+        }
+        if (!round.sheet || !batch_sheet_page(&round, format_string, filetype, page)) {
+            if (file != stdin) {
+                fclose(file);
+            }
+            if (round.sheet) {
+                strcpy(symbol->errtxt, round.sheet->errtxt);
+                ZBarcode_Delete(round.sheet);
+                return ZINT_ERROR_INVALID_OPTION;
+            }
+            strcpy(symbol->errtxt, "105: Insufficient memory for batch processing");
+            return ZINT_ERROR_MEMORY;
+        }
+    } else if (round.container == BATCH_RAW) {
+#ifdef _WIN32
+        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
+            if (file != stdin) {
+                fclose(file);
+            }
+            strcpy(symbol->errtxt, "153: Could not set stdout to binary mode");
+            return ZINT_ERROR_FILE_ACCESS;
+        }
+#endif
+        output = stdout;
+    } else if (round.container == BATCH_TAR) {
+        if (!(output = fopen(archive_file, "wb"))) {
+            if (file != stdin) {
+                fclose(file);
+            }
+            strcpy(symbol->errtxt, "151: Could not open archive file");
+            return ZINT_ERROR_FILE_ACCESS;
+        }
+        mtime = time(NULL);
+    }
+    round.threads = 1;
+#ifndef ZINT_NO_THREADS
+    /* Separate files output to stdout must be in order, as must symbols placed on sheets, so are done by the calling
+       thread only */
+    if (symbol->threads > 1 && round.container != BATCH_SHEET
+            && (round.container != BATCH_FILES || !(symbol->output_options & BARCODE_STDOUT))) {
+        round.threads = symbol->threads > BATCH_MAX_THREADS ? BATCH_MAX_THREADS : symbol->threads;
+    }
+#endif
+    max_lines = round.threads > 1 ? round.threads * BATCH_LINES_PER_THREAD : 1;
+
+    memcpy(&template_symbol, symbol, sizeof(template_symbol));
+    if (round.threads > 1) {
+        template_symbol.threads = 0; /* Symbols are already being encoded in parallel */
+    }
+    if (round.container == BATCH_TAR) {
+        template_symbol.output_options |= BARCODE_MEMORY_FILE;
+    }
+    round.template_symbol = &template_symbol;
+    round.rotate_angle = rotate_angle;
+
+    reader = (struct batch_reader *) malloc(sizeof(struct batch_reader));
+    round.lines = (struct batch_line *) malloc(sizeof(struct batch_line) * max_lines);
+    round.data_size = ZINT_MAX_FILE_LEN;
+    round.data = (unsigned char *) malloc(round.data_size);
+    round.workers[0] = ZBarcode_Create();
+    if (!reader || !round.lines || !round.data || !round.workers[0]) {
+        free(reader);
+        free(round.lines);
+        free(round.data);
+        ZBarcode_Delete(round.workers[0]);
+        if (file != stdin) {
+            fclose(file);
+        }
+        if (output && output != stdout) {
+            fclose(output);
+        }
+        ZBarcode_Delete(round.sheet);
+        strcpy(symbol->errtxt, "105: Insufficient memory for batch processing");
+        return ZINT_ERROR_MEMORY;
+    }
+    for (t = 1; t < round.threads; t++) {
+        if (!(round.workers[t] = ZBarcode_Create())) {
+            round.threads = t;
             break;
         }
-        character = (unsigned char) intChar;
-        if (character == '\n') {
-            if (posn > 0 && buffer[posn - 1] == '\r') {
-                /* CR+LF - assume Windows formatting and remove CR */
-                posn--;
-                buffer[posn] = '\0';
+    }
+    reader->file = file;
+    reader->chunk = file == stdin ? 1 : sizeof(reader->buf);
+    reader->pos = reader->len = 0;
+    reader->last = EOF;
+
+    while (!eof && line_count < 2000000000) {
+        size_t offset = 0;
+
+        for (round.count = 0; round.count < max_lines && line_count + round.count < 2000000000; round.count++) {
+            struct batch_line *line = &round.lines[round.count];
+            if (!batch_read_line(reader, &round, offset, line)) {
+                eof = 1;
+                break;
+            }
+            offset += line->length + 1;
+            line->line_count = line_count + round.count;
+            line->error_number = 0;
+            line->errtxt[0] = '\0';
+            line->output = NULL;
+            line->output_size = 0;
+            line->width = line->height = 0;
+            if (!line->too_long && round.container != BATCH_SHEET) {
+                batch_output_file(round.data + line->offset, line->length, line->line_count, mirror_mode,
+                        format_string, filetype, symbol->input_mode, line->output_file);
             }
+        }
 
-            if (mirror_mode == 0) {
-                inpos = 0;
-                local_line_count = line_count;
-                memset(number, 0, sizeof(number));
-                memset(reverse_number, 0, sizeof(reverse_number));
-                memset(reversed_string, 0, sizeof(reversed_string));
-                memset(output_file, 0, sizeof(output_file));
-                do {
-                    number[inpos] = itoc(local_line_count % 10);
-                    local_line_count /= 10;
-                    inpos++;
-                } while (local_line_count > 0);
-                number[inpos] = '\0';
-
-                for (i = 0; i < inpos; i++) {
-                    reverse_number[i] = number[inpos - i - 1];
-                }
+        batch_run(&round);
 
-                format_len = strlen(format_string);
-                for (i = format_len; i > 0; i--) {
-                    format_char = format_string[i - 1];
-
-                    switch (format_char) {
-                        case '#':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = ' ';
-                            }
-                            break;
-                        case '~':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = '0';
-                            }
-                            break;
-                        case '@':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = '*';
-                            }
-                            break;
-                        default:
-                            adjusted[0] = format_string[i - 1];
-                            break;
-                    }
-                    strcat(reversed_string, adjusted);
+        for (i = 0; i < round.count; i++) {
+            struct batch_line *line = &round.lines[i];
+            if (line->too_long) {
+                fprintf(stderr, "On line %d: Error 103: Input data too long\n", line->line_count);
+                fflush(stderr);
+            } else {
+                error_number = line->error_number;
+                if (error_number != 0) {
+                    fprintf(stderr, "On line %d: %s\n", line->line_count, line->errtxt);
+                    fflush(stderr);
                 }
-
-                for (i = 0; i < format_len; i++) {
-                    output_file[i] = reversed_string[format_len - i - 1];
+            }
+            if (output && !write_error) {
+                /* Failed lines are left out of archives but keep their place in raw streams */
+                if (round.container == BATCH_RAW) {
+                    write_error = !batch_raw_bitmap(output, line->output, line->output_size, line->width,
+                                        line->height);
+                } else if (line->output) {
+                    write_error = !batch_tar_member(output, line->output_file, line->output, line->output_size,
+                                        mtime);
                 }
-            } else {
-                /* Name the output file from the data being processed */
-                i = 0;
-                o = 0;
-                do {
-                    if (buffer[i] < 0x20) {
-                        output_file[o] = '_';
-                    } else {
-                        switch (buffer[i]) {
-                            case 0x21: // !
-                            case 0x22: // "
-                            case 0x2a: // *
-                            case 0x2f: // /
-                            case 0x3a: // :
-                            case 0x3c: // <
-                            case 0x3e: // >
-                            case 0x3f: // ?
-                            case 0x5c: // Backslash
-                            case 0x7c: // |
-                            case 0x7f: // DEL
-                                output_file[o] = '_';
-                                break;
-                            default:
-                                output_file[o] = buffer[i];
-                                break;
-                        }
-                    }
-
-                    // Skip escape characters
-                    if ((buffer[i] == 0x5c) && (symbol->input_mode & ESCAPE_MODE)) {
-                        i++;
-                        if (buffer[i] == 'x') {
-                            i += 2;
-                        }
-                    }
-                    i++;
-                    o++;
-                } while (i < posn && o < 251);
-
-                /* Add file extension */
-                output_file[o] = '.';
-                output_file[o + 1] = '\0';
-
-                strcat(output_file, filetype);
             }
-
-            strcpy(symbol->outfile, output_file);
-            error_number = ZBarcode_Encode_and_Print(symbol, buffer, posn, rotate_angle);
-            if (error_number != 0) {
-                fprintf(stderr, "On line %d: %s\n", line_count, symbol->errtxt);
-                fflush(stderr);
+            free(line->output);
+            if (round.container == BATCH_SHEET && round.cell == layout->columns * layout->rows) {
+                write_error = !batch_sheet_page(&round, format_string, filetype, ++page);
             }
-            ZBarcode_Clear(symbol);
-            memset(buffer, 0, sizeof(buffer));
-            posn = 0;
-            line_count++;
-        } else {
-            buffer[posn] = character;
-            posn++;
         }
-        if (posn >= (int) sizeof(buffer)) {
-            fprintf(stderr, "On line %d: Error 103: Input data too long\n", line_count);
-            fflush(stderr);
-            do {
-                character = fgetc(file);
-            } while ((!feof(file)) && (character != '\n'));
+        if (write_error) {
+            break;
         }
-    } while ((!feof(file)) && (line_count < 2000000000));
+        line_count += round.count;
+    }
 
-    if (character != '\n') {
+    if (reader->last != '\n') {
         fprintf(stderr, "Warning 104: No newline at end of file\n");
         fflush(stderr);
     }
 
-    fclose(file);
+    if (round.container == BATCH_SHEET) {
+        if (!write_error && round.cell && ZBarcode_Sheet_Print(round.sheet) >= ZINT_ERROR) {
+            write_error = 1;
+        }
+        if (write_error) {
+            strcpy(symbol->errtxt, round.sheet->errtxt);
+            error_number = ZINT_ERROR_FILE_ACCESS;
+        }
+        ZBarcode_Delete(round.sheet);
+    }
+    if (output && !write_error) {
+        if (round.container == BATCH_TAR) {
+            /* End of archive is marked by two zero blocks */
+            static const char zeroes[1024] = {0};
+            write_error = fwrite(zeroes, 1, sizeof(zeroes), output) != sizeof(zeroes);
+        }
+        write_error |= fflush(output) != 0;
+    }
+    if (output && output != stdout && fclose(output) != 0) {
+        write_error = 1;
+    }
+
+    for (t = 0; t < round.threads; t++) {
+        ZBarcode_Delete(round.workers[t]);
+    }
+    free(round.data);
+    free(round.lines);
+    free(reader);
+    if (file != stdin) {
+        fclose(file);
+    }
+    if (write_error && round.container != BATCH_SHEET) {
+        strcpy(symbol->errtxt, "152: Failed to write batch output");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
     return error_number;
 }
 
@@ -484,6 +1037,9 @@ int main(int argc, char **argv) {
     int input_cnt = 0;
     int batch_mode = 0;
     int mirror_mode = 0;
+    char *archive_file = NULL;
+    int raw_stream = 0;
+    struct batch_sheet layout = { 0, 0, 1, 1 };
     int fullmultibyte = 0;
     int mask = 0;
     int separator = 0;
@@ -511,6 +1067,7 @@ int main(int argc, char **argv) {
         int option_index = 0;
         static struct option long_options[] = {
             {"addongap", 1, 0, 0},
+            {"archive", 1, 0, 0},
             {"barcode", 1, 0, 'b'},
             {"batch", 0, 0, 0},
             {"binary", 0, 0, 0},
@@ -519,6 +1076,7 @@ int main(int argc, char **argv) {
             {"bold", 0, 0, 0},
             {"border", 1, 0, 0},
             {"box", 0, 0, 0},
+            {"c128opt", 0, 0, 0},
             {"cmyk", 0, 0, 0},
             {"cols", 1, 0, 0},
             {"data", 1, 0, 'd'},
@@ -534,7 +1092,9 @@ int main(int argc, char **argv) {
             {"filetype", 1, 0, 0},
             {"fontsize", 1, 0, 0},
             {"fullmultibyte", 0, 0, 0},
+            {"grid", 1, 0, 0},
             {"gs1", 0, 0, 0},
+            {"gs1strict", 0, 0, 0},
             {"gssep", 0, 0, 0},
             {"height", 1, 0, 0},
             {"help", 0, 0, 'h'},
@@ -546,15 +1106,19 @@ int main(int argc, char **argv) {
             {"nobackground", 0, 0, 0},
             {"notext", 0, 0, 0},
             {"output", 1, 0, 'o'},
+            {"pdfopt", 0, 0, 0},
             {"primary", 1, 0, 0},
+            {"rawstream", 0, 0, 0},
             {"reverse", 0, 0, 'r'},
             {"rotate", 1, 0, 0},
             {"rows", 1, 0, 0},
             {"scale", 1, 0, 0},
             {"secure", 1, 0, 0},
             {"separator", 1, 0, 0},
+            {"sheet", 1, 0, 0},
             {"small", 0, 0, 0},
             {"square", 0, 0, 0},
+            {"threads", 1, 0, 0},
             {"types", 0, 0, 't'},
             {"verbose", 0, 0, 0}, // Currently undocumented, output some debug info
             {"vers", 1, 0, 0},
@@ -600,6 +1164,9 @@ int main(int argc, char **argv) {
                 if (!strcmp(long_options[option_index].name, "gs1")) {
                     my_symbol->input_mode = (my_symbol->input_mode & ~0x07) | GS1_MODE;
                 }
+                if (!strcmp(long_options[option_index].name, "gs1strict")) {
+                    my_symbol->input_mode |= GS1STRICT_MODE;
+                }
                 if (!strcmp(long_options[option_index].name, "binary")) {
                     my_symbol->input_mode = (my_symbol->input_mode & ~0x07) | DATA_MODE;
                 }
@@ -626,9 +1193,28 @@ int main(int argc, char **argv) {
                         mask = 0;
                     }
                 }
+                if (!strcmp(long_options[option_index].name, "threads")) {
+                    error_number = validator(NESET, optarg);
+                    if (error_number == ZINT_ERROR_INVALID_DATA) {
+                        fprintf(stderr, "Error 149: Invalid threads value\n");
+                        exit(1);
+                    }
+                    if ((atoi(optarg) >= 1) && (atoi(optarg) <= 64)) {
+                        my_symbol->threads = atoi(optarg);
+                    } else {
+                        fprintf(stderr, "Warning 150: Invalid number of threads (1 to 64 only)\n");
+                        fflush(stderr);
+                    }
+                }
                 if (!strcmp(long_options[option_index].name, "notext")) {
                     my_symbol->show_hrt = 0;
                 }
+                if (!strcmp(long_options[option_index].name, "c128opt")) {
+                    my_symbol->option_3 = C128_OPTIMAL;
+                }
+                if (!strcmp(long_options[option_index].name, "pdfopt")) {
+                    my_symbol->option_3 = PDF_OPTIMAL;
+                }
                 if (!strcmp(long_options[option_index].name, "square")) {
                     my_symbol->option_3 = DM_SQUARE;
                 }
@@ -816,6 +1402,37 @@ int main(int argc, char **argv) {
                     /* Use filenames which reflect content */
                     mirror_mode = 1;
                 }
+                if (!strcmp(long_options[option_index].name, "archive")) {
+                    /* Collect batch output in a single tar file */
+                    archive_file = optarg;
+                }
+                if (!strcmp(long_options[option_index].name, "rawstream")) {
+                    /* Send batch output to stdout as raw bitmaps */
+                    raw_stream = 1;
+                }
+                if (!strcmp(long_options[option_index].name, "sheet")) {
+                    /* Arrange batch output on pages */
+                    if (!dimensions(optarg, &layout.width, &layout.height)) {
+                        fprintf(stderr, "Error 156: Invalid sheet size\n");
+                        exit(1);
+                    }
+                    if (layout.width > 65535 || layout.height > 65535) {
+                        fprintf(stderr, "Warning 157: Invalid sheet size (1 to 65535 only), ignoring\n");
+                        fflush(stderr);
+                        layout.width = layout.height = 0;
+                    }
+                }
+                if (!strcmp(long_options[option_index].name, "grid")) {
+                    if (!dimensions(optarg, &layout.columns, &layout.rows)) {
+                        fprintf(stderr, "Error 158: Invalid grid value\n");
+                        exit(1);
+                    }
+                    if (layout.columns > 1000 || layout.rows > 1000) {
+                        fprintf(stderr, "Warning 159: Invalid grid size (1 to 1000 only), ignoring\n");
+                        fflush(stderr);
+                        layout.columns = layout.rows = 1;
+                    }
+                }
                 if (!strcmp(long_options[option_index].name, "filetype")) {
                     /* Select the type of output file */
                     if (!supported_filetype(optarg)) {
@@ -988,12 +1605,28 @@ int main(int argc, char **argv) {
                 fprintf(stderr, "Warning 145: Scaling less than 0.5 will be set to 0.5 for '%s' output\n", filetype);
                 fflush(stderr);
             }
-            error_number = batch_process(my_symbol, arg_opts[0].arg, mirror_mode, filetype, rotate_angle);
+            if (archive_file && raw_stream) {
+                fprintf(stderr, "Warning 154: Can't use both archive and raw stream output, ignoring archive\n");
+                fflush(stderr);
+                archive_file = NULL;
+            }
+            if (layout.width && (archive_file || raw_stream)) {
+                fprintf(stderr, "Warning 160: Can't use sheet with archive or raw stream output, ignoring sheet\n");
+                fflush(stderr);
+                layout.width = 0;
+            }
+            error_number = batch_process(my_symbol, arg_opts[0].arg, mirror_mode, filetype, rotate_angle,
+                            archive_file, raw_stream, layout.width ? &layout : NULL);
             if (error_number != 0) {
                 fprintf(stderr, "%s\n", my_symbol->errtxt);
                 fflush(stderr);
             }
         } else {
+            if (archive_file || raw_stream || layout.width) {
+                fprintf(stderr, "Warning 155: Archive, raw stream and sheet output only available in batch mode,"
+                                " ignoring\n");
+                fflush(stderr);
+            }
             if (*filetype != '\0') {
                 set_extension(my_symbol->outfile, filetype);
             }
@@ -512,6 +512,239 @@ static void test_batch_large(int index, int debug) {
     testFinish();
 }
 
+static void test_batch_threads(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int b;
+        int threads;
+        int direct;
+        char *input;
+        char *outfile;
+
+        int num_expected;
+        char *expected_files;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_EANX, -1, 0, "123\nA\n456\n\n789\nB\n", "test_threads~~.svg", 3, "test_threads01.svg\000test_threads03.svg\000test_threads05.svg", "On line 2: Error 284: Invalid characters in data\nOn line 4: Error 205: No input data\nOn line 6: Error 284: Invalid characters in data" },
+        /*  1*/ { BARCODE_EANX, 3, 0, "123\nA\n456\n\n789\nB\n", "test_threads~~.svg", 3, "test_threads01.svg\000test_threads03.svg\000test_threads05.svg", "On line 2: Error 284: Invalid characters in data\nOn line 4: Error 205: No input data\nOn line 6: Error 284: Invalid characters in data" },
+        /*  2*/ { BARCODE_EANX, 64, 0, "123\r\n456\r\nA", "test_threads~~.svg", 2, "test_threads01.svg\000test_threads02.svg", "Warning 104: No newline at end of file" },
+        /*  3*/ { BARCODE_CODE128, 2, 1, "1\n2\n3\n", NULL, 0, NULL, "D2 13 9B 39 63 AC\nD2 19 CB 2E 63 AC\nD2 19 73 27 63 AC" }, // Output to stdout done in order
+        /*  4*/ { BARCODE_CODE128, 65, 0, "1\n", "test_threads~~.svg", 1, "test_threads01.svg", "Warning 150: Invalid number of threads (1 to 64 only)" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+
+    char *input_filename = "test_batch_threads.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        strcpy(cmd, data[i].direct ? "zint --dump --batch" : "zint --batch");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "-b ", data[i].b);
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_input(cmd, input_filename, data[i].input);
+        arg_data(cmd, "-o ", data[i].outfile);
+
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_container(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int b;
+        int threads;
+        char *archive;
+        int raw_stream;
+        char *input;
+        char *outfile;
+
+        char *expected;
+        int num_expected;
+        char *expected_members;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_EANX, -1, "test_batch.tar", 0, "123\nA\n456\n", "test_container~~.svg", "On line 2: Error 284: Invalid characters in data", 2, "test_container01.svg\000test_container03.svg" },
+        /*  1*/ { BARCODE_EANX, 3, "test_batch.tar", 0, "123\nA\n456\n", "test_container~~.svg", "On line 2: Error 284: Invalid characters in data", 2, "test_container01.svg\000test_container03.svg" },
+        /*  2*/ { BARCODE_CODE128, 2, "test_batch.tar", 0, "1\n2\n3\n", "dir/test~.png", "", 3, "dir/test1.png\000dir/test2.png\000dir/test3.png" },
+        /*  3*/ { BARCODE_EANX, -1, NULL, 1, "123\nA\n456\n", NULL, "On line 2: Error 284: Invalid characters in data", 3, "118x116\0000x0\000118x116" },
+        /*  4*/ { BARCODE_EANX, 4, NULL, 1, "123\nA\n456\n", NULL, "On line 2: Error 284: Invalid characters in data", 3, "118x116\0000x0\000118x116" },
+        /*  5*/ { BARCODE_CODE128, -1, "test_batch.tar", 1, "1\n", NULL, "Warning 154: Can't use both archive and raw stream output, ignoring archive", 1, "92x116" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+    static unsigned char file_buf[262144];
+
+    char *input_filename = "test_batch_container.txt";
+    char *raw_filename = "test_batch_container.raw";
+    char *member;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        strcpy(cmd, "zint --batch");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "-b ", data[i].b);
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_data(cmd, "--archive=", data[i].archive);
+        arg_bool(cmd, "--rawstream", data[i].raw_stream);
+        arg_input(cmd, input_filename, data[i].input);
+        arg_data(cmd, "-o ", data[i].outfile);
+
+        if (data[i].raw_stream) {
+            sprintf(cmd + (int) strlen(cmd), " 2>&1 > %s", raw_filename);
+        } else {
+            strcat(cmd, " 2>&1");
+        }
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        FILE *fp = fopen(data[i].raw_stream ? raw_filename : data[i].archive, "rb");
+        assert_nonnull(fp, "i:%d fopen failed (%d)\n", i, errno);
+        int file_size = (int) fread(file_buf, 1, sizeof(file_buf), fp);
+        assert_zero(fclose(fp), "i:%d fclose != 0 (%d)\n", i, errno);
+
+        int posn = 0;
+        member = data[i].expected_members;
+        if (data[i].raw_stream) {
+            /* Records of 4-byte big-endian width and height followed by RGB bitmap */
+            for (int j = 0; j < data[i].num_expected; j++) {
+                assert_nonzero(posn + 8 <= file_size, "i:%d j:%d posn %d + 8 > file_size %d\n", i, j, posn, file_size);
+                int width = (file_buf[posn] << 24) | (file_buf[posn + 1] << 16) | (file_buf[posn + 2] << 8) | file_buf[posn + 3];
+                int height = (file_buf[posn + 4] << 24) | (file_buf[posn + 5] << 16) | (file_buf[posn + 6] << 8) | file_buf[posn + 7];
+                sprintf(buf, "%dx%d", width, height);
+                assert_zero(strcmp(buf, member), "i:%d j:%d dimensions %s != %s\n", i, j, buf, member);
+                posn += 8 + width * height * 3;
+                member += strlen(member) + 1;
+            }
+            assert_equal(posn, file_size, "i:%d posn %d != file_size %d\n", i, posn, file_size);
+            assert_zero(remove(raw_filename), "i:%d remove(%s) != 0 (%d)\n", i, raw_filename, errno);
+        } else {
+            /* 512-byte ustar headers each followed by contents padded to 512, then 2 zero blocks */
+            for (int j = 0; j < data[i].num_expected; j++) {
+                assert_nonzero(posn + 512 <= file_size, "i:%d j:%d posn %d + 512 > file_size %d\n", i, j, posn, file_size);
+                assert_zero(strcmp((char *) file_buf + posn, member), "i:%d j:%d name %s != %s\n", i, j, file_buf + posn, member);
+                assert_zero(memcmp(file_buf + posn + 257, "ustar", 6), "i:%d j:%d no ustar magic\n", i, j);
+                int size = (int) strtol((char *) file_buf + posn + 124, NULL, 8);
+                posn += 512 + (size + 511) / 512 * 512;
+                member += strlen(member) + 1;
+            }
+            assert_equal(posn + 1024, file_size, "i:%d posn %d + 1024 != file_size %d\n", i, posn, file_size);
+            assert_zero(remove(data[i].archive), "i:%d remove(%s) != 0 (%d)\n", i, data[i].archive, errno);
+            if (data[i].outfile) {
+                assert_zero(testUtilExists(data[i].expected_members), "i:%d testUtilExists(%s) != 0\n", i, data[i].expected_members);
+            }
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_sheet(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int b;
+        char *sheet;
+        char *grid;
+        int threads;
+        char *input;
+        char *outfile;
+
+        char *expected;
+        int num_expected;
+        char *expected_pages;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, "300x200", "2x1", -1, "1\n2\n3\n", "test_sheet~.png", "", 2, "test_sheet1.png\000test_sheet2.png" },
+        /*  1*/ { BARCODE_CODE128, "300x200", "2x1", 4, "1\n2\n3\n", "test_sheet~.gif", "", 2, "test_sheet1.gif\000test_sheet2.gif" },
+        /*  2*/ { BARCODE_EANX, "400x300", "2x2", -1, "123\nA\n456\n", "test_sheet~.svg", "On line 2: Error 284: Invalid characters in data", 1, "test_sheet1.svg" },
+        /*  3*/ { BARCODE_CODE128, "50x200", NULL, -1, "1\n", "test_sheet~.bmp", "On line 1: Error 663: Symbol does not fit on sheet", 0, "" },
+        /*  4*/ { BARCODE_CODE128, "300x200", NULL, -1, "1\n", "test_sheet~.emf", "Error 244: Unknown or unsupported output format for sheet", 0, "" },
+        /*  5*/ { BARCODE_CODE128, "300", NULL, -1, "1\n", "test_sheet~.png", "Error 156: Invalid sheet size", 0, "" },
+        /*  6*/ { BARCODE_CODE128, "300x200", "0x1", -1, "1\n", "test_sheet~.png", "Error 158: Invalid grid value", 0, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+
+    char *input_filename = "test_batch_sheet.txt";
+    char *page;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        strcpy(cmd, "zint --batch");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "-b ", data[i].b);
+        arg_data(cmd, "--sheet=", data[i].sheet);
+        arg_data(cmd, "--grid=", data[i].grid);
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_input(cmd, input_filename, data[i].input);
+        arg_data(cmd, "-o ", data[i].outfile);
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        page = data[i].expected_pages;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(page), "i:%d j:%d testUtilExists(%s) == 0\n", i, j, page);
+            assert_zero(remove(page), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, page, errno);
+            page += strlen(page) + 1;
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
 static void test_checks(int index, int debug) {
 
     testStart("");
@@ -621,6 +854,9 @@ int main(int argc, char *argv[]) {
         { "test_stdin_input", test_stdin_input, 1, 0, 1 },
         { "test_batch_input", test_batch_input, 1, 0, 1 },
         { "test_batch_large", test_batch_large, 1, 0, 1 },
+        { "test_batch_threads", test_batch_threads, 1, 0, 1 },
+        { "test_batch_container", test_batch_container, 1, 0, 1 },
+        { "test_batch_sheet", test_batch_sheet, 1, 0, 1 },
         { "test_checks", test_checks, 1, 0, 1 },
     };
 
@@ -0,0 +1,116 @@
+/*
+    Zint Barcode Generator - the open source barcode generator
+    Copyright (C) 2009 - 2020 Robin Stuart <rstuart114@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/* vim: set ts=4 sw=4 et : */
+
+//#include <QDebug>
+#include <QRunnable>
+
+#include "exportengine.h"
+
+/* A worker taking items from the engine until none are left or it's cancelled, with its own QZint */
+class ExportTask : public QRunnable
+{
+public:
+    ExportTask(ExportEngine *engine) : m_engine(engine) {}
+
+    void run()
+    {
+        const int total = m_engine->m_data.size();
+        Zint::QZint bc;
+        int index;
+
+        bc.copySettings(m_engine->m_settings);
+
+        while (!m_engine->m_cancelled.loadAcquire() && (index = m_engine->m_next.fetchAndAddRelaxed(1)) < total) {
+            bc.setText(m_engine->m_data.at(index));
+            bc.save_to_file(m_engine->m_fileNames.at(index));
+            QMetaObject::invokeMethod(m_engine, "workerItemDone", Qt::QueuedConnection, Q_ARG(int, index),
+                    Q_ARG(QString, bc.hasErrors() ? bc.error_message() : QString()));
+        }
+        QMetaObject::invokeMethod(m_engine, "workerFinished", Qt::QueuedConnection);
+    }
+
+private:
+    ExportEngine *m_engine;
+};
+
+ExportEngine::ExportEngine(QObject *parent) : QObject(parent)
+{
+    m_done = 0;
+    m_workers = 0;
+}
+
+ExportEngine::~ExportEngine()
+{
+    cancel();
+    m_pool.waitForDone(); /* Any results still queued are discarded along with us */
+}
+
+/* Save `data[i]` to `fileNames[i]` using the settings of `settings`. Returns false if already running */
+bool ExportEngine::start(const Zint::QZint &settings, const QStringList &data, const QStringList &fileNames)
+{
+    int i, workers;
+
+    if (isRunning()) {
+        return false;
+    }
+
+    m_settings.copySettings(settings);
+    m_data = data;
+    m_fileNames = fileNames;
+    m_next.storeRelease(0);
+    m_cancelled.storeRelease(0);
+    m_done = 0;
+
+    workers = qMin(m_pool.maxThreadCount(), m_data.size());
+    if (workers <= 0) {
+        emit finished(false);
+        return true;
+    }
+    m_workers = workers;
+    for (i = 0; i < workers; i++) {
+        m_pool.start(new ExportTask(this));
+    }
+    return true;
+}
+
+/* Stop handing out items. Those in progress complete, and `finished(true)` follows */
+void ExportEngine::cancel()
+{
+    m_cancelled.storeRelease(1);
+}
+
+bool ExportEngine::isRunning() const
+{
+    return m_workers > 0;
+}
+
+void ExportEngine::workerItemDone(int index, const QString &error)
+{
+    m_done++;
+    emit itemDone(index, error);
+    emit progress(m_done, m_data.size());
+}
+
+void ExportEngine::workerFinished()
+{
+    if (--m_workers == 0) {
+        emit finished(m_cancelled.loadAcquire() != 0);
+    }
+}
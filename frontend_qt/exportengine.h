@@ -0,0 +1,66 @@
+/*
+    Zint Barcode Generator - the open source barcode generator
+    Copyright (C) 2009 - 2020 Robin Stuart <rstuart114@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef EXPORTENGINE_H
+#define EXPORTENGINE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include "qzint.h"
+
+/* Saves a list of data items to a list of files on a pool of worker threads, each worker with its own QZint copying
+   the settings of a given one. Results are reported on the thread that owns the engine (the GUI thread) */
+class ExportEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExportEngine(QObject *parent = 0);
+    ~ExportEngine();
+
+    bool start(const Zint::QZint &settings, const QStringList &data, const QStringList &fileNames);
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void itemDone(int index, const QString &error); /* `error` empty on success */
+    void progress(int done, int total);
+    void finished(bool cancelled);
+
+private slots:
+    void workerItemDone(int index, const QString &error);
+    void workerFinished();
+
+private:
+    friend class ExportTask;
+
+    QThreadPool m_pool;
+    Zint::QZint m_settings; /* Only read by workers while running */
+    QStringList m_data;
+    QStringList m_fileNames;
+    QAtomicInt m_next; /* Index of next item to be taken by a worker */
+    QAtomicInt m_cancelled;
+    int m_done;
+    int m_workers;
+};
+
+#endif
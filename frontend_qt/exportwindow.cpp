@@ -40,6 +40,11 @@ ExportWindow::ExportWindow()
     connect(btnCancel, SIGNAL( clicked( bool )), SLOT(quit_now()));
     connect(btnOK, SIGNAL( clicked( bool )), SLOT(process()));
     connect(btnDestPath, SIGNAL( clicked( bool )), SLOT(get_directory()));
+    connect(&m_engine, SIGNAL( itemDone( int, const QString& )), SLOT(item_done( int, const QString& )));
+    connect(&m_engine, SIGNAL( progress( int, int )), SLOT(export_progress( int, int )));
+    connect(&m_engine, SIGNAL( finished( bool )), SLOT(export_finished( bool )));
+
+    prgExport->setVisible(false);
 }
 
 ExportWindow::~ExportWindow()
@@ -55,6 +60,10 @@ ExportWindow::~ExportWindow()
 
 void ExportWindow::quit_now()
 {
+    if (m_engine.isRunning()) {
+        m_engine.cancel();
+        return;
+    }
     close();
 }
 
@@ -83,7 +92,7 @@ void ExportWindow::process()
     QString fileName;
     QString dataString;
     QString suffix;
-    QString Feedback;
+    QStringList data, fileNames;
     int lines, i, j, inputpos;
 
     lines = output_data.count(QChar('\n'), Qt::CaseInsensitive);
@@ -110,7 +119,6 @@ void ExportWindow::process()
 #endif
     }
     txtFeedback->clear();
-    Feedback = "";
 
     for(i = 0; i < lines; i++) {
         int datalen = 0;
@@ -164,18 +172,60 @@ void ExportWindow::process()
                 }
                 break;
         }
-        barcode->bc.setText(dataString.toLatin1().data());
-        barcode->bc.save_to_file(fileName.toLatin1().data());
+        data << QString(dataString.toLatin1().data());
+        fileNames << QString(fileName.toLatin1().data());
+        inputpos += datalen + 1;
+    }
+
+    /* Files are named above in line order, then saved in the background */
+    m_errors = QStringList();
+    for (i = 0; i < lines; i++) {
+        m_errors << QString();
+    }
+    btnOK->setEnabled(false);
+    btnCancel->setText(tr("&Cancel"));
+    btnCancel->setToolTip(tr("Stop exporting"));
+    prgExport->setRange(0, lines);
+    prgExport->setValue(0);
+    prgExport->setVisible(true);
+    m_engine.start(barcode->bc, data, fileNames);
+}
+
+void ExportWindow::item_done(int index, const QString &error)
+{
+    m_errors[index] = error;
+}
+
+void ExportWindow::export_progress(int done, int total)
+{
+    (void)total;
+    prgExport->setValue(done);
+}
+
+void ExportWindow::export_finished(bool cancelled)
+{
+    QString Feedback;
+    int i;
+
+    /* Workers take lines in order and finish any they've taken, so those done are always the first */
+    for (i = 0; i < prgExport->value(); i++) {
         Feedback += "Line ";
         Feedback += QString::number(i + 1);
         Feedback += ": ";
-        if (barcode->bc.hasErrors()) {
-            Feedback += barcode->bc.error_message();
+        if (!m_errors[i].isEmpty()) {
+            Feedback += m_errors[i];
             Feedback += "\n";
         } else {
             Feedback += "Success\n";
         }
-        txtFeedback->document()->setPlainText(Feedback);
-        inputpos += datalen + 1;
     }
+    if (cancelled) {
+        Feedback += "Cancelled\n";
+    }
+    txtFeedback->document()->setPlainText(Feedback);
+
+    prgExport->setVisible(false);
+    btnCancel->setText(tr("&Close"));
+    btnCancel->setToolTip(tr("Close window"));
+    btnOK->setEnabled(true);
 }
@@ -22,6 +22,7 @@
 
 #include "ui_extExport.h"
 #include "barcodeitem.h"
+#include "exportengine.h"
 
 class ExportWindow : public QDialog, private Ui::ExportDialog
 {
@@ -37,6 +38,13 @@ private slots:
 	void quit_now();
 	void process();
 	void get_directory();
+	void item_done(int index, const QString &error);
+	void export_progress(int done, int total);
+	void export_finished(bool cancelled);
+
+private:
+	ExportEngine m_engine;
+	QStringList m_errors;
 };
 
 #endif
\ No newline at end of file
@@ -11,6 +11,7 @@ QT += uitools
 HEADERS += barcodeitem.h \
          datawindow.h \
          exportwindow.h \
+         exportengine.h \
          mainwindow.h \
          sequencewindow.h \
          qzint.h
@@ -49,6 +50,7 @@ FORMS += extData.ui \
 SOURCES += barcodeitem.cpp \
         datawindow.cpp \
         exportwindow.cpp \
+        exportengine.cpp \
         main.cpp \
         mainwindow.cpp \
         sequencewindow.cpp \
@@ -7,6 +7,7 @@ QT += widgets
 HEADERS += barcodeitem.h \
          datawindow.h \
          exportwindow.h \
+         exportengine.h \
          mainwindow.h \
          sequencewindow.h \
          qzint.h
@@ -45,6 +46,7 @@ FORMS += extData.ui \
 SOURCES += barcodeitem.cpp \
         datawindow.cpp \
         exportwindow.cpp \
+        exportengine.cpp \
         main.cpp \
         mainwindow.cpp \
         sequencewindow.cpp \
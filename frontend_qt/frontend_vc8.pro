@@ -14,6 +14,7 @@ HEADERS = 	mainwindow.h \
 			barcodeitem.h \
 			datawindow.h \
 			exportwindow.h \
+			exportengine.h \
 			sequencewindow.h \
 			qzint.h
 
@@ -22,6 +23,7 @@ SOURCES = 	main.cpp \
 			barcodeitem.cpp \
 			datawindow.cpp \
 			exportwindow.cpp \
+			exportengine.cpp \
 			sequencewindow.cpp
 			qzint.cpp
 
@@ -187,8 +187,12 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags fl)
     connect(bwidth,  SIGNAL(valueChanged( int )), SLOT(update_preview()));
     connect(btype, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
     connect(cmbFontSetting, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
-    connect(txtData, SIGNAL(textChanged( const QString& )), SLOT(update_preview()));
-    connect(txtComposite, SIGNAL(textChanged()), SLOT(update_preview()));
+    /* Typing restarts the preview timer rather than re-encoding on every keystroke */
+    m_previewTimer.setSingleShot(true);
+    m_previewTimer.setInterval(150);
+    connect(&m_previewTimer, SIGNAL(timeout()), SLOT(update_preview()));
+    connect(txtData, SIGNAL(textChanged( const QString& )), &m_previewTimer, SLOT(start()));
+    connect(txtComposite, SIGNAL(textChanged()), &m_previewTimer, SLOT(start()));
     connect(chkComposite, SIGNAL(stateChanged( int )), SLOT(composite_ui_set()));
     connect(chkComposite, SIGNAL(stateChanged( int )), SLOT(update_preview()));
     connect(cmbCompType, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
@@ -275,6 +279,15 @@ void MainWindow::reset_view()
     update_preview();
 }
 
+/* Bring the preview (and so the settings) up to date with any data typed but not yet previewed */
+void MainWindow::flush_preview()
+{
+    if (m_previewTimer.isActive()) {
+        m_previewTimer.stop();
+        update_preview();
+    }
+}
+
 bool MainWindow::save()
 {
     QSettings settings;
@@ -283,6 +296,8 @@ bool MainWindow::save()
     QString filename;
     QString suffix;
 
+    flush_preview();
+
     save_dialog.setAcceptMode(QFileDialog::AcceptSave);
     save_dialog.setWindowTitle("Save Barcode Image");
     save_dialog.setDirectory(settings.value("studio/default_dir", QDir::toNativeSeparators(QDir::homePath())).toString());
@@ -398,6 +413,8 @@ int MainWindow::open_data_dialog()
 
 int MainWindow::open_sequence_dialog()
 {
+    flush_preview();
+
     SequenceWindow dlg;
     dlg.barcode = &m_bc;
     return dlg.exec();
@@ -543,6 +560,8 @@ void MainWindow::quit_now()
 
 void MainWindow::copy_to_clipboard_svg()
 {
+    flush_preview();
+
     QClipboard *clipboard = QGuiApplication::clipboard();
     QString filename = ".zint.svg";
     double scale = spnScale->value();
@@ -565,6 +584,8 @@ void MainWindow::copy_to_clipboard_svg()
 
 void MainWindow::copy_to_clipboard_bmp()
 {
+    flush_preview();
+
     QClipboard *clipboard = QGuiApplication::clipboard();
     QString filename = ".zint.bmp";
 
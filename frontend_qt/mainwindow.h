@@ -21,6 +21,7 @@
 #include <QGraphicsItem>
 #include <QMainWindow>
 #include <QGraphicsScene>
+#include <QTimer>
 
 #include "ui_mainWindow.h"
 #include "barcodeitem.h"
@@ -148,6 +149,7 @@ protected:
 	void set_lineedit_from_setting(QSettings &settings, const QString &setting, const QString &child, const char *default_val = "");
 	void save_sub_settings(QSettings &settings, int symbology);
 	void load_sub_settings(QSettings &settings, int symbology);
+    void flush_preview();
 
 private slots:
     bool save();
@@ -165,6 +167,7 @@ private:
     QWidget *m_optionWidget;
     QGraphicsScene *scene;
 	int m_symbology;
+    QTimer m_previewTimer; /* Delays preview while data being typed */
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <QFontMetrics>
+#include <QDataStream>
 /* the following include was necessary to compile with QT 5.18 on Windows */
 /* QT 8.7 did not require it. */
 #include <QPainterPath>
@@ -57,6 +58,11 @@ namespace Zint {
         m_reader_init = false;
         m_rotate_angle = 0;
         m_debug = false;
+        m_cacheDpr = 0.0;
+        m_cacheRotateAngle = 0;
+        m_batchPaths = false;
+        m_antialias = true;
+        m_pathLayersValid = false;
     }
 
     QZint::~QZint() {
@@ -110,7 +116,26 @@ namespace Zint {
         strcpy(m_zintSymbol->primary, m_primaryMessage.toLatin1().left(127));
     }
 
+    /* All the settings that go into an encode, so that it need only be redone when one changes */
+    QByteArray QZint::stateKey() const {
+        QByteArray key;
+        QDataStream stream(&key, QIODevice::WriteOnly);
+        stream << m_symbol << m_text << m_primaryMessage << m_height << m_borderType << m_borderWidth << m_fontSetting
+                << m_option_2 << m_option_3 << m_securityLevel << m_input_mode << m_fgColor << m_bgColor << m_cmyk
+                << m_whitespace << m_scale << m_show_hrt << m_eci << m_dotty << m_dot_size << m_gssep
+                << m_reader_init << m_debug;
+        return key;
+    }
+
     void QZint::encode() {
+        QByteArray key = stateKey();
+        if (m_zintSymbol && key == m_encodedKey) {
+            return;
+        }
+        m_cachePixmap = QPixmap();
+        m_pathLayers.clear();
+        m_pathLayersValid = false;
+
         resetSymbol();
         QByteArray bstr = m_text.toUtf8();
         m_error = ZBarcode_Encode_and_Buffer_Vector(m_zintSymbol, (unsigned char *) bstr.data(), bstr.length(), 0); /* Note do our own rotation */
@@ -121,6 +146,10 @@ namespace Zint {
             m_height = m_zintSymbol->height;
             m_borderWidth = m_zintSymbol->border_width;
             m_whitespace = m_zintSymbol->whitespace_width;
+            key = stateKey(); /* Above may have filled in defaults */
+        }
+        m_encodedKey = key;
+        if (m_error < ZINT_ERROR) {
             emit encoded();
         }
     }
@@ -328,6 +357,62 @@ namespace Zint {
         m_debug = debug;
     }
 
+    /* Take all the settings of `other` (but not its text) so as to produce the same symbols */
+    void QZint::copySettings(const QZint & other) {
+        m_symbol = other.m_symbol;
+        m_primaryMessage = other.m_primaryMessage;
+        m_height = other.m_height;
+        m_borderType = other.m_borderType;
+        m_borderWidth = other.m_borderWidth;
+        m_fontSetting = other.m_fontSetting;
+        m_option_2 = other.m_option_2;
+        m_option_3 = other.m_option_3;
+        m_securityLevel = other.m_securityLevel;
+        m_input_mode = other.m_input_mode;
+        m_fgColor = other.m_fgColor;
+        m_bgColor = other.m_bgColor;
+        m_cmyk = other.m_cmyk;
+        m_whitespace = other.m_whitespace;
+        m_scale = other.m_scale;
+        m_show_hrt = other.m_show_hrt;
+        m_eci = other.m_eci;
+        m_rotate_angle = other.m_rotate_angle;
+        m_dotty = other.m_dotty;
+        m_dot_size = other.m_dot_size;
+        target_size_horiz = other.target_size_horiz;
+        target_size_vert = other.target_size_vert;
+        m_gssep = other.m_gssep;
+        m_reader_init = other.m_reader_init;
+        m_debug = other.m_debug;
+        m_batchPaths = other.m_batchPaths;
+        m_antialias = other.m_antialias;
+    }
+
+    bool QZint::batchPaths() const {
+        return m_batchPaths;
+    }
+
+    /* If set, render all shapes of the same colour as one path filled with a single call, rather than one call
+       per rectangle, hexagon and circle */
+    void QZint::setBatchPaths(bool batchPaths) {
+        if (batchPaths != m_batchPaths) {
+            m_batchPaths = batchPaths;
+            m_cachePixmap = QPixmap();
+        }
+    }
+
+    bool QZint::antialias() const {
+        return m_antialias;
+    }
+
+    /* Whether to antialias hexagons and circles (rectangles are never antialiased) */
+    void QZint::setAntialias(bool antialias) {
+        if (antialias != m_antialias) {
+            m_antialias = antialias;
+            m_cachePixmap = QPixmap();
+        }
+    }
+
     bool QZint::hasHRT(int symbology) const {
         return ZBarcode_Cap(symbology ? symbology : m_symbol, ZINT_CAP_HRT);
     }
@@ -373,6 +458,10 @@ namespace Zint {
     }
 
     bool QZint::save_to_file(QString filename) {
+        m_encodedKey.clear(); /* Symbol replaced so next render must encode */
+        m_cachePixmap = QPixmap();
+        m_pathLayers.clear();
+        m_pathLayersValid = false;
         resetSymbol();
         strcpy(m_zintSymbol->outfile, filename.toLatin1().left(255));
         QByteArray bstr = m_text.toUtf8();
@@ -414,19 +503,29 @@ namespace Zint {
         }
     }
 
-    void QZint::render(QPainter & painter, const QRectF & paintRect, AspectRatioMode mode) {
-        struct zint_vector_rect *rect;
-        struct zint_vector_hexagon *hex;
-        struct zint_vector_circle *circle;
-        struct zint_vector_string *string;
+    /* Whether `painter` draws unscaled onto the screen or an image, so that a pixmap of the symbol may stand in */
+    bool QZint::isRasterDevice(const QPainter & painter) {
+        const QPaintDevice *device = painter.device();
+        if (!device) {
+            return false;
+        }
+        switch (device->devType()) {
+            case QInternal::Widget:
+            case QInternal::Pixmap:
+            case QInternal::Image:
+                return painter.worldTransform().type() <= QTransform::TxTranslate;
+                break;
+        }
+        return false;
+    }
 
+    void QZint::render(QPainter & painter, const QRectF & paintRect, AspectRatioMode mode) {
         (void)mode; /* Not currently used */
 
         encode();
 
-        painter.save();
-
         if (m_error >= ZINT_ERROR) {
+            painter.save();
             painter.setRenderHint(QPainter::Antialiasing);
             QFont font(fontStyleError, fontSizeError);
             painter.setFont(font);
@@ -435,6 +534,106 @@ namespace Zint {
             return;
         }
 
+        /* Printers, pictures and scaled painters get the vectors so as not to lose resolution */
+        if (!isRasterDevice(painter) || paintRect.isEmpty()) {
+            renderSymbol(painter, paintRect);
+            return;
+        }
+
+        const qreal dpr = painter.device()->devicePixelRatioF();
+        if (m_cachePixmap.isNull() || m_cacheSize != paintRect.size() || m_cacheDpr != dpr
+                || m_cacheRotateAngle != m_rotate_angle) {
+            m_cachePixmap = QPixmap((int) ceil(paintRect.width() * dpr), (int) ceil(paintRect.height() * dpr));
+            m_cachePixmap.setDevicePixelRatio(dpr);
+            m_cachePixmap.fill(Qt::transparent);
+            QPainter pixmapPainter(&m_cachePixmap);
+            renderSymbol(pixmapPainter, QRectF(QPointF(0, 0), paintRect.size()));
+            pixmapPainter.end();
+            m_cacheSize = paintRect.size();
+            m_cacheDpr = dpr;
+            m_cacheRotateAngle = m_rotate_angle;
+        }
+        painter.drawPixmap(paintRect.topLeft(), m_cachePixmap);
+    }
+
+    /* Merge the symbol's shapes into one path per colour for `setBatchPaths()`. Rectangles (as already merged by
+       the library) don't overlap so are grouped by colour regardless of order, but circles may be painted over
+       one another (MaxiCode bullseye) so only consecutive circles of the same colour share a path */
+    void QZint::buildPathLayers() {
+        struct zint_vector_rect *rect;
+        struct zint_vector_hexagon *hex;
+        struct zint_vector_circle *circle;
+        QPainterPath rectPaths[9]; /* Indexed by rect colour, -1 (foreground) at 0 */
+        int i;
+
+        m_pathLayers.clear();
+        m_pathLayersValid = true;
+
+        for (rect = m_zintSymbol->vector->rectangles; rect; rect = rect->next) {
+            i = rect->colour >= 0 && rect->colour < 9 ? rect->colour : 0;
+            rectPaths[i].addRect(QRectF(rect->x, rect->y, rect->width, rect->height));
+        }
+        for (i = 0; i < 9; i++) {
+            if (!rectPaths[i].isEmpty()) {
+                PathLayer layer;
+                layer.colour = i == 0 ? m_fgColor : QColor(colourToQtColor(i));
+                layer.path = rectPaths[i];
+                layer.path.setFillRule(Qt::WindingFill);
+                layer.antialias = false;
+                layer.outline = false;
+                m_pathLayers.append(layer);
+            }
+        }
+
+        hex = m_zintSymbol->vector->hexagons;
+        if (hex) {
+            PathLayer layer;
+            layer.colour = m_fgColor;
+            layer.path.setFillRule(Qt::WindingFill);
+            layer.antialias = true;
+            layer.outline = false;
+            qreal previous_diameter = 0.0, radius = 0.0, half_radius = 0.0, half_sqrt3_radius = 0.0;
+            for (; hex; hex = hex->next) {
+                if (previous_diameter != hex->diameter) {
+                    previous_diameter = hex->diameter;
+                    radius = 0.5 * previous_diameter;
+                    half_radius = 0.25 * previous_diameter;
+                    half_sqrt3_radius = 0.43301270189221932338 * previous_diameter;
+                }
+                layer.path.moveTo(hex->x, hex->y + radius);
+                layer.path.lineTo(hex->x + half_sqrt3_radius, hex->y + half_radius);
+                layer.path.lineTo(hex->x + half_sqrt3_radius, hex->y - half_radius);
+                layer.path.lineTo(hex->x, hex->y - radius);
+                layer.path.lineTo(hex->x - half_sqrt3_radius, hex->y - half_radius);
+                layer.path.lineTo(hex->x - half_sqrt3_radius, hex->y + half_radius);
+                layer.path.closeSubpath();
+            }
+            m_pathLayers.append(layer);
+        }
+
+        for (circle = m_zintSymbol->vector->circles; circle; ) {
+            PathLayer layer;
+            const int colour = circle->colour;
+            layer.colour = colour ? m_bgColor : m_fgColor; /* Set means use background colour */
+            layer.path.setFillRule(Qt::WindingFill);
+            layer.antialias = true;
+            layer.outline = true;
+            for (; circle && circle->colour == colour; circle = circle->next) {
+                const qreal radius = 0.5 * circle->diameter;
+                layer.path.addEllipse(QPointF(circle->x, circle->y), radius, radius);
+            }
+            m_pathLayers.append(layer);
+        }
+    }
+
+    void QZint::renderSymbol(QPainter & painter, const QRectF & paintRect) {
+        struct zint_vector_rect *rect;
+        struct zint_vector_hexagon *hex;
+        struct zint_vector_circle *circle;
+        struct zint_vector_string *string;
+
+        painter.save();
+
         painter.setClipRect(paintRect, Qt::IntersectClip);
 
         qreal xtr = paintRect.x();
@@ -476,8 +675,27 @@ namespace Zint {
         //Red square for diagnostics
         //painter.fillRect(QRect(0, 0, m_zintSymbol->vector->width, m_zintSymbol->vector->height), QBrush(QColor(255,0,0,255)));
 
+        if (m_batchPaths) {
+            if (!m_pathLayersValid) {
+                buildPathLayers();
+            }
+            for (int i = 0; i < m_pathLayers.size(); i++) {
+                const PathLayer & layer = m_pathLayers.at(i);
+                painter.setRenderHint(QPainter::Antialiasing, layer.antialias && m_antialias);
+                painter.setPen(layer.outline ? QPen(layer.colour, 0) : QPen(Qt::NoPen));
+                painter.setBrush(layer.colour);
+                painter.drawPath(layer.path);
+            }
+            rect = NULL;
+            hex = NULL;
+            circle = NULL;
+        } else {
+            rect = m_zintSymbol->vector->rectangles;
+            hex = m_zintSymbol->vector->hexagons;
+            circle = m_zintSymbol->vector->circles;
+        }
+
         // Plot rectangles
-        rect = m_zintSymbol->vector->rectangles;
         if (rect) {
             QBrush brush(Qt::SolidPattern);
             while (rect) {
@@ -492,9 +710,8 @@ namespace Zint {
         }
 
         // Plot hexagons
-        hex = m_zintSymbol->vector->hexagons;
         if (hex) {
-            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setRenderHint(QPainter::Antialiasing, m_antialias);
             QBrush fgBrush(m_fgColor);
             qreal previous_diameter = 0.0, radius = 0.0, half_radius = 0.0, half_sqrt3_radius = 0.0;
             while (hex) {
@@ -520,9 +737,8 @@ namespace Zint {
         }
 
         // Plot dots (circles)
-        circle = m_zintSymbol->vector->circles;
         if (circle) {
-            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setRenderHint(QPainter::Antialiasing, m_antialias);
             QPen p;
             QBrush fgBrush(m_fgColor);
             qreal previous_diameter = 0.0, radius = 0.0;
@@ -19,6 +19,9 @@
 #define BARCODERENDER_H
 #include <QColor>
 #include <QPainter>
+#include <QPixmap>
+#include <QPainterPath>
+#include <QList>
 #include "zint.h"
 
 namespace Zint
@@ -103,6 +106,14 @@ public:
 
     void setDebug(bool debug);
 
+    void copySettings(const QZint & other);
+
+    bool batchPaths() const;
+    void setBatchPaths(bool batchPaths);
+
+    bool antialias() const;
+    void setAntialias(bool antialias);
+
     bool hasHRT(int symbology = 0) const;
     bool isExtendable(int symbology = 0) const;
     bool supportsECI(int symbology = 0) const;
@@ -129,9 +140,21 @@ signals:
 private:
     void resetSymbol();
     void encode();
+    QByteArray stateKey() const;
+    void renderSymbol(QPainter & painter, const QRectF & paintRect);
+    static bool isRasterDevice(const QPainter & painter);
+    void buildPathLayers();
     static Qt::GlobalColor colourToQtColor(int colour);
 
 private:
+    /* Shapes of one colour merged into a single path, see `setBatchPaths()` */
+    struct PathLayer {
+        QColor colour;
+        QPainterPath path;
+        bool antialias; /* Whether to honour `m_antialias` (not for rectangles) */
+        bool outline; /* Whether to stroke with a cosmetic pen as for individual circles */
+    };
+
     int m_symbol;
     QString m_text;
     QString m_primaryMessage;
@@ -161,6 +184,15 @@ private:
     bool m_gssep;
     bool m_reader_init;
     bool m_debug;
+    QByteArray m_encodedKey; /* `stateKey()` as at last encode, empty if none */
+    QPixmap m_cachePixmap; /* Last raster render, reused while size, pixel ratio and rotation unchanged */
+    QSizeF m_cacheSize;
+    qreal m_cacheDpr;
+    int m_cacheRotateAngle;
+    bool m_batchPaths;
+    bool m_antialias;
+    QList<PathLayer> m_pathLayers; /* Built on first batched render after encode */
+    bool m_pathLayersValid;
 };
 }
 #endif
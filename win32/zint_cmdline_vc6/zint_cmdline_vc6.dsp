@@ -104,6 +104,14 @@ SOURCE=..\..\backend\bmp.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\backend\cache.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\backend\scratch.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\backend\codablock.c
 # End Source File
 # Begin Source File
@@ -152,6 +160,10 @@ SOURCE=..\..\backend\emf.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\backend\filemem.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\backend\gb18030.c
 # End Source File
 # Begin Source File
@@ -220,6 +232,10 @@ SOURCE=..\..\backend\output.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\backend\parallel.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\backend\pcx.c
 # End Source File
 # Begin Source File